@@ -112,6 +112,18 @@ if( LIBAKRYPT_HAVE_LIMITS )
     set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DLIBAKRYPT_HAVE_LIMITS_H" )
 endif()
 
+# -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  #include <sys/random.h>
+  int main( void ) {
+     char buffer[16];
+     return ( int )getrandom( buffer, sizeof( buffer ), 0 );
+  }" LIBAKRYPT_HAVE_SYSRANDOM )
+
+if( LIBAKRYPT_HAVE_SYSRANDOM )
+    set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DLIBAKRYPT_HAVE_SYSRANDOM_H" )
+endif()
+
 # -------------------------------------------------------------------------------------------------- #
 check_c_source_compiles("
   #include <sys/mman.h>
@@ -19,6 +19,39 @@ if( LIBAKRYPT_HAVE_BUILTIN_MULQ_GCC )
     set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DLIBAKRYPT_HAVE_BUILTIN_MULQ_GCC" )
 endif()
 
+# -------------------------------------------------------------------------------------------------- #
+# -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  #include <sys/types.h>
+  int main( void ) {
+    #if defined( __x86_64__ ) && defined( __BMI2__ ) && defined( __ADX__ )
+      u_int64_t lo, hi, t = 0, u = 1, v = 2;
+      __asm__ (\"xorl %%eax, %%eax; mulx %4, %0, %1; adcx %0, %2; adox %1, %2\"
+                : \"=&r\" (lo), \"=&r\" (hi), \"+r\" (t) : \"d\" (u), \"r\" (v) : \"rax\", \"cc\" );
+      return ( int )t - 3;
+    #else
+      #error Unsupported architecture
+    #endif
+  }" LIBAKRYPT_HAVE_BUILTIN_MULX_ADX )
+
+if( LIBAKRYPT_HAVE_BUILTIN_MULX_ADX )
+    set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DLIBAKRYPT_HAVE_BUILTIN_MULX_ADX" )
+endif()
+
+# -------------------------------------------------------------------------------------------------- #
+# -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  int main( void ) {
+    __extension__ typedef unsigned __int128 uint128;
+    uint128 x = 1;
+    x <<= 64;
+    return ( int )( x >> 64 ) - 1;
+  }" LIBAKRYPT_HAVE_BUILTIN_INT128 )
+
+if( LIBAKRYPT_HAVE_BUILTIN_INT128 )
+    set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DLIBAKRYPT_HAVE_BUILTIN_INT128" )
+endif()
+
 # -------------------------------------------------------------------------------------------------- #
 # -------------------------------------------------------------------------------------------------- #
 check_c_source_compiles("
@@ -34,3 +67,33 @@ check_c_source_compiles("
 if( LIBAKRYPT_HAVE_BUILTIN_CLMULEPI64 )
     set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DLIBAKRYPT_HAVE_BUILTIN_CLMULEPI64" )
 endif()
+
+# -------------------------------------------------------------------------------------------------- #
+# -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  static __thread int counter = 0;
+  int main( void ) {
+    counter++;
+    return counter - 1;
+  }" LIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL )
+
+if( LIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL )
+    set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DLIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL" )
+endif()
+
+# -------------------------------------------------------------------------------------------------- #
+# -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  int main( void ) {
+    unsigned long long x = 0, y = 1;
+    void *p = 0;
+    __atomic_store_n( &x, 1, __ATOMIC_RELEASE );
+    if( !__atomic_compare_exchange_n( &x, &y, 2, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE )) return 1;
+    __atomic_store_n( &p, &x, __ATOMIC_RELEASE );
+    __atomic_add_fetch( &y, __atomic_exchange_n( &x, 2, __ATOMIC_ACQ_REL ) - 2, __ATOMIC_ACQ_REL );
+    return ( int )__atomic_load_n( &x, __ATOMIC_ACQUIRE ) - 2 + ( __atomic_load_n( &p, __ATOMIC_ACQUIRE ) != &x );
+  }" LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+
+if( LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+    set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DLIBAKRYPT_HAVE_BUILTIN_ATOMIC" )
+endif()
@@ -59,19 +59,20 @@
          bkey->encrypt( &bkey->key, acpkm +8, new_key +8 );
          bkey->encrypt( &bkey->key, acpkm +16, new_key +16 );
          bkey->encrypt( &bkey->key, acpkm +24, new_key +24 );
-         counter = ak_libakrypt_get_option( "acpkm_section_magma_block_count" );
+         counter = ak_libakrypt_get_option_by_index( option_acpkm_section_magma_block_count );
          break;
       case 16: /* шифр с длиной блока 128 бит */
          bkey->encrypt( &bkey->key, acpkm, new_key );
          bkey->encrypt( &bkey->key, acpkm +16, new_key +16 );
-         counter = ak_libakrypt_get_option( "acpkm_section_kuznechik_block_count" );
+         counter =
+                 ak_libakrypt_get_option_by_index( option_acpkm_section_kuznechik_block_count );
          break;
       default: return ak_error_message( ak_error_wrong_block_cipher,
                                            __func__ , "incorrect block size of block cipher key" );
    }
 
  /* присваиваем ключу значение */
-  if(( error = ak_bckey_context_set_key( bkey, new_key, bkey->key.key.size, ak_true )) != ak_error_ok )
+  if(( error = ak_bckey_context_rekey( bkey, new_key, bkey->key.key.size )) != ak_error_ok )
     ak_error_message( error, __func__ , "can't replace key by new using acpkm" );
    else {
            bkey->key.resource.value.type = key_using_resource;
@@ -165,7 +166,7 @@
   if( section_size%bkey->bsize != 0 ) return ak_error_message( ak_error_wrong_block_cipher_length,
                                __func__ , "the length of section is not divided by block length" );
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_context_verify( &bkey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                   "incorrect integrity code of secret key value" );
  /* проверяем размер синхропосылки */
@@ -179,8 +180,8 @@
                                                              а также устанавливаем синхропосылку */
   switch( bkey->bsize ) {
     case 8:
-       maxseclen = ak_libakrypt_get_option( "acpkm_section_magma_block_count" );
-       mcount = ak_libakrypt_get_option( "magma_cipher_resource" )/maxseclen;
+       maxseclen = ak_libakrypt_get_option_by_index( option_acpkm_section_magma_block_count );
+       mcount = ak_libakrypt_get_option_by_index( option_magma_cipher_resource )/maxseclen;
        #ifdef LIBAKRYPT_LITTLE_ENDIAN
          ctr[0] = ((ak_uint64 *)iv)[0] << 32;
        #else
@@ -188,8 +189,9 @@
        #endif
       break;
     case 16:
-       maxseclen = ak_libakrypt_get_option( "acpkm_section_kuznechik_block_count" );
-       mcount = ak_libakrypt_get_option( "kuznechik_cipher_resource" )/maxseclen;
+       maxseclen =
+                 ak_libakrypt_get_option_by_index( option_acpkm_section_kuznechik_block_count );
+       mcount = ak_libakrypt_get_option_by_index( option_kuznechik_cipher_resource )/maxseclen;
        ctr[1] = ((ak_uint64 *) iv)[0];
       break;
     default: return ak_error_message( ak_error_wrong_block_cipher,
@@ -205,10 +207,9 @@
     bkey->key.resource.value.counter = mcount; /* здесь находится максимальное число сообщений,
                                                   которые могут быть зашифрованы на данном ключе */
   } else {
-      if( bkey->key.resource.value.counter < 1 )
+      if( ak_skey_context_reserve_resource( &bkey->key, 1, 0 ) != ak_error_ok )
         return ak_error_message( ak_error_low_key_resource,
                                 __func__ , "low key using resource for block cipher key context" );
-       else bkey->key.resource.value.counter--;
      }
 
  /* теперь размножаем исходный ключ */
@@ -27,6 +27,7 @@
     - bkey.decrypt -- алгоритм расшифрования одного блока
     - bkey.shedule_keys -- алгоритм развертки ключа и генерации раундовых ключей
     - bkey.delete_keys -- функция удаления раундовых ключей
+    - bkey.wipe_keys -- функция очистки раундовых ключей без освобождения памяти
 
     Следующие поля принимают значения по-умолчанию
     - bkey.key.data -- указатель на служебную область памяти
@@ -72,6 +73,7 @@
   bkey->decrypt =       NULL;
   bkey->schedule_keys = NULL;
   bkey->delete_keys =   NULL;
+  bkey->wipe_keys =     NULL;
 
  return ak_error_ok;
 }
@@ -107,6 +109,7 @@
   bkey->decrypt =       NULL;
   bkey->schedule_keys = NULL;
   bkey->delete_keys =   NULL;
+  bkey->wipe_keys =     NULL;
 
  return error;
 }
@@ -155,6 +158,16 @@
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция устанавливает ресурс ключа блочного шифрования, определяемый опциями
+    библиотеки `magma_cipher_resource` и `kuznechik_cipher_resource`.                              */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_bckey_context_set_cipher_resource( ak_bckey bkey )
+{
+ return ak_skey_context_set_resource( &bkey->key, block_counter_resource,
+            bkey->bsize == 8 ? option_magma_cipher_resource : option_kuznechik_cipher_resource, 0, 0 );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция присваивает контексту ключа алгоритма блочного шифрования заданное значение,
     содержащееся в области памяти, на которую указывает аргумент функции keyptr.
@@ -201,16 +214,60 @@
     ak_error_message( error, __func__, "incorrect execution of key scheduling procedure" );
 
  /* устанавливаем ресурс использования серетного ключа */
-  if( bkey->bsize == 8 ) {
-   if(( error = ak_skey_context_set_resource( &bkey->key,
-                      block_counter_resource, "magma_cipher_resource", 0, 0 )) != ak_error_ok )
-    ak_error_message( error, __func__, "incorrect assigning \"magma_cipher_resource\" option" );
-  } else {
-      if(( error = ak_skey_context_set_resource( &bkey->key,
-                     block_counter_resource, "kuznechik_cipher_resource", 0, 0 )) != ak_error_ok )
-        ak_error_message( error, __func__,
-                                      "incorrect assigning \"kuznechik_cipher_resource\" option" );
-    }
+  if(( error = ak_bckey_context_set_cipher_resource( bkey )) != ak_error_ok )
+    ak_error_message( error, __func__, "incorrect assigning of secret key resource" );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция предназначена для частой смены значения ключа, например, при выработке производных
+    ключей в режимах ACPKM или в протоколе sp fiot. В отличие от функции ak_bckey_context_set_key()
+    повторно используется вся память, ранее выделенная под ключ, его маску, контрольную сумму
+    и развернутые раундовые ключи; заново вычисляются только маска, контрольная сумма
+    и раундовые ключи.
+
+    Если контексту ключа еще не было присвоено значение, либо контекст не владеет памятью,
+    в которой размещен ключ, то функция вызывает ak_bckey_context_set_key().
+
+    @param bkey Контекст ключа блочного алгоритма шифрования.
+    @param keyptr Указатель на область памяти, содержащую новое значение ключа.
+    @param size Размер области памяти, содержащей значение ключа.
+
+    @return Функция возвращает код ошибки. В случае успеха возвращается \ref ak_error_ok (ноль).   */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_context_rekey( ak_bckey bkey, const ak_pointer keyptr, const size_t size )
+{
+  int error = ak_error_ok;
+
+ /* проверяем входные данные */
+  if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                      "using null pointer to secret key context" );
+  if( keyptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                "using null pointer to key data" );
+  if( size != bkey->key.key.size ) return ak_error_message( ak_error_wrong_length, __func__,
+                                                      "using a new key value with wrong length" );
+ /* ключ должен быть ранее присвоен и размещен в принадлежащей контексту памяти */
+  if((( bkey->key.flags&skey_flag_set_key ) == 0 ) || ( bkey->key.key.flag != ak_true ) ||
+                                                       ( bkey->key.mask.size != size ))
+    return ak_bckey_context_set_key( bkey, keyptr, size, ak_true );
+
+ /* замещаем значение ключа и вырабатываем новую маску */
+  ak_skey_context_modify_begin( &bkey->key );
+  memcpy( bkey->key.key.data, keyptr, size );
+  bkey->key.flags &= (0xFFFFFFFFFFFFFFFFLL ^ skey_flag_set_mask );
+  if(( error = bkey->key.set_mask( &bkey->key )) == ak_error_ok )
+    error = bkey->key.set_icode( &bkey->key );
+  ak_skey_context_modify_end( &bkey->key );
+  if( error != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong secret key masking" );
+
+ /* развертка выполняется в ранее выделенной памяти */
+  if( bkey->schedule_keys != NULL ) error = bkey->schedule_keys( &bkey->key );
+  if( error != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect execution of key scheduling procedure" );
+
+  if(( error = ak_bckey_context_set_cipher_resource( bkey )) != ak_error_ok )
+    ak_error_message( error, __func__, "incorrect assigning of secret key resource" );
  return error;
 }
 
@@ -246,16 +303,8 @@
     ak_error_message( error, __func__, "incorrect execution of key scheduling procedure" );
 
  /* устанавливаем ресурс использования серетного ключа */
-  if( bkey->bsize == 8 ) {
-   if(( error = ak_skey_context_set_resource( &bkey->key,
-                      block_counter_resource, "magma_cipher_resource", 0, 0 )) != ak_error_ok )
-    ak_error_message( error, __func__, "incorrect assigning \"magma_cipher_resource\" option" );
-  } else {
-      if(( error = ak_skey_context_set_resource( &bkey->key,
-                     block_counter_resource, "kuznechik_cipher_resource", 0, 0 )) != ak_error_ok )
-        ak_error_message( error, __func__,
-                                      "incorrect assigning \"kuznechik_cipher_resource\" option" );
-    }
+  if(( error = ak_bckey_context_set_cipher_resource( bkey )) != ak_error_ok )
+    ak_error_message( error, __func__, "incorrect assigning of secret key resource" );
  return error;
 }
 
@@ -299,16 +348,8 @@
     ak_error_message( error, __func__, "incorrect execution of key scheduling procedure" );
 
  /* устанавливаем ресурс использования серетного ключа */
-  if( bkey->bsize == 8 ) {
-   if(( error = ak_skey_context_set_resource( &bkey->key,
-                      block_counter_resource, "magma_cipher_resource", 0, 0 )) != ak_error_ok )
-    ak_error_message( error, __func__, "incorrect assigning \"magma_cipher_resource\" option" );
-  } else {
-      if(( error = ak_skey_context_set_resource( &bkey->key,
-                     block_counter_resource, "kuznechik_cipher_resource", 0, 0 )) != ak_error_ok )
-        ak_error_message( error, __func__,
-                                      "incorrect assigning \"kuznechik_cipher_resource\" option" );
-    }
+  if(( error = ak_bckey_context_set_cipher_resource( bkey )) != ak_error_ok )
+    ak_error_message( error, __func__, "incorrect assigning of secret key resource" );
 
  return error;
 }
@@ -346,6 +387,7 @@
   bkey->decrypt = rkey->decrypt;
   bkey->schedule_keys = rkey->schedule_keys;
   bkey->delete_keys = rkey->delete_keys;
+  bkey->wipe_keys = rkey->wipe_keys;
 
  /* выполняем развертку раундовых ключей */
   if( bkey->schedule_keys != NULL ) error = bkey->schedule_keys( &bkey->key );
@@ -354,13 +396,199 @@
     return ak_error_message( error, __func__, "incorrect execution of key scheduling procedure" );
   }
  /* выполняем забытое: перемаскируем секретный ключ */
-  if(( error = bkey->key.set_mask( &bkey->key )) != ak_error_ok ) {
+  ak_skey_context_modify_begin( &bkey->key );
+  error = bkey->key.set_mask( &bkey->key );
+  ak_skey_context_modify_end( &bkey->key );
+  if( error != ak_error_ok ) {
     ak_bckey_context_destroy( bkey );
     ak_error_message( error, __func__, "incorrect secret key remasking" );
   }
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция уничтожает значение секретного ключа и развернутые раундовые ключи; память,
+    выделенная под ключ, его маску, контрольную сумму и развернутые ключи, не освобождается.
+    Развернутые ключи замещаются случайными данными, а занимаемая ими ячейка защищенной
+    области памяти повторно используется при следующем присвоении ключу значения.
+
+    @param bkey Контекст ключа алгоритма блочного шифрования.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_context_wipe( ak_bckey bkey )
+{
+  int error = ak_error_ok;
+
+  if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                  "using a null pointer to block cipher context" );
+  if(( bkey->wipe_keys != NULL ) &&
+                                 (( error = bkey->wipe_keys( &bkey->key )) != ak_error_ok ))
+    ak_error_message( error, __func__ , "wrong wiping of round keys" );
+  if(( error = ak_skey_context_wipe( &bkey->key )) != ak_error_ok )
+    ak_error_message( error, __func__ , "wrong wiping of secret key" );
+  if( ak_buffer_is_assigned( &bkey->ivector ))
+    memset( bkey->ivector.data, 0, bkey->ivector.size );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                     пул повторно используемых ключей блочного шифрования                        */
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция создает пул ключей алгоритма блочного шифрования, заданного своим идентификатором,
+    и заранее создает заданное количество контекстов ключей. Контексты ключей, полученные из пула,
+    используют уже выделенную память под ключ, маску, контрольную сумму и развернутые
+    раундовые ключи: при возврате в пул ключевая информация замещается случайными данными,
+    но память не освобождается. Поэтому получение и возврат ключа не обращаются ни к системному
+    распределителю памяти, ни к защищенной области памяти.
+
+    Пул не является потокобезопасным: предполагается, что каждый поток (соединение)
+    использует собственный пул.
+
+    @param pool Контекст пула ключей.
+    @param oid Идентификатор алгоритма блочного шифрования.
+    @param count Количество заранее создаваемых контекстов ключей; может быть равно нулю.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_pool_create( ak_bckey_pool pool, ak_oid oid, const size_t count )
+{
+  int error = ak_error_ok;
+
+  if( pool == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                       "using null pointer to block cipher pool" );
+  if( oid == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                       "using null pointer to block cipher oid" );
+  if(( oid->engine != block_cipher ) || ( oid->mode != algorithm ))
+    return ak_error_message( ak_error_oid_engine, __func__ , "using oid with wrong engine" );
+
+  pool->oid = oid;
+  pool->count = 0;
+  pool->total = 0;
+  if(( pool->size = count ) == 0 ) pool->size = 4;
+  if(( pool->idle = malloc( pool->size*sizeof( ak_bckey ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__,
+                                                "incorrect memory allocation for block cipher pool" );
+ /* заранее создаем контексты ключей */
+  while( pool->count < count ) {
+    ak_bckey bkey = NULL;
+    if(( bkey = malloc( sizeof( struct bckey ))) == NULL ) {
+      error = ak_error_message( ak_error_out_of_memory, __func__,
+                                                 "incorrect memory allocation for block cipher key" );
+      break;
+    }
+    if(( error = ak_bckey_context_create_oid( bkey, oid )) != ak_error_ok ) {
+      free( bkey );
+      ak_error_message( error, __func__, "incorrect creation of block cipher key" );
+      break;
+    }
+    pool->idle[pool->count++] = bkey;
+    pool->total++;
+  }
+  if( error != ak_error_ok ) ak_bckey_pool_destroy( pool );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция уничтожает все контексты ключей, хранящиеся в пуле. Контексты ключей, полученные
+    из пула и не возвращенные в него, должны уничтожаться функцией ak_bckey_context_delete().
+
+    @param pool Контекст пула ключей.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_pool_destroy( ak_bckey_pool pool )
+{
+  if( pool == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                       "using null pointer to block cipher pool" );
+  while( pool->count > 0 ) ak_bckey_context_delete( pool->idle[--pool->count] );
+  if( pool->idle != NULL ) free( pool->idle );
+  pool->idle = NULL;
+  pool->size = pool->total = 0;
+  pool->oid = NULL;
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция извлекает из пула контекст ключа и присваивает ему заданное значение;
+    если пул пуст, то создается новый контекст ключа.
+
+    @param pool Контекст пула ключей.
+    @param keyptr Указатель на область памяти, содержащую значение ключа.
+    @param size Размер ключа в байтах.
+    @return В случае успеха функция возвращает указатель на контекст ключа. В противном случае
+    возвращается NULL, а код ошибки может быть получен с помощью функции ak_error_get_value().     */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_bckey ak_bckey_pool_checkout( ak_bckey_pool pool, const ak_pointer keyptr, const size_t size )
+{
+  int error = ak_error_ok;
+  ak_bckey bkey = NULL;
+
+  if( pool == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__, "using null pointer to block cipher pool" );
+    return NULL;
+  }
+  if( pool->count > 0 ) bkey = pool->idle[--pool->count];
+   else {
+     if(( bkey = malloc( sizeof( struct bckey ))) == NULL ) {
+       ak_error_message( ak_error_out_of_memory, __func__,
+                                                 "incorrect memory allocation for block cipher key" );
+       return NULL;
+     }
+     if(( error = ak_bckey_context_create_oid( bkey, pool->oid )) != ak_error_ok ) {
+       free( bkey );
+       ak_error_message( error, __func__, "incorrect creation of block cipher key" );
+       return NULL;
+     }
+     pool->total++;
+   }
+ /* присваиваем значение ключа, используя уже выделенную память */
+  if(( error = ak_bckey_context_set_key( bkey, keyptr, size, ak_true )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect assigning of secret key value" );
+    ak_bckey_pool_checkin( pool, bkey );
+    return NULL;
+  }
+ return bkey;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция уничтожает ключевую информацию и возвращает контекст ключа в пул.
+    Память, выделенная под контекст ключа и развернутые раундовые ключи, не освобождается,
+    а ее содержимое замещается случайными данными (см. ak_bckey_context_wipe()). Ключ считается
+    неустановленным и не может использоваться до следующего извлечения из пула.
+
+    @param pool Контекст пула ключей.
+    @param bkey Контекст ключа, полученный с помощью функции ak_bckey_pool_checkout().
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_pool_checkin( ak_bckey_pool pool, ak_bckey bkey )
+{
+  int error = ak_error_ok;
+
+  if( pool == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                       "using null pointer to block cipher pool" );
+  if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                  "using null pointer to block cipher context" );
+ /* уничтожаем ключевую информацию, не освобождая память контекста */
+  if(( error = ak_bckey_context_wipe( bkey )) != ak_error_ok )
+    ak_error_message( error, __func__, "incorrect wiping of secret key" );
+
+  if( pool->count == pool->size ) {
+    ak_bckey *idle = realloc( pool->idle, 2*pool->size*sizeof( ak_bckey ));
+    if( idle == NULL ) {
+      pool->total--;
+      ak_bckey_context_delete( bkey );
+      return ak_error_message( ak_error_out_of_memory, __func__,
+                                             "incorrect memory allocation for block cipher pool" );
+    }
+    pool->idle = idle;
+    pool->size <<= 1;
+  }
+  pool->idle[pool->count++] = bkey;
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                             теперь реализация режимов шифрования                                */
 /* ----------------------------------------------------------------------------------------------- */
@@ -386,15 +614,14 @@
                             __func__ , "the length of input data is not divided by block length" );
 
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_context_verify( &bkey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode,
                                         __func__, "incorrect integrity code of secret key value" );
  /* уменьшаем значение ресурса ключа */
   blocks = (ak_uint64 ) size/bkey->bsize;
-  if( bkey->key.resource.value.counter < blocks )
+  if( ak_skey_context_reserve_resource( &bkey->key, blocks, 0 ) != ak_error_ok )
     return ak_error_message( ak_error_low_key_resource,
                                                    __func__ , "low resource of block cipher key" );
-   else bkey->key.resource.value.counter -= blocks;
 
  /* теперь приступаем к зашифрованию данных */
   switch( bkey->bsize ) {
@@ -413,8 +640,8 @@
     default: return ak_error_message( ak_error_wrong_block_cipher,
                                           __func__ , "incorrect block size of block cipher key" );
   }
- /* перемаскируем ключ */
-  if(( error = bkey->key.set_mask( &bkey->key )) != ak_error_ok )
+ /* перемаскируем ключ в соответствии с установленной для него политикой */
+  if(( error = ak_skey_context_remask( &bkey->key, size/bkey->bsize )) != ak_error_ok )
     ak_error_message( error, __func__ , "wrong remasking of secret key" );
 
  return ak_error_ok;
@@ -443,15 +670,14 @@
                             __func__ , "the length of input data is not divided by block length" );
 
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_context_verify( &bkey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode,
                                         __func__, "incorrect integrity code of secret key value" );
  /* уменьшаем значение ресурса ключа */
   blocks = (ak_uint64 ) size/bkey->bsize;
-  if( bkey->key.resource.value.counter < blocks )
+  if( ak_skey_context_reserve_resource( &bkey->key, blocks, 0 ) != ak_error_ok )
     return ak_error_message( ak_error_low_key_resource,
                                                    __func__ , "low resource of block cipher key" );
-   else bkey->key.resource.value.counter -= blocks;
 
  /* теперь приступаем к расшифрованию данных */
   switch( bkey->bsize ) {
@@ -470,8 +696,8 @@
     default: return ak_error_message( ak_error_wrong_block_cipher,
                                           __func__ , "incorrect block size of block cipher key" );
   }
- /* перемаскируем ключ */
-  if(( error = bkey->key.set_mask( &bkey->key )) != ak_error_ok )
+ /* перемаскируем ключ в соответствии с установленной для него политикой */
+  if(( error = ak_skey_context_remask( &bkey->key, size/bkey->bsize )) != ak_error_ok )
     ak_error_message( error, __func__ , "wrong remasking of secret key" );
 
  return ak_error_ok;
@@ -530,37 +756,45 @@
   int error = ak_error_ok;
   ak_int64 blocks = (ak_int64)size/bkey->bsize,
              tail = (ak_int64)size%bkey->bsize;
+  const ssize_t resource = ( ssize_t )( blocks + ( tail > 0 ));
   ak_uint64 yaout[2], *inptr = (ak_uint64 *)in, *outptr = (ak_uint64 *)out;
 
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_context_verify( &bkey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                    "incorrect integrity code of secret key value" );
- /* уменьшаем значение ресурса ключа */
-  if( bkey->key.resource.value.counter < ( blocks + ( tail > 0 )))
+ /* резервируем ресурс ключа; при ошибках в синхропосылке резерв возвращается */
+  if( ak_skey_context_reserve_resource( &bkey->key, resource, 0 ) != ak_error_ok )
     return ak_error_message( ak_error_low_key_resource,
                                                     __func__ , "low resource of block cipher key" );
-   else bkey->key.resource.value.counter -= ( blocks + ( tail > 0 ));
 
  /* выбираем, как вычислять синхропосылку */
   if(( iv == NULL ) || ( iv_size == 0 )) { /* запрос на использование внутреннего значения */
-    if( ak_buffer_is_assigned( &bkey->ivector ) != ak_true )
+    if( ak_buffer_is_assigned( &bkey->ivector ) != ak_true ) {
+      ak_skey_context_commit_resource( &bkey->key, resource, 0 );
       return ak_error_message( ak_error_wrong_block_cipher_function, __func__ ,
                                   "first calling function with undefined value of initial vector" );
-    if( bkey->key.flags&bckey_flag_not_ctr )
+    }
+    if( bkey->key.flags&bckey_flag_not_ctr ) {
+      ak_skey_context_commit_resource( &bkey->key, resource, 0 );
       return ak_error_message( ak_error_wrong_block_cipher_function, __func__ ,
                               "secondary calling function with undefined value of initial vector" );
+    }
   } else {
      size_t halfsize = bkey->bsize >> 1 ;
 
     /* проверяем длину синхропосылки (если меньше половины блока, то плохо)
         если больше - то лишнее не используется */
-     if( iv_size < halfsize )
+     if( iv_size < halfsize ) {
+       ak_skey_context_commit_resource( &bkey->key, resource, 0 );
        return ak_error_message( ak_error_wrong_iv_length, __func__,
                                                               "incorrect length of initial value" );
+     }
     /* выделяем память под буффер и помещаем в него значение */
-     if(( error = ak_buffer_set_size( &bkey->ivector, bkey->bsize )) != ak_error_ok )
+     if(( error = ak_buffer_set_size( &bkey->ivector, bkey->bsize )) != ak_error_ok ) {
+       ak_skey_context_commit_resource( &bkey->key, resource, 0 );
        return ak_error_message( error, __func__ , "incorrect momory allocation for internal vector" );
+     }
 
      memset( bkey->ivector.data, 0, bkey->ivector.size );
       /* слишком большое значение iv_size может привести к выходу за границы памяти,
@@ -627,8 +861,9 @@
     bkey->key.flags |= bckey_flag_not_ctr;
   }
 
- /* перемаскируем ключ */
-  if(( error = bkey->key.set_mask( &bkey->key )) != ak_error_ok )
+ /* перемаскируем ключ в соответствии с установленной для него политикой */
+  if(( error = ak_skey_context_remask( &bkey->key,
+                                      ( size + bkey->bsize - 1 )/bkey->bsize )) != ak_error_ok )
     ak_error_message( error, __func__ , "wrong remasking of secret key" );
 
  return error;
@@ -671,17 +906,17 @@
   }
 
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true ) {
+  if( ak_skey_context_verify( &bkey->key ) != ak_true ) {
     ak_error_message( ak_error_wrong_key_icode, __func__,
                                                   "incorrect integrity code of secret key value" );
     return NULL;
   }
 
  /* уменьшаем значение ресурса ключа */
-  if( bkey->key.resource.value.counter < ( blocks + ( tail > 0 ))) {
+  if( ak_skey_context_reserve_resource( &bkey->key, blocks + ( tail > 0 ), 0 ) != ak_error_ok ) {
     ak_error_message( ak_error_low_key_resource, __func__ , "low resource of block cipher key" );
     return NULL;
-  } else bkey->key.resource.value.counter -= ( blocks + ( tail > 0 )); /* уменьшаем ресурс ключа */
+  }
 
   memset( akey, 0, sizeof( akey ));
   memset( yaout, 0, sizeof( yaout ));
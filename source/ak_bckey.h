@@ -43,6 +43,8 @@
    ak_function_skey *schedule_keys;
   /*! \brief Функция уничтожения развернутых ключей. */
    ak_function_skey *delete_keys;
+  /*! \brief Функция очистки развернутых ключей без освобождения занимаемой ими памяти. */
+   ak_function_skey *wipe_keys;
 };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -50,6 +52,8 @@
  int ak_bckey_context_create( ak_bckey , size_t , size_t );
 /*! \brief Очистка ключа алгоритма блочного шифрования. */
  int ak_bckey_context_destroy( ak_bckey );
+/*! \brief Уничтожение ключевой информации без освобождения памяти контекста. */
+ int ak_bckey_context_wipe( ak_bckey );
 /*! \brief Удаление ключа алгоритма блочного шифрования. */
  ak_pointer ak_bckey_context_delete( ak_pointer );
 
@@ -64,6 +68,8 @@
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Присвоение контексту ключа алгоритма блочного шифрования константного значения. */
  int ak_bckey_context_set_key( ak_bckey, const ak_pointer , const size_t , const bool_t );
+/*! \brief Смена значения ключа алгоритма блочного шифрования без повторного выделения памяти. */
+ int ak_bckey_context_rekey( ak_bckey, const ak_pointer , const size_t );
 /*! \brief Присвоение контексту ключа алгоритма блочного шифрования случайного значения. */
  int ak_bckey_context_set_key_random( ak_bckey , ak_random );
 /*! \brief Присвоение контексту ключа алгоритма блочного шифрования значения, выработанного из пароля. */
@@ -76,6 +82,36 @@
     из рекомендаций Р 1323565.1.012-2018. */
  int ak_bckey_context_next_acpkm_key( ak_bckey );
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Пул повторно используемых ключей алгоритма блочного шифрования.
+
+    Пул хранит созданные контексты ключей одного алгоритма блочного шифрования;
+    при возврате в пул ключевая информация уничтожается, а выделенная память сохраняется.
+    Это позволяет избежать многократного выделения и освобождения памяти при частой смене
+    ключей, например, ключей отдельных сообщений (пакетов).                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct bckey_pool {
+  /*! \brief Идентификатор алгоритма блочного шифрования. */
+   ak_oid oid;
+  /*! \brief Массив контекстов, готовых к использованию. */
+   ak_bckey *idle;
+  /*! \brief Количество контекстов, готовых к использованию. */
+   size_t count;
+  /*! \brief Размер массива контекстов. */
+   size_t size;
+  /*! \brief Общее количество контекстов, созданных пулом. */
+   size_t total;
+ } *ak_bckey_pool;
+
+/*! \brief Создание пула ключей алгоритма блочного шифрования. */
+ int ak_bckey_pool_create( ak_bckey_pool , ak_oid , const size_t );
+/*! \brief Уничтожение пула ключей алгоритма блочного шифрования. */
+ int ak_bckey_pool_destroy( ak_bckey_pool );
+/*! \brief Получение из пула ключа с заданным значением. */
+ ak_bckey ak_bckey_pool_checkout( ak_bckey_pool , const ak_pointer , const size_t );
+/*! \brief Возврат ключа в пул. */
+ int ak_bckey_pool_checkin( ak_bckey_pool , ak_bckey );
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Зашифрование данных в режиме простой замены. */
  int ak_bckey_context_encrypt_ecb( ak_bckey , ak_pointer , ak_pointer , size_t );
@@ -4,6 +4,15 @@
 /*  Файл ak_buffer.с                                                                               */
 /*  - содержит реализацию всех функций для работы с буфферами данных                               */
 /* ----------------------------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------------------------------- */
+/* это объявление нужно для использования флагов MAP_ANONYMOUS и MADV_DONTDUMP */
+#ifdef __linux__
+ #ifndef _DEFAULT_SOURCE
+   #define _DEFAULT_SOURCE
+ #endif
+#endif
+
  #include <string.h>
  #include <stdlib.h>
 
@@ -11,6 +20,15 @@
 #ifdef LIBAKRYPT_HAVE_STDALIGN
  #include <stdalign.h>
 #endif
+#ifdef LIBAKRYPT_HAVE_SYSMMAN_H
+ #include <sys/mman.h>
+#endif
+#ifdef LIBAKRYPT_HAVE_UNISTD_H
+ #include <unistd.h>
+#endif
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
 
  #include <ak_buffer.h>
 
@@ -30,6 +48,330 @@
   size );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                        защищенная область памяти для ключевой информации                        */
+/* ----------------------------------------------------------------------------------------------- */
+#if defined( LIBAKRYPT_HAVE_SYSMMAN_H ) && defined( MAP_ANONYMOUS )
+/*! \brief Количество классов размеров ячеек: от 16 до 1024 байт. */
+ #define ak_secure_classes_count   (7)
+/*! \brief Минимальный размер ячейки защищенной области памяти (в байтах). */
+ #define ak_secure_min_slot       (16)
+/*! \brief Количество страниц памяти, доступных для размещения ячеек одного фрагмента. */
+ #define ak_secure_chunk_pages     (4)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Фрагмент защищенной области памяти.
+
+    Фрагмент представляет собой отображенную в память последовательность страниц, которая
+    окружена двумя охранными страницами, недоступными ни для чтения, ни для записи.
+    Доступные страницы фрагмента блокируются в оперативной памяти (не выгружаются на диск),
+    исключаются из дампов памяти и нарезаются на ячейки одинакового размера.                       */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct secure_chunk {
+  /*! \brief начало отображенной области, включая охранные страницы */
+   ak_uint8 *region;
+  /*! \brief размер отображенной области в байтах */
+   size_t region_size;
+  /*! \brief начало области, доступной для размещения ячеек */
+   ak_uint8 *base;
+  /*! \brief размер области, доступной для размещения ячеек */
+   size_t size;
+  /*! \brief номер класса размера ячеек */
+   size_t sclass;
+  /*! \brief количество выделенных ячеек */
+   size_t used;
+ } *ak_secure_chunk;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Защищенная область памяти для хранения ключевой информации.
+
+    Для каждого класса размеров поддерживается список свободных ячеек, связанный через первое
+    слово каждой свободной ячейки; поэтому выделение и освобождение ячейки выполняются за
+    константное время. Массив фрагментов упорядочен по адресам, что позволяет
+    определять фрагмент, содержащий освобождаемый указатель, двоичным поиском.                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static struct secure_arena {
+  /*! \brief списки свободных ячеек для каждого класса размеров */
+   ak_pointer free[ak_secure_classes_count];
+  /*! \brief упорядоченный по адресам массив фрагментов */
+   ak_secure_chunk chunks;
+  /*! \brief количество фрагментов */
+   size_t count;
+  /*! \brief размер массива фрагментов */
+   size_t size;
+  /*! \brief общее количество выделенных ячеек */
+   size_t used;
+  /*! \brief размер страницы памяти */
+   size_t page;
+ } arena = { { NULL }, NULL, 0, 0, 0, 0 };
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ static pthread_mutex_t ak_secure_arena_mutex = PTHREAD_MUTEX_INITIALIZER;
+ #define ak_secure_arena_lock()   pthread_mutex_lock( &ak_secure_arena_mutex )
+ #define ak_secure_arena_unlock() pthread_mutex_unlock( &ak_secure_arena_mutex )
+#else
+ #define ak_secure_arena_lock()
+ #define ak_secure_arena_unlock()
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает номер класса размеров, к которому относится заданный размер. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline size_t ak_secure_arena_class( size_t size )
+{
+  size_t sclass = 0, slot = ak_secure_min_slot;
+  while( slot < size ) { slot <<= 1; sclass++; }
+ return sclass;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция ищет фрагмент, содержащий заданный указатель.
+    \return Индекс фрагмента в массиве. Если указатель не принадлежит защищенной области,
+    возвращается количество фрагментов.                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static size_t ak_secure_arena_find( const ak_uint8 *ptr )
+{
+  size_t left = 0, right = arena.count;
+
+  while( left < right ) {
+    size_t mid = left + ( right - left )/2;
+    if( ptr < arena.chunks[mid].base ) right = mid;
+     else {
+       if( ptr < arena.chunks[mid].base + arena.chunks[mid].size ) return mid;
+       left = mid + 1;
+     }
+  }
+ return arena.count;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция создает новый фрагмент для заданного класса размеров и помещает
+    его ячейки в список свободных ячеек.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_secure_arena_morecore( const size_t sclass )
+{
+  ak_uint8 *region = NULL;
+  struct secure_chunk chunk;
+  size_t idx = 0, slot = ( size_t )ak_secure_min_slot << sclass;
+
+  if( arena.page == 0 ) {
+   #ifdef LIBAKRYPT_HAVE_UNISTD_H
+    long page = sysconf( _SC_PAGESIZE );
+    arena.page = page > 0 ? ( size_t )page : 4096;
+   #else
+    arena.page = 4096;
+   #endif
+  }
+ /* увеличиваем массив фрагментов */
+  if( arena.count == arena.size ) {
+    size_t newsize = arena.size ? arena.size << 1 : 16;
+    ak_secure_chunk chunks = realloc( arena.chunks, newsize*sizeof( struct secure_chunk ));
+    if( chunks == NULL ) return ak_error_message( ak_error_out_of_memory, __func__,
+                                                 "incorrect memory allocation for chunks array" );
+    arena.chunks = chunks;
+    arena.size = newsize;
+  }
+
+ /* отображаем страницы памяти и устанавливаем охранные страницы */
+  chunk.size = ak_secure_chunk_pages*arena.page;
+  chunk.region_size = chunk.size + 2*arena.page;
+  if(( region = mmap( NULL, chunk.region_size, PROT_READ | PROT_WRITE,
+                                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 )) == MAP_FAILED )
+    return ak_error_message( ak_error_out_of_memory, __func__,
+                                                     "incorrect mapping of secure memory pages" );
+  mprotect( region, arena.page, PROT_NONE );
+  mprotect( region + arena.page + chunk.size, arena.page, PROT_NONE );
+ #ifdef MADV_DONTDUMP
+  madvise( region + arena.page, chunk.size, MADV_DONTDUMP );
+ #endif
+ /* невозможность блокировки страниц (например, из-за ограничения RLIMIT_MEMLOCK)
+    не препятствует использованию фрагмента */
+  if(( mlock( region + arena.page, chunk.size ) != 0 ) && ( ak_log_get_level() > ak_log_standard ))
+    ak_error_message( ak_error_ok, __func__, "secure memory pages are not locked in memory" );
+
+  chunk.region = region;
+  chunk.base = region + arena.page;
+  chunk.sclass = sclass;
+  chunk.used = 0;
+
+ /* вставляем фрагмент в упорядоченный массив */
+  for( idx = arena.count; idx > 0; idx-- ) {
+     if( arena.chunks[idx-1].base < chunk.base ) break;
+     arena.chunks[idx] = arena.chunks[idx-1];
+  }
+  arena.chunks[idx] = chunk;
+  arena.count++;
+
+ /* нарезаем фрагмент на ячейки */
+  for( idx = chunk.size; idx >= slot; idx -= slot ) {
+     ak_pointer ptr = chunk.base + idx - slot;
+     *( ak_pointer *)ptr = arena.free[sclass];
+     arena.free[sclass] = ptr;
+  }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция выделяет память для хранения ключевой информации в защищенной области памяти:
+    страницы этой области блокируются в оперативной памяти, исключаются из дампов памяти
+    и отделяются от остальной памяти процесса охранными страницами.
+    Выделенная память выравнена по границе 16 байт.
+
+    Память, размер которой превышает 1024 байта, а также память, которую не удалось выделить
+    в защищенной области, выделяется функцией ak_libakrypt_aligned_malloc().
+    Память должна освобождаться функцией ak_libakrypt_secure_free().
+
+    @param size Размер выделяемой памяти в байтах.
+    @return Указатель на выделенную память.                                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_pointer ak_libakrypt_secure_malloc( size_t size )
+{
+  size_t sclass = 0;
+  ak_pointer ptr = NULL;
+
+  if(( size == 0 ) || ( size > ( ak_secure_min_slot << ( ak_secure_classes_count - 1 ))))
+    return ak_libakrypt_aligned_malloc( size );
+  sclass = ak_secure_arena_class( size );
+
+  ak_secure_arena_lock();
+  if(( arena.free[sclass] != NULL ) || ( ak_secure_arena_morecore( sclass ) == ak_error_ok )) {
+    ptr = arena.free[sclass];
+    arena.free[sclass] = *( ak_pointer *)ptr;
+    *( ak_pointer *)ptr = NULL;
+    arena.chunks[ ak_secure_arena_find( ptr )].used++;
+    arena.used++;
+  }
+  ak_secure_arena_unlock();
+
+  if( ptr == NULL ) return ak_libakrypt_aligned_malloc( size );
+ return ptr;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция обнуляет и освобождает память, выделенную функцией ak_libakrypt_secure_malloc().
+    Память, не принадлежащая защищенной области, освобождается функцией free().
+
+    @param ptr Указатель на освобождаемую память.                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_libakrypt_secure_free( ak_pointer ptr )
+{
+  size_t idx = 0;
+  ak_secure_chunk chunk = NULL;
+
+  if( ptr == NULL ) return;
+  ak_secure_arena_lock();
+  if(( idx = ak_secure_arena_find( ptr )) == arena.count ) {
+    ak_secure_arena_unlock();
+    free( ptr );
+    return;
+  }
+  chunk = arena.chunks+idx;
+  memset( ptr, 0, ( size_t )ak_secure_min_slot << chunk->sclass );
+  *( ak_pointer *)ptr = arena.free[chunk->sclass];
+  arena.free[chunk->sclass] = ptr;
+  chunk->used--;
+  arena.used--;
+  ak_secure_arena_unlock();
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param ptr Указатель на область памяти.
+    @return Функция возвращает \ref ak_true, если указатель принадлежит защищенной
+    области памяти. В противном случае возвращается \ref ak_false.                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_libakrypt_secure_contains( const ak_pointer ptr )
+{
+  bool_t result = ak_false;
+
+  ak_secure_arena_lock();
+  result = ( ak_secure_arena_find( ptr ) != arena.count );
+  ak_secure_arena_unlock();
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @return Функция возвращает количество ячеек защищенной области памяти,
+    выделенных и не освобожденных в данный момент.                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ size_t ak_libakrypt_secure_used( void )
+{
+  size_t used = 0;
+
+  ak_secure_arena_lock();
+  used = arena.used;
+  ak_secure_arena_unlock();
+ return used;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция освобождает все фрагменты защищенной области памяти, если ни одна ячейка
+    не используется. В противном случае, фрагменты сохраняются до завершения программы,
+    поскольку ключи, не уничтоженные пользователем, продолжают ссылаться на них.
+
+    @return В случае успеха функция возвращает \ref ak_error_ok. Если часть ячеек
+    используется, то возвращается \ref ak_error_secure_memory_used.                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_libakrypt_secure_destroy( void )
+{
+  int error = ak_error_ok;
+  size_t idx = 0, used = 0;
+
+  ak_secure_arena_lock();
+  if(( used = arena.used ) == 0 ) {
+    for( idx = 0; idx < arena.count; idx++ ) {
+       memset( arena.chunks[idx].base, 0, arena.chunks[idx].size );
+       munlock( arena.chunks[idx].base, arena.chunks[idx].size );
+       munmap( arena.chunks[idx].region, arena.chunks[idx].region_size );
+    }
+    if( arena.chunks != NULL ) free( arena.chunks );
+    memset( &arena, 0, sizeof( struct secure_arena ));
+  } else error = ak_error_secure_memory_used;
+  ak_secure_arena_unlock();
+
+  if( error != ak_error_ok )
+    ak_error_message_fmt( error, __func__,
+               "secure memory holds %u not destroyed secret values", (unsigned int) used );
+ return error;
+}
+
+#else
+/* ----------------------------------------------------------------------------------------------- */
+/*! При отсутствии системных вызовов отображения страниц памяти используется обычное
+    выравненное выделение памяти.                                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_pointer ak_libakrypt_secure_malloc( size_t size )
+{
+ return ak_libakrypt_aligned_malloc( size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_libakrypt_secure_free( ak_pointer ptr )
+{
+  free( ptr );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_libakrypt_secure_contains( const ak_pointer ptr )
+{
+  ( void )ptr;
+ return ak_false;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ size_t ak_libakrypt_secure_used( void )
+{
+ return 0;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_libakrypt_secure_destroy( void )
+{
+ return ak_error_ok;
+}
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция устанавливает значение полей структуры struct buffer в значения по-умолчанию.
 
@@ -290,7 +632,7 @@
 
     if(( error = ak_buffer_free( buff )) != ak_error_ok ) {
       ak_error_message( error, __func__, "incorrect buffer memory destroying");
-      free( ptr );
+      buff->free( ptr );
       return error;
     }
     buff->data = ptr;
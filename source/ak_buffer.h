@@ -59,6 +59,16 @@
 
 /*! \brief Функция выделения оперативной памяти. */
  ak_pointer ak_libakrypt_aligned_malloc( size_t );
+/*! \brief Функция выделения памяти для ключевой информации в защищенной области. */
+ ak_pointer ak_libakrypt_secure_malloc( size_t );
+/*! \brief Функция освобождения памяти, выделенной в защищенной области. */
+ void ak_libakrypt_secure_free( ak_pointer );
+/*! \brief Проверка принадлежности указателя защищенной области памяти. */
+ bool_t ak_libakrypt_secure_contains( const ak_pointer );
+/*! \brief Количество ячеек защищенной области памяти, используемых в данный момент. */
+ size_t ak_libakrypt_secure_used( void );
+/*! \brief Освобождение защищенной области памяти. */
+ int ak_libakrypt_secure_destroy( void );
 
 #endif
 /* ----------------------------------------------------------------------------------------------- */
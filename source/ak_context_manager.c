@@ -133,6 +133,7 @@
   node->id = id;
   node->oid = oid;
   node->status = node_is_equal;
+  node->retired = NULL;
 
  return node;
 }
@@ -171,6 +172,22 @@
  static pthread_mutex_t ak_context_manager_mutex = PTHREAD_MUTEX_INITIALIZER;
 #endif
 
+/* ----------------------------------------------------------------------------------------------- */
+/* если компилятор не поддерживает атомарные операции, то изменение структуры управления
+   контекстами выполняется под защитой мьютекса                                                    */
+#ifdef LIBAKRYPT_HAVE_BUILTIN_ATOMIC
+ #define ak_context_manager_lock()
+ #define ak_context_manager_unlock()
+#else
+ #ifdef LIBAKRYPT_HAVE_PTHREAD
+  #define ak_context_manager_lock()     pthread_mutex_lock( &ak_context_manager_mutex )
+  #define ak_context_manager_unlock()   pthread_mutex_unlock( &ak_context_manager_mutex )
+ #else
+  #define ak_context_manager_lock()
+  #define ak_context_manager_unlock()
+ #endif
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                                    класс ak_context_manager                                     */
 /* ----------------------------------------------------------------------------------------------- */
@@ -193,9 +210,9 @@
                                             "using a null pointer to context manager structure" );
  /* инициализируем генератор ключей */
 #if defined(__unix__) || defined(__APPLE__)
-  if(( error = ak_random_context_create_urandom( &manager->key_generator )) != ak_error_ok )
+  if(( error = ak_random_context_create_getrandom( &manager->key_generator )) != ak_error_ok )
     return ak_error_message( error, __func__,
-                            "wrong initialization of /dev/urandom for random number generation" );
+                          "wrong initialization of getrandom() for random number generation" );
 #else
  #ifdef _WIN32
    if(( error = ak_random_context_create_winrtl( &manager->key_generator )) != ak_error_ok ) {
@@ -211,15 +228,20 @@
  #endif
 #endif
 
- /* инициализируем указатели контекстов */
-  manager->size = ( size_t )ak_libakrypt_get_option("context_manager_size");
+ /* инициализируем сегменты: память выделяется только для первого из них */
+  for( idx = 0; idx < ak_context_manager_max_segments; idx++ ) manager->segments[idx] = NULL;
+  manager->base = ( size_t )ak_libakrypt_get_option_by_index( option_context_manager_size );
+  manager->count = 0;
+  manager->size = 0;
+  manager->free = 0;
+  memset( manager->readers, 0, sizeof( manager->readers ));
+  manager->retired = NULL;
 
-  if(( manager->array = malloc( manager->size*sizeof( ak_pointer ))) == NULL ) {
+  if(( error = ak_context_manager_morealloc( manager )) != ak_error_ok ) {
     ak_context_manager_destroy( manager );
-    return ak_error_message( ak_error_out_of_memory, __func__ ,
+    return ak_error_message( error, __func__ ,
                                             "wrong memory allocation for context manager nodes" );
   }
-  for( idx = 0; idx < manager->size; idx++ ) manager->array[idx] = NULL;
 
  return ak_error_ok;
 }
@@ -237,26 +259,35 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_context_manager_destroy( ak_context_manager manager )
 {
-  size_t idx = 0;
+  size_t idx = 0, jdx = 0;
   int error = ak_error_ok;
+  ak_context_node node = NULL;
 
   if( manager == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                             "using a null pointer to context manager structure" );
-  if( manager->array == NULL ) {
+ /* освобождаем удаленные ранее элементы */
+  while(( node = manager->retired ) != NULL ) {
+    manager->retired = node->retired;
+    ak_context_node_delete( node );
+  }
+  if( manager->segments[0] == NULL ) {
     ak_error_message( error = ak_error_undefined_value, __func__ ,
                                                    "cleaning context manager with empty memory" );
   } else {
-          /* удаляем ключевые структуры */
-           for( idx = 0; idx < manager->size; idx++ )
-              if( manager->array[idx] != NULL )
-                manager->array[idx] = ak_context_node_delete( manager->array[idx] );
-
-           /* очищаем и уничтожаем память */
-           memset( manager->array, 0, manager->size);
-           free( manager->array );
-           manager->array = NULL;
+          /* удаляем ключевые структуры и сегменты */
+           for( idx = 0; idx < ak_context_manager_max_segments; idx++ ) {
+              if( manager->segments[idx] == NULL ) continue;
+              for( jdx = 0; jdx < ( manager->base << idx ); jdx++ )
+                 if( manager->segments[idx][jdx].node != NULL )
+                   manager->segments[idx][jdx].node =
+                                            ak_context_node_delete( manager->segments[idx][jdx].node );
+              free( manager->segments[idx] );
+              manager->segments[idx] = NULL;
+           }
   }
+  manager->count = 0;
   manager->size = 0;
+  manager->free = 0;
 
  /* удаляем генератор ключей */
   if(( error = ak_random_context_destroy( &manager->key_generator )) != ak_error_ok )
@@ -266,15 +297,15 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! Функция выделяет дополнительную память под массив хранения контекстов.
-    При выделении памяти производится перенос содержащихся в массиве указателей
-    (элементов структуры управления контекстами) в новую область памяти.
-    Старая область памяти уничтожается.
+/*! Функция добавляет к структуре управления контекстами новый сегмент, размер которого вдвое
+    больше размера предыдущего сегмента, и помещает ячейки нового сегмента в список свободных ячеек.
+    Ранее созданные сегменты не перемещаются, поэтому функция может выполняться одновременно с
+    поиском контекстов в других потоках. Если новый сегмент одновременно создается другим потоком,
+    то функция завершается без ошибки, не выделяя память.
 
-    При выделении памяти размер новой области увеличивается в два раза, по сравнению с предыдущим
-    объемом, то есть происходит двукратное увеличение. Максимальное число
-    хранимых в структуре управления контекстов является внешним параметром библиотеки.
-    Данное значение устанавливается в файле `libakrypt.conf` (см. раздел \ref construction_options).
+    Максимальное число хранимых в структуре управления контекстов является внешним параметром
+    библиотеки. Данное значение устанавливается в файле `libakrypt.conf`
+    (см. раздел \ref construction_options).
 
     @param manager Указатель на структуру управления ключами
     @return В случае успеха функция возвращает \ref ak_error_ok (ноль). В противном случае
@@ -282,29 +313,80 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_context_manager_morealloc( ak_context_manager manager )
 {
-  size_t idx, newsize , msize = ( size_t )ak_libakrypt_get_option("context_manager_max_size");
+  ak_uint64 head = 0, value = 0;
+  ak_context_slot segment = NULL, expected = NULL;
+  size_t idx, first, ssize, newsize, count, msize =
+                  ( size_t )ak_libakrypt_get_option_by_index( option_context_manager_max_size );
 
   if( manager == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                             "using a null pointer to context manager structure" );
-  if(( newsize = ( manager->size << 1 )) <= manager->size )
+  count = ak_atomic_load( &manager->count );
+  if( count >= ak_context_manager_max_segments )
     return ak_error_message( ak_error_context_manager_size, __func__ ,
                                       "unexpected value of new value of context manager's size" );
-  if( newsize > msize ) return ak_error_message( ak_error_context_manager_max_size, __func__,
+  first = manager->base*(((size_t)1 << count ) - 1 );
+  ssize = manager->base << count;
+  if(( newsize = first + ssize ) <= first )
+    return ak_error_message( ak_error_context_manager_size, __func__ ,
+                                      "unexpected value of new value of context manager's size" );
+  if(( count > 0 ) && ( newsize > msize ))
+    return ak_error_message( ak_error_context_manager_max_size, __func__,
+                                   "current size of context manager exceeds permissible bounds" );
+  if( newsize > 0xffffffffU )
+    return ak_error_message( ak_error_context_manager_max_size, __func__,
                                    "current size of context manager exceeds permissible bounds" );
 
-  if(( manager->array = realloc( manager->array, sizeof( ak_pointer )*newsize )) == NULL )
+  if(( segment = malloc( ssize*sizeof( struct context_slot ))) == NULL )
     return ak_error_message( ak_error_out_of_memory, __func__ ,
                                             "wrong memory allocation for context manager nodes" );
- /* инициализируем новые ячейки массива */
-  for( idx = manager->size; idx < newsize; idx++ ) manager->array[idx] = NULL;
-  manager->size = newsize;
+ /* инициализируем ячейки нового сегмента и связываем их в список */
+  for( idx = 0; idx < ssize; idx++ ) {
+     segment[idx].node = NULL;
+     segment[idx].generation = 0;
+     segment[idx].next = ( ak_uint32 )( first + idx + 2 );
+  }
+
+ /* публикуем сегмент; если другой поток нас опередил, то память освобождается */
+  if( !ak_atomic_cas( &manager->segments[count], &expected, segment )) {
+    free( segment );
+    return ak_error_ok;
+  }
+
+ /* помещаем ячейки сегмента в список свободных ячеек */
+  head = ak_atomic_load( &manager->free );
+  do {
+      segment[ssize-1].next = ( ak_uint32 )( head&0xffffffffU );
+      value = ((( head >> 32 ) + 1 ) << 32 ) | ( ak_uint64 )( first + 1 );
+  } while( !ak_atomic_cas( &manager->free, &head, value ));
+
+  ak_atomic_store( &manager->size, newsize );
+  ak_atomic_store( &manager->count, count+1 );
 
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Сегмент с номером k содержит ячейки с индексами от base(2^k - 1) до base(2^{k+1} - 1) - 1.
+
+    @param manager Указатель на структуру управления контекстами
+    @param idx Индекс ячейки
+    @return Указатель на ячейку или NULL, если ячейка с заданным индексом не существует.            */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_context_slot ak_context_manager_get_slot( ak_context_manager manager, size_t idx )
+{
+  ak_context_slot segment = NULL;
+  size_t q = idx/manager->base + 1, k = 0;
+
+  while( q >>= 1 ) k++;
+  if( k >= ak_context_manager_max_segments ) return NULL;
+  if(( segment = ak_atomic_load( &manager->segments[k] )) == NULL ) return NULL;
+ return segment + ( idx - manager->base*(((size_t)1 << k ) - 1 ));
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! По заданному значению индекса массива idx функция вычисляет значение дескриптора,
-    доступного пользователю. Обратное преобразование задается функцией
+    доступного пользователю: младшие 32 бита дескриптора содержат индекс, старшие -
+    текущее поколение ячейки. Обратное преобразование задается функцией
     ak_context_manager_handle_to_idx().
 
     @param manager Указатель на структуру управления контекстами
@@ -313,9 +395,16 @@
 /* ----------------------------------------------------------------------------------------------- */
  ak_handle ak_context_manager_idx_to_handle( ak_context_manager manager, size_t idx )
 {
-  if( manager == NULL ) ak_error_message( ak_error_null_pointer, __func__ ,
+  ak_context_slot slot = NULL;
+
+  if( manager == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__ ,
                                             "using a null pointer to context manager structure" );
- return ( ak_handle )idx;
+    return ak_error_wrong_handle;
+  }
+  if(( slot = ak_context_manager_get_slot( manager, idx )) == NULL ) return ak_error_wrong_handle;
+ return ( ak_handle )(((( ak_uint64 )( ak_atomic_load( &slot->generation )&0x7fffffffU )) << 32 )
+                                                                                  | ( ak_uint64 )idx );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -331,13 +420,138 @@
 {
   if( manager == NULL ) ak_error_message( ak_error_null_pointer, __func__ ,
                                             "using a null pointer to context manager structure" );
- return ( size_t ) handle;
+ return ( size_t )(( ak_uint64 ) handle&0xffffffffU );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция извлекает из структуры управления контекстами список удаленных элементов и,
+    если ни один поток не выполняет чтение элементов, освобождает их память. Все элементы списка
+    изъяты из ячеек до извлечения списка, поэтому поток, начавший чтение после проверки
+    счетчиков, не может получить к ним доступ. Если читающие потоки есть, то список возвращается
+    обратно и будет освобожден при следующем добавлении или удалении контекста,
+    либо при уничтожении структуры управления контекстами.
+
+    Функция вызывается только из функций, изменяющих структуру, и никогда из функций поиска
+    контекста.
+
+    @param manager Указатель на структуру управления контекстами                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_context_manager_reclaim( ak_context_manager manager )
+{
+  size_t idx = 0;
+  ak_context_node list = ak_atomic_load( &manager->retired ), tail = NULL, head = NULL;
+
+  while(( list != NULL ) && !ak_atomic_cas( &manager->retired, &list, NULL ));
+  if( list == NULL ) return;
+
+  ak_atomic_fence();
+  for( idx = 0; idx < ak_context_manager_reader_stripes; idx++ )
+     if( ak_atomic_load( &manager->readers[idx].count ) != 0 ) break;
+  if( idx == ak_context_manager_reader_stripes ) {
+    while( list != NULL ) {
+      tail = list->retired;
+      ak_context_node_delete( list );
+      list = tail;
+    }
+    return;
+  }
+
+ /* возвращаем список обратно */
+  for( tail = list; tail->retired != NULL; tail = tail->retired );
+  head = ak_atomic_load( &manager->retired );
+  do {
+      tail->retired = head;
+  } while( !ak_atomic_cas( &manager->retired, &head, list ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+#ifdef LIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL
+/*! \brief Номер счетчика читающих потоков, увеличенный на единицу, который использует
+    текущий поток (ноль - номер еще не назначен). */
+ static __thread size_t ak_context_manager_reader_slot = 0;
+/*! \brief Номер счетчика, который будет назначен следующему потоку. */
+ static size_t ak_context_manager_reader_next = 0;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция отмечает начало чтения элементов структуры управления контекстами.
+    \details Каждому потоку при первом обращении назначается свой счетчик читающих потоков;
+    при отсутствии поддержки локальной памяти потока номер счетчика вычисляется по адресу стека.
+    @return Номер счетчика, который должен быть передан функции ak_context_manager_read_end(). */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline size_t ak_context_manager_read_begin( ak_context_manager manager )
+{
+  size_t stripe = 0;
+#ifdef LIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL
+  if(( stripe = ak_context_manager_reader_slot ) == 0 )
+    ak_context_manager_reader_slot = stripe = ( ak_atomic_add( &ak_context_manager_reader_next,
+                                                1 )%ak_context_manager_reader_stripes ) + 1;
+  stripe--;
+#else
+  stripe = (( size_t )&stripe >> 16 )%ak_context_manager_reader_stripes;
+#endif
+  ak_atomic_add( &manager->readers[stripe].count, 1 );
+  ak_atomic_fence();
+ return stripe;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция отмечает завершение чтения элементов структуры управления контекстами.
+    \details Функция не освобождает удаленные элементы, это выполняется функцией
+    ak_context_manager_reclaim() при изменении структуры. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_context_manager_read_end( ak_context_manager manager, size_t stripe )
+{
+  ak_atomic_sub( &manager->readers[stripe].count, 1 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция извлекает ячейку из списка свободных ячеек, при необходимости добавляя
+    новый сегмент. Извлечение выполняется без блокировок.
+
+    @param manager Указатель на структуру управления контекстами
+    @param idx Указатель на переменную, в которую помещается индекс ячейки
+    @return В случае успеха функция возвращает \ref ak_error_ok (ноль). В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_context_manager_pop_slot( ak_context_manager manager, size_t *idx )
+{
+  int error = ak_error_ok;
+  ak_context_slot slot = NULL;
+  ak_uint64 head = ak_atomic_load( &manager->free ), value = 0;
+
+  for( ;; ) {
+     if(( head&0xffffffffU ) == 0 ) { /* свободных ячеек нет */
+       if(( error = ak_context_manager_morealloc( manager )) != ak_error_ok ) return error;
+       head = ak_atomic_load( &manager->free );
+       continue;
+     }
+     *idx = ( size_t )( head&0xffffffffU ) - 1;
+     slot = ak_context_manager_get_slot( manager, *idx );
+     value = ((( head >> 32 ) + 1 ) << 32 ) | ( ak_uint64 )ak_atomic_load( &slot->next );
+     if( ak_atomic_cas( &manager->free, &head, value )) break;
+  }
+ return ak_error_ok;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! Функция находит первый равный NULL адрес элемента структуры и
-    помещает по этому адресу новый элемент. В случае, если текущей объем памяти недостаточен для
-    размещения нового элемента, происходит выделение нового фрагмента памяти.
+/*! \brief Функция возвращает ячейку с заданным индексом в список свободных ячеек.                */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_context_manager_push_slot( ak_context_manager manager, size_t idx )
+{
+  ak_context_slot slot = ak_context_manager_get_slot( manager, idx );
+  ak_uint64 head = ak_atomic_load( &manager->free ), value = 0;
+
+  do {
+      ak_atomic_store( &slot->next, ( ak_uint32 )( head&0xffffffffU ));
+      value = ((( head >> 32 ) + 1 ) << 32 ) | ( ak_uint64 )( idx + 1 );
+  } while( !ak_atomic_cas( &manager->free, &head, value ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция извлекает свободную ячейку из списка свободных ячеек и помещает в нее новый элемент.
+    В случае, если свободных ячеек нет, к структуре добавляется новый сегмент.
+    При наличии атомарных операций функция не использует блокировок.
 
     @param manager Указатель на структуру управления контекстами
     @param ctx Контекст, который будет храниться в структуре управленияя контекстами
@@ -367,68 +581,88 @@
   }
   if( defaultstr == NULL )  defaultstr = "";
 
- /* блокируем доступ к структуре управления контекстами */
-#ifdef LIBAKRYPT_HAVE_PTHREAD
-  pthread_mutex_lock( &ak_context_manager_mutex );
-#endif
-
- /* ищем свободный адрес */
-  for( idx = 0; idx < manager->size; idx++ ) {
-     if( manager->array[idx] == NULL ) break;
-  }
-  if( idx == manager->size ) {
-    if(( error =  ak_context_manager_morealloc( manager )) != ak_error_ok ) {
-      ak_error_message( error, __func__, "wrong allocation a new memory for context manager" );
-      #ifdef LIBAKRYPT_HAVE_PTHREAD
-        pthread_mutex_unlock( &ak_context_manager_mutex );
-      #endif
-      return ak_error_wrong_handle;
-    }
+  ak_context_manager_lock();
+ /* получаем свободную ячейку */
+  if(( error = ak_context_manager_pop_slot( manager, &idx )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "wrong allocation a new memory for context manager" );
+    ak_context_manager_unlock();
+    return ak_error_wrong_handle;
   }
 
  /* адрес найден, теперь размещаем контекст */
   handle = ak_context_manager_idx_to_handle( manager, idx );
   if(( node = ak_context_node_new( ctx, handle, engine, defaultstr )) == NULL ) {
     ak_error_message( ak_error_get_value(), __func__, "wrong creation of context manager node" );
-    #ifdef LIBAKRYPT_HAVE_PTHREAD
-     pthread_mutex_unlock( &ak_context_manager_mutex );
-    #endif
+    ak_context_manager_push_slot( manager, idx );
+    ak_context_manager_unlock();
     return ak_error_wrong_handle;
   }
-  manager->array[idx] = node;
-#ifdef LIBAKRYPT_HAVE_PTHREAD
-  pthread_mutex_unlock( &ak_context_manager_mutex );
-#endif
+  ak_atomic_store( &ak_context_manager_get_slot( manager, idx )->node, node );
+ /* освобождаем элементы, удаление которых было отложено */
+  ak_context_manager_reclaim( manager );
+  ak_context_manager_unlock();
 
  return handle;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция удаляет контекст и возвращает ячейку в список свободных ячеек. Поколение ячейки
+    увеличивается, поэтому дескриптор удаленного контекста становится недействительным.
+    Если другие потоки в данный момент выполняют поиск контекстов, то удаление элемента
+    откладывается до завершения ими чтения (см. ak_context_manager_reclaim()).
+
+    @param manager Указатель на структуру управления контекстами
+    @param handle Дескриптор контектса
+    @return В случае успеха функция возвращает \ref ak_error_ok (ноль). В противном случае
+    возвращается код ошибки.                                                                       */
 /* ----------------------------------------------------------------------------------------------- */
  int ak_context_manager_delete_node( ak_context_manager manager, ak_handle handle )
 {
-  size_t idx = 0;
   int error = ak_error_ok;
+  size_t idx = 0, stripe = 0;
+  ak_context_slot slot = NULL;
+  ak_context_node node = NULL, head = NULL;
 
   if( manager == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                       "using a null pointer to context manager" );
+  ak_context_manager_lock();
  /* получаем индекс из значения дескриптора */
-  if(( error = ak_context_manager_handle_check( manager, handle, &idx )) != ak_error_ok )
+  if(( error = ak_context_manager_handle_check( manager, handle, &idx )) != ak_error_ok ) {
+    ak_context_manager_unlock();
     return ak_error_message( error, __func__, "incorrect handle" );
+  }
+
+ /* изымаем элемент из ячейки; если это одновременно сделал другой поток, то выходим */
+  slot = ak_context_manager_get_slot( manager, idx );
+  stripe = ak_context_manager_read_begin( manager );
+  node = ak_atomic_load( &slot->node );
+  if(( node == NULL ) || ( node->id != handle ) || !ak_atomic_cas( &slot->node, &node, NULL )) {
+    ak_context_manager_read_end( manager, stripe );
+    ak_context_manager_unlock();
+    return ak_error_message( ak_error_wrong_handle, __func__, "using a stale handle" );
+  }
+  ak_context_manager_read_end( manager, stripe );
+  ak_atomic_store( &slot->generation, slot->generation + 1 );
+
+ /* помещаем элемент в список удаленных элементов и освобождаем его, если это возможно */
+  head = ak_atomic_load( &manager->retired );
+  do {
+      node->retired = head;
+  } while( !ak_atomic_cas( &manager->retired, &head, node ));
+  ak_context_manager_push_slot( manager, idx );
+  ak_context_manager_reclaim( manager );
+  ak_context_manager_unlock();
 
- /* блокируем доступ и удаляем объект */
-#ifdef LIBAKRYPT_HAVE_PTHREAD
-  pthread_mutex_lock( &ak_context_manager_mutex );
-#endif
-  manager->array[idx] = ak_context_node_delete( manager->array[idx] );
-#ifdef LIBAKRYPT_HAVE_PTHREAD
-  pthread_mutex_unlock( &ak_context_manager_mutex );
-#endif
  return ak_error_ok;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция проверяет, что внутренний массив контекстов содержит в себе отличный от NULL контекст
-    с заданным значеним дескриптора ключа. Функция не экспортируется.
+    с заданным значеним дескриптора ключа, а поколение ячейки совпадает с поколением,
+    указанным в дескрипторе. Функция не использует блокировок. Функция не экспортируется.
+    Поколение ячейки сравнивается до обращения к элементу, а сам элемент читается
+    только при увеличенном счетчике читающих потоков, поэтому он не может быть освобожден
+    одновременно выполняемым удалением. Функция не освобождает удаленные элементы.
 
     @param manager Контекст структуры управления контекстами.
     @param handle Дескриптор контекста.
@@ -438,28 +672,43 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_context_manager_handle_check( ak_context_manager manager, ak_handle handle, size_t *idx )
 {
+  size_t stripe = 0;
+  int error = ak_error_ok;
+  ak_context_slot slot = NULL;
+  ak_context_node node = NULL;
+
  /* проверяем менеджер контекстов */
   if( manager == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                       "using null pointer to context manager" );
  /* проверяем, что значение handle определено */
-  if( handle == ak_error_wrong_handle ) return ak_error_message( ak_error_wrong_handle,
+  if( handle < 0 ) return ak_error_message( ak_error_wrong_handle,
                                                   __func__, "using an undefined handle value" );
  /* определяем индекс */
   *idx = ak_context_manager_handle_to_idx( manager, handle );
 
  /* проверяем границы */
-  if( *idx >= manager->size )
+  if(( slot = ak_context_manager_get_slot( manager, *idx )) == NULL )
     return ak_error_message( ak_error_wrong_handle, __func__, "invalid handle index" );
 
+ /* проверяем поколение */
+  if((( ak_uint64 )handle >> 32 ) != ( ak_atomic_load( &slot->generation )&0x7fffffffU ))
+    return ak_error_message( ak_error_wrong_handle, __func__, "using a stale handle" );
+
+  stripe = ak_context_manager_read_begin( manager );
  /* проверяем наличие node */
-  if( manager->array[*idx] == NULL )
-    return ak_error_message( ak_error_null_pointer, __func__,
+  if(( node = ak_atomic_load( &slot->node )) == NULL )
+    ak_error_message( error = ak_error_null_pointer, __func__,
                                                "using a null pointer to context manager node" );
- /* проверяем наличие контекста */
-  if( manager->array[*idx]->ctx == NULL )
-    return ak_error_message( ak_error_null_pointer, __func__, "using null pointer to context" );
+  else /* поколение могло измениться после проверки */
+    if( node->id != handle )
+      ak_error_message( error = ak_error_wrong_handle, __func__, "using a stale handle" );
+    else /* проверяем наличие контекста */
+      if( node->ctx == NULL )
+        ak_error_message( error = ak_error_null_pointer, __func__,
+                                                               "using null pointer to context" );
+  ak_context_manager_read_end( manager, stripe );
 
- return ak_error_ok;
+ return error;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -471,6 +720,7 @@
  int ak_libakrypt_create_context_manager( void )
 {
   int error = ak_error_ok;
+  ak_context_manager manager = NULL;
 
  /* блокируем доступ */
 #ifdef LIBAKRYPT_HAVE_PTHREAD
@@ -486,12 +736,16 @@
                                                      "trying to create existing context manager" );
   }
 
-  if(( libakrypt_manager = malloc( sizeof( struct context_manager ))) == NULL )
+  if(( manager = malloc( sizeof( struct context_manager ))) == NULL )
     ak_error_message( error = ak_error_out_of_memory, __func__,
                                                    "wrong memory allocation for context manager" );
   else {
-         if(( error = ak_context_manager_create( libakrypt_manager )) != ak_error_ok )
+         if(( error = ak_context_manager_create( manager )) != ak_error_ok ) {
            ak_error_message( error, __func__, "incorrect initialization of context manager" );
+           free( manager );
+         }
+          /* структура становится доступной другим потокам только после полной инициализации */
+          else ak_atomic_store( &libakrypt_manager, manager );
        }
 
  /* разблокируем доступ */
@@ -509,6 +763,7 @@
  int ak_libakrypt_destroy_context_manager( void )
 {
   int error = ak_error_ok;
+  ak_context_manager manager = NULL;
 
  /* блокируем доступ */
 #ifdef LIBAKRYPT_HAVE_PTHREAD
@@ -522,10 +777,12 @@
     return ak_error_message( ak_error_null_pointer, __func__ ,
                                                  "destroying a null pointer to context manager" );
   }
-  if(( error = ak_context_manager_destroy( libakrypt_manager )) != ak_error_ok )
+  manager = libakrypt_manager;
+  ak_atomic_store( &libakrypt_manager, NULL );
+  if(( error = ak_context_manager_destroy( manager )) != ak_error_ok )
     ak_error_message( error, __func__, "wrong destroing of context manager" );
 
-  free( libakrypt_manager );
+  free( manager );
 
  /* разблокируем доступ */
 #ifdef LIBAKRYPT_HAVE_PTHREAD
@@ -542,14 +799,18 @@
 {
  ak_context_manager result = NULL;
 
+#ifdef LIBAKRYPT_HAVE_BUILTIN_ATOMIC
+  result = ak_atomic_load( &libakrypt_manager );
+#else
  #ifdef LIBAKRYPT_HAVE_PTHREAD
   pthread_mutex_lock( &ak_context_manager_mutex );
  #endif
 
   result = libakrypt_manager;
 
-#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #ifdef LIBAKRYPT_HAVE_PTHREAD
   pthread_mutex_unlock( &ak_context_manager_mutex );
+ #endif
 #endif
 
   if( !result )
@@ -628,8 +889,10 @@
 /* ----------------------------------------------------------------------------------------------- */
  ak_pointer ak_handle_get_context( ak_handle handle, oid_engines_t *engine )
 {
-  size_t idx = 0;
+  size_t idx = 0, stripe = 0;
+  ak_pointer ctx = NULL;
   int error = ak_error_ok;
+  ak_context_node node = NULL;
   ak_context_manager manager = NULL;
 
  /* получаем доступ к структуре управления контекстами */
@@ -638,13 +901,30 @@
     return NULL;
   }
 
+  ak_context_manager_lock();
   if(( error = ak_context_manager_handle_check( manager, handle, &idx )) != ak_error_ok ) {
+    ak_context_manager_unlock();
     ak_error_message( error, __func__, "wrong handle" );
     return NULL;
   }
 
-  *engine = manager->array[idx]->oid->engine;
- return manager->array[idx]->ctx;
+  /* контекст мог быть удален другим потоком после проверки; элемент не освобождается,
+     пока увеличен счетчик читающих потоков, однако одновременное удаление и использование
+     контекста с одним и тем же дескриптором остается ответственностью пользователя */
+  stripe = ak_context_manager_read_begin( manager );
+  node = ak_atomic_load( &ak_context_manager_get_slot( manager, idx )->node );
+  if(( node == NULL ) || ( node->id != handle )) {
+    ak_context_manager_read_end( manager, stripe );
+    ak_context_manager_unlock();
+    ak_error_message( ak_error_wrong_handle, __func__, "using a stale handle" );
+    return NULL;
+  }
+  *engine = node->oid->engine;
+  ctx = node->ctx;
+  ak_context_manager_read_end( manager, stripe );
+  ak_context_manager_unlock();
+
+ return ctx;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -34,6 +34,8 @@
    struct buffer description;
   /*! \brief статус контекста */
    context_node_status_t status;
+  /*! \brief следующий элемент в списке удаленных элементов, ожидающих освобождения памяти */
+   struct context_node *retired;
 } *ak_context_node;
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -43,6 +45,37 @@
 /*! \brief Уничтожение элемента структуры управления контекстами. */
  ak_pointer ak_context_node_delete( ak_pointer );
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Максимальное количество фрагментов памяти (сегментов) структуры управления контекстами. */
+ #define ak_context_manager_max_segments   (32)
+
+/*! \brief Количество счетчиков читающих потоков структуры управления контекстами. */
+ #define ak_context_manager_reader_stripes   (16)
+/*! \brief Размер строки кэша, используемый для размещения счетчиков читающих потоков. */
+ #define ak_context_manager_cache_line       (64)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Счетчик потоков, читающих элементы структуры управления контекстами.
+    \details Каждый счетчик занимает отдельную строку кэша, поэтому потоки, использующие
+    разные счетчики, не конкурируют за одну и ту же память.                                        */
+ typedef struct context_reader {
+  /*! \brief количество потоков, читающих в данный момент элементы структуры */
+   size_t count;
+  /*! \brief выравнивание до размера строки кэша */
+   ak_uint8 padding[ak_context_manager_cache_line - sizeof( size_t )];
+} *ak_context_reader;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Ячейка структуры управления контекстами. */
+ typedef struct context_slot {
+  /*! \brief указатель на элемент структуры управления контекстами */
+   ak_context_node node;
+  /*! \brief поколение ячейки, увеличивается при каждом удалении контекста */
+   ak_uint32 generation;
+  /*! \brief индекс следующей свободной ячейки, увеличенный на единицу (ноль - ячеек больше нет) */
+   ak_uint32 next;
+} *ak_context_slot;
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Структура, предназначенная для управления контекстами.
 
@@ -50,15 +83,38 @@
     произвольных классов библиотеки, для которых
     механизмом OID определены стандартные действия (создание, удаление и т.п.).
 
+    Массив состоит из сегментов, размер каждого следующего сегмента вдвое больше предыдущего.
+    При увеличении объема памяти добавляется новый сегмент, а существующие сегменты не
+    перемещаются, поэтому поиск контекста по дескриптору выполняется без блокировок.
+    Свободные ячейки хранятся в односвязном списке, изменяемом атомарными операциями.
+    Дескриптор контекста содержит индекс ячейки и ее поколение, что позволяет обнаружить
+    использование дескриптора уже удаленного контекста.
+    Удаленный элемент освобождается только тогда, когда ни один поток не выполняет поиск
+    контекста; до этого момента элемент хранится в списке `retired`. Количество читающих потоков
+    учитывается набором счетчиков `readers`: каждый поток использует один из них, поэтому
+    поиск контекстов в разных потоках не изменяет одну и ту же строку кэша. Освобождение
+    удаленных элементов выполняется при добавлении и удалении контекстов, но не при их поиске.
+
     При инициализации библиотеки создается только один объект менеджера контекстов, который
     используется для работы с контекстами пользователей.
     Доступ пользователям библиотеки к менеджеру контекстов закрыт.                                 */
 /* ----------------------------------------------------------------------------------------------- */
  typedef struct context_manager {
-  /*! \brief массив указателей на структуры управления контекстами */
-   ak_context_node *array;
-  /*! \brief общее количество выделенной по структуры управления памяти */
+  /*! \brief массив сегментов, содержащих ячейки структуры управления */
+   ak_context_slot segments[ak_context_manager_max_segments];
+  /*! \brief количество ячеек в первом сегменте */
+   size_t base;
+  /*! \brief количество созданных сегментов */
+   size_t count;
+  /*! \brief общее количество ячеек во всех сегментах */
    size_t size;
+  /*! \brief вершина списка свободных ячеек (младшие 32 бита - индекс, увеличенный на единицу,
+      старшие - счетчик изменений, предотвращающий ABA-проблему) */
+   ak_uint64 free;
+  /*! \brief счетчики потоков, читающих в данный момент элементы структуры */
+   struct context_reader readers[ak_context_manager_reader_stripes];
+  /*! \brief список удаленных элементов, память которых еще не освобождена */
+   ak_context_node retired;
   /*! \brief генератор, используемый для выработки ключей */
    struct random key_generator;
 } *ak_context_manager;
@@ -75,6 +131,8 @@
                                            const ak_pointer , const oid_engines_t , const char * );
 /*! \brief Удаление контекста из структуры управления контекстами. */
  int ak_context_manager_delete_node( ak_context_manager , ak_handle );
+/*! \brief Получение ячейки структуры управления контекстами по индексу массива. */
+ ak_context_slot ak_context_manager_get_slot( ak_context_manager , size_t );
 /*! \brief Получение точного значения дескриптора по индексу массива. */
  ak_handle ak_context_manager_idx_to_handle( ak_context_manager , size_t );
 /*! \brief Получение точного значения индекса массива по значению декскриптора. */
@@ -0,0 +1,384 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  Copyright (c) 2019 by Axel Kenzo, axelkenzo@mail.ru                                            */
+/*                                                                                                 */
+/*  Файл ak_ctrrnd.c                                                                               */
+/*  - содержит реализацию генератора псевдо-случайных чисел, использующего алгоритм блочного       */
+/*    шифрования в режиме гаммирования (CTR-DRBG)                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+#ifdef LIBAKRYPT_HAVE_STDLIB_H
+ #include <stdlib.h>
+#else
+ #error Library cannot be compiled without stdlib.h header
+#endif
+#ifdef LIBAKRYPT_HAVE_STRING_H
+ #include <string.h>
+#else
+ #error Library cannot be compiled without string.h header
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+ #include <ak_bckey.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество 128-битных блоков гаммы, вырабатываемых за одно обращение к генератору. */
+ #define ak_random_ctr_buffer_blocks      (16)
+/*! \brief Количество блоков гаммы, вырабатываемых на одном ключе; после их выработки ключ и
+    счетчик заменяются новыми значениями, выработанными генератором. */
+ #define ak_random_ctr_rekey_blocks     (4096)
+/*! \brief Количество замен ключа, после которого генератор повторно инициализируется
+    случайными данными, полученными от операционной системы. */
+ #define ak_random_ctr_reseed_count      (256)
+/*! \brief Максимальная длина ключа и блока используемых алгоритмов шифрования (в байтах). */
+ #define ak_random_ctr_seed_size          (48)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Класс для хранения внутренних состояний генератора, использующего режим гаммирования. */
+ typedef struct random_ctr {
+  /*! \brief ключ алгоритма блочного шифрования */
+   struct bckey key;
+  /*! \brief текущее значение счетчика */
+   ak_uint8 counter[16];
+  /*! \brief массив выработанных значений */
+   ak_uint8 buffer[16*ak_random_ctr_buffer_blocks];
+  /*! \brief текущее количество доступных для выдачи октетов */
+   size_t len;
+  /*! \brief количество блоков, выработанных на текущем ключе */
+   size_t blocks;
+  /*! \brief количество замен ключа, выполненных после последней инициализации */
+   size_t rekeys;
+  /*! \brief генератор операционной системы, используемый для инициализации */
+   struct random entropy;
+ } *ak_random_ctr;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция создает генератор операционной системы, используемый для инициализации.
+
+    Используется буфферизованный генератор getrandom или, в ОС Windows, генератор криптопровайдера
+    по умолчанию; некриптографические генераторы для инициализации не используются.
+    Генератор создается один раз вместе с генератором CTR-DRBG, поэтому повторная
+    инициализация не требует открытия файлов и, как правило, обращения к операционной системе.     */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_ctr_create_entropy( ak_random entropy )
+{
+#if defined(__unix__) || defined(__APPLE__)
+  return ak_random_context_create_getrandom( entropy );
+#else
+ #ifdef _WIN32
+  return ak_random_context_create_winrtl( entropy );
+ #else
+  #error ak_random_ctr_create_entropy(): using a non defined path of compilation
+ #endif
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция увеличивает значение счетчика на единицу (счетчик хранится в little endian). */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_random_ctr_increment( ak_uint8 *counter, const size_t size )
+{
+  size_t i = 0;
+  for( i = 0; i < size; i++ ) if( ++counter[i] != 0 ) break;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция заменяет ключ и значение счетчика.
+
+    Новые значения ключа и счетчика вырабатываются генератором (зашифрованием последовательных
+    значений счетчика) и складываются по модулю два с данными `seed`, если они заданы.
+    Поскольку предыдущее значение ключа уничтожается, уже выданные генератором данные не
+    могут быть восстановлены по его текущему состоянию.
+
+    @param rc Контекст внутренних данных генератора.
+    @param seed Данные, используемые для изменения состояния генератора (может быть NULL).
+    @param size Размер данных в октетах (не более, чем \ref ak_random_ctr_seed_size).
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_ctr_update( ak_random_ctr rc, const ak_uint8 *seed, const size_t size )
+{
+  size_t i = 0;
+  int error = ak_error_ok;
+  ak_uint8 temp[ak_random_ctr_seed_size];
+  const size_t bsize = rc->key.bsize, len = 32 + bsize;
+
+  if( rc->key.key.check_icode( &rc->key.key ) != ak_true )
+    return ak_error_message( ak_error_wrong_key_icode, __func__,
+                                                   "incorrect integrity code of secret key value" );
+  for( i = 0; i < len; i += bsize ) {
+     ak_random_ctr_increment( rc->counter, bsize );
+     rc->key.encrypt( &rc->key.key, rc->counter, temp+i );
+  }
+  if( seed != NULL )
+    for( i = 0; i < ak_min( size, len ); i++ ) temp[i] ^= seed[i];
+
+  memcpy( rc->counter, temp+32, bsize );
+  error = ak_bckey_context_set_key( &rc->key, temp, 32, ak_true );
+  memset( temp, 0, sizeof( temp ));
+  if( error != ak_error_ok ) return ak_error_message( error, __func__ ,
+                                                         "incorrect assigning of new key value" );
+  memset( rc->buffer, 0, sizeof( rc->buffer ));
+  rc->len = 0;
+  rc->blocks = 0;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция повторно инициализирует генератор случайными данными,
+    полученными от операционной системы.                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_ctr_reseed( ak_random_ctr rc )
+{
+  int error = ak_error_ok;
+  ak_uint8 seed[ak_random_ctr_seed_size];
+
+  if(( error = ak_random_context_random( &rc->entropy, seed, sizeof( seed ))) != ak_error_ok )
+    return ak_error_message( error, __func__ , "incorrect generation of seed value" );
+  error = ak_random_ctr_update( rc, seed, sizeof( seed ));
+  memset( seed, 0, sizeof( seed ));
+  rc->rekeys = 0;
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param rnd Контекст генератора.
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_ctr_next( ak_random rnd )
+{
+  size_t i = 0;
+  int error = ak_error_ok;
+  ak_random_ctr rc = NULL;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                    "use a null pointer to a random generator" );
+  rc = ( ak_random_ctr )rnd->data;
+  if( rc->len != 0 ) return ak_error_message( ak_error_wrong_length, __func__,
+                                                             "unexpected use of next function" );
+ /* при исчерпании ресурса ключа заменяем ключ, а время от времени
+    повторно инициализируем генератор данными операционной системы */
+  if( rc->blocks >= ak_random_ctr_rekey_blocks ) {
+    if( ++rc->rekeys >= ak_random_ctr_reseed_count ) error = ak_random_ctr_reseed( rc );
+     else error = ak_random_ctr_update( rc, NULL, 0 );
+    if( error != ak_error_ok ) return ak_error_message( error, __func__ ,
+                                                       "incorrect update of generator state" );
+  }
+  if( ak_skey_context_verify( &rc->key.key ) != ak_true )
+    return ak_error_message( ak_error_wrong_key_icode, __func__,
+                                                   "incorrect integrity code of secret key value" );
+ /* вырабатываем сразу несколько блоков гаммы, заполняя весь массив
+    (для шифра Магма количество блоков вдвое больше, чем для Кузнечика) */
+  for( i = 0; i < sizeof( rc->buffer ); i += rc->key.bsize ) {
+     ak_random_ctr_increment( rc->counter, rc->key.bsize );
+     rc->key.encrypt( &rc->key.key, rc->counter, rc->buffer + i );
+  }
+  rc->blocks += sizeof( rc->buffer )/rc->key.bsize;
+  rc->len = sizeof( rc->buffer );
+
+ /* перемаскируем ключ */
+  ak_skey_context_modify_begin( &rc->key.key );
+  error = rc->key.key.set_mask( &rc->key.key );
+  ak_skey_context_modify_end( &rc->key.key );
+  if( error != ak_error_ok )
+    ak_error_message( error, __func__ , "wrong remasking of secret key" );
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param ptr Указатель на область внутренних данных генератора.                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_random_ctr_free( ak_pointer ptr )
+{
+  int error = ak_error_ok;
+  ak_random_ctr rc = ( ak_random_ctr )ptr;
+
+  if( ptr == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__ , "freeing a null pointer to data" );
+    return;
+  }
+  memset( rc->buffer, 0, sizeof( rc->buffer ));
+  memset( rc->counter, 0, sizeof( rc->counter ));
+  if(( error = ak_bckey_context_destroy( &rc->key )) != ak_error_ok )
+    ak_error_message( error, __func__ , "wrong destroying internal block cipher key" );
+  if(( error = ak_random_context_destroy( &rc->entropy )) != ak_error_ok )
+    ak_error_message( error, __func__ , "wrong destroying internal random generator" );
+  free( ptr );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Данные, которыми инициализируется генератор, не заменяют его текущее состояние,
+    а изменяют его, т.е. ранее полученная от операционной системы энтропия не теряется.
+
+    \param rnd Контекст генератора.
+    \param ptr Указатель на область данных, которыми инициалиируется генератор
+    \param size Размер области в байтах
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_ctr_randomize_ptr( ak_random rnd, const ak_pointer ptr, const ssize_t size )
+{
+  int error = ak_error_ok;
+  ak_random_ctr rc = NULL;
+  const ak_uint8 *seed = ptr;
+  ssize_t realsize = size;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "use a null pointer to a random generator" );
+  if( ptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                   "use a null pointer to data" );
+  if( size <= 0 ) return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                                 "use a data with wrong length" );
+  rc = ( ak_random_ctr )rnd->data;
+
+ /* длинные данные обрабатываются фрагментами */
+  while( realsize > 0 ) {
+    size_t len = ak_min( (size_t)realsize, ak_random_ctr_seed_size );
+    if(( error = ak_random_ctr_update( rc, seed, len )) != ak_error_ok )
+      return ak_error_message( error, __func__ , "incorrect update of generator state" );
+    seed += len;
+    realsize -= len;
+  }
+ return ak_random_ctr_next( rnd );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \param rnd Контекст генератора.
+    \param ptr Указатель на область памяти, в которую помещаются вырабатываемые значения
+    \param size Размер области в байтах
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_ctr_random( ak_random rnd, const ak_pointer ptr, const ssize_t size )
+{
+  int error = ak_error_ok;
+  ak_uint8 *inptr = ptr;
+  ssize_t realsize = size;
+  ak_random_ctr rc = NULL;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "use a null pointer to a random generator" );
+  if( ptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                   "use a null pointer to data" );
+  if( size <= 0 ) return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                                 "use a data with wrong length" );
+  rc = ( ak_random_ctr )rnd->data;
+  while( realsize > 0 ) {
+    size_t offset = ak_min( (size_t)realsize, rc->len ),
+           start = sizeof( rc->buffer ) - rc->len;
+   /* выдаваемые данные сразу уничтожаются */
+    memcpy( inptr, rc->buffer + start, offset );
+    memset( rc->buffer + start, 0, offset );
+    inptr += offset;
+    realsize -= offset;
+    if(( rc->len -= offset ) == 0 ) /* вычисляем следующий массив данных */
+      if(( error = ak_random_ctr_next( rnd )) != ak_error_ok ) return error;
+  }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция создает генератор, вырабатывающий последовательность псевдо-случайных данных
+    с помощью алгоритма блочного шифрования в режиме гаммирования (по аналогии с генератором
+    CTR_DRBG из NIST SP 800-90A). Параметр oid задает используемый алгоритм блочного шифрования.
+
+    Начальные значения ключа и счетчика получаются от операционной системы. Гамма
+    вырабатывается фрагментами по 16x\ref ak_random_ctr_buffer_blocks октетов; после выработки
+    \ref ak_random_ctr_rekey_blocks блоков ключ и счетчик заменяются значениями,
+    выработанными самим генератором, а после \ref ak_random_ctr_reseed_count таких замен
+    генератор повторно инициализируется данными операционной системы.
+
+    \param generator контекст инициализируемого генератора псевдо-случайных чисел.
+    \param oid идентификатор алгоритма блочного шифрования.
+    \return Функция возвращает код ошибки.                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_random_context_create_ctr_oid( ak_random generator, ak_oid oid )
+{
+  int error = ak_error_ok;
+  ak_random_ctr rc = NULL;
+  char oidname[32]; /* имя для oid генератора псевдо-случайных чисел */
+  ak_uint8 seed[ak_random_ctr_seed_size];
+
+  if( oid == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                    "using null pointer to block cipher OID" );
+ /* проверяем, что OID от алгоритма блочного шифрования */
+  if( oid->engine != block_cipher )
+    return ak_error_message( ak_error_oid_engine, __func__ , "using oid with wrong engine" );
+ /* проверяем, что OID от алгоритма, а не от параметров */
+  if( oid->mode != algorithm )
+    return ak_error_message( ak_error_oid_mode, __func__ , "using oid with wrong mode" );
+
+ /* создаем генератор */
+  if(( error = ak_random_context_create( generator )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong initialization of random generator" );
+
+  if(( rc = generator->data = malloc( sizeof( struct random_ctr ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+              "incorrect memory allocation for an internal variables of random generator" );
+
+ /* инициализируем поля и данные внутренней структуры данных */
+  if(( error = ak_random_ctr_create_entropy( &rc->entropy )) != ak_error_ok ) {
+    free( generator->data );
+    generator->data = NULL;
+    ak_random_context_destroy( generator );
+    return ak_error_message( error, __func__ ,
+                                      "incorrect creation of internal random generator context" );
+  }
+  if(( error = ak_bckey_context_create_oid( &rc->key, oid )) != ak_error_ok ) {
+    ak_random_context_destroy( &rc->entropy );
+    free( generator->data );
+    generator->data = NULL;
+    ak_random_context_destroy( generator );
+    return ak_error_message( error, __func__ , "incorrect creation of internal block cipher key" );
+  }
+  memset( rc->counter, 0, sizeof( rc->counter ));
+  memset( rc->buffer, 0, sizeof( rc->buffer ));
+  rc->len = 0;
+  rc->blocks = 0;
+  rc->rekeys = 0;
+  ak_snprintf( oidname, 30, "ctr-%s", oid->name );
+
+  generator->oid = ak_oid_context_find_by_name( oidname );
+  generator->next = ak_random_ctr_next;
+  generator->randomize_ptr = ak_random_ctr_randomize_ptr;
+  generator->random = ak_random_ctr_random;
+  generator->free = ak_random_ctr_free;
+
+ /* начальные значения ключа и счетчика получаем от операционной системы */
+  if(( error = ak_random_context_random( &rc->entropy, seed, sizeof( seed ))) == ak_error_ok ) {
+    memcpy( rc->counter, seed+32, rc->key.bsize );
+    error = ak_bckey_context_set_key( &rc->key, seed, 32, ak_true );
+  }
+  memset( seed, 0, sizeof( seed ));
+  if( error != ak_error_ok ) {
+    ak_random_context_destroy( generator );
+    return ak_error_message( error, __func__ , "incorrect initialization of generator state" );
+  }
+
+ /* вычисляем псевдо-случайные данные */
+ return ak_random_ctr_next( generator );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \param generator контекст инициализируемого генератора псевдо-случайных чисел.                 */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_random_context_create_ctr_kuznechik( ak_random generator )
+{
+  return ak_random_context_create_ctr_oid( generator, ak_oid_context_find_by_name( "kuznechik" ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \param generator контекст инициализируемого генератора псевдо-случайных чисел.                 */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_random_context_create_ctr_magma( ak_random generator )
+{
+  return ak_random_context_create_ctr_oid( generator, ak_oid_context_find_by_name( "magma" ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*!  \example test-internal-random05.c                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+/*                                                                                    ak_ctrrnd.c  */
+/* ----------------------------------------------------------------------------------------------- */
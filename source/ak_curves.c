@@ -4,11 +4,19 @@
 /*  Файл ak_curves.с                                                                               */
 /*  - содержит реализацию функций для работы с эллиптическими кривыми.                             */
 /* ----------------------------------------------------------------------------------------------- */
+#ifdef LIBAKRYPT_HAVE_STDLIB_H
+ #include <stdlib.h>
+#else
+ #error Library cannot be compiled without stdlib.h header
+#endif
 #ifdef LIBAKRYPT_HAVE_STRING_H
  #include <string.h>
 #else
  #error Library cannot be compiled without string.h header
 #endif
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
  #include <ak_parameters.h>
@@ -27,27 +35,27 @@
  /* определяем константы 4 и 27 в представлении Монтгомери */
   ak_mpzn_set_ui( d, ec->size, 4 );
   ak_mpzn_set_ui( s, ak_mpznmax_size, 27 );
-  ak_mpzn_mul_montgomery( d, d, ec->r2, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, ec->r2, ec->p, ec->n, ec->size );
+  ec->mul( d, d, ec->r2, ec->p, ec->n, ec->size );
+  ec->mul( s, s, ec->r2, ec->p, ec->n, ec->size );
 
  /* вычисляем 4a^3 (mod p) значение в представлении Монтгомери */
-  ak_mpzn_mul_montgomery( d, d, ec->a, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( d, d, ec->a, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( d, d, ec->a, ec->p, ec->n, ec->size );
+  ec->mul( d, d, ec->a, ec->p, ec->n, ec->size );
+  ec->mul( d, d, ec->a, ec->p, ec->n, ec->size );
+  ec->mul( d, d, ec->a, ec->p, ec->n, ec->size );
 
  /* вычисляем значение 4a^3 + 27b^2 (mod p) в представлении Монтгомери */
-  ak_mpzn_mul_montgomery( s, s, ec->b, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, ec->b, ec->p, ec->n, ec->size );
+  ec->mul( s, s, ec->b, ec->p, ec->n, ec->size );
+  ec->mul( s, s, ec->b, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( d, d, s, ec->p, ec->size );
 
  /* определяем константу -16 в представлении Монтгомери и вычисляем D = -16(4a^3+27b^2) (mod p) */
   ak_mpzn_set_ui( s, ec->size, 16 );
   ak_mpzn_sub( s, ec->p, s, ec->size );
-  ak_mpzn_mul_montgomery( s, s, ec->r2, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( d, d, s, ec->p, ec->n, ec->size );
+  ec->mul( s, s, ec->r2, ec->p, ec->n, ec->size );
+  ec->mul( d, d, s, ec->p, ec->n, ec->size );
 
  /* возвращаем результат (в обычном представлении) */
-  ak_mpzn_mul_montgomery( d, d, one, ec->p, ec->n, ec->size );
+  ec->mul( d, d, one, ec->p, ec->n, ec->size );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -71,6 +79,9 @@
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для проведения проверки функция вырабатывает случайное число \f$ t \pmod{q} \f$ и проверяет
     выполнимость равенства \f$ t \cdot t^{-1} \equiv 1 \pmod{q}\f$.
+    Обратный элемент вычисляется функцией ak_mpzn_modpow_montgomery(), поэтому порядок
+    подгруппы \f$ q \f$ должен удовлетворять неравенству \f$ q \geq r/8 \f$; для меньших
+    значений \f$ q \f$ проверка завершается с ошибкой.
 
     @param ec Контекст эллиптической кривой.
 
@@ -89,12 +100,14 @@
 
   ak_mpzn_set_ui( r, ec->size, 2 );
   ak_mpzn_sub( r, ec->q, r, ec->size );
+ /* при недопустимом значении q функция возведения в степень не изменяет s */
+  ak_mpzn_set_ui( s, ec->size, 0 );
   ak_mpzn_modpow_montgomery( s, t, r, ec->q, ec->nq, ec->size );
-  ak_mpzn_mul_montgomery( t, s, t, ec->q, ec->nq, ec->size );
+  ec->mulq( t, s, t, ec->q, ec->nq, ec->size );
 
-  ak_mpzn_mul_montgomery( t, t, ec->r2q, ec->q, ec->nq, ec->size );
-  ak_mpzn_mul_montgomery( t, t, ec->point.z, ec->q, ec->nq, ec->size );
-  ak_mpzn_mul_montgomery( t, t, ec->point.z, ec->q, ec->nq, ec->size );
+  ec->mulq( t, t, ec->r2q, ec->q, ec->nq, ec->size );
+  ec->mulq( t, t, ec->point.z, ec->q, ec->nq, ec->size );
+  ec->mulq( t, t, ec->point.z, ec->q, ec->nq, ec->size );
   if( ak_mpzn_cmp_ui( t, ec->size, 1 )) return ak_error_ok;
    else return ak_error_curve_order_parameters;
 }
@@ -123,6 +136,7 @@
 {
   char str[512];
   ak_mpzn512 temp;
+  ak_mpznmax wide;
   struct wpoint wp;
   int error = ak_error_ok;
 
@@ -143,6 +157,47 @@
   if( ak_mpzn_cmp( temp, ec->p, ec->size ) != 0 )
     return ak_error_message( ak_error_wrong_endian, __func__,
                                                "incorrect convertation string to mpzn integer" );
+ /* проверяем, что оптимизированные функции умножения согласованы с универсальной */
+  if(( ec->mul == NULL ) || ( ec->mulq == NULL ))
+    return ak_error_message( ak_error_undefined_function, __func__ ,
+                                                     "using undefined modular multiplication" );
+  ak_mpzn_mul_montgomery( temp, ec->a, ec->b, ec->p, ec->n, ec->size );
+  if( ec->reduction == pseudo_mersenne_reduction ) {
+    size_t i = 0;
+    ak_uint64 c = ( ak_uint64 )0 - ec->p[0];
+
+   /* модуль должен иметь вид p = 2^n - c, тогда r \equiv c и r^2 \equiv c^2 (mod p) */
+    if( c >= 0x100000000LL )
+      return ak_error_message( ak_error_curve_prime_modulo, __func__ ,
+                                                "using pseudo mersenne prime with wrong form" );
+    for( i = 1; i < ec->size; i++ )
+       if( ec->p[i] != 0xffffffffffffffffLL )
+         return ak_error_message( ak_error_curve_prime_modulo, __func__ ,
+                                                "using pseudo mersenne prime with wrong form" );
+   /* переводим результат умножения Монтгомери в обычное представление: temp <- ab (mod p) */
+    ak_mpzn_set_ui( wp.y, ec->size, c*c );
+    ak_mpzn_mul_montgomery( temp, temp, wp.y, ec->p, ec->n, ec->size );
+  }
+  ec->mul( wp.x, ec->a, ec->b, ec->p, ec->n, ec->size );
+  if( ak_mpzn_cmp( temp, wp.x, ec->size ) != 0 )
+    return ak_error_message( ak_error_not_equal_data, __func__,
+                                                "incorrect optimized multiplication modulo p" );
+  ak_mpzn_mul_montgomery( temp, ec->r2q, ec->r2q, ec->q, ec->nq, ec->size );
+  ec->mulq( wp.x, ec->r2q, ec->r2q, ec->q, ec->nq, ec->size );
+  if( ak_mpzn_cmp( temp, wp.x, ec->size ) != 0 )
+    return ak_error_message( ak_error_not_equal_data, __func__,
+                                                "incorrect optimized multiplication modulo q" );
+ /* проверяем константы алгоритма Барретта, используя равенства (p-1)^2 = 1 (mod p) и (q-1)^2 = 1 (mod q) */
+  ak_mpzn_set_ui( temp, ec->size, 1 );
+  ak_mpzn_sub( wp.x, ec->p, temp, ec->size );
+  ak_mpzn_mul( wide, wp.x, wp.x, ec->size );
+  ak_mpzn_rem_barrett( wp.y, wide, ec->p, ec->mu, ec->size );
+  ak_mpzn_sub( wp.x, ec->q, temp, ec->size );
+  ak_mpzn_mul( wide, wp.x, wp.x, ec->size );
+  ak_mpzn_rem_barrett( wp.z, wide, ec->q, ec->muq, ec->size );
+  if( !ak_mpzn_cmp_ui( wp.y, ec->size, 1 ) || !ak_mpzn_cmp_ui( wp.z, ec->size, 1 ))
+    return ak_error_message( ak_error_not_equal_data, __func__,
+                                                     "incorrect constants of barrett reduction" );
  /* проверяем, что дискриминант кривой отличен от нуля */
   if(( error = ak_wcurve_discriminant_is_ok( ec )) != ak_error_ok )
     return ak_error_message( ak_error_curve_discriminant, __func__ ,
@@ -335,28 +390,136 @@
 
  /* Проверяем принадлежность точки заданной кривой */
   ak_mpzn_set( t, ec->a, ec->size );
-  ak_mpzn_mul_montgomery( t, t, wp->x, ec->p, ec->n, ec->size );
+  ec->mul( t, t, wp->x, ec->p, ec->n, ec->size );
   ak_mpzn_set( s, ec->b, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->z, ec->p, ec->n, ec->size );
+  ec->mul( s, s, wp->z, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( t, t, s, ec->p, ec->size ); // теперь в t величина (ax+bz)
 
   ak_mpzn_set( s, wp->z, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( t, t, s, ec->p, ec->n, ec->size ); // теперь в t величина (ax+bz)z^2
+  ec->mul( s, s, s, ec->p, ec->n, ec->size );
+  ec->mul( t, t, s, ec->p, ec->n, ec->size ); // теперь в t величина (ax+bz)z^2
 
   ak_mpzn_set( s, wp->x, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->x, ec->p, ec->n, ec->size );
+  ec->mul( s, s, s, ec->p, ec->n, ec->size );
+  ec->mul( s, s, wp->x, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( t, t, s, ec->p, ec->size ); // теперь в t величина x^3 + (ax+bz)z^2
 
   ak_mpzn_set( s, wp->y, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->z, ec->p, ec->n, ec->size ); // теперь в s величина x^3 + (ax+bz)z^2
+  ec->mul( s, s, s, ec->p, ec->n, ec->size );
+  ec->mul( s, s, wp->z, ec->p, ec->n, ec->size ); // теперь в s величина x^3 + (ax+bz)z^2
 
   if( ak_mpzn_cmp( t, s, ec->size )) return ak_false;
  return ak_true;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Удвоение точки, заданной указателями на координаты; используется функциями
+    ak_wpoint_double() и ak_wpoint256_double(), которые передают в нее размер параметров кривой.
+    При константном значении `size` компилятор генерирует код, специализированный под этот размер. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_double_kernel( ak_uint64 *x, ak_uint64 *y, ak_uint64 *z,
+                                      ak_uint64 *a, ak_uint64 *p, ak_uint64 n, const size_t size,
+                                                           ak_function_mpzn_mul_montgomery *mul )
+{
+ ak_mpznmax u1, u2, u3, u4, u5, u6, u7;
+
+ if( ak_mpzn_cmp_ui( z, size, 0 ) == ak_true ) return;
+ if( ak_mpzn_cmp_ui( y, size, 0 ) == ak_true ) {
+   ak_mpzn_set_ui( x, size, 0 );
+   ak_mpzn_set_ui( y, size, 1 );
+   ak_mpzn_set_ui( z, size, 0 );
+   return;
+ }
+ // dbl-2007-bl
+ mul( u1, x, x, p, n, size );
+ mul( u2, z, z, p, n, size );
+ ak_mpzn_lshift_montgomery( u4, u1, p, size );
+ ak_mpzn_add_montgomery( u4, u4, u1, p, size );
+ mul( u3, u2, a, p, n, size );
+ ak_mpzn_add_montgomery( u3, u3, u4, p, size );  // u3 = az^2 + 3x^2
+ mul( u4, y, z, p, n, size );
+ ak_mpzn_lshift_montgomery( u4, u4, p, size );   // u4 = 2yz
+ mul( u5, y, u4, p, n, size ); // u5 = 2y^2z
+ ak_mpzn_lshift_montgomery( u6, u5, p, size ); // u6 = 2u5
+ mul( u7, u6, x, p, n, size ); // u7 = 8xy^2z
+ ak_mpzn_lshift_montgomery( u1, u7, p, size );
+ ak_mpzn_sub( u1, p, u1, size );
+ mul( u2, u3, u3, p, n, size );
+ ak_mpzn_add_montgomery( u2, u2, u1, p, size );
+ mul( x, u2, u4, p, n, size );
+ mul( u6, u6, u5, p, n, size );
+ ak_mpzn_sub( u6, p, u6, size );
+ ak_mpzn_sub( u2, p, u2, size );
+ ak_mpzn_add_montgomery( u2, u2, u7, p, size );
+ mul( y, u2, u3, p, n, size );
+ ak_mpzn_add_montgomery( y, y, u6, p, size );
+ mul( z, u4, u4, p, n, size );
+ mul( z, z, u4, p, n, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сложение точек, заданных указателями на координаты; используется функциями
+    ak_wpoint_add() и ak_wpoint256_add().                                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_add_kernel( ak_uint64 *x1, ak_uint64 *y1, ak_uint64 *z1,
+                                    ak_uint64 *x2, ak_uint64 *y2, ak_uint64 *z2,
+                                    ak_uint64 *a, ak_uint64 *p, ak_uint64 n, const size_t size,
+                                                           ak_function_mpzn_mul_montgomery *mul )
+{
+  ak_mpznmax u1, u2, u3, u4, u5, u6, u7;
+
+  if( ak_mpzn_cmp_ui( z2, size, 0 ) == ak_true ) return;
+  if( ak_mpzn_cmp_ui( z1, size, 0 ) == ak_true ) {
+    memcpy( x1, x2, size*sizeof( ak_uint64 ));
+    memcpy( y1, y2, size*sizeof( ak_uint64 ));
+    memcpy( z1, z2, size*sizeof( ak_uint64 ));
+    return;
+  }
+  // поскольку удвоение точки с помощью формул сложения дает бесконечно удаленную точку,
+  // необходимо выполнить проверку
+  mul( u1, x1, z2, p, n, size );
+  mul( u2, x2, z1, p, n, size );
+  if( ak_mpzn_cmp( u1, u2, size ) == 0 ) { // случай совпадения х-координат точки
+    mul( u1, y1, z2, p, n, size );
+    mul( u2, y2, z1, p, n, size );
+    if( ak_mpzn_cmp( u1, u2, size ) == 0 ) // случай полного совпадения точек
+      ak_wpoint_double_kernel( x1, y1, z1, a, p, n, size, mul );
+     else {
+       ak_mpzn_set_ui( x1, size, 0 );
+       ak_mpzn_set_ui( y1, size, 1 );
+       ak_mpzn_set_ui( z1, size, 0 );
+     }
+    return;
+  }
+
+  //add-1998-cmo-2
+  mul( u1, x1, z2, p, n, size );
+  mul( u2, y1, z2, p, n, size );
+  ak_mpzn_sub( u2, p, u2, size );
+  mul( u3, z1, z2, p, n, size );
+  mul( u4, y2, z1, p, n, size );
+  ak_mpzn_add_montgomery( u4, u4, u2, p, size );
+  mul( u5, u4, u4, p, n, size );
+  ak_mpzn_sub( u7, p, u1, size );
+  mul( x1, x2, z1, p, n, size );
+  ak_mpzn_add_montgomery( x1, x1, u7, p, size );
+  mul( u7, x1, x1, p, n, size );
+  mul( u6, u7, x1, p, n, size );
+  mul( u1, u7, u1, p, n, size );
+  ak_mpzn_lshift_montgomery( u7, u1, p, size );
+  ak_mpzn_add_montgomery( u7, u7, u6, p, size );
+  ak_mpzn_sub( u7, p, u7, size );
+  mul( u5, u5, u3, p, n, size );
+  ak_mpzn_add_montgomery( u5, u5, u7, p, size );
+  mul( x1, x1, u5, p, n, size );
+  mul( u2, u2, u6, p, n, size );
+  ak_mpzn_sub( u5, p, u5, size );
+  ak_mpzn_add_montgomery( u1, u1, u5, p, size );
+  mul( y1, u4, u1, p, n, size );
+  ak_mpzn_add_montgomery( y1, y1, u2, p, size );
+  mul( z1, u6, u3, p, n, size );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Точка эллиптической кривой \f$ P = (x:y:z) \f$ заменяется значением \f$ 2P  = (x_3:y_3:z_3)\f$,
     то есть складывается сама с собой (удваивается).
@@ -385,38 +548,10 @@
 /* ----------------------------------------------------------------------------------------------- */
  void ak_wpoint_double( ak_wpoint wp, ak_wcurve ec )
 {
- ak_mpznmax u1, u2, u3, u4, u5, u6, u7;
-
- if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true ) return;
- if( ak_mpzn_cmp_ui( wp->y, ec->size, 0 ) == ak_true ) {
-   ak_wpoint_set_as_unit( wp, ec );
-   return;
- }
- // dbl-2007-bl
- ak_mpzn_mul_montgomery( u1, wp->x, wp->x, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( u2, wp->z, wp->z, ec->p, ec->n, ec->size );
- ak_mpzn_lshift_montgomery( u4, u1, ec->p, ec->size );
- ak_mpzn_add_montgomery( u4, u4, u1, ec->p, ec->size );
- ak_mpzn_mul_montgomery( u3, u2, ec->a, ec->p, ec->n, ec->size );
- ak_mpzn_add_montgomery( u3, u3, u4, ec->p, ec->size );  // u3 = az^2 + 3x^2
- ak_mpzn_mul_montgomery( u4, wp->y, wp->z, ec->p, ec->n, ec->size );
- ak_mpzn_lshift_montgomery( u4, u4, ec->p, ec->size );   // u4 = 2yz
- ak_mpzn_mul_montgomery( u5, wp->y, u4, ec->p, ec->n, ec->size ); // u5 = 2y^2z
- ak_mpzn_lshift_montgomery( u6, u5, ec->p, ec->size ); // u6 = 2u5
- ak_mpzn_mul_montgomery( u7, u6, wp->x, ec->p, ec->n, ec->size ); // u7 = 8xy^2z
- ak_mpzn_lshift_montgomery( u1, u7, ec->p, ec->size );
- ak_mpzn_sub( u1, ec->p, u1, ec->size );
- ak_mpzn_mul_montgomery( u2, u3, u3, ec->p, ec->n, ec->size );
- ak_mpzn_add_montgomery( u2, u2, u1, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->x, u2, u4, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( u6, u6, u5, ec->p, ec->n, ec->size );
- ak_mpzn_sub( u6, ec->p, u6, ec->size );
- ak_mpzn_sub( u2, ec->p, u2, ec->size );
- ak_mpzn_add_montgomery( u2, u2, u7, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->y, u2, u3, ec->p, ec->n, ec->size );
- ak_mpzn_add_montgomery( wp->y, wp->y, u6, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->z, u4, u4, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( wp->z, wp->z, u4, ec->p, ec->n, ec->size );
+ /* для кривых длины 256 бит размер передается константой */
+  if( ec->size == ak_mpzn256_size )
+    ak_wpoint_double_kernel( wp->x, wp->y, wp->z, ec->a, ec->p, ec->n, ak_mpzn256_size, ec->mul );
+   else ak_wpoint_double_kernel( wp->x, wp->y, wp->z, ec->a, ec->p, ec->n, ec->size, ec->mul );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -455,52 +590,11 @@
 /* ----------------------------------------------------------------------------------------------- */
  void ak_wpoint_add( ak_wpoint wp1, ak_wpoint wp2, ak_wcurve ec )
 {
-  ak_mpznmax u1, u2, u3, u4, u5, u6, u7;
-
-  if( ak_mpzn_cmp_ui( wp2->z, ec->size, 0 ) == ak_true ) return;
-  if( ak_mpzn_cmp_ui( wp1->z, ec->size, 0 ) == ak_true ) {
-    ak_wpoint_set_wpoint( wp1, wp2, ec );
-    return;
-  }
-  // поскольку удвоение точки с помощью формул сложения дает бесконечно удаленную точку,
-  // необходимо выполнить проверку
-  ak_mpzn_mul_montgomery( u1, wp1->x, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, wp2->x, wp1->z, ec->p, ec->n, ec->size );
-  if( ak_mpzn_cmp( u1, u2, ec->size ) == 0 ) { // случай совпадения х-координат точки
-    ak_mpzn_mul_montgomery( u1, wp1->y, wp2->z, ec->p, ec->n, ec->size );
-    ak_mpzn_mul_montgomery( u2, wp2->y, wp1->z, ec->p, ec->n, ec->size );
-    if( ak_mpzn_cmp( u1, u2, ec->size ) == 0 ) // случай полного совпадения точек
-      ak_wpoint_double( wp1, ec );
-     else ak_wpoint_set_as_unit( wp1, ec );
-    return;
-  }
-
-  //add-1998-cmo-2
-  ak_mpzn_mul_montgomery( u1, wp1->x, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, wp1->y, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_sub( u2, ec->p, u2, ec->size );
-  ak_mpzn_mul_montgomery( u3, wp1->z, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u4, wp2->y, wp1->z, ec->p, ec->n, ec->size );
-  ak_mpzn_add_montgomery( u4, u4, u2, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( u5, u4, u4, ec->p, ec->n, ec->size );
-  ak_mpzn_sub( u7, ec->p, u1, ec->size );
-  ak_mpzn_mul_montgomery( wp1->x, wp2->x, wp1->z, ec->p, ec->n, ec->size );
-  ak_mpzn_add_montgomery( wp1->x, wp1->x, u7, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( u7, wp1->x, wp1->x, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u6, u7, wp1->x, ec->p, ec->n, ec->size);
-  ak_mpzn_mul_montgomery( u1, u7, u1, ec->p, ec->n, ec->size );
-  ak_mpzn_lshift_montgomery( u7, u1, ec->p, ec->size );
-  ak_mpzn_add_montgomery( u7, u7, u6, ec->p, ec->size );
-  ak_mpzn_sub( u7, ec->p, u7, ec->size );
-  ak_mpzn_mul_montgomery( u5, u5, u3, ec->p, ec->n, ec->size );
-  ak_mpzn_add_montgomery( u5, u5, u7, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->x, wp1->x, u5, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, u2, u6, ec->p, ec->n, ec->size );
-  ak_mpzn_sub( u5, ec->p, u5, ec->size );
-  ak_mpzn_add_montgomery( u1, u1, u5, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->y, u4, u1, ec->p, ec->n, ec->size );
-  ak_mpzn_add_montgomery( wp1->y, wp1->y, u2, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->z, u6, u3, ec->p, ec->n, ec->size );
+  if( ec->size == ak_mpzn256_size )
+    ak_wpoint_add_kernel( wp1->x, wp1->y, wp1->z, wp2->x, wp2->y, wp2->z,
+                                              ec->a, ec->p, ec->n, ak_mpzn256_size, ec->mul );
+   else ak_wpoint_add_kernel( wp1->x, wp1->y, wp1->z, wp2->x, wp2->y, wp2->z,
+                                                     ec->a, ec->p, ec->n, ec->size, ec->mul );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -513,22 +607,98 @@
 /* ----------------------------------------------------------------------------------------------- */
  void ak_wpoint_reduce( ak_wpoint wp, ak_wcurve ec )
 {
- ak_mpznmax u, one = ak_mpznmax_one;
+ ak_mpznmax u;
  if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true ) {
    ak_wpoint_set_as_unit( wp, ec );
    return;
  }
 
- ak_mpzn_set_ui( u, ec->size, 2 );
- ak_mpzn_sub( u, ec->p, u, ec->size );
- ak_mpzn_modpow_montgomery( u, wp->z, u, ec->p, ec->n, ec->size ); // u <- z^{p-2} (mod p)
- ak_mpzn_mul_montgomery( u, u, one, ec->p, ec->n, ec->size );
+ /* поскольку точка может зависеть от секретных данных, обращение выполняется за постоянное время;
+    для z, заданного в представлении Монтгомери, получаем u = z^{-1}r^{-1} (mod p), а после
+    умножения на r^2 - обычное значение z^{-1} (mod p) */
+ ak_mpzn_inverse_safegcd( u, wp->z, ec->p, ec->size );
+ ec->mul( u, u, ec->r2, ec->p, ec->n, ec->size );
 
- ak_mpzn_mul_montgomery( wp->x, wp->x, u, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( wp->y, wp->y, u, ec->p, ec->n, ec->size );
+ ec->mul( wp->x, wp->x, u, ec->p, ec->n, ec->size );
+ ec->mul( wp->y, wp->y, u, ec->p, ec->n, ec->size );
  ak_mpzn_set_ui( wp->z, ec->size, 1 );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция приводит к аффинной форме сразу несколько точек эллиптической кривой,
+    выполняя для этого только одно обращение вычета по модулю \f$ p \f$ (метод Монтгомери
+    одновременного обращения). Для этого вычисляются произведения
+    \f$ a_i = z_0z_1\cdots z_i \pmod{p}\f$, обращается последнее из них,
+    после чего обратные значения \f$ z_i^{-1} = a_i^{-1}a_{i-1}\f$ вычисляются в обратном порядке.
+    Таким образом, вместо \f$ n \f$ обращений выполняется одно обращение
+    и примерно \f$ 3n \f$ умножений.
+
+    Бесконечно удаленные точки (с нулевой z-координатой) в произведение не включаются
+    и приводятся к стандартному виду, как это делает функция ak_wpoint_reduce().
+
+    @param wp Массив указателей на точки кривой, которые приводятся к аффинной форме
+    @param count Количество точек
+    @param ec Эллиптическая кривая, которой принадлежат точки
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_wpoint_reduce_batch( ak_wpoint *wp, const size_t count, ak_wcurve ec )
+{
+  size_t i = 0;
+  ak_uint64 *acc = NULL;
+  int error = ak_error_ok;
+  ak_mpznmax u, t, one = ak_mpznmax_one;
+
+  if( wp == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                              "using null pointer to points array" );
+  if( ec == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using null pointer to elliptic curve" );
+  if( count == 0 ) return ak_error_ok;
+  if( count == 1 ) {
+    ak_wpoint_reduce( wp[0], ec );
+    return ak_error_ok;
+  }
+  if(( acc = malloc( count*ec->size*sizeof( ak_uint64 ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                          "incorrect memory allocation for products" );
+ /* прямой проход: acc_i = z_0z_1...z_i в используемом представлении вычетов */
+  ak_mpzn_set_ui( u, ec->size, 1 );
+  ec->mul( u, u, ec->r2, ec->p, ec->n, ec->size );
+  for( i = 0; i < count; i++ ) {
+     if( ak_mpzn_cmp_ui( wp[i]->z, ec->size, 0 ) == ak_false )
+       ec->mul( u, u, wp[i]->z, ec->p, ec->n, ec->size );
+     ak_mpzn_set( acc + i*ec->size, u, ec->size );
+  }
+
+ /* обращаем произведение и возвращаем результат в используемое представление */
+  if(( error = ak_mpzn_inverse_safegcd( u, u, ec->p, ec->size )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "wrong inversion of points coordinates product" );
+    goto labexit;
+  }
+  ec->mul( u, u, ec->r2, ec->p, ec->n, ec->size );
+  ec->mul( u, u, ec->r2, ec->p, ec->n, ec->size );
+
+ /* обратный проход: вычисляем z_i^{-1} и приводим точки */
+  i = count;
+  while( i-- > 0 ) {
+     if( ak_mpzn_cmp_ui( wp[i]->z, ec->size, 0 ) == ak_true ) {
+       ak_wpoint_set_as_unit( wp[i], ec );
+       continue;
+     }
+     if( i > 0 ) ec->mul( t, u, acc + ( i-1 )*ec->size, ec->p, ec->n, ec->size );
+       else ak_mpzn_set( t, u, ec->size );
+     ec->mul( u, u, wp[i]->z, ec->p, ec->n, ec->size );
+     ec->mul( t, t, one, ec->p, ec->n, ec->size );
+
+     ec->mul( wp[i]->x, wp[i]->x, t, ec->p, ec->n, ec->size );
+     ec->mul( wp[i]->y, wp[i]->y, t, ec->p, ec->n, ec->size );
+     ak_mpzn_set_ui( wp[i]->z, ec->size, 1 );
+  }
+
+  labexit: free( acc );
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для заданной точки \f$ P = (x:y:z) \f$ и заданного целого числа (вычета) \f$ k \f$
     функция вычисляет кратную точку \f$ Q \f$, удовлетворяющую
@@ -547,7 +717,9 @@
     @param size Размер степени \f$ k \f$ в машинных словах - значение, как правило,
     задаваемое константой \ref ak_mpzn256_size или \ref ak_mpzn512_size. В общем случае
     может приниимать любое неотрицательное значение.
-    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+    @param ec Эллиптическая кривая, на которой происходят вычисления
+
+    Для кривых длины 256 бит вычисления выполняются функцией ak_wpoint256_pow().                   */
 /* ----------------------------------------------------------------------------------------------- */
  void ak_wpoint_pow( ak_wpoint wq, ak_wpoint wp, ak_uint64 *k, size_t size, ak_wcurve ec )
 {
@@ -555,6 +727,16 @@
   long long int i, j;
   struct wpoint Q, R; /* две точки из лесенки Монтгомери */
 
+ /* для кривых длины 256 бит вычисления выполняются с точками вдвое меньшего размера */
+  if( ec->size == ak_mpzn256_size ) {
+    struct wpoint256 wt;
+
+    ak_wpoint256_set_wpoint( &wt, wp, ec );
+    ak_wpoint256_pow( &wt, &wt, k, size, ec );
+    ak_wpoint_set_wpoint256( wq, &wt, ec );
+    return;
+  }
+
  /* начальные значения для переменных */
   ak_wpoint_set_as_unit( &Q, ec );
   ak_wpoint_set_wpoint( &R, wp, ec );
@@ -594,6 +776,426 @@
   return ak_mpzn_cmp_ui( ep.z, ec->size, 0 );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                  вычисление кратных точек для образующей точки эллиптической кривой             */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество зубцов гребенки (количество бит степени, обрабатываемых за один шаг). */
+ #define ak_wpoint_comb_width     (4)
+/*! \brief Максимальное количество кривых, для которых хранятся таблицы гребенки. */
+ #define ak_wpoint_comb_tables   (16)
+
+/*! \brief Таблица точек, используемая методом гребенки для образующей точки кривой.
+
+    Точки хранятся в аффинной форме: для каждой точки последовательно размещаются
+    `size` слов x-координаты и `size` слов y-координаты, где `size` размер параметров кривой.
+    Таким образом, для кривых длины 256 бит таблица занимает 1 килобайт. */
+ typedef struct wpoint_comb {
+ /*! \brief эллиптическая кривая, для которой вычислена таблица */
+  ak_wcurve wc;
+ /*! \brief расстояние между зубцами гребенки (в битах) */
+  size_t d;
+ /*! \brief аффинные координаты точек \f$ \sum_{i} j_i[2^{id}]P \f$, где \f$ j = \sum_i j_i2^i \f$
+     (точка с номером ноль, то есть бесконечно удаленная точка, не хранится) */
+  ak_uint64 points[( 1 << ak_wpoint_comb_width )*2*ak_mpzn512_size];
+} *ak_wpoint_comb;
+
+/*! \brief Вычисленные таблицы гребенки. */
+ static struct wpoint_comb wpoint_comb_tables[ak_wpoint_comb_tables];
+/*! \brief Количество вычисленных таблиц. */
+ static size_t wpoint_comb_tables_count = 0;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+/*! \brief Блокировка, используемая при поиске и вычислении таблиц. */
+ static pthread_mutex_t wpoint_comb_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Поиск (при необходимости, вычисление) таблицы гребенки для заданной кривой.
+    \return Указатель на таблицу или NULL, если таблица не может быть вычислена.                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_wpoint_comb ak_wpoint_comb_find( ak_wcurve wc )
+{
+  size_t i = 0, j = 0;
+  ak_wpoint_comb comb = NULL;
+  ak_wpoint pts[1 << ak_wpoint_comb_width];
+  struct wpoint g[ak_wpoint_comb_width], sums[1 << ak_wpoint_comb_width];
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &wpoint_comb_lock );
+#endif
+  for( i = 0; i < wpoint_comb_tables_count; i++ )
+     if( wpoint_comb_tables[i].wc == wc ) { comb = wpoint_comb_tables+i; goto labexit; }
+  if( wpoint_comb_tables_count == ak_wpoint_comb_tables ) goto labexit;
+
+ /* вычисляем точки g_i = [2^{id}]P */
+  comb = wpoint_comb_tables + wpoint_comb_tables_count;
+  comb->d = ( 64*wc->size + ak_wpoint_comb_width - 1 )/ak_wpoint_comb_width;
+  ak_wpoint_set( g, wc );
+  for( i = 1; i < ak_wpoint_comb_width; i++ ) {
+     ak_wpoint_set_wpoint( g+i, g+i-1, wc );
+     for( j = 0; j < comb->d; j++ ) ak_wpoint_double( g+i, wc );
+  }
+
+ /* вычисляем все суммы точек g_i и приводим их к аффинной форме */
+  for( j = 0; j < ( 1 << ak_wpoint_comb_width ); j++ ) {
+     ak_wpoint_set_as_unit( sums+j, wc );
+     for( i = 0; i < ak_wpoint_comb_width; i++ )
+        if(( j >> i )&1 ) ak_wpoint_add( sums+j, g+i, wc );
+     pts[j] = sums+j;
+  }
+  if( ak_wpoint_reduce_batch( pts, 1 << ak_wpoint_comb_width, wc ) != ak_error_ok ) {
+    comb = NULL;
+    goto labexit;
+  }
+
+ /* после приведения координаты x и y содержат значения аффинных координат в обычной форме,
+    переводим их в представление, используемое для вычислений на кривой */
+  for( j = 1; j < ( 1 << ak_wpoint_comb_width ); j++ ) {
+     ak_uint64 *x = comb->points + 2*j*wc->size, *y = x + wc->size;
+     wc->mul( x, sums[j].x, wc->r2, wc->p, wc->n, wc->size );
+     wc->mul( y, sums[j].y, wc->r2, wc->p, wc->n, wc->size );
+  }
+  comb->wc = wc;
+  wpoint_comb_tables_count++;
+
+ labexit:
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_unlock( &wpoint_comb_lock );
+#endif
+ return comb;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычитание вычетов по модулю \f$ p \f$ с помощью сложения с противоположным вычетом. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_comb_sub( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                ak_uint64 *p, const size_t size )
+{
+  ak_mpznmax t;
+  ak_mpzn_sub( t, p, y, size );
+  ak_mpzn_add_montgomery( z, x, t, p, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Полное сложение точек \f$ P = (x_1:y_1:z_1) \f$ и \f$ Q = (x_2:y_2:z_2) \f$ в проективных
+    координатах (алгоритм 1 из работы J.Renes, C.Costello, L.Batina,
+    <a href="https://eprint.iacr.org/2015/1060">Complete addition formulas for prime
+    order elliptic curves</a>, 2016).
+
+    Формулы справедливы для любых точек подгруппы нечетного порядка, в том числе
+    для совпадающих и бесконечно удаленных точек, поэтому последовательность операций
+    не зависит от значений точек. Результат помещается в \f$ P \f$; указатели на координаты
+    точек \f$ P \f$ и \f$ Q \f$ могут совпадать (в этом случае выполняется удвоение точки).
+    Величина `b3` есть утроенный коэффициент \f$ b \f$ кривой.                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_comb_add_kernel( ak_uint64 *x1, ak_uint64 *y1, ak_uint64 *z1,
+                     ak_uint64 *x2, ak_uint64 *y2, ak_uint64 *z2, ak_uint64 *a, ak_uint64 *b3,
+                  ak_uint64 *p, ak_uint64 n, const size_t size, ak_function_mpzn_mul_montgomery *mul )
+{
+  ak_mpznmax t0, t1, t2, t3, t4, t5, x3, y3, z3;
+
+  mul( t0, x1, x2, p, n, size );
+  mul( t1, y1, y2, p, n, size );
+  mul( t2, z1, z2, p, n, size );
+  ak_mpzn_add_montgomery( t3, x1, y1, p, size );
+  ak_mpzn_add_montgomery( t4, x2, y2, p, size );
+  mul( t3, t3, t4, p, n, size );
+  ak_mpzn_add_montgomery( t4, t0, t1, p, size );
+  ak_wpoint_comb_sub( t3, t3, t4, p, size );        /* t3 = x1y2 + x2y1 */
+  ak_mpzn_add_montgomery( t4, x1, z1, p, size );
+  ak_mpzn_add_montgomery( t5, x2, z2, p, size );
+  mul( t4, t4, t5, p, n, size );
+  ak_mpzn_add_montgomery( t5, t0, t2, p, size );
+  ak_wpoint_comb_sub( t4, t4, t5, p, size );        /* t4 = x1z2 + x2z1 */
+  ak_mpzn_add_montgomery( t5, y1, z1, p, size );
+  ak_mpzn_add_montgomery( x3, y2, z2, p, size );
+  mul( t5, t5, x3, p, n, size );
+  ak_mpzn_add_montgomery( x3, t1, t2, p, size );
+  ak_wpoint_comb_sub( t5, t5, x3, p, size );        /* t5 = y1z2 + y2z1 */
+  mul( z3, a, t4, p, n, size );
+  mul( x3, b3, t2, p, n, size );
+  ak_mpzn_add_montgomery( z3, x3, z3, p, size );
+  ak_wpoint_comb_sub( x3, t1, z3, p, size );
+  ak_mpzn_add_montgomery( z3, t1, z3, p, size );
+  mul( y3, x3, z3, p, n, size );
+  ak_mpzn_add_montgomery( t1, t0, t0, p, size );
+  ak_mpzn_add_montgomery( t1, t1, t0, p, size );
+  mul( t2, a, t2, p, n, size );
+  mul( t4, b3, t4, p, n, size );
+  ak_mpzn_add_montgomery( t1, t1, t2, p, size );
+  ak_wpoint_comb_sub( t2, t0, t2, p, size );
+  mul( t2, a, t2, p, n, size );
+  ak_mpzn_add_montgomery( t4, t4, t2, p, size );
+  mul( t0, t1, t4, p, n, size );
+  ak_mpzn_add_montgomery( y3, y3, t0, p, size );
+  mul( t0, t5, t4, p, n, size );
+  mul( x3, t3, x3, p, n, size );
+  ak_wpoint_comb_sub( x3, x3, t0, p, size );
+  mul( t0, t3, t1, p, n, size );
+  mul( z3, t5, z3, p, n, size );
+  ak_mpzn_add_montgomery( z3, z3, t0, p, size );
+
+  memcpy( x1, x3, size*sizeof( ak_uint64 ));
+  memcpy( y1, y3, size*sizeof( ak_uint64 ));
+  memcpy( z1, z3, size*sizeof( ak_uint64 ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Полное сложение точки \f$ P = (x_1:y_1:z_1) \f$ и точки \f$ Q = (x_2, y_2) \f$,
+    заданной в аффинной форме (алгоритм 2 из работы J.Renes, C.Costello, L.Batina).
+
+    Формулы справедливы для любой точки \f$ P \f$ подгруппы нечетного порядка, в том числе
+    бесконечно удаленной или совпадающей с \f$ Q \f$; точка \f$ Q \f$ не может быть
+    бесконечно удаленной. Результат помещается в \f$ P \f$.                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_comb_add_affine_kernel( ak_uint64 *x1, ak_uint64 *y1, ak_uint64 *z1,
+                                   ak_uint64 *x2, ak_uint64 *y2, ak_uint64 *a, ak_uint64 *b3,
+                  ak_uint64 *p, ak_uint64 n, const size_t size, ak_function_mpzn_mul_montgomery *mul )
+{
+  ak_mpznmax t0, t1, t2, t3, t4, t5, x3, y3, z3;
+
+  mul( t0, x1, x2, p, n, size );
+  mul( t1, y1, y2, p, n, size );
+  ak_mpzn_add_montgomery( t3, x2, y2, p, size );
+  ak_mpzn_add_montgomery( t4, x1, y1, p, size );
+  mul( t3, t3, t4, p, n, size );
+  ak_mpzn_add_montgomery( t4, t0, t1, p, size );
+  ak_wpoint_comb_sub( t3, t3, t4, p, size );        /* t3 = x1y2 + x2y1 */
+  mul( t4, x2, z1, p, n, size );
+  ak_mpzn_add_montgomery( t4, t4, x1, p, size );    /* t4 = x1 + x2z1 */
+  mul( t5, y2, z1, p, n, size );
+  ak_mpzn_add_montgomery( t5, t5, y1, p, size );    /* t5 = y1 + y2z1 */
+  mul( z3, a, t4, p, n, size );
+  mul( x3, b3, z1, p, n, size );
+  ak_mpzn_add_montgomery( z3, x3, z3, p, size );
+  ak_wpoint_comb_sub( x3, t1, z3, p, size );
+  ak_mpzn_add_montgomery( z3, t1, z3, p, size );
+  mul( y3, x3, z3, p, n, size );
+  ak_mpzn_add_montgomery( t1, t0, t0, p, size );
+  ak_mpzn_add_montgomery( t1, t1, t0, p, size );
+  mul( t2, a, z1, p, n, size );
+  mul( t4, b3, t4, p, n, size );
+  ak_mpzn_add_montgomery( t1, t1, t2, p, size );
+  ak_wpoint_comb_sub( t2, t0, t2, p, size );
+  mul( t2, a, t2, p, n, size );
+  ak_mpzn_add_montgomery( t4, t4, t2, p, size );
+  mul( t0, t1, t4, p, n, size );
+  ak_mpzn_add_montgomery( y3, y3, t0, p, size );
+  mul( t0, t5, t4, p, n, size );
+  mul( x3, t3, x3, p, n, size );
+  ak_wpoint_comb_sub( x3, x3, t0, p, size );
+  mul( t0, t3, t1, p, n, size );
+  mul( z3, t5, z3, p, n, size );
+  ak_mpzn_add_montgomery( z3, z3, t0, p, size );
+
+  memcpy( x1, x3, size*sizeof( ak_uint64 ));
+  memcpy( y1, y3, size*sizeof( ak_uint64 ));
+  memcpy( z1, z3, size*sizeof( ak_uint64 ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление кратной точки методом гребенки; размер параметров кривой `size`
+    передается отдельно, чтобы для кривых длины 256 бит он был константой.                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_comb_pow_kernel( ak_wpoint wq, ak_uint64 *k, size_t ksize,
+                                              ak_wpoint_comb comb, ak_wcurve ec, const size_t size )
+{
+  size_t i = 0, j = 0, digit = 0;
+  long long int t = 0;
+  ak_uint64 mask = 0;
+  ak_mpznmax b3, selx, sely;
+  struct wpoint acc, sum;
+
+ /* утроенный коэффициент b, используемый формулами сложения */
+  ak_mpzn_add_montgomery( b3, ec->b, ec->b, ec->p, size );
+  ak_mpzn_add_montgomery( b3, b3, ec->b, ec->p, size );
+
+  ak_wpoint_set_as_unit( &acc, ec );
+  for( t = ( long long int )comb->d - 1; t >= 0; t-- ) {
+    /* вычисляем значение зубцов гребенки */
+     digit = 0;
+     for( i = 0; i < ak_wpoint_comb_width; i++ ) {
+        size_t bit = ( size_t )t + i*comb->d;
+        if( bit < 64*ksize ) digit |= (( k[bit >> 6] >> ( bit&0x3F ))&1 ) << i;
+     }
+
+    /* выбираем точку из таблицы, просматривая всю таблицу;
+       для нулевого значения выбирается последняя точка */
+     memset( selx, 0, sizeof( ak_mpznmax ));
+     memset( sely, 0, sizeof( ak_mpznmax ));
+     for( j = 1; j < ( 1 << ak_wpoint_comb_width ); j++ ) {
+        ak_uint64 *x = comb->points + 2*j*size, *y = x + size;
+        mask = ( ak_uint64 )0 - ( ak_uint64 )(( j == digit ) |
+                                       (( digit == 0 ) & ( j == ( 1 << ak_wpoint_comb_width )-1 )));
+        for( i = 0; i < size; i++ ) {
+           selx[i] |= x[i]&mask;
+           sely[i] |= y[i]&mask;
+        }
+     }
+
+    /* удвоение и сложение выполняются по полным формулам */
+     ak_wpoint_comb_add_kernel( acc.x, acc.y, acc.z, acc.x, acc.y, acc.z,
+                                                      ec->a, b3, ec->p, ec->n, size, ec->mul );
+     memcpy( &sum, &acc, sizeof( struct wpoint ));
+     ak_wpoint_comb_add_affine_kernel( sum.x, sum.y, sum.z, selx, sely,
+                                                      ec->a, b3, ec->p, ec->n, size, ec->mul );
+
+    /* сохраняем сумму только для ненулевого значения зубцов */
+     mask = ( ak_uint64 )0 - ( ak_uint64 )( digit != 0 );
+     for( i = 0; i < size; i++ ) {
+        acc.x[i] ^= ( acc.x[i]^sum.x[i] )&mask;
+        acc.y[i] ^= ( acc.y[i]^sum.y[i] )&mask;
+        acc.z[i] ^= ( acc.z[i]^sum.z[i] )&mask;
+     }
+  }
+  ak_wpoint_set_wpoint( wq, &acc, ec );
+  memset( selx, 0, sizeof( ak_mpznmax ));
+  memset( sely, 0, sizeof( ak_mpznmax ));
+  memset( &sum, 0, sizeof( struct wpoint ));
+  memset( &acc, 0, sizeof( struct wpoint ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет кратную точку \f$ Q = [k]P \f$, где \f$ P \f$ образующая точка
+    эллиптической кривой, используя метод гребенки (Lim, Lee, 1994). Для каждой кривой
+    при первом обращении вычисляется и сохраняется таблица из 15 точек в аффинной форме;
+    после этого вычисление выполняется за \f$ d = n/4 \f$ удвоений и \f$ d \f$ сложений,
+    где \f$ n \f$ длина степени \f$ k \f$ в битах, что примерно вчетверо быстрее
+    лесенки Монтгомери.
+
+    Выбор точки из таблицы выполняется с помощью масок после просмотра всей таблицы.
+    Удвоение и сложение выполняются по полным формулам Renes, Costello, Batina,
+    не содержащим ветвлений и одинаковым для любых точек, в том числе бесконечно удаленной;
+    сложение выполняется на каждом шаге, в том числе для нулевых значений зубцов гребенки
+    (результат такого сложения отбрасывается). Таким образом, последовательность операций
+    над точками и обращений к таблице не зависит от значения \f$ k \f$.
+
+    Если степень \f$ k \f$ длиннее параметров кривой или таблица не может быть вычислена,
+    используется функция ak_wpoint_pow().
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат (не приводится к аффинной форме).
+    @param k Степень кратности.
+    @param size Размер степени \f$ k \f$ в машинных словах.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow_base( ak_wpoint wq, ak_uint64 *k, size_t size, ak_wcurve ec )
+{
+  ak_wpoint_comb comb = NULL;
+
+  if(( size > ec->size ) || (( comb = ak_wpoint_comb_find( ec )) == NULL )) {
+    ak_wpoint_pow( wq, &ec->point, k, size, ec );
+    return;
+  }
+ /* для кривых длины 256 бит размер передается константой */
+  if( ec->size == ak_mpzn256_size ) ak_wpoint_comb_pow_kernel( wq, k, size, comb, ec, ak_mpzn256_size );
+   else ak_wpoint_comb_pow_kernel( wq, k, size, comb, ec, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                       операции с точками эллиптических кривых длины 256 бит                     */
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param wp точка длины 256 бит, которой присваивается значение.
+    @param wq точка эллиптической кривой, значение которой присваивается.
+    @param ec эллиптическая кривая длины 256 бит, которой принадлежит точка `wq`.
+    @return Функция возвращает \ref ak_error_ok. В случае ошибки возвращается ее код.            */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_wpoint256_set_wpoint( ak_wpoint256 wp, ak_wpoint wq, ak_wcurve ec )
+{
+  const size_t len = ak_mpzn256_size*sizeof( ak_uint64 );
+
+  if(( wp == NULL ) || ( wq == NULL )) return ak_error_message( ak_error_null_pointer,
+                                          __func__ , "using null pointer to elliptic curve point" );
+  if( ec == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                         "using null pointer to elliptic curve" );
+  if( ec->size != ak_mpzn256_size ) return ak_error_message( ak_error_curve_not_supported,
+                                            __func__ , "using elliptic curve with wrong length" );
+  memcpy( wp->x, wq->x, len );
+  memcpy( wp->y, wq->y, len );
+  memcpy( wp->z, wq->z, len );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param wp точка эллиптической кривой, которой присваивается значение.
+    @param wq точка длины 256 бит, значение которой присваивается.
+    @param ec эллиптическая кривая длины 256 бит, которой принадлежит точка `wp`.
+    @return Функция возвращает \ref ak_error_ok. В случае ошибки возвращается ее код.            */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_wpoint_set_wpoint256( ak_wpoint wp, ak_wpoint256 wq, ak_wcurve ec )
+{
+  const size_t len = ak_mpzn256_size*sizeof( ak_uint64 );
+
+  if(( wp == NULL ) || ( wq == NULL )) return ak_error_message( ak_error_null_pointer,
+                                          __func__ , "using null pointer to elliptic curve point" );
+  if( ec == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                         "using null pointer to elliptic curve" );
+  if( ec->size != ak_mpzn256_size ) return ak_error_message( ak_error_curve_not_supported,
+                                            __func__ , "using elliptic curve with wrong length" );
+  memcpy( wp->x, wq->x, len );
+  memcpy( wp->y, wq->y, len );
+  memcpy( wp->z, wq->z, len );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция аналогична функции ak_wpoint_double().
+
+    @param wp удваиваемая точка \f$ P \f$ эллиптической кривой.
+    @param ec эллиптическая кривая, которой принадлежит точка \f$P\f$.                             */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint256_double( ak_wpoint256 wp, ak_wcurve ec )
+{
+  ak_wpoint_double_kernel( wp->x, wp->y, wp->z, ec->a, ec->p, ec->n, ak_mpzn256_size, ec->mul );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция аналогична функции ak_wpoint_add().
+
+    @param wp1 Точка \f$ P \f$, в которую помещается результат операции сложения; первое слагаемое
+    @param wp2 Точка \f$ Q \f$, второе слагаемое
+    @param ec Эллиптическая кривая, которой принадллежат складываемые точки                        */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint256_add( ak_wpoint256 wp1, ak_wpoint256 wp2, ak_wcurve ec )
+{
+  ak_wpoint_add_kernel( wp1->x, wp1->y, wp1->z, wp2->x, wp2->y, wp2->z,
+                                              ec->a, ec->p, ec->n, ak_mpzn256_size, ec->mul );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция аналогична функции ak_wpoint_pow() и использует метод `лесенки Монтгомери`.
+    Исходная точка \f$ P \f$ и результирующая точка \f$ Q \f$ могут совпадать.
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат.
+    @param wp Точка \f$ P \f$, которая возводится в степень.
+    @param k Степень кратности.
+    @param size Размер степени \f$ k \f$ в машинных словах.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint256_pow( ak_wpoint256 wq, ak_wpoint256 wp, ak_uint64 *k, size_t size,
+                                                                                   ak_wcurve ec )
+{
+  ak_uint64 uk = 0;
+  long long int i, j;
+  struct wpoint256 Q, R; /* две точки из лесенки Монтгомери */
+
+ /* начальные значения для переменных */
+  ak_mpzn_set_ui( Q.x, ak_mpzn256_size, 0 );
+  ak_mpzn_set_ui( Q.y, ak_mpzn256_size, 1 );
+  ak_mpzn_set_ui( Q.z, ak_mpzn256_size, 0 );
+  memcpy( &R, wp, sizeof( struct wpoint256 ));
+
+ /* полный цикл по всем(!) битам числа k */
+  for( i = size-1; i >= 0; i-- ) {
+     uk = k[i];
+     for( j = 0; j < 64; j++ ) {
+       if( uk&0x8000000000000000LL ) { ak_wpoint256_add( &Q, &R, ec ); ak_wpoint256_double( &R, ec ); }
+        else { ak_wpoint256_add( &R, &Q, ec ); ak_wpoint256_double( &Q, ec ); }
+       uk <<= 1;
+     }
+  }
+ /* копируем полученный результат */
+  memcpy( wq, &Q, sizeof( struct wpoint256 ));
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                                                                                    ak_curves.c  */
 /* ----------------------------------------------------------------------------------------------- */
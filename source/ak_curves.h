@@ -55,8 +55,22 @@
  void ak_wpoint_add( ak_wpoint , ak_wpoint , ak_wcurve );
 /*! \brief Приведение проективной точки к аффинному виду. */
  void ak_wpoint_reduce( ak_wpoint , ak_wcurve );
+/*! \brief Одновременное приведение нескольких проективных точек к аффинному виду. */
+ int ak_wpoint_reduce_batch( ak_wpoint * , const size_t , ak_wcurve );
 /*! \brief Вычисление кратной точки эллиптической кривой. */
  void ak_wpoint_pow( ak_wpoint , ak_wpoint , ak_uint64 *, size_t , ak_wcurve );
+/*! \brief Вычисление кратной точки для образующей точки эллиптической кривой. */
+ void ak_wpoint_pow_base( ak_wpoint , ak_uint64 *, size_t , ak_wcurve );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Способ реализации арифметики в конечном поле, над которым определена эллиптическая кривая. */
+ typedef enum {
+  /*! \brief Элементы поля хранятся в представлении Монтгомери. */
+   montgomery_reduction,
+  /*! \brief Элементы поля хранятся в обычном представлении, модуль имеет вид \f$ p = 2^n - c\f$,
+      где \f$ c < 2^{32} \f$, и редукция выполняется с помощью сдвигов и умножения на \f$ c \f$. */
+   pseudo_mersenne_reduction
+} wcurve_reduction_t;
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Класс, реализующий эллиптическую кривую, заданную в короткой форме Вейерштрасса
@@ -72,7 +86,13 @@
     или \f$ r=2^{512}\f$, тогда \f$ n \equiv n_0 \pmod{2^{64}}\f$,
     где \f$ n_0 \equiv -p^{-1} \pmod{r}\f$.
 
-    Величина \f$ r_2 \f$ удовлетворяет сравнению \f$ r_2 \equiv r^2 \pmod{p}\f$.                   */
+    Величина \f$ r_2 \f$ удовлетворяет сравнению \f$ r_2 \equiv r^2 \pmod{p}\f$.
+
+    Для кривых, модуль которых имеет вид \f$ p = 2^n - c \f$ (поле reduction принимает
+    значение \ref pseudo_mersenne_reduction), вычисления по модулю \f$ p \f$ производятся
+    в обычном представлении. В этом случае коэффициенты \f$ a, b\f$ также хранятся в обычном
+    представлении, а величина \f$ r_2 \f$ равна единице. Вычисления по модулю \f$ q \f$
+    всегда производятся в представлении Монтгомери.                                                */
 /* ----------------------------------------------------------------------------------------------- */
  struct wcurve
 {
@@ -101,7 +121,53 @@
  /*! \brief Строка, содержащая символьную запись модуля \f$ p \f$.
      \details Используется для проверки корректного хранения парметров кривой в памяти. */
   const char *pchar;
+ /*! \brief Функция умножения вычетов по модулю \f$ p \f$, оптимизированная для
+     заданного размера и вида параметров кривой. */
+  ak_function_mpzn_mul_montgomery *mul;
+ /*! \brief Функция умножения вычетов по модулю \f$ q \f$ в представлении Монтгомери. */
+  ak_function_mpzn_mul_montgomery *mulq;
+ /*! \brief Способ реализации арифметики по модулю \f$ p \f$. */
+  wcurve_reduction_t reduction;
+ /*! \brief Константа \f$ \mu = \lfloor 2^{128\cdot size} / p \rfloor \f$, используемая
+     в алгоритме приведения Барретта по модулю \f$ p \f$. */
+  ak_uint64 mu[ak_mpzn512_size+1];
+ /*! \brief Константа \f$ \mu_q = \lfloor 2^{128\cdot size} / q \rfloor \f$, используемая
+     в алгоритме приведения Барретта по модулю \f$ q \f$. */
+  ak_uint64 muq[ak_mpzn512_size+1];
+};
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Точка эллиптической кривой, определенной над полем, характеристика которого не
+    превосходит \f$ 2^{256} \f$.
+
+    Структура содержит те же данные, что и структура \ref wpoint, однако память под
+    координаты точки выделяется только в объеме \ref ak_mpzn256_size машинных слов.
+    Это позволяет вдвое сократить объем памяти, занимаемый точками и таблицами точек
+    для кривых длины 256 бит.                                                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ struct wpoint256
+{
+/*! \brief x-координата точки эллиптической кривой */
+ ak_uint64 x[ak_mpzn256_size];
+/*! \brief y-координата точки эллиптической кривой */
+ ak_uint64 y[ak_mpzn256_size];
+/*! \brief z-координата точки эллиптической кривой */
+ ak_uint64 z[ak_mpzn256_size];
 };
+/*! \brief Контекст точки эллиптической кривой длины 256 бит */
+ typedef struct wpoint256 *ak_wpoint256;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Присвоение точке длины 256 бит значения точки эллиптической кривой. */
+ int ak_wpoint256_set_wpoint( ak_wpoint256 , ak_wpoint , ak_wcurve );
+/*! \brief Присвоение точке эллиптической кривой значения точки длины 256 бит. */
+ int ak_wpoint_set_wpoint256( ak_wpoint , ak_wpoint256 , ak_wcurve );
+/*! \brief Удвоение точки эллиптической кривой длины 256 бит. */
+ void ak_wpoint256_double( ak_wpoint256 , ak_wcurve );
+/*! \brief Прибавление к одной точке эллиптической кривой длины 256 бит значения другой точки. */
+ void ak_wpoint256_add( ak_wpoint256 , ak_wpoint256 , ak_wcurve );
+/*! \brief Вычисление кратной точки эллиптической кривой длины 256 бит. */
+ void ak_wpoint256_pow( ak_wpoint256 , ak_wpoint256 , ak_uint64 *, size_t , ak_wcurve );
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Вычисление дискриминанта эллиптической кривой, заданной в короткой форме Вейерштрасса. */
@@ -442,7 +442,7 @@ int ak_fiot_context_connect_udp_socket(ak_fiot fctx, char *serverIP, unsigned sh
 #ifdef _WIN32
    if(( error = ak_random_context_create_winrtl( &fctx->crypto_rnd )) != ak_error_ok ) {
 #else
-   if(( error = ak_random_context_create_urandom( &fctx->crypto_rnd )) != ak_error_ok ) {
+   if(( error = ak_random_context_create_getrandom( &fctx->crypto_rnd )) != ak_error_ok ) {
 #endif
      ak_error_message( error, __func__, "incorrect creation of crypto random generator");
      ak_fiot_context_destroy( fctx );
@@ -13,6 +13,7 @@
 
 /* ----------------------------------------------------------------------------------------------- */
  #include <ak_fiot.h>
+ #include <ak_sign.h>
 
 /* ----------------------------------------------------------------------------------------------- */
  #define requestIdentifierExtensionFlag   ( 0x02uLL )
@@ -72,7 +73,7 @@
                                            fctx->secret, sizeof( fctx->secret ))) != ak_error_ok )
      return ak_error_message( error, __func__, "incorrect generation of random data" );
 
-   ak_wpoint_pow( &wp, &fctx->curve->point, fctx->secret, fctx->curve->size, fctx->curve );
+   ak_wpoint_pow_base( &wp, fctx->secret, fctx->curve->size, fctx->curve );
    ak_wpoint_reduce( &wp, fctx->curve );
 
   /* копируем координаты точки, жестко записывая их в little endian представлении */
@@ -301,7 +302,7 @@
 
   /* так как в контексте уже содержится точка, полученная от клиента,
      то используем временную переменную wp */
-   ak_wpoint_pow( &wp, &fctx->curve->point, fctx->secret, fctx->curve->size, fctx->curve );
+   ak_wpoint_pow_base( &wp, fctx->secret, fctx->curve->size, fctx->curve );
    ak_wpoint_reduce( &wp, fctx->curve );
 
   /* копируем координаты точки, жестко записывая их в little endian представлении */
@@ -351,19 +352,14 @@
   ak_uint8 out[64];
   struct hmac hmac_ctx;
   int error = ak_error_ok;
-  ak_mpzn512 cofactor = ak_mpzn512_one;
 
  /*! \note удалить позже */
   char str[512];
 
  /* в начале формируем общую точку Q на эллиптической кривой */
-  ak_wpoint_pow( &fctx->point, &fctx->point, fctx->secret, fctx->curve->size, fctx->curve );
-  if( fctx->curve->cofactor != 1 ) { /* здесь мы неявно используем тот факт,
-                                                   что кофактор не больше 4х */
-    cofactor[0] = fctx->curve->cofactor;
-    ak_wpoint_pow( &fctx->point, &fctx->point, cofactor, 1, fctx->curve );
-  }
-  ak_wpoint_reduce( &fctx->point, fctx->curve );
+  if(( error = ak_wpoint_vko( &fctx->point, &fctx->point,
+                                             fctx->secret, fctx->curve )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect calculation of common point" );
 
  /* приводим x-координату к последовательности октетов в little endian */
   if(( error = ak_mpzn_to_little_endian( fctx->point.x, fctx->curve->size,
@@ -109,7 +109,7 @@
     } /* теперь в переменной key находится нужное значение */
 
   /* устанавливаем значение ключа C(S)K_n */
-   if(( error = ak_bckey_context_set_key( ekey, ats+32, 32, ak_true )) != ak_error_ok ) {
+   if(( error = ak_bckey_context_rekey( ekey, ats+32, 32 )) != ak_error_ok ) {
      ak_error_message( error, __func__, "incorrect setting temporary integrity key" );
      goto labexit;
    }
@@ -127,7 +127,7 @@
   ak_error_message_fmt( 0, __func__, "iC(S)FK: %s [%s]", str, ds );
 
   /* устанавливаем значение ключа eC(S)FK */
-   if(( error = ak_bckey_context_set_key( ekey, key, sizeof( key ), ak_true )) != ak_error_ok ) {
+   if(( error = ak_bckey_context_rekey( ekey, key, sizeof( key ))) != ak_error_ok ) {
      ak_error_message_fmt( error, __func__,
                         "incorrect assigning of %s encryption key for indices [%u,%u]", ds, m, n );
      goto labexit;
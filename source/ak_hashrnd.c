@@ -15,6 +15,11 @@
  #error Library cannot be compiled without string.h header
 #endif
 
+/* ----------------------------------------------------------------------------------------------- */
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
  #include <ak_hash.h>
  #include <ak_mpzn.h>
@@ -30,8 +35,34 @@
    ak_uint8 buffer[64];
   /*! \brief текущее количество доступных для выдачи октетов */
    size_t len;
+  /*! \brief количество созданных подпотоков генератора */
+   ak_uint64 substreams;
+  /*! \brief флаг того, что генератор является подпотоком другого генератора */
+   bool_t substream;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  /*! \brief блокировка, используемая при создании подпотоков */
+   pthread_mutex_t lock;
+#endif
  } *ak_random_hashrnd;
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция увеличивает счетчик и вычисляет от него хеш-код, помещая результат в out.
+
+    Поскольку значение счетчика занимает ровно один блок, функция обходится без промежуточной
+    очистки контекста, выполняемой функцией ak_hash_context_ptr().                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_random_hashrnd_block( ak_random_hashrnd hrnd, ak_pointer out )
+{
+  ak_mpzn512 one = ak_mpzn512_one;
+
+ /* увеличиваем счетчик */
+  ak_mpzn_add( hrnd->counter, hrnd->counter, one, ak_mpzn512_size );
+ /* вычисляем новое хеш-значение */
+  hrnd->ctx.clean( &hrnd->ctx );
+  hrnd->ctx.update( &hrnd->ctx, hrnd->counter, 64 );
+  hrnd->ctx.finalize( &hrnd->ctx, NULL, 0, out );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param rnd Контекст генератора.
     \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
@@ -40,7 +71,6 @@
  static int ak_random_hashrnd_next( ak_random rnd )
 {
   ak_random_hashrnd hrnd = NULL;
-  ak_mpzn512 one = ak_mpzn512_one;
 
   if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                                     "use a null pointer to a random generator" );
@@ -48,10 +78,7 @@
   hrnd = ( ak_random_hashrnd )rnd->data;
   if( hrnd->len != 0 ) return ak_error_message( ak_error_wrong_length, __func__,
                                                              "unexpected use of next function" );
- /* увеличиваем счетчик */
-  ak_mpzn_add( hrnd->counter, hrnd->counter, one, ak_mpzn512_size );
- /* вычисляем новое хеш-значение */
-  ak_hash_context_ptr( &hrnd->ctx, hrnd->counter, 64, hrnd->buffer );
+  ak_random_hashrnd_block( hrnd, hrnd->buffer );
  /* определяем доступный объем данных для считывания */
   hrnd->len = hrnd->ctx.hsize;
 
@@ -68,6 +95,11 @@
     ak_error_message( ak_error_null_pointer, __func__ , "freeing a null pointer to data" );
     return;
   }
+  memset( (( ak_random_hashrnd )ptr)->counter, 0, 64 );
+  memset( (( ak_random_hashrnd )ptr)->buffer, 0, 64 );
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_destroy( &(( ak_random_hashrnd )ptr)->lock );
+#endif
  /* уничтожаем контекст функции хеширования */
   if(( error = ak_hash_context_destroy( &(( ak_random_hashrnd )ptr)->ctx )) != ak_error_ok )
      ak_error_message( error, __func__ , "wrong destroying internal hash function context" );
@@ -95,6 +127,7 @@
  /* восстанавливаем начальное значение */
   hrnd = ( ak_random_hashrnd )rnd->data;
   hrnd->len = 0;
+  hrnd->substream = ak_false; /* новое начальное заполнение делает генератор независимым */
   memset( hrnd->counter, 0, 64 );
   memset( hrnd->buffer, 0, 64 );
 
@@ -132,30 +165,43 @@
   if( size <= 0 ) return ak_error_message( ak_error_wrong_length, __func__ ,
                                                                  "use a data with wrong length" );
   hrnd = ( ak_random_hashrnd )rnd->data;
-  while( realsize > 0 ) {
+
+ /* сначала выдаем данные, оставшиеся от предыдущего вызова */
+  if( hrnd->len > 0 ) {
     size_t offset = ak_min( (size_t)realsize, hrnd->len );
     memcpy( inptr, hrnd->buffer + (hrnd->ctx.hsize - hrnd->len), offset );
     inptr += offset;
     realsize -= offset;
-    if(( hrnd->len -= offset ) <= 0 ) /* вычисляем следующий массив данных */
-      ak_random_hashrnd_next( rnd );
+    hrnd->len -= offset;
+  }
+  if( hrnd->len > 0 ) return ak_error_ok;
+
+ /* полные фрагменты вырабатываются сразу в область памяти пользователя,
+    минуя внутренний буффер */
+  while( realsize >= ( ssize_t )hrnd->ctx.hsize ) {
+    ak_random_hashrnd_block( hrnd, inptr );
+    inptr += hrnd->ctx.hsize;
+    realsize -= hrnd->ctx.hsize;
+  }
+
+ /* вычисляем следующий массив данных и выдаем из него оставшийся хвост */
+  ak_random_hashrnd_next( rnd );
+  if( realsize > 0 ) {
+    memcpy( inptr, hrnd->buffer, ( size_t )realsize );
+    hrnd->len -= ( size_t )realsize;
   }
  return ak_error_ok;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! Функия создает генератор, вырабатывающий последовательность псевдо-случайных данных с
-    использованием бесключевой функции хеширования согласно рекомендациям по
-    стандартизации Р 1323565.1.006-2017.
-    Параметр oid задает используемый алгоритм хеширования.
+/*! \brief Функция создает контекст генератора hashrnd с нулевым начальным значением счетчика.
 
     \param generator контекст инициализируемого генератора псевдо-случайных чисел.
     \param oid идентификатор бесключевой функции хеширования.
     \return Функция возвращает код ошибки.                                                         */
 /* ----------------------------------------------------------------------------------------------- */
- int ak_random_context_create_hashrnd_oid( ak_random generator, ak_oid oid )
+ static int ak_random_hashrnd_create( ak_random generator, ak_oid oid )
 {
-  struct random rnd;
   int error = ak_error_ok;
   ak_random_hashrnd hrnd = NULL;
   char oidname[32]; /* имя для oid генератора псевдо-случайных чисел */
@@ -179,13 +225,20 @@
 
   /* инициализируем поля и данные внутренней структуры данных */
    if(( error = ak_hash_context_create_oid( &hrnd->ctx, oid )) != ak_error_ok ) {
+     free( generator->data );
+     generator->data = NULL;
      ak_random_context_destroy( generator );
      return ak_error_message( error, __func__ ,
                                    "incorrect creation of internal hash function context" );
    }
    hrnd->len = 0;
+   hrnd->substreams = 0;
+   hrnd->substream = ak_false;
    memset( hrnd->counter, 0, 64 );
    memset( hrnd->buffer, 0, 64 );
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+   pthread_mutex_init( &hrnd->lock, NULL );
+#endif
    ak_snprintf( oidname, 30, "hashrnd-%s", oid->name );
 
    generator->oid = ak_oid_context_find_by_name( oidname );
@@ -194,6 +247,29 @@
    generator->random = ak_random_hashrnd_random;
    generator->free = ak_random_hashrnd_free;
 
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функия создает генератор, вырабатывающий последовательность псевдо-случайных данных с
+    использованием бесключевой функции хеширования согласно рекомендациям по
+    стандартизации Р 1323565.1.006-2017.
+    Параметр oid задает используемый алгоритм хеширования.
+
+    \param generator контекст инициализируемого генератора псевдо-случайных чисел.
+    \param oid идентификатор бесключевой функции хеширования.
+    \return Функция возвращает код ошибки.                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_random_context_create_hashrnd_oid( ak_random generator, ak_oid oid )
+{
+  struct random rnd;
+  int error = ak_error_ok;
+  ak_random_hashrnd hrnd = NULL;
+
+  if(( error = ak_random_hashrnd_create( generator, oid )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong initialization of hashrnd generator" );
+  hrnd = ( ak_random_hashrnd )generator->data;
+
  /* для корректной работы присваиваем какое-то случайное начальное значение,
     используя для этого другой генератор псевдо-случайных чисел */
 
@@ -217,6 +293,62 @@
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция создает генератор (подпоток), вырабатывающий последовательность, независимую от
+    последовательностей основного генератора и других его подпотоков. Подпоток использует ту же
+    функцию хеширования и то же начальное заполнение, что и основной генератор; при этом старшие
+    64 бита области изменения счетчика (октеты с 8 по 15) принимают уникальное для подпотока
+    значение, а младшие 64 бита обнуляются. Тем самым, последовательности не пересекаются,
+    пока каждым из генераторов вырабатывается менее 2^64 блоков.
+
+    Подпотоки предназначены для использования в многопоточных программах: каждый поток создает
+    свой подпоток и далее работает с ним без каких-либо блокировок. Основной генератор
+    используется только в момент создания подпотока и может разделяться несколькими потоками.
+
+    Подпоток не может служить основным генератором для создания других подпотоков:
+    номера подпотоков отсчитываются каждым генератором независимо, поэтому подпоток подпотока
+    совпал бы с одним из подпотоков основного генератора.
+
+    \param substream контекст создаваемого подпотока.
+    \param generator контекст основного генератора hashrnd.
+    \return Функция возвращает код ошибки.                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_random_context_create_hashrnd_substream( ak_random substream, ak_random generator )
+{
+  int error = ak_error_ok;
+  ak_uint64 index = 0;
+  ak_random_hashrnd hrnd = NULL, srnd = NULL;
+
+  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "use a null pointer to a random generator" );
+  if( generator->free != ak_random_hashrnd_free )
+    return ak_error_message( ak_error_undefined_function, __func__ ,
+                                                      "using random generator of wrong type" );
+  hrnd = ( ak_random_hashrnd )generator->data;
+  if( hrnd->substream ) return ak_error_message( ak_error_undefined_function, __func__ ,
+                                          "creating a substream of another substream generator" );
+
+ /* создаем контекст подпотока */
+  if(( error = ak_random_hashrnd_create( substream, hrnd->ctx.oid )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong initialization of substream generator" );
+  srnd = ( ak_random_hashrnd )substream->data;
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &hrnd->lock );
+#endif
+  index = ++hrnd->substreams;
+  memcpy( srnd->counter, hrnd->counter, 64 );
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_unlock( &hrnd->lock );
+#endif
+  srnd->counter[0] = 0;
+  srnd->counter[1] = index;
+  srnd->substream = ak_true;
+
+ /* вычисляем псевдо-случайные данные */
+ return ak_random_hashrnd_next( substream );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \param generator контекст инициализируемого генератора псевдо-случайных чисел.                 */
 /* ----------------------------------------------------------------------------------------------- */
@@ -161,7 +161,7 @@
 
  /* устанавливаем ресурс ключа */
   if(( error = ak_skey_context_set_resource( &hctx->key,
-                          key_using_resource, "hmac_key_count_resource", 0, 0 )) != ak_error_ok )
+        key_using_resource, option_hmac_key_count_resource, 0, 0 )) != ak_error_ok )
     ak_error_message( error, __func__, "incorrect assigning \"hmac_key_count_resource\" option" );
  return error;
 }
@@ -188,7 +188,7 @@
 
  /* устанавливаем ресурс ключа */
   if(( error = ak_skey_context_set_resource( &hctx->key,
-                          key_using_resource, "hmac_key_count_resource", 0, 0 )) != ak_error_ok )
+        key_using_resource, option_hmac_key_count_resource, 0, 0 )) != ak_error_ok )
     ak_error_message( error, __func__, "incorrect assigning \"hmac_key_count_resource\" option" );
 
  return error;
@@ -225,7 +225,7 @@
 
  /* устанавливаем ресурс ключа */
   if(( error = ak_skey_context_set_resource( &hctx->key,
-                          key_using_resource, "hmac_key_count_resource", 0, 0 )) != ak_error_ok )
+        key_using_resource, option_hmac_key_count_resource, 0, 0 )) != ak_error_ok )
     ak_error_message( error, __func__, "incorrect assigning \"hmac_key_count_resource\" option" );
 
  return error;
@@ -249,11 +249,13 @@
   if( !((hctx->key.flags)&skey_flag_set_key )) return ak_error_message( ak_error_key_value,
                                                __func__ , "using hmac key with unassigned value" );
 
-  if( hctx->key.resource.value.counter <= 1 ) return ak_error_message( ak_error_low_key_resource,
-                                            __func__, "using hmac key context with low resource" );
-                      /* нам надо два раза использовать ключ => ресурс должен быть не менее двух */
   if( hctx->ctx.bsize > sizeof( buffer )) return ak_error_message( ak_error_wrong_length,
                                             __func__, "using hash function with huge block size" );
+ /* нам надо два раза использовать ключ => ресурс должен быть не менее двух;
+    первое использование резервируется сейчас, второе - при финализации */
+  if( ak_skey_context_reserve_resource( &hctx->key, 1, 1 ) != ak_error_ok )
+    return ak_error_message( ak_error_low_key_resource,
+                                            __func__, "using hmac key context with low resource" );
 
  /* фомируем маскированное значение ключа */
   len = ak_min( hctx->ctx.bsize, hctx->key.key.size );
@@ -264,8 +266,10 @@
   for( ; idx < hctx->ctx.bsize; idx++ ) buffer[idx] = 0x36;
 
  /* инициализируем начальное состояние контекста хеширования */
-  if(( error = hctx->ctx.clean( &hctx->ctx )) != ak_error_ok )
+  if(( error = hctx->ctx.clean( &hctx->ctx )) != ak_error_ok ) {
+    ak_skey_context_commit_resource( &hctx->key, 1, 0 );
     return ak_error_message( error, __func__, "wrong cleaning of hash function context" );
+  }
 
  /* обновляем состояние контекста хеширования */
   if(( error = hctx->ctx.update( &hctx->ctx, buffer, hctx->ctx.bsize )) != ak_error_ok )
@@ -274,9 +278,8 @@
  /* очищаем буффер */
   ak_ptr_wipe( buffer, sizeof( buffer ), &hctx->key.generator, ak_true );
 
- /* перемаскируем ключ и меняем его ресурс */
-  hctx->key.set_mask( &hctx->key );
-  hctx->key.resource.value.counter--; /* мы использовали ключ один раз */
+ /* перемаскируем ключ; ресурс был зарезервирован ранее */
+  ak_skey_context_remask( &hctx->key, 1 );
 
  return error;
 }
@@ -302,7 +305,8 @@
  /* проверяем наличие ключа и его ресурс */
   if( !((hctx->key.flags)&skey_flag_set_key )) return ak_error_message( ak_error_key_value,
                                                __func__ , "using hmac key with unassigned value" );
-  if( hctx->key.resource.value.counter <= 0 ) return ak_error_message( ak_error_low_key_resource,
+  if( ak_atomic_load( &hctx->key.resource.value.counter ) <= 0 )
+    return ak_error_message( ak_error_low_key_resource,
                                             __func__, "using hmac key context with low resource" );
 
   return hctx->ctx.update( &hctx->ctx, data, size );
@@ -381,9 +385,10 @@
  /* очищаем буффер */
   ak_ptr_wipe( keybuffer, sizeof( keybuffer ), &hctx->key.generator, ak_true );
 
- /* ресурс ключа */
-  hctx->key.set_mask( &hctx->key );
-  hctx->key.resource.value.counter--; /* мы использовали ключ один раз */
+ /* ресурс ключа; значение не проверяется, поскольку второе использование
+    ключа обеспечено при инициализации контекста */
+  ak_skey_context_remask( &hctx->key, 1 );
+  ak_atomic_add( &hctx->key.resource.value.counter, -1 ); /* мы использовали ключ один раз */
 
  /* последний update/finalize и возврат результата */
   if( hctx->ctx.bsize == hctx->ctx.hsize ) {
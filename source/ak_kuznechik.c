@@ -26,6 +26,8 @@
  static ak_uint64 ak_kuznechik_encryption_matrix[16][256][2];
 /*! \brief Таблицы, используемые для реализации алгоритма расшифрования одного блока. */
  static ak_uint64 ak_kuznechik_decryption_matrix[16][256][2];
+/*! \brief Итерационные константы, используемые в процедуре развертки ключа. */
+ static ak_uint64 ak_kuznechik_constants[32][2];
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Развернутые раундовые ключи и маски алгоритма Кузнечик.
@@ -52,10 +54,32 @@
  return z;
 }
 
+/* ---------------------------------------------------------------------------------------------- */
+/*! \brief Функция реализует линейное преобразование L согласно ГОСТ Р 34.12-2015
+    (шестнадцать тактов работы линейного регистра сдвига).                                        */
+/* ---------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_linear_steps( ak_uint8 *w  )
+{
+  int i = 0, j = 0;
+  const ak_uint8 kuz_lvec[16] = {
+    0x01, 0x94, 0x20, 0x85, 0x10, 0xC2, 0xC0, 0x01, 0xFB, 0x01, 0xC0, 0xC2, 0x10, 0x85, 0x20, 0x94
+  };
+
+  for( j = 0; j < 16; j++ ) {
+     ak_uint8 z = w[0];
+     for( i = 1; i < 16; i++ ) {
+        w[i-1] = w[i];
+        z ^= ak_kuznechik_mul_gf256( w[i], kuz_lvec[i] );
+     }
+     w[15] = z;
+  }
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  bool_t ak_bckey_init_kuznechik_tables( void )
 {
   int i, j, l;
+  ak_uint64 idx = 0;
   for( i = 0; i < 16; i++ ) {
       for( j = 0; j < 256; j++ ) {
          ak_uint8 b[16], ib[16];
@@ -67,6 +91,16 @@
          memcpy( ak_kuznechik_decryption_matrix[i][j], ib, 16 );
       }
   }
+ /* константы не зависят от ключа, поэтому вычисляются один раз */
+  for( i = 0; i < 32; i++ ) {
+    #ifdef LIBAKRYPT_LITTLE_ENDIAN
+     ak_kuznechik_constants[i][0] = ++idx;
+    #else
+     ak_kuznechik_constants[i][0] = bswap_64( ++idx );
+    #endif
+     ak_kuznechik_constants[i][1] = 0;
+     ak_kuznechik_linear_steps(( ak_uint8 *)ak_kuznechik_constants[i] );
+  }
   if( ak_log_get_level() >= ak_log_maximum )
     ak_error_message( ak_error_ok, __func__ , "initialization is Ok" );
 
@@ -74,37 +108,37 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! \brief Функция умножает вектор w на матрицу D, результат помещается в вектор x.                */
+/*! \brief Функция реализует преобразование LS (подстановку и линейное преобразование)
+    с помощью таблиц, используемых при зашифровании.                                              */
 /* ----------------------------------------------------------------------------------------------- */
- static void ak_kuznechik_matrix_mul_vector( const ak_uint8 D[16][16], ak_uint8 *w, ak_uint8* x )
+ static void ak_kuznechik_table_ls( ak_uint64 *w )
 {
-  int i = 0, j = 0;
+  int i = 0;
+  ak_uint8 *b = ( ak_uint8 *)w;
+  ak_uint64 t = 0, s = 0;
+
   for( i = 0; i < 16; i++ ) {
-    ak_uint8 z = ak_kuznechik_mul_gf256( D[i][0], w[0] );
-    for( j = 1; j < 16; j++ ) z ^= ak_kuznechik_mul_gf256( D[i][j], w[j] );
-    x[i] = z;
+     t ^= ak_kuznechik_encryption_matrix[i][b[i]][0];
+     s ^= ak_kuznechik_encryption_matrix[i][b[i]][1];
   }
+  w[0] = t; w[1] = s;
 }
 
-/* ---------------------------------------------------------------------------------------------- */
-/*! \brief Функция реализует линейное преобразование L согласно ГОСТ Р 34.12-2015
-    (шестнадцать тактов работы линейного регистра сдвига).                                        */
-/* ---------------------------------------------------------------------------------------------- */
- static void ak_kuznechik_linear_steps( ak_uint8 *w  )
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет значение x = L^{-1}(w) с помощью таблиц, используемых при
+    расшифровании (подстановка pi компенсирует обратную подстановку, содержащуюся в таблицах). */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_table_linv( const ak_uint64 *w, ak_uint64 *x )
 {
-  int i = 0, j = 0;
-  const ak_uint8 kuz_lvec[16] = {
-    0x01, 0x94, 0x20, 0x85, 0x10, 0xC2, 0xC0, 0x01, 0xFB, 0x01, 0xC0, 0xC2, 0x10, 0x85, 0x20, 0x94
-  };
+  int i = 0;
+  const ak_uint8 *b = ( const ak_uint8 *)w;
+  ak_uint64 t = 0, s = 0;
 
-  for( j = 0; j < 16; j++ ) {
-     ak_uint8 z = w[0];
-     for( i = 1; i < 16; i++ ) {
-        w[i-1] = w[i];
-        z ^= ak_kuznechik_mul_gf256( w[i], kuz_lvec[i] );
-     }
-     w[15] = z;
+  for( i = 0; i < 16; i++ ) {
+     t ^= ak_kuznechik_decryption_matrix[i][gost_pi[b[i]]][0];
+     s ^= ak_kuznechik_decryption_matrix[i][gost_pi[b[i]]][1];
   }
+  x[0] = t; x[1] = s;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -128,12 +162,36 @@
       ak_error_message( error, __func__, "incorrect wiping an internal data" );
       memset( skey->data, 0, sizeof( ak_kuznechik_expanded_keys ));
     }
-    free( skey->data );
+    ak_libakrypt_secure_free( skey->data );
     skey->data = NULL;
   }
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция замещает развернутые ключи алгоритма Кузнечик случайными данными,
+    не освобождая занимаемую ими память.
+    \param skey Указатель на контекст секретного ключа, содержащего развернутые
+    раундовые ключи и маски.
+    \return Функция возвращает \ref ak_error_ok в случае успеха.
+    В противном случае возвращается код ошибки.                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_kuznechik_wipe_keys( ak_skey skey )
+{
+  int error = ak_error_ok;
+
+  if( skey == NULL ) return ak_error_message( ak_error_null_pointer,
+                                                 __func__ , "using a null pointer to secret key" );
+  if( skey->data != NULL ) {
+    if(( error = ak_ptr_wipe( skey->data, sizeof( ak_kuznechik_expanded_keys ),
+                                                  &skey->generator, ak_true )) != ak_error_ok ) {
+      ak_error_message( error, __func__, "incorrect wiping an internal data" );
+      memset( skey->data, 0, sizeof( ak_kuznechik_expanded_keys ));
+    }
+  }
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция реализует развертку ключей для алгоритма Кузнечик.
     \param skey Указатель на контекст секретного ключа, в который помещаются развернутые
@@ -143,8 +201,8 @@
 /* ----------------------------------------------------------------------------------------------- */
  static int ak_kuznechik_schedule_keys( ak_skey skey )
 {
-  int i = 0, j = 0, l = 0, kdx = 2;
-  ak_uint64 a0[2], a1[2], c[2], t[2], idx = 0;
+  int i = 0, j = 0, kdx = 2;
+  ak_uint64 a0[2], a1[2], t[2];
   ak_uint64 *ekey = NULL, *mkey = NULL, *dkey = NULL, *xkey = NULL;
 
  /* выполняем стандартные проверки */
@@ -153,12 +211,11 @@
  /* проверяем целостность ключа */
   if( skey->check_icode( skey ) != ak_true ) return ak_error_message( ak_error_wrong_key_icode,
                                                 __func__ , "using key with wrong integrity code" );
- /* удаляем былое */
-  if( skey->data != NULL ) ak_kuznechik_delete_keys( skey );
-
- /* далее, по-возможности, выделяем выравненную память */
-  if(( skey->data = ak_libakrypt_aligned_malloc( sizeof( ak_kuznechik_expanded_keys ))) == NULL )
-    return ak_error_message( ak_error_out_of_memory, __func__ ,
+ /* память в защищенной области выделяется один раз; при последующих присвоениях
+    ключу новых значений прежние развернутые ключи замещаются новыми */
+  if( skey->data == NULL )
+    if(( skey->data = ak_libakrypt_secure_malloc( sizeof( ak_kuznechik_expanded_keys ))) == NULL )
+      return ak_error_message( ak_error_out_of_memory, __func__ ,
                                                              "wrong allocation of internal data" );
  /* получаем указатели на области памяти */
   ekey = ( ak_uint64 *)skey->data;                  /* 10 прямых раундовых ключей */
@@ -179,22 +236,16 @@
   dkey[0] = a1[0]^xkey[0]; dkey[1] = a1[1]^xkey[1];
 
   ekey[2] = a0[0]^mkey[2]; ekey[3] = a0[1]^mkey[3];
-  ak_kuznechik_matrix_mul_vector( Linv, (ak_uint8 *)a0, (ak_uint8 *)( dkey+2 ));
+  ak_kuznechik_table_linv( a0, dkey+2 );
   dkey[2] ^= xkey[2]; dkey[3] ^= xkey[3];
 
   for( j = 0; j < 4; j++ ) {
      for( i = 0; i < 8; i++ ) {
-      #ifdef LIBAKRYPT_LITTLE_ENDIAN
-        c[0] = ++idx; /* вычисляем константу алгоритма согласно ГОСТ Р 34.12-2015 */
-      #else
-        c[0] = bswap_64( ++idx );
-      #endif
-        c[1] = 0;
-        ak_kuznechik_linear_steps(( ak_uint8 *)c );
-
-        t[0] = a1[0] ^ c[0]; t[1] = a1[1] ^ c[1];
-        for( l = 0; l < 16; l++ ) ((ak_uint8 *)t)[l] = gost_pi[ ((ak_uint8 *)t)[l]];
-        ak_kuznechik_linear_steps(( ak_uint8 *)t );
+       /* константы алгоритма вычислены заранее согласно ГОСТ Р 34.12-2015,
+          преобразование LS выполняется с помощью таблиц зашифрования */
+        t[0] = a1[0] ^ ak_kuznechik_constants[8*j+i][0];
+        t[1] = a1[1] ^ ak_kuznechik_constants[8*j+i][1];
+        ak_kuznechik_table_ls( t );
 
         t[0] ^= a0[0]; t[1] ^= a0[1];
         a0[0] = a1[0]; a0[1] = a1[1];
@@ -202,12 +253,12 @@
      }
      kdx += 2;
      ekey[kdx] = a1[0]^mkey[kdx]; ekey[kdx+1] = a1[1]^mkey[kdx+1];
-     ak_kuznechik_matrix_mul_vector( Linv, ( ak_uint8 *)a1, (ak_uint8 *)( dkey+kdx ));
+     ak_kuznechik_table_linv( a1, dkey+kdx );
      dkey[kdx] ^= xkey[kdx]; dkey[kdx+1] ^= xkey[kdx+1];
 
      kdx += 2;
      ekey[kdx] = a0[0]^mkey[kdx]; ekey[kdx+1] = a0[1]^mkey[kdx+1];
-     ak_kuznechik_matrix_mul_vector( Linv, ( ak_uint8 *)a0, (ak_uint8 *)( dkey+kdx ));
+     ak_kuznechik_table_linv( a0, dkey+kdx );
      dkey[kdx] ^= xkey[kdx]; dkey[kdx+1] ^= xkey[kdx+1];
   }
  return ak_error_ok;
@@ -368,6 +419,7 @@
  /* устанавливаем методы */
   bkey->schedule_keys = ak_kuznechik_schedule_keys;
   bkey->delete_keys = ak_kuznechik_delete_keys;
+  bkey->wipe_keys = ak_kuznechik_wipe_keys;
   bkey->encrypt = ak_kuznechik_encrypt_with_mask;
   bkey->decrypt = ak_kuznechik_decrypt_with_mask;
 
@@ -101,6 +101,12 @@
    #ifdef LIBAKRYPT_HAVE_BUILTIN_MULQ_GCC
     ak_error_message( ak_error_ok, __func__ , "library applies assembler code for mulq command" );
    #endif
+   #ifdef LIBAKRYPT_HAVE_BUILTIN_MULX_ADX
+    ak_error_message( ak_error_ok, __func__ , "library applies assembler code for mulx/adx commands" );
+   #endif
+   #ifdef LIBAKRYPT_HAVE_BUILTIN_INT128
+    ak_error_message( ak_error_ok, __func__ , "library applies unsigned __int128 type" );
+   #endif
    #ifdef LIBAKRYPT_HAVE_PTHREAD
     ak_error_message( ak_error_ok, __func__ , "library runs with pthreads support" );
    #endif
@@ -369,6 +375,9 @@
  /* выводим значения установленных параметров библиотеки */
    ak_libakrypt_log_options();
 
+ /* при необходимости запускаем асинхронный вывод сообщений аудита */
+   if( ak_libakrypt_get_option_by_index( option_log_async ) == 1 ) ak_log_set_async( ak_true );
+
  /* проверяем длины фиксированных типов данных */
    if( ak_libakrypt_test_types() != ak_true ) {
      ak_error_message( ak_error_get_value(), __func__ , "sizes of predefined types is wrong" );
@@ -446,8 +455,21 @@
   if( ak_libakrypt_destroy_context_manager() != ak_error_ok ) {
     ak_error_message( ak_error_get_value(), __func__, "destroying of context manager is wrong" );
   }
+
+ /* останавливаем фоновую проверку контрольных сумм секретных ключей */
+  ak_libakrypt_icode_verifier_destroy();
 #endif
 
+ /* уничтожаем генератор масок текущего потока */
+  ak_random_context_thread_local_destroy();
+
+ /* освобождаем защищенную область памяти, если все ключи уничтожены */
+  ak_libakrypt_secure_destroy();
+
+ /* выводим накопленные сообщения и завершаем асинхронный вывод */
+  ak_log_set_async( ak_false );
+  ak_log_destroy_rings();
+
   if( ak_log_get_level() != ak_log_none )
     ak_error_message( ak_error_ok, __func__ , "all crypto mechanisms successfully destroyed" );
 
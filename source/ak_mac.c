@@ -543,6 +543,23 @@
  return ictx->oid;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param ictx Контекст алгоритма итерационного сжатия (имитовставки).
+    @return Функция возвращает указатель на секретный ключ. Для бесключевых алгоритмов
+    возвращается NULL.                                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_skey ak_mac_context_get_skey( ak_mac ictx )
+{
+  if( ictx == NULL ) return NULL;
+  switch( ictx->engine )
+  {
+    case hmac_function: return &(( ak_hmac )ictx->ctx)->key;
+    case omac_function: return &(( ak_omac )ictx->ctx)->bkey.key;
+    case mgm_function: return &(( ak_mgm )ictx->ctx)->bkey.key;
+    default: return NULL;
+  }
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param hctx Контекст алгоритма итерационного сжатия (имитовставки).
 
@@ -861,17 +878,201 @@
   if( kctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                 "using a null pointer to secret key mac context" );
  /* получаем указатель на секретный ключ */
-  switch( kctx->engine ) {
-    case hmac_function: skey = ( ak_skey )( &(( ak_hmac )kctx->ctx)->key );
+  if(( skey = ak_mac_context_get_skey( kctx )) == NULL )
+    return ak_error_message( ak_error_oid_engine, __func__,
+                                            "using an unsupported engine for secret key context" );
+ return ak_skey_context_mac_context_update( skey, uctx );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                   пул повторно используемых контекстов сжимающих отображений                    */
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция создает пул контекстов алгоритма итерационного сжатия, заданного своим
+    идентификатором, и заранее создает заданное количество контекстов. Контексты, полученные
+    из пула, используют уже выделенную память под внутренние состояния и ключевую информацию,
+    поэтому получение и возврат контекста не требуют выделения памяти.
+
+    Пул не является потокобезопасным: предполагается, что каждый поток (соединение)
+    использует собственный пул.
+
+    @param pool Контекст пула.
+    @param oid Идентификатор алгоритма хеширования или выработки имитовставки.
+    @param count Количество заранее создаваемых контекстов; может быть равно нулю.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_mac_pool_create( ak_mac_pool pool, ak_oid oid, const size_t count )
+{
+  int error = ak_error_ok;
+
+  if( pool == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                "using null pointer to mac pool" );
+  if( oid == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                 "using null pointer to mac oid" );
+  if( oid->mode != algorithm )
+    return ak_error_message( ak_error_oid_mode, __func__, "using oid with wrong mode" );
+
+  pool->oid = oid;
+  pool->count = 0;
+  pool->total = 0;
+  if(( pool->size = count ) == 0 ) pool->size = 4;
+  if(( pool->idle = malloc( pool->size*sizeof( ak_mac ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__,
+                                                        "incorrect memory allocation for mac pool" );
+ /* заранее создаем контексты */
+  while( pool->count < count ) {
+    ak_mac ictx = NULL;
+    if(( ictx = malloc( sizeof( struct mac ))) == NULL ) {
+      error = ak_error_message( ak_error_out_of_memory, __func__,
+                                                     "incorrect memory allocation for mac context" );
+      break;
+    }
+    if(( error = ak_mac_context_create_oid( ictx, oid )) != ak_error_ok ) {
+      free( ictx );
+      ak_error_message( error, __func__, "incorrect creation of mac context" );
+      break;
+    }
+    pool->idle[pool->count++] = ictx;
+    pool->total++;
+  }
+  if( error != ak_error_ok ) ak_mac_pool_destroy( pool );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция уничтожает все контексты, хранящиеся в пуле. Контексты, полученные
+    из пула и не возвращенные в него, должны уничтожаться функцией ak_mac_context_delete().
+
+    @param pool Контекст пула.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_mac_pool_destroy( ak_mac_pool pool )
+{
+  if( pool == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                "using null pointer to mac pool" );
+  while( pool->count > 0 ) ak_mac_context_delete( pool->idle[--pool->count] );
+  if( pool->idle != NULL ) free( pool->idle );
+  pool->idle = NULL;
+  pool->size = pool->total = 0;
+  pool->oid = NULL;
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция извлекает из пула контекст, присваивает ему заданное значение секретного ключа
+    и приводит его в начальное состояние; если пул пуст, то создается новый контекст.
+
+    @param pool Контекст пула.
+    @param keyptr Указатель на область памяти, содержащую значение ключа. Для бесключевых
+    функций хеширования должен быть равен NULL.
+    @param size Размер ключа в байтах.
+    @return В случае успеха функция возвращает указатель на контекст. В противном случае
+    возвращается NULL, а код ошибки может быть получен с помощью функции ak_error_get_value().     */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_mac ak_mac_pool_checkout( ak_mac_pool pool, const ak_pointer keyptr, const size_t size )
+{
+  ak_mac ictx = NULL;
+  int error = ak_error_ok;
+
+  if( pool == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__, "using null pointer to mac pool" );
+    return NULL;
+  }
+  if( pool->count > 0 ) ictx = pool->idle[--pool->count];
+   else {
+     if(( ictx = malloc( sizeof( struct mac ))) == NULL ) {
+       ak_error_message( ak_error_out_of_memory, __func__,
+                                                     "incorrect memory allocation for mac context" );
+       return NULL;
+     }
+     if(( error = ak_mac_context_create_oid( ictx, pool->oid )) != ak_error_ok ) {
+       free( ictx );
+       ak_error_message( error, __func__, "incorrect creation of mac context" );
+       return NULL;
+     }
+     pool->total++;
+   }
+ /* присваиваем значение ключа, используя уже выделенную память */
+  if( ak_mac_context_is_key_settable( ictx )) {
+    if(( error = ak_mac_context_set_key( ictx, keyptr, size, ak_true )) != ak_error_ok )
+      ak_error_message( error, __func__, "incorrect assigning of secret key value" );
+  } else
+     if( keyptr != NULL ) error = ak_error_message( ak_error_key_usage, __func__,
+                                                           "using a key for non-key mac context" );
+  /* для алгоритма MGM очистка выполняется после установки синхропосылки */
+  if(( error == ak_error_ok ) && ( ictx->engine != mgm_function ) &&
+                                          (( error = ak_mac_context_clean( ictx )) != ak_error_ok ))
+    ak_error_message( error, __func__, "incorrect cleaning of mac context" );
+  if( error != ak_error_ok ) {
+    ak_mac_pool_checkin( pool, ictx );
+    return NULL;
+  }
+ return ictx;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция уничтожает ключевую информацию и текущее состояние контекста и возвращает его в пул.
+    Память, выделенная под контекст, не освобождается: значение секретного ключа замещается
+    случайными данными (см. ak_skey_context_wipe() и ak_bckey_context_wipe()), после чего ключ
+    считается неустановленным и не может использоваться до следующего извлечения контекста из пула.
+    Кроме ключа уничтожаются и зависящие от него внутренние состояния алгоритмов: состояние
+    функции хеширования HMAC, полученное после обработки ключа, промежуточное значение
+    имитовставки OMAC и внутреннее состояние алгоритма MGM; синхропосылка алгоритма MGM
+    также удаляется и должна быть установлена заново после извлечения контекста из пула.
+
+    @param pool Контекст пула.
+    @param ictx Контекст, полученный с помощью функции ak_mac_pool_checkout().
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_mac_pool_checkin( ak_mac_pool pool, ak_mac ictx )
+{
+  ak_mgm mctx = NULL;
+  ak_hmac hctx = NULL;
+  ak_omac octx = NULL;
+  int error = ak_error_ok;
+
+  if( pool == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                "using null pointer to mac pool" );
+  if( ictx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                             "using null pointer to mac context" );
+ /* уничтожаем ключевую информацию, не освобождая память контекста */
+  switch( ictx->engine ) {
+    case hmac_function: hctx = ( ak_hmac )ictx->ctx;
+      error = ak_skey_context_wipe( &hctx->key );
+     /* состояние функции хеширования содержит результат сжатия ключа, сложенного с ipad */
+      if( hctx->ctx.clean != NULL ) hctx->ctx.clean( &hctx->ctx );
       break;
-    case omac_function: skey = ( ak_skey )( &(( ak_omac )kctx->ctx)->bkey.key );
+    case omac_function: octx = ( ak_omac )ictx->ctx;
+      error = ak_bckey_context_wipe( &octx->bkey );
+      if( octx->yaout.data != NULL ) ak_buffer_wipe( &octx->yaout, &octx->bkey.key.generator );
       break;
-    case mgm_function: skey = ( ak_skey )( &(( ak_mgm )( kctx->ctx ))->bkey.key );
+    case mgm_function: mctx = ( ak_mgm )ictx->ctx;
+      error = ak_bckey_context_wipe( &mctx->bkey );
+      memset( &mctx->mctx, 0, sizeof( struct mgm_ctx ));
+     /* синхропосылка удаляется, чтобы следующий пользователь не мог использовать ее повторно */
+      ak_buffer_free( &mctx->iv );
       break;
-    default: return ak_error_message( ak_error_oid_engine, __func__,
-                                            "using an unsupported engine for secret key context" );
+    default: break;
   }
- return ak_skey_context_mac_context_update( skey, uctx );
+  if( error != ak_error_ok ) ak_error_message( error, __func__, "incorrect wiping of secret key" );
+  if( ictx->data != NULL ) memset( ictx->data, 0, ictx->bsize );
+  ictx->length = 0;
+
+  if( pool->count == pool->size ) {
+    ak_mac *idle = realloc( pool->idle, 2*pool->size*sizeof( ak_mac ));
+    if( idle == NULL ) {
+      pool->total--;
+      ak_mac_context_delete( ictx );
+      return ak_error_message( ak_error_out_of_memory, __func__,
+                                                        "incorrect memory allocation for mac pool" );
+    }
+    pool->idle = idle;
+    pool->size <<= 1;
+  }
+  pool->idle[pool->count++] = ictx;
+ return error;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
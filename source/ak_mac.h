@@ -113,6 +113,37 @@
 /*! \brief Обновление одного контекста сжимающего отображения ключевым значением,
     содержащимся во втором контексте. */
  int ak_mac_context_update_mac_context_key( ak_mac, ak_mac );
+/*! \brief Получение указателя на секретный ключ контекста сжимающего отображения. */
+ ak_skey ak_mac_context_get_skey( ak_mac );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Пул повторно используемых контекстов сжимающих отображений.
+
+    Пул хранит созданные контексты одного алгоритма хеширования или выработки имитовставки;
+    при возврате в пул ключевая информация и текущее состояние уничтожаются,
+    а выделенная память сохраняется.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct mac_pool {
+  /*! \brief Идентификатор алгоритма. */
+   ak_oid oid;
+  /*! \brief Массив контекстов, готовых к использованию. */
+   ak_mac *idle;
+  /*! \brief Количество контекстов, готовых к использованию. */
+   size_t count;
+  /*! \brief Размер массива контекстов. */
+   size_t size;
+  /*! \brief Общее количество контекстов, созданных пулом. */
+   size_t total;
+ } *ak_mac_pool;
+
+/*! \brief Создание пула контекстов сжимающих отображений. */
+ int ak_mac_pool_create( ak_mac_pool , ak_oid , const size_t );
+/*! \brief Уничтожение пула контекстов сжимающих отображений. */
+ int ak_mac_pool_destroy( ak_mac_pool );
+/*! \brief Получение из пула контекста с заданным значением секретного ключа. */
+ ak_mac ak_mac_pool_checkout( ak_mac_pool , const ak_pointer , const size_t );
+/*! \brief Возврат контекста в пул. */
+ int ak_mac_pool_checkin( ak_mac_pool , ak_mac );
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Проверка корректной работы механизмов итерационного сжатия для функций хеширования. */
@@ -515,12 +515,30 @@
  /* если ключ был создан, но ему не было присвоено значение, здесь возникнет ошибка */
   if( skey->data != NULL ) {
     ak_ptr_wipe( skey->data, sizeof( struct magma_encrypted_keys ), &skey->generator, ak_true );
-    free( skey->data );
+    ak_libakrypt_secure_free( skey->data );
     skey->data = NULL;
   }
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция замещает развернутые ключи и маски случайными данными,
+    не освобождая занимаемую ими память.
+
+    @param skey Указатель на контекст секретного ключа
+
+    @return В случае успеха функция возвращает ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_magma_context_wipe_keys( ak_skey skey )
+{
+  if( skey == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using a null pointer to secret key" );
+  if( skey->data != NULL )
+    ak_ptr_wipe( skey->data, sizeof( struct magma_encrypted_keys ), &skey->generator, ak_true );
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция выработки инвертированного ключа и ключевых масок.
 
@@ -539,11 +557,11 @@
  /* проверяем целостность ключа */
   if( skey->check_icode( skey ) != ak_true ) return ak_error_message( ak_error_wrong_key_icode,
                                                 __func__ , "using key with wrong integrity code" );
- /* удаляем былое */
-  if( skey->data != NULL ) ak_magma_context_delete_keys( skey );
-
-  if(( data = ak_libakrypt_aligned_malloc( sizeof( struct magma_encrypted_keys ))) == NULL )
-    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+ /* память в защищенной области выделяется один раз; при последующих присвоениях
+    ключу новых значений прежние развернутые ключи замещаются новыми */
+  if(( data = skey->data ) == NULL )
+    if(( data = ak_libakrypt_secure_malloc( sizeof( struct magma_encrypted_keys ))) == NULL )
+      return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
 
  /* выставляем флаги того, что память выделена */
   memset( data, 0, sizeof( struct magma_encrypted_keys ));
@@ -855,6 +873,7 @@ int ak_bckey_context_create_magma( ak_bckey bkey )
 
   bkey->schedule_keys = ak_magma_context_schedule_keys;
   bkey->delete_keys = ak_magma_context_delete_keys;
+  bkey->wipe_keys = ak_magma_context_wipe_keys;
   bkey->encrypt = ak_magma_encrypt_with_random_walk;
   bkey->decrypt = ak_magma_decrypt_with_random_walk;
 
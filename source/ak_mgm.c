@@ -59,9 +59,6 @@
  if(( authenticationKey->key.flags&skey_flag_set_key ) == 0 )
    return ak_error_message( ak_error_key_value, __func__,
                                          "using block cipher key context with undefined key value");
- if( authenticationKey->key.resource.value.counter <= 0 )
-   return ak_error_message( ak_error_low_key_resource, __func__, "using key with low key resource");
-
  if( iv == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                                             "using null pointer to initial vector");
  if(( iv_size == 0 ) || ( iv_size > authenticationKey->bsize ))
@@ -80,8 +77,9 @@
   ivector[authenticationKey->bsize-1] = ( ivector[authenticationKey->bsize-1]&0x7F ) ^ 0x80;
 
  /* зашифровываем необходимое и удаляемся */
+  if( ak_skey_context_reserve_resource( &authenticationKey->key, 1, 0 ) != ak_error_ok )
+    return ak_error_message( ak_error_low_key_resource, __func__, "using key with low key resource");
   authenticationKey->encrypt( &authenticationKey->key, ivector, &ctx->zcount );
-  authenticationKey->key.resource.value.counter--;
 
  return ak_error_ok;
 }
@@ -153,9 +151,9 @@
   if(( adata == NULL ) || ( adata_size == 0 )) return ak_error_ok;
 
  /* проверка ресурса ключа */
-  if( authenticationKey->key.resource.value.counter <= (resource = blocks + (tail > 0)))
+  if( ak_skey_context_reserve_resource( &authenticationKey->key,
+                                          resource = blocks + (tail > 0), 1 ) != ak_error_ok )
    return ak_error_message( ak_error_low_key_resource, __func__, "using key with low key resource");
-  else authenticationKey->key.resource.value.counter -= resource;
 
  /* теперь основной цикл */
  if( absize == 16 ) { /* обработка 128-битным шифром */
@@ -220,10 +218,10 @@
   }
 
  /* традиционная проверка ресурса */
-  if( authenticationKey->key.resource.value.counter <= 0 ) {
+  if( ak_skey_context_reserve_resource( &authenticationKey->key, 1, 0 ) != ak_error_ok ) {
     ak_error_message( ak_error_low_key_resource, __func__, "using key with low key resource");
     return NULL;
-  } else authenticationKey->key.resource.value.counter--;
+  }
 
  /* закрываем добавление шифруемых данных */
    ak_mgm_set_bit( ctx->flags, ak_mgm_encrypted_data_bit );
@@ -298,9 +296,6 @@
  if(( encryptionKey->key.flags&skey_flag_set_key ) == 0 )
            return ak_error_message( ak_error_key_value, __func__,
                                                "using secret key context with undefined key value");
- if( encryptionKey->key.resource.value.counter <= 0 )
-   return ak_error_message( ak_error_low_key_resource, __func__, "using key with low key resource");
-
  if( iv == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                                             "using null pointer to initial vector");
  if(( iv_size == 0 ) || ( iv_size > encryptionKey->bsize ))
@@ -316,8 +311,9 @@
   ivector[iv_size-1] = ( ivector[iv_size-1]&0x7F );
 
  /* зашифровываем необходимое и удаляемся */
+  if( ak_skey_context_reserve_resource( &encryptionKey->key, 1, 0 ) != ak_error_ok )
+    return ak_error_message( ak_error_low_key_resource, __func__, "using key with low key resource");
   encryptionKey->encrypt( &encryptionKey->key, ivector, &ctx->ycount );
-  encryptionKey->key.resource.value.counter--;
 
  return ak_error_ok;
 }
@@ -388,18 +384,22 @@
   if(( in == NULL ) || ( size == 0 )) return ak_error_ok;
 
  /* проверка ресурса ключа выработки имитовставки */
+  resource = blocks + (tail > 0);
   if( authenticationKey != NULL ) {
-    if( authenticationKey->key.resource.value.counter <= ( ssize_t )(resource = blocks + (tail > 0)))
+    if( ak_skey_context_reserve_resource( &authenticationKey->key,
+                                                      ( ssize_t )resource, 1 ) != ak_error_ok )
       return ak_error_message( ak_error_low_key_resource, __func__,
                                                 "using authentication key with low key resource");
-    else authenticationKey->key.resource.value.counter -= resource;
   }
 
- /* проверка ресурса ключа шифрования */
-  if( encryptionKey->key.resource.value.counter <= ( ssize_t )resource )
-   return ak_error_message( ak_error_low_key_resource, __func__,
+ /* проверка ресурса ключа шифрования; при его нехватке резерв ключа имитовставки возвращается */
+  if( ak_skey_context_reserve_resource( &encryptionKey->key,
+                                                      ( ssize_t )resource, 1 ) != ak_error_ok ) {
+    if( authenticationKey != NULL )
+      ak_skey_context_commit_resource( &authenticationKey->key, ( ssize_t )resource, 0 );
+    return ak_error_message( ak_error_low_key_resource, __func__,
                                                    "using encryption key with low key resource");
-  else encryptionKey->key.resource.value.counter -= resource;
+  }
 
  /* теперь обработка данных */
   memset( &e, 0, 16 );
@@ -524,18 +524,22 @@
   if(( in == NULL ) || ( size == 0 )) return ak_error_ok;
 
  /* проверка ресурса ключа выработки имитовставки */
+  resource = blocks + (tail > 0);
   if( authenticationKey != NULL ) {
-    if( authenticationKey->key.resource.value.counter <= ( ssize_t )(resource = blocks + (tail > 0)))
+    if( ak_skey_context_reserve_resource( &authenticationKey->key,
+                                                      ( ssize_t )resource, 1 ) != ak_error_ok )
       return ak_error_message( ak_error_low_key_resource, __func__,
                                                 "using authentication key with low key resource");
-    else authenticationKey->key.resource.value.counter -= resource;
   }
 
- /* проверка ресурса ключа шифрования */
-  if( encryptionKey->key.resource.value.counter <= ( ssize_t )resource )
-   return ak_error_message( ak_error_low_key_resource, __func__,
+ /* проверка ресурса ключа шифрования; при его нехватке резерв ключа имитовставки возвращается */
+  if( ak_skey_context_reserve_resource( &encryptionKey->key,
+                                                      ( ssize_t )resource, 1 ) != ak_error_ok ) {
+    if( authenticationKey != NULL )
+      ak_skey_context_commit_resource( &authenticationKey->key, ( ssize_t )resource, 0 );
+    return ak_error_message( ak_error_low_key_resource, __func__,
                                                    "using encryption key with low key resource");
-  else encryptionKey->key.resource.value.counter -= resource;
+  }
 
  /* теперь обработка данных */
   memset( &e, 0, 16 );
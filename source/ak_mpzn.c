@@ -51,6 +51,28 @@
  } while (0)
 #endif
 
+/* ----------------------------------------------------------------------------------------------- */
+/* макрос вычисляет двойное слово (hi, lo) = a*b + t + c; переполнение здесь невозможно            */
+#ifdef LIBAKRYPT_HAVE_BUILTIN_INT128
+ __extension__ typedef unsigned __int128 ak_mpzn_uint128;
+
+ #define ak_mpzn_mac( hi, lo, a, b, t, c )                                              \
+ do {                                                                                   \
+    ak_mpzn_uint128 __w = ( ak_mpzn_uint128 )(a)*(b) + (t) + (c);                       \
+    (lo) = ( ak_uint64 ) __w;                                                           \
+    (hi) = ( ak_uint64 )( __w >> 64 );                                                  \
+ } while(0)
+#else
+ #define ak_mpzn_mac( hi, lo, a, b, t, c )                                              \
+ do {                                                                                   \
+    ak_uint64 __mh, __ml, __mt = (t), __mc = (c);                                       \
+    umul_ppmm( __mh, __ml, (a), (b) );                                                  \
+    __ml += __mt; __mh += ( __ml < __mt );                                              \
+    __ml += __mc; __mh += ( __ml < __mc );                                              \
+    (lo) = __ml; (hi) = __mh;                                                           \
+ } while(0)
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция присваивает значение вычета x вычету z. Для оптимизации вычислений проверка
     корректности входных данных не производится.
@@ -565,6 +587,92 @@
    else memcpy( r, s, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет младшие `size` слов произведения двух вычетов длины `size` слов.     */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_mul_low( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y, const size_t size )
+{
+  size_t i = 0, j = 0;
+  ak_mpznmax w = ak_mpznmax_zero;
+
+  for( i = 0; i < size; i++ ) {
+     ak_uint64 m = 0, d = x[i];
+     for( j = 0; i+j < size; j++ ) {
+        ak_uint64 w1, w0, cy;
+        umul_ppmm( w1, w0, d, y[j] );
+        w[i+j] += m;
+        cy = w[i+j] < m;
+
+        w[i+j] += w0;
+        cy += w[i+j] < w0;
+        m = w1 + cy;
+     }
+  }
+  memcpy( z, w, sizeof( ak_uint64 )*size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет вычет \f$ r \f$, удовлетворяющий сравнению \f$ r \equiv u \pmod{m}\f$,
+    с помощью алгоритма Барретта (см. A.Menezes, P.van Oorschot, S.Vanstone,
+    Handbook of Applied Cryptography, алгоритм 14.42).
+
+    В отличие от функции ak_mpzn_rem(), на вход функции может подаваться произвольный вычет
+    \f$ u \f$ двойной длины, т.е. \f$ 0 \leq u < 2^{128\cdot size} \f$, например, произведение
+    двух вычетов, вычисленное функцией ak_mpzn_mul(). Для приведения вычета обычной длины
+    его старшая половина должна быть заполнена нулями.
+
+    Для вычислений используется заранее вычисленная константа
+    \f$ \mu = \lfloor 2^{128\cdot size} / m \rfloor \f$, занимающая `size+1` слово. Для
+    модулей эллиптических кривых соответствующие константы хранятся в полях `mu` и `muq`
+    структуры \ref wcurve. Ветвления, зависящие от значения \f$ u \f$, в функции отсутствуют.
+
+    @param r Результат применения операции вычисления остатка от деления (`size` слов)
+    @param u Вычет, значение которого приводится по модулю (`2*size` слов)
+    @param m Модуль, по которому производится приведение; старшее слово модуля
+    должно быть отлично от нуля
+    @param mu Константа алгоритма Барретта (`size+1` слово)
+    @param size Размер модуля в словах (значение константы ak_mpzn256_size или ak_mpzn512_size ) */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_rem_barrett( ak_uint64 *r, ak_uint64 *u, ak_uint64 *m,
+                                                              ak_uint64 *mu, const size_t size )
+{
+  size_t i = 0, j = 0;
+  ak_uint64 mask = 0;
+  ak_mpznmax w = ak_mpznmax_zero, t, x;
+
+ /* вычисляем q1*mu, где q1 = floor( u/b^{size-1} ) и b = 2^64,
+    при этом нам нужны только старшие слова произведения, начиная с номера size+1 */
+  for( i = 0; i <= size; i++ ) {
+     ak_uint64 c = 0, d = u[size-1+i];
+     for( j = 0; j <= size; j++ ) {
+        ak_uint64 w1, w0, cy;
+        umul_ppmm( w1, w0, d, mu[j] );
+        w[i+j] += c;
+        cy = w[i+j] < c;
+
+        w[i+j] += w0;
+        cy += w[i+j] < w0;
+        c = w1 + cy;
+     }
+     w[i+size+1] = c;
+  }
+
+ /* вычисляем r = ( u - q3*m ) mod b^{size+1}, где q3 = floor( q1*mu/b^{size+1} ) */
+  memcpy( x, m, sizeof( ak_uint64 )*size ); x[size] = 0;
+  ak_mpzn_mul_low( t, w+size+1, x, size+1 );
+  ak_mpzn_sub( t, u, t, size+1 );
+
+ /* выполняем не более двух вычитаний модуля (без ветвлений) */
+  for( i = 0; i < 2; i++ ) {
+     mask = ( ak_uint64 )0 - ( ak_uint64 )( ak_mpzn_sub( w, t, x, size+1 ) == 0 );
+     for( j = 0; j <= size; j++ ) t[j] ^= mask&( t[j]^w[j] );
+  }
+  memcpy( r, t, sizeof( ak_uint64 )*size );
+
+  memset( w, 0, sizeof( ak_mpznmax ));
+  memset( t, 0, sizeof( ak_mpznmax ));
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /* Операции Монтгомери:                                                                            */
 /* реализованы операции сложения и умножения вычетов по материалам статьи                          */
@@ -721,6 +829,323 @@
   if( cy != t[2*size] ) memcpy( z, t+size, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                   развернутые варианты умножения Монтгомери для 256 и 512 бит                   */
+/* ----------------------------------------------------------------------------------------------- */
+/* макросы ak_mpzn_addmul_row256() и ak_mpzn_addmul_row512() прибавляют к вычету t длины size+2
+   произведение вычета a длины size на слово m, т.е. вычисляют t <- t + m*a;
+   при наличии инструкций mulx/adcx/adox используются две независимые цепочки переносов            */
+#ifdef LIBAKRYPT_HAVE_BUILTIN_MULX_ADX
+ #define ak_mulx_step( j, jn )                                                          \
+   "mulx " #j "(%[aptr]), %[lo], %[hi]\n\t"                                             \
+   "adox %[lo], %[acc]\n\t"                                                             \
+   "movq %[acc], " #j "(%[tptr])\n\t"                                                   \
+   "movq " #jn "(%[tptr]), %[acc]\n\t"                                                  \
+   "adcx %[hi], %[acc]\n\t"
+
+ #define ak_mulx_tail( j, jn )                                                          \
+   "adox %[zero], %[acc]\n\t"                                                           \
+   "movq %[acc], " #j "(%[tptr])\n\t"                                                   \
+   "movq " #jn "(%[tptr]), %[acc]\n\t"                                                  \
+   "adcx %[zero], %[acc]\n\t"                                                           \
+   "adox %[zero], %[acc]\n\t"                                                           \
+   "movq %[acc], " #jn "(%[tptr])\n\t"
+
+ #define ak_mulx_row( t, a, m, code )                                                   \
+ do {                                                                                   \
+    ak_uint64 __lo, __hi, __acc, __zero;                                                \
+    __asm__ volatile (                                                                  \
+      "xorl %k[zero], %k[zero]\n\t"                                                     \
+      "movq 0(%[tptr]), %[acc]\n\t"                                                     \
+      code                                                                              \
+      : [lo] "=&r" (__lo), [hi] "=&r" (__hi),                                           \
+        [acc] "=&r" (__acc), [zero] "=&r" (__zero)                                      \
+      : [tptr] "r" (t), [aptr] "r" (a), "d" (m)                                         \
+      : "cc", "memory" );                                                               \
+ } while(0)
+
+ #define ak_mpzn_addmul_row256( t, a, m )                                               \
+   ak_mulx_row( t, a, m,                                                                \
+     ak_mulx_step( 0, 8 ) ak_mulx_step( 8, 16 ) ak_mulx_step( 16, 24 )                  \
+     ak_mulx_step( 24, 32 ) ak_mulx_tail( 32, 40 ))
+
+ #define ak_mpzn_addmul_row512( t, a, m )                                               \
+   ak_mulx_row( t, a, m,                                                                \
+     ak_mulx_step( 0, 8 ) ak_mulx_step( 8, 16 ) ak_mulx_step( 16, 24 )                  \
+     ak_mulx_step( 24, 32 ) ak_mulx_step( 32, 40 ) ak_mulx_step( 40, 48 )               \
+     ak_mulx_step( 48, 56 ) ak_mulx_step( 56, 64 ) ak_mulx_tail( 64, 72 ))
+#else
+ #define ak_mpzn_addmul_row256( t, a, m )                                               \
+ do {                                                                                   \
+    ak_uint64 __c = 0, __m = (m);                                                       \
+    ak_mpzn_mac( __c, (t)[0], __m, (a)[0], (t)[0], __c );                               \
+    ak_mpzn_mac( __c, (t)[1], __m, (a)[1], (t)[1], __c );                               \
+    ak_mpzn_mac( __c, (t)[2], __m, (a)[2], (t)[2], __c );                               \
+    ak_mpzn_mac( __c, (t)[3], __m, (a)[3], (t)[3], __c );                               \
+    (t)[4] += __c; (t)[5] += ( (t)[4] < __c );                                          \
+ } while(0)
+
+ #define ak_mpzn_addmul_row512( t, a, m )                                               \
+ do {                                                                                   \
+    ak_uint64 __c = 0, __m = (m);                                                       \
+    ak_mpzn_mac( __c, (t)[0], __m, (a)[0], (t)[0], __c );                               \
+    ak_mpzn_mac( __c, (t)[1], __m, (a)[1], (t)[1], __c );                               \
+    ak_mpzn_mac( __c, (t)[2], __m, (a)[2], (t)[2], __c );                               \
+    ak_mpzn_mac( __c, (t)[3], __m, (a)[3], (t)[3], __c );                               \
+    ak_mpzn_mac( __c, (t)[4], __m, (a)[4], (t)[4], __c );                               \
+    ak_mpzn_mac( __c, (t)[5], __m, (a)[5], (t)[5], __c );                               \
+    ak_mpzn_mac( __c, (t)[6], __m, (a)[6], (t)[6], __c );                               \
+    ak_mpzn_mac( __c, (t)[7], __m, (a)[7], (t)[7], __c );                               \
+    (t)[8] += __c; (t)[9] += ( (t)[8] < __c );                                          \
+ } while(0)
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Завершающий шаг умножения Монтгомери: вычисление \f$ z = t - p\f$,
+    если \f$ t \geq p \f$, и \f$ z = t \f$ в противном случае.
+
+    Выбор результата производится без ветвлений, значение t[size] содержит
+    старший бит (перенос) вычета t.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_mul_montgomery_final( ak_uint64 *z, ak_uint64 *t,
+                                                               ak_uint64 *p, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 av = 0, bv = 0, cy = 0, mask = 0;
+  ak_uint64 u[ak_mpzn512_size];
+
+  for( i = 0; i < size; i++ ) {
+     av = t[i];
+     bv = av - cy;
+     cy = bv > av;
+     av = bv - p[i];
+     cy += av > bv;
+     u[i] = av;
+  }
+ /* маска равна единицам, только если вычитание привело к заему, а t[size] = 0, т.е. t < p */
+  mask = ( ak_uint64 )0 - ( cy&( t[size]^1 ));
+  for( i = 0; i < size; i++ ) z[i] = ( u[i]&~mask )^( t[i]&mask );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет то же значение, что и функция ak_mpzn_mul_montgomery(), однако
+    оптимизирована для вычетов длины \ref ak_mpzn256_size. Умножение и редукция чередуются
+    (метод FIOS из статьи Koc, Acar, Kaliski), циклы развернуты полностью. При наличии
+    инструкций mulx/adcx/adox процессоров x86-64 используется ассемблерная реализация
+    сложения строк, в противном случае используется тип `unsigned __int128`, либо
+    макрос umul_ppmm.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Левый аргумент опреации умножения
+    @param y Правый аргумент операции умножения
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях (см. описание ak_mpzn_mul_montgomery())
+    @param size Размер модуля в словах; значение параметра не используется и
+    сохраняется для совместимости с типом \ref ak_function_mpzn_mul_montgomery.                    */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_mul_montgomery256( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  ak_uint64 t[2*ak_mpzn256_size+2] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+  (void)size;
+
+  ak_mpzn_addmul_row256( t, y, x[0] );
+  ak_mpzn_addmul_row256( t, p, t[0]*n0 );
+  ak_mpzn_addmul_row256( t+1, y, x[1] );
+  ak_mpzn_addmul_row256( t+1, p, t[1]*n0 );
+  ak_mpzn_addmul_row256( t+2, y, x[2] );
+  ak_mpzn_addmul_row256( t+2, p, t[2]*n0 );
+  ak_mpzn_addmul_row256( t+3, y, x[3] );
+  ak_mpzn_addmul_row256( t+3, p, t[3]*n0 );
+
+  ak_mpzn_mul_montgomery_final( z, t+ak_mpzn256_size, p, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет то же значение, что и функция ak_mpzn_mul_montgomery(), однако
+    оптимизирована для вычетов длины \ref ak_mpzn512_size (см. описание
+    функции ak_mpzn_mul_montgomery256()).
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Левый аргумент опреации умножения
+    @param y Правый аргумент операции умножения
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях (см. описание ak_mpzn_mul_montgomery())
+    @param size Размер модуля в словах; значение параметра не используется.                        */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_mul_montgomery512( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  ak_uint64 t[2*ak_mpzn512_size+2] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+  (void)size;
+
+  ak_mpzn_addmul_row512( t, y, x[0] );
+  ak_mpzn_addmul_row512( t, p, t[0]*n0 );
+  ak_mpzn_addmul_row512( t+1, y, x[1] );
+  ak_mpzn_addmul_row512( t+1, p, t[1]*n0 );
+  ak_mpzn_addmul_row512( t+2, y, x[2] );
+  ak_mpzn_addmul_row512( t+2, p, t[2]*n0 );
+  ak_mpzn_addmul_row512( t+3, y, x[3] );
+  ak_mpzn_addmul_row512( t+3, p, t[3]*n0 );
+  ak_mpzn_addmul_row512( t+4, y, x[4] );
+  ak_mpzn_addmul_row512( t+4, p, t[4]*n0 );
+  ak_mpzn_addmul_row512( t+5, y, x[5] );
+  ak_mpzn_addmul_row512( t+5, p, t[5]*n0 );
+  ak_mpzn_addmul_row512( t+6, y, x[6] );
+  ak_mpzn_addmul_row512( t+6, p, t[6]*n0 );
+  ak_mpzn_addmul_row512( t+7, y, x[7] );
+  ak_mpzn_addmul_row512( t+7, p, t[7]*n0 );
+
+  ak_mpzn_mul_montgomery_final( z, t+ak_mpzn512_size, p, ak_mpzn512_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                 умножение по модулю простых чисел специального вида p = 2^n - c                 */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция приводит по модулю \f$ p = 2^n - c\f$ вычет u длины size+1, старшее
+    слово которого не превосходит \f$ c \f$.
+
+    Используется сравнение \f$ 2^n \equiv c \pmod{p} \f$: старшее слово вычета умножается
+    на \f$ c \f$ и прибавляется к младшим словам. Возникающий перенос повторно заменяется
+    на \f$ c \f$, после чего выполняется однократное вычитание модуля. Все операции
+    выполняются без ветвлений.                                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_pseudo_mersenne_fold( ak_uint64 *z, ak_uint64 *u,
+                                                                 ak_uint64 c, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 hi = 0, lo = 0, cy = 0, mask = 0;
+  ak_uint64 s[ak_mpzn512_size];
+
+ /* u <- u_low + c*u[size]; поскольку u[size] <= c < 2^{32}, то произведение помещается в 128 бит */
+  ak_mpzn_mac( hi, lo, u[size], c, 0, 0 );
+  u[0] += lo; cy = u[0] < lo;
+  u[1] += cy; cy = u[1] < cy;
+  u[1] += hi; cy += u[1] < hi;
+  for( i = 2; i < size; i++ ) { u[i] += cy; cy = u[i] < cy; }
+
+ /* перенос означает, что результат больше 2^n; в этом случае значение u мало и
+    прибавление c не приводит к новому переносу */
+  mask = ( ak_uint64 )0 - cy;
+  lo = c&mask;
+  u[0] += lo; cy = u[0] < lo;
+  for( i = 1; i < size; i++ ) { u[i] += cy; cy = u[i] < cy; }
+
+ /* теперь u < 2^n и u >= p тогда и только тогда, когда u + c >= 2^n */
+  s[0] = u[0] + c; cy = s[0] < c;
+  for( i = 1; i < size; i++ ) { s[i] = u[i] + cy; cy = s[i] < cy; }
+  mask = ( ak_uint64 )0 - cy;
+  for( i = 0; i < size; i++ ) z[i] = ( s[i]&mask )^( u[i]&~mask );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет значение \f$ z \equiv xy \pmod{p} \f$ для модуля \f$ p = 2^{256} - c \f$,
+    где \f$ c < 2^{32} \f$. В отличие от функции ak_mpzn_mul_montgomery256(), вычеты
+    \f$ x, y \f$ и результат \f$ z \f$ хранятся в обычном представлении, а вместо редукции
+    Монтгомери используются две свертки старшей половины произведения с константой
+    \f$ c = 2^{256} - p \f$. Величина \f$ c \f$ определяется по младшему слову модуля.
+
+    Функция имеет тот же интерфейс, что и функция ak_mpzn_mul_montgomery(), что позволяет
+    хранить ее в контексте эллиптической кривой.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Левый аргумент опреации умножения
+    @param y Правый аргумент операции умножения
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Не используется
+    @param size Не используется                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_mul_pseudo_mersenne256( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  ak_uint64 c = ( ak_uint64 )0 - p[0];
+  ak_uint64 t[2*ak_mpzn256_size+2] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+  ak_uint64 u[ak_mpzn256_size+2] = { 0, 0, 0, 0, 0, 0 };
+  (void)n0; (void)size;
+
+ /* вычисляем произведение t <- x*y */
+  ak_mpzn_addmul_row256( t, y, x[0] );
+  ak_mpzn_addmul_row256( t+1, y, x[1] );
+  ak_mpzn_addmul_row256( t+2, y, x[2] );
+  ak_mpzn_addmul_row256( t+3, y, x[3] );
+
+ /* первая свертка: u <- t_low + c*t_high, при этом u[4] <= c */
+  memcpy( u, t, ak_mpzn256_size*sizeof( ak_uint64 ));
+  ak_mpzn_addmul_row256( u, t+ak_mpzn256_size, c );
+
+ /* вторая свертка и окончательное приведение */
+  ak_mpzn_pseudo_mersenne_fold( z, u, c, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет значение \f$ z \equiv xy \pmod{p} \f$ для модуля \f$ p = 2^{512} - c \f$,
+    где \f$ c < 2^{32} \f$ (см. описание функции ak_mpzn_mul_pseudo_mersenne256()).
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Левый аргумент опреации умножения
+    @param y Правый аргумент операции умножения
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Не используется
+    @param size Не используется                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_mul_pseudo_mersenne512( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  ak_uint64 c = ( ak_uint64 )0 - p[0];
+  ak_uint64 t[2*ak_mpzn512_size+2] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+  ak_uint64 u[ak_mpzn512_size+2] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+  (void)n0; (void)size;
+
+  ak_mpzn_addmul_row512( t, y, x[0] );
+  ak_mpzn_addmul_row512( t+1, y, x[1] );
+  ak_mpzn_addmul_row512( t+2, y, x[2] );
+  ak_mpzn_addmul_row512( t+3, y, x[3] );
+  ak_mpzn_addmul_row512( t+4, y, x[4] );
+  ak_mpzn_addmul_row512( t+5, y, x[5] );
+  ak_mpzn_addmul_row512( t+6, y, x[6] );
+  ak_mpzn_addmul_row512( t+7, y, x[7] );
+
+  memcpy( u, t, ak_mpzn512_size*sizeof( ak_uint64 ));
+  ak_mpzn_addmul_row512( u, t+ak_mpzn512_size, c );
+
+  ak_mpzn_pseudo_mersenne_fold( z, u, c, ak_mpzn512_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает значение i-го бита числа k. */
+ #define ak_mpzn_get_bit( k, i ) ((( k )[( i ) >> 6] >> (( i )&0x3f ))&1 )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выбирает оптимизированную функцию умножения Монтгомери и вычисляет
+    значение \f$ r \pmod{p} \f$, то есть единицу в представлении Монтгомери.
+
+    @return Функция возвращает указатель на функцию умножения или NULL,
+    если модуль имеет недопустимое значение.                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_function_mpzn_mul_montgomery *ak_mpzn_modpow_montgomery_init( ak_uint64 *unit,
+                                                                ak_uint64 *p, const size_t size )
+{
+  size_t i = 0;
+  ak_mpznmax t;
+  ak_function_mpzn_mul_montgomery *mul = ak_mpzn_mul_montgomery;
+
+  if( size == ak_mpzn256_size ) mul = ak_mpzn_mul_montgomery256;
+  if( size == ak_mpzn512_size ) mul = ak_mpzn_mul_montgomery512;
+
+ /* модуль должен удовлетворять неравенству p >= r/8 (например, порядок группы точек кривой
+    с кофактором 4), тогда r - p < 7p и для вычисления r (mod p) достаточно
+    не более шести дополнительных вычитаний модуля */
+  if(( p[size-1] >> 61 ) == 0 ) {
+    ak_error_message( ak_error_undefined_value, __func__ , "using an unexpected value of prime modulo" );
+    return NULL;
+  }
+  ak_mpzn_set_ui( unit, size, 0 );
+  ak_mpzn_sub( unit, unit, p, size );
+  for( i = 0; i < 6; i++ )
+     if( ak_mpzn_sub( t, unit, p, size ) == 0 ) ak_mpzn_set( unit, t, size );
+ return mul;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для вычета \f$ x \f$, заданного в представлении Монтгомери в виде \f$ xr \f$, где \f$ r \f$
     заданная степень двойки, вычисляется вычет \f$ z \f$,
@@ -728,6 +1153,18 @@
     Результат \f$ z \f$  является значением вычета \f$ x^k \pmod{p}\f$ в представлении Монтгомери.
     Величины \f$ k \f$  и \f$ p \f$ задаются как обычные вычеты и \f$ p \f$  отлично от нуля.
 
+    Для вычислений используется метод скользящего окна: заранее вычисляются нечетные степени
+    \f$ x, x^3, \ldots, x^{2^w-1}\f$, где ширина окна \f$ w \f$ равна 4 для 256-ти битных
+    и 5 для 512-ти битных вычетов. Это сокращает количество умножений примерно в \f$ w \f$ раз
+    по сравнению с бинарным методом, однако время работы функции зависит от значения
+    степени \f$ k \f$. Для секретных значений степени следует использовать
+    функцию ak_mpzn_modpow_montgomery_fixed_window().
+
+    Модуль должен удовлетворять неравенству \f$ p \geq r/8 \f$, то есть хотя бы один
+    из трех старших битов модуля должен быть равен единице; этому условию удовлетворяют
+    модули и порядки подгрупп всех поддерживаемых эллиптических кривых. Для других модулей
+    функция помещает в журнал сообщение об ошибке и завершается, не изменяя значение \f$ z \f$.
+
     @param z Вычет, в который помещается результат
     @param x Вычет, который возводится в степень \f$ k \f$
     @param k Степень, в которую возводится вычет \f$ x \f$
@@ -740,31 +1177,505 @@
  void ak_mpzn_modpow_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *k,
                                                    ak_uint64 *p, ak_uint64 n0, const size_t size )
 {
-  ak_uint64 uk = 0;
-  size_t s = size-1;
-  long long int i, j;
-  ak_mpznmax res = ak_mpznmax_zero; // это константа r (mod p) = r-p
-  if( ak_mpzn_sub( res, res, p, size ) == 0 ) {
-    ak_error_message( ak_error_undefined_value,
-                                          "using an unexpected value of prime modulo", __func__ );
-    return;
+  bool_t started = ak_false;
+  long long int i, j, l;
+  size_t val = 0, width = ( size > ak_mpzn256_size ) ? 5 : 4;
+  ak_mpznmax res, sqr, table[16];
+  ak_function_mpzn_mul_montgomery *mul = NULL;
+
+  if(( mul = ak_mpzn_modpow_montgomery_init( res, p, size )) == NULL ) return;
+
+ /* таблица нечетных степеней: table[i] = x^{2i+1} */
+  ak_mpzn_set( table[0], x, size );
+  mul( sqr, x, x, p, n0, size );
+  for( i = 1; i < ( 1 << ( width-1 )); i++ ) mul( table[i], table[i-1], sqr, p, n0, size );
+
+  i = 64*size - 1;
+  while( i >= 0 ) {
+    /* нулевые биты требуют только возведения в квадрат */
+     if( ak_mpzn_get_bit( k, i ) == 0 ) {
+       if( started ) mul( res, res, res, p, n0, size );
+       i--;
+       continue;
+     }
+    /* окно заканчивается на младшем единичном бите из не более чем width бит */
+     j = i - ( long long int )width + 1;
+     if( j < 0 ) j = 0;
+     while( ak_mpzn_get_bit( k, j ) == 0 ) j++;
+     for( l = i, val = 0; l >= j; l-- ) val = ( val << 1 )^ak_mpzn_get_bit( k, l );
+
+     if( started ) {
+       for( l = i; l >= j; l-- ) mul( res, res, res, p, n0, size );
+       mul( res, res, table[val >> 1], p, n0, size );
+     } else {
+         ak_mpzn_set( res, table[val >> 1], size );
+         started = ak_true;
+       }
+     i = j - 1;
   }
-  while( k[s] == 0 ) {
-     if( s > 0 ) --s;
-      else {
-             ak_mpzn_set( z, res, size );
-             return;
-           }
-  }
-  for( i = s; i >= 0; i-- ) {
-     uk = k[i];
-     for( j = 0; j < 64; j++ ) {
-        ak_mpzn_mul_montgomery( res, res, res, p, n0, size );
-        if( uk&0x8000000000000000LL ) ak_mpzn_mul_montgomery( res, res, x, p, n0, size );
-        uk <<= 1;
+  memcpy( z, res, size*sizeof( ak_uint64 ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет то же значение, что и функция ak_mpzn_modpow_montgomery(),
+    то есть вычет \f$z \equiv (x^k)r \pmod{p}\f$, однако последовательность выполняемых операций
+    и обращений к памяти не зависит от значения степени \f$ k \f$.
+
+    Используется метод фиксированного окна шириной 4 бита: заранее вычисляются
+    степени \f$ x^0, x^1, \ldots, x^{15} \f$, затем для каждой тетрады степени \f$ k \f$
+    (начиная со старшей) выполняются четыре возведения в квадрат и одно умножение
+    на элемент таблицы. Элемент таблицы выбирается с помощью масок после просмотра
+    всех ее элементов, что исключает зависимость времени доступа к памяти от значения тетрады.
+
+    К модулю \f$ p \f$ предъявляются те же требования, что и в функции
+    ak_mpzn_modpow_montgomery(): при \f$ p < r/8 \f$ значение \f$ z \f$ не изменяется.
+
+    @param z Вычет, в который помещается результат
+    @param x Вычет, который возводится в степень \f$ k \f$
+    @param k Степень, в которую возводится вычет \f$ x \f$
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях.
+    @param size Размер модуля в словах                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_modpow_montgomery_fixed_window( ak_uint64 *z, ak_uint64 *x, ak_uint64 *k,
+                                                   ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  size_t i, j, l;
+  ak_uint64 nibble, mask;
+  ak_mpznmax res, sel, table[16];
+  ak_function_mpzn_mul_montgomery *mul = NULL;
+
+  if(( mul = ak_mpzn_modpow_montgomery_init( table[0], p, size )) == NULL ) return;
+
+ /* таблица степеней: table[i] = x^i */
+  ak_mpzn_set( table[1], x, size );
+  for( i = 2; i < 16; i++ ) mul( table[i], table[i-1], x, p, n0, size );
+
+  ak_mpzn_set( res, table[0], size );
+  for( i = 16*size; i > 0; i-- ) {
+     nibble = ( k[( i-1 ) >> 4] >> ((( i-1 )&0xf ) << 2 ))&0xf;
+     for( j = 0; j < 4; j++ ) mul( res, res, res, p, n0, size );
+
+    /* выбираем table[nibble], просматривая всю таблицу */
+     memset( sel, 0, size*sizeof( ak_uint64 ));
+     for( j = 0; j < 16; j++ ) {
+        mask = (( nibble ^ j ) - 1 ) >> 63;
+        mask = ( ak_uint64 )0 - mask;
+        for( l = 0; l < size; l++ ) sel[l] |= table[j][l]&mask;
      }
+     mul( res, res, sel, p, n0, size );
   }
   memcpy( z, res, size*sizeof( ak_uint64 ));
+  memset( sel, 0, sizeof( sel ));
+  memset( table, 0, sizeof( table ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                      функции вычисления обратных вычетов по простому модулю                     */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество 30-ти битных знаковых разрядов, используемых для представления вычета,
+    длина которого равна size 64-х битным словам. */
+ #define ak_mpzn_s30_size( size ) ( (( size )*64 )/30 + 1 )
+/*! \brief Максимальное количество 30-ти битных разрядов, используемых алгоритмом safegcd. */
+ #define ak_mpzn_s30_max_size ( ak_mpzn_s30_size( ak_mpzn512_size ))
+/*! \brief Маска младших 30-ти бит. */
+ #define ak_mpzn_s30_mask ( (ak_int32) 0x3fffffff )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Матрица перехода, вычисляемая для 30 последовательных шагов алгоритма safegcd. */
+ typedef struct {
+  /*! \brief Элементы матрицы, вычисляющие новое значение f. */
+   ak_int32 u, v;
+  /*! \brief Элементы матрицы, вычисляющие новое значение g. */
+   ak_int32 q, r;
+} ak_mpzn_s30_matrix;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Перевод вычета из обычного представления в представление 30-ти битными разрядами. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_to_s30( ak_int32 *r, ak_uint64 *x, const size_t size )
+{
+  size_t i, bit, idx, off;
+  ak_uint64 val;
+
+  for( i = 0; i < ak_mpzn_s30_size( size ); i++ ) {
+     bit = 30*i; idx = bit >> 6; off = bit&0x3f;
+     val = 0;
+     if( idx < size ) val = x[idx] >> off;
+     if(( off > 34 ) && ( idx+1 < size )) val ^= x[idx+1] << ( 64 - off );
+     r[i] = ( ak_int32 )( val&ak_mpzn_s30_mask );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Перевод неотрицательного вычета, представленного 30-ти битными разрядами,
+    в обычное представление. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_from_s30( ak_uint64 *z, ak_int32 *r, const size_t size )
+{
+  size_t i, bit, idx, off;
+
+  memset( z, 0, size*sizeof( ak_uint64 ));
+  for( i = 0; i < ak_mpzn_s30_size( size ); i++ ) {
+     bit = 30*i; idx = bit >> 6; off = bit&0x3f;
+     if( idx < size ) z[idx] ^= (( ak_uint64 ) r[i] ) << off;
+     if(( off > 34 ) && ( idx+1 < size )) z[idx+1] ^= (( ak_uint64 ) r[i] ) >> ( 64 - off );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выполняет 30 шагов (divstep) алгоритма Бернштейна-Янга над младшими словами
+    величин f и g и вычисляет матрицу перехода.
+
+    Все ветвления алгоритма заменены операциями с масками, поэтому время работы функции
+    не зависит от обрабатываемых значений.
+
+    @param eta Величина \f$ -\delta \f$ алгоритма Бернштейна-Янга
+    @param f0 Младшие 30 бит величины f
+    @param g0 Младшие 30 бит величины g
+    @param t Матрица перехода, удовлетворяющая равенству \f$ 2^{30}(f', g') = t(f, g)\f$
+    @return Новое значение величины eta.                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_int32 ak_mpzn_s30_divsteps( ak_int32 eta,
+                                         ak_uint32 f0, ak_uint32 g0, ak_mpzn_s30_matrix *t )
+{
+  int i = 0;
+  ak_uint32 u = 1, v = 0, q = 0, r = 1, f = f0, g = g0, c1, c2, x, y, z;
+
+  for( i = 0; i < 30; i++ ) {
+    /* c1 = -1, если delta > 0, и c2 = -1, если g нечетно */
+     c1 = ( ak_uint32 )( eta >> 31 );
+     c2 = ( ak_uint32 )0 - ( g&1 );
+     x = ( f ^ c1 ) - c1;
+     y = ( u ^ c1 ) - c1;
+     z = ( v ^ c1 ) - c1;
+    /* g <- g -/+ f в случае нечетного g */
+     g += x&c2;
+     q += y&c2;
+     r += z&c2;
+    /* меняем местами f и g в случае delta > 0 и нечетного g */
+     c1 &= c2;
+     eta = ( ak_int32 )(( ak_uint32 )eta ^ c1 ) - ( ak_int32 )( c1 + 1 );
+     f += g&c1;
+     u += q&c1;
+     v += r&c1;
+    /* делим g на два */
+     g >>= 1;
+     u <<= 1;
+     v <<= 1;
+  }
+  t->u = ( ak_int32 )u; t->v = ( ak_int32 )v;
+  t->q = ( ak_int32 )q; t->r = ( ak_int32 )r;
+ return eta;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет \f$ (d, e) \leftarrow t(d, e)/2^{30} \pmod{p} \f$.
+
+    Перед делением к каждой из величин добавляется кратное модуля, обнуляющее младшие 30 бит.
+    Величины \f$ d, e \f$ остаются в интервале \f$ (-2p, p) \f$.                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_s30_update_de( ak_int32 *d, ak_int32 *e, ak_mpzn_s30_matrix *t,
+                                                ak_int32 *p, ak_uint32 pinv, const size_t len )
+{
+  size_t i = 0;
+  ak_int32 di, ei, md, me, sd, se;
+  ak_int64 cd, ce;
+
+ /* если d (или e) отрицательно, то добавляем к результату модуль, умноженный на (u, q) (или (v, r)) */
+  sd = d[len-1] >> 31;
+  se = e[len-1] >> 31;
+  md = ( t->u&sd ) + ( t->v&se );
+  me = ( t->q&sd ) + ( t->r&se );
+
+  di = d[0]; ei = e[0];
+  cd = ( ak_int64 )t->u*di + ( ak_int64 )t->v*ei;
+  ce = ( ak_int64 )t->q*di + ( ak_int64 )t->r*ei;
+
+ /* корректируем md, me так, чтобы младшие 30 бит результата были равны нулю */
+  md -= ( ak_int32 )(( pinv*( ak_uint32 )cd + ( ak_uint32 )md )&ak_mpzn_s30_mask );
+  me -= ( ak_int32 )(( pinv*( ak_uint32 )ce + ( ak_uint32 )me )&ak_mpzn_s30_mask );
+  cd += ( ak_int64 )p[0]*md;
+  ce += ( ak_int64 )p[0]*me;
+  cd >>= 30;
+  ce >>= 30;
+
+  for( i = 1; i < len; i++ ) {
+     di = d[i]; ei = e[i];
+     cd += ( ak_int64 )t->u*di + ( ak_int64 )t->v*ei + ( ak_int64 )p[i]*md;
+     ce += ( ak_int64 )t->q*di + ( ak_int64 )t->r*ei + ( ak_int64 )p[i]*me;
+     d[i-1] = ( ak_int32 )cd&ak_mpzn_s30_mask; cd >>= 30;
+     e[i-1] = ( ak_int32 )ce&ak_mpzn_s30_mask; ce >>= 30;
+  }
+  d[len-1] = ( ak_int32 )cd;
+  e[len-1] = ( ak_int32 )ce;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет \f$ (f, g) \leftarrow t(f, g)/2^{30} \f$ (деление выполняется нацело). */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_s30_update_fg( ak_int32 *f, ak_int32 *g,
+                                                      ak_mpzn_s30_matrix *t, const size_t len )
+{
+  size_t i = 0;
+  ak_int32 fi, gi;
+  ak_int64 cf, cg;
+
+  fi = f[0]; gi = g[0];
+  cf = ( ak_int64 )t->u*fi + ( ak_int64 )t->v*gi;
+  cg = ( ak_int64 )t->q*fi + ( ak_int64 )t->r*gi;
+  cf >>= 30;
+  cg >>= 30;
+
+  for( i = 1; i < len; i++ ) {
+     fi = f[i]; gi = g[i];
+     cf += ( ak_int64 )t->u*fi + ( ak_int64 )t->v*gi;
+     cg += ( ak_int64 )t->q*fi + ( ak_int64 )t->r*gi;
+     f[i-1] = ( ak_int32 )cf&ak_mpzn_s30_mask; cf >>= 30;
+     g[i-1] = ( ak_int32 )cg&ak_mpzn_s30_mask; cg >>= 30;
+  }
+  f[len-1] = ( ak_int32 )cf;
+  g[len-1] = ( ak_int32 )cg;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция распространяет переносы между 30-ти битными разрядами. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_s30_carry( ak_int32 *d, const size_t len )
+{
+  size_t i = 0;
+  for( i = 0; i < len-1; i++ ) {
+     d[i+1] += d[i] >> 30;
+     d[i] &= ak_mpzn_s30_mask;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Завершающий шаг алгоритма safegcd: проверка равенства \f$ f = \pm 1 \f$ и
+    приведение величины \f$ d \in (-2p, p) \f$ к интервалу \f$ [0, p) \f$ с учетом знака \f$ f \f$.
+
+    @return Функция возвращает \ref ak_error_ok, если \f$ f = \pm 1 \f$, и
+    \ref ak_error_undefined_value в противном случае.                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_mpzn_s30_finalize( ak_uint64 *z, ak_int32 *d, ak_int32 *f,
+                                                               ak_int32 *m, const size_t size )
+{
+  size_t i = 0;
+  ak_uint32 one = 0, mone = 0;
+  ak_int32 sign = 0, cond = 0;
+  const size_t len = ak_mpzn_s30_size( size );
+
+  sign = f[len-1] >> 31;
+  for( i = 0; i < len; i++ ) {
+     one |= ( ak_uint32 )( f[i] ^ ( i == 0 ? 1 : 0 ));
+     mone |= ( ak_uint32 )( f[i] ^ ( i == len-1 ? -1 : ak_mpzn_s30_mask ));
+  }
+
+ /* приводим d к интервалу [0, p) */
+  cond = d[len-1] >> 31;
+  for( i = 0; i < len; i++ ) d[i] += m[i]&cond;
+  for( i = 0; i < len; i++ ) d[i] = ( d[i] ^ sign ) - sign;
+  ak_mpzn_s30_carry( d, len );
+  cond = d[len-1] >> 31;
+  for( i = 0; i < len; i++ ) d[i] += m[i]&cond;
+  ak_mpzn_s30_carry( d, len );
+
+  ak_mpzn_from_s30( z, d, size );
+  if( one && mone ) return ak_error_undefined_value;
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет вычет \f$ z \f$, удовлетворяющий сравнению \f$ xz \equiv 1 \pmod{p}\f$,
+    с помощью алгоритма safegcd, предложенного Д. Бернштейном и Б. Янгом
+    (D.J. Bernstein, B.-Y. Yang, Fast constant-time gcd computation and modular inversion, 2019).
+
+    Вычет \f$ x \f$ и модуль \f$ p \f$ задаются в обычном представлении, модуль должен быть
+    нечетным, а вычет \f$ x \f$ удовлетворять неравенству \f$ 0 \leq x < p \f$.
+    Количество выполняемых итераций алгоритма зависит только от длины модуля и
+    выбирается равным оценке \f$ \lceil (49d+57)/17 \rceil \f$, где \f$ d \f$ длина модуля в битах.
+    Поскольку алгоритм не содержит ветвлений, зависящих от значения \f$ x \f$,
+    функция может использоваться для обращения секретных значений.
+
+    Для вычета \f$ xr \f$, заданного в представлении Монтгомери, результат работы функции
+    равен \f$ x^{-1}r^{-1} \f$; для перехода к представлению Монтгомери его следует
+    дважды домножить на величину \f$ r^2 \pmod{p}\f$.
+
+    @param z Вычет, в который помещается результат
+    @param x Обращаемый вычет
+    @param p Нечетный модуль, по которому производятся вычисления
+    @param size Размер модуля в словах (значение не должно превышать \ref ak_mpzn512_size )
+
+    @return В случае успеха функция возвращает \ref ak_error_ok. Если вычет \f$ x \f$
+    необратим, то возвращается \ref ak_error_undefined_value.                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_mpzn_inverse_safegcd( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p, const size_t size )
+{
+  int error = ak_error_ok;
+  size_t i = 0, count = 0;
+  ak_uint32 pinv = 0;
+  ak_int32 eta = -1;
+  ak_mpzn_s30_matrix t;
+  ak_int32 d[ak_mpzn_s30_max_size], e[ak_mpzn_s30_max_size],
+           f[ak_mpzn_s30_max_size], g[ak_mpzn_s30_max_size], m[ak_mpzn_s30_max_size];
+  const size_t len = ak_mpzn_s30_size( size );
+
+  if(( !size ) || ( size > ak_mpzn512_size ))
+    return ak_error_message( ak_error_wrong_length, __func__ , "using modulo with wrong length" );
+  if(( p[0]&1 ) == 0 )
+    return ak_error_message( ak_error_undefined_value, __func__ , "using an even modulo" );
+
+ /* обратный к модулю элемент по модулю 2^{30}, метод Ньютона */
+  pinv = ( ak_uint32 )p[0];
+  for( i = 0; i < 4; i++ ) pinv *= 2 - ( ak_uint32 )p[0]*pinv;
+
+  ak_mpzn_to_s30( m, p, size );
+  ak_mpzn_to_s30( f, p, size );
+  ak_mpzn_to_s30( g, x, size );
+  memset( d, 0, sizeof( d ));
+  memset( e, 0, sizeof( e ));
+  e[0] = 1;
+
+ /* количество итераций зависит только от длины модуля */
+  count = ( 49*64*size + 57 + 16 )/17;
+  for( i = 0; i < count; i += 30 ) {
+     eta = ak_mpzn_s30_divsteps( eta, ( ak_uint32 )f[0], ( ak_uint32 )g[0], &t );
+     ak_mpzn_s30_update_de( d, e, &t, m, pinv, len );
+     ak_mpzn_s30_update_fg( f, g, &t, len );
+  }
+
+ /* по завершении алгоритма g = 0, f = \pm НОД(x,p), d = x^{-1}f (mod p) */
+  error = ak_mpzn_s30_finalize( z, d, f, m, size );
+  memset( d, 0, sizeof( d ));
+  memset( e, 0, sizeof( e ));
+  memset( f, 0, sizeof( f ));
+  memset( g, 0, sizeof( g ));
+
+  if( error != ak_error_ok ) return ak_error_message( error, __func__ ,
+                                                             "using a non invertible value" );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает количество младших нулевых бит ненулевого 32-х битного слова. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline int ak_mpzn_ctz32( ak_uint32 w )
+{
+#ifdef __GNUC__
+  return __builtin_ctz( w );
+#else
+  int k = 0;
+  while(( w&1 ) == 0 ) { w >>= 1; k++; }
+ return k;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выполняет 30 шагов бинарного алгоритма над младшими словами величин f и g
+    и вычисляет матрицу перехода; время работы функции зависит от обрабатываемых значений.
+
+    В отличие от функции ak_mpzn_s30_divsteps(), серии делений g на два выполняются
+    за одну операцию сдвига, а при сложении g с кратным f обнуляются сразу несколько
+    (до восьми) младших бит величины g.                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_int32 ak_mpzn_s30_divsteps_var( ak_int32 eta,
+                                         ak_uint32 f0, ak_uint32 g0, ak_mpzn_s30_matrix *t )
+{
+  int i = 30, limit, zeros;
+  ak_uint32 u = 1, v = 0, q = 0, r = 1, f = f0, g = g0, m, w, finv, tmp;
+
+  for( ;; ) {
+    /* выполняем сразу все деления g на два (старший бит-ограничитель не дает выйти за i шагов) */
+     zeros = ak_mpzn_ctz32( g | ( 0xffffffffU << i ));
+     g >>= zeros;
+     u <<= zeros;
+     v <<= zeros;
+     eta -= zeros;
+     i -= zeros;
+     if( i == 0 ) break;
+
+    /* f и g нечетны; если delta > 0, то заменяем (f, g) на (g, -f) */
+     if( eta < 0 ) {
+       eta = -eta;
+       tmp = f; f = g; g = 0 - tmp;
+       tmp = u; u = q; q = 0 - tmp;
+       tmp = v; v = r; r = 0 - tmp;
+     }
+
+    /* обнуляем не более min(eta+1, i, 8) младших бит g, добавляя к g кратное f */
+     limit = ( eta + 1 ) > i ? i : ( eta + 1 );
+     m = ( 0xffffffffU >> ( 32 - limit ))&0xff;
+     finv = f * ( 2 - f*f );
+     finv *= 2 - f*finv;
+     w = (( 0 - g )*finv )&m;
+     g += f*w;
+     q += u*w;
+     r += v*w;
+  }
+  t->u = ( ak_int32 )u; t->v = ( ak_int32 )v;
+  t->q = ( ak_int32 )q; t->r = ( ak_int32 )r;
+ return eta;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет вычет \f$ z \f$, удовлетворяющий сравнению \f$ xz \equiv 1 \pmod{p}\f$,
+    с помощью бинарного расширенного алгоритма Евклида, в котором шаги алгоритма
+    группируются по 30 и применяются к вычетам в виде матриц перехода
+    (так же, как в функции ak_mpzn_inverse_safegcd()). Вычисления завершаются сразу после
+    обнуления величины \f$ g \f$, а не по исчерпании оценки количества шагов.
+
+    Вычет \f$ x \f$ и модуль \f$ p \f$ задаются в обычном представлении, модуль должен быть
+    нечетным, а вычет \f$ x \f$ удовлетворять неравенству \f$ 0 \leq x < p \f$.
+
+    \b Внимание! Время работы функции зависит от значения \f$ x \f$, поэтому функция должна
+    использоваться только для обращения открытых данных (например, при проверке электронной подписи).
+    Для обращения секретных значений следует использовать функцию ak_mpzn_inverse_safegcd().
+
+    @param z Вычет, в который помещается результат
+    @param x Обращаемый вычет
+    @param p Нечетный модуль, по которому производятся вычисления
+    @param size Размер модуля в словах (значение не должно превышать \ref ak_mpzn512_size )
+
+    @return В случае успеха функция возвращает \ref ak_error_ok. Если вычет \f$ x \f$
+    необратим, то возвращается \ref ak_error_undefined_value.                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_mpzn_inverse_binary( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p, const size_t size )
+{
+  int error = ak_error_ok;
+  size_t i = 0;
+  ak_uint32 pinv = 0, nonzero = 0;
+  ak_int32 eta = -1;
+  ak_mpzn_s30_matrix t;
+  ak_int32 d[ak_mpzn_s30_max_size], e[ak_mpzn_s30_max_size],
+           f[ak_mpzn_s30_max_size], g[ak_mpzn_s30_max_size], m[ak_mpzn_s30_max_size];
+  const size_t len = ak_mpzn_s30_size( size );
+
+  if(( !size ) || ( size > ak_mpzn512_size ))
+    return ak_error_message( ak_error_wrong_length, __func__ , "using modulo with wrong length" );
+  if(( p[0]&1 ) == 0 )
+    return ak_error_message( ak_error_undefined_value, __func__ , "using an even modulo" );
+
+  pinv = ( ak_uint32 )p[0];
+  for( i = 0; i < 4; i++ ) pinv *= 2 - ( ak_uint32 )p[0]*pinv;
+
+  ak_mpzn_to_s30( m, p, size );
+  ak_mpzn_to_s30( f, p, size );
+  ak_mpzn_to_s30( g, x, size );
+  memset( d, 0, sizeof( d ));
+  memset( e, 0, sizeof( e ));
+  e[0] = 1;
+
+  do{
+     eta = ak_mpzn_s30_divsteps_var( eta, ( ak_uint32 )f[0], ( ak_uint32 )g[0], &t );
+     ak_mpzn_s30_update_de( d, e, &t, m, pinv, len );
+     ak_mpzn_s30_update_fg( f, g, &t, len );
+     for( i = 0, nonzero = 0; i < len; i++ ) nonzero |= ( ak_uint32 )g[i];
+  } while( nonzero );
+
+  if(( error = ak_mpzn_s30_finalize( z, d, f, m, size )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "using a non invertible value" );
+ return ak_error_ok;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
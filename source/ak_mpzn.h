@@ -35,6 +35,11 @@
 /*! \brief Тип данных для хранения максимально возможного большого числа. */
  typedef ak_uint64 ak_mpznmax[ ak_mpznmax_size ];
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция умножения двух вычетов в представлении Монтгомери. */
+ typedef void ( ak_function_mpzn_mul_montgomery )( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                          ak_uint64 *, ak_uint64, const size_t );
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Присвоение вычету другого вычета. */
  void ak_mpzn_set( ak_uint64 *, ak_uint64 * , const size_t );
@@ -70,6 +75,8 @@
  void ak_mpzn_mul( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
 /*! \brief Вычисление остатка от деления одного вычета на другой */
  void ak_mpzn_rem( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
+/*! \brief Вычисление остатка от деления вычета двойной длины с помощью алгоритма Барретта */
+ void ak_mpzn_rem_barrett( ak_uint64 *, ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Сложение двух вычетов в представлении Монтгомери. */
@@ -79,9 +86,29 @@
 /*! \brief Умножение двух вычетов в представлении Монтгомери. */
  void ak_mpzn_mul_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *,
                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Умножение двух 256-ти битных вычетов в представлении Монтгомери. */
+ void ak_mpzn_mul_montgomery256( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                          ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Умножение двух 512-ти битных вычетов в представлении Монтгомери. */
+ void ak_mpzn_mul_montgomery512( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                          ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Умножение двух 256-ти битных вычетов по модулю \f$ 2^{256} - c \f$. */
+ void ak_mpzn_mul_pseudo_mersenne256( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                          ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Умножение двух 512-ти битных вычетов по модулю \f$ 2^{512} - c \f$. */
+ void ak_mpzn_mul_pseudo_mersenne512( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                          ak_uint64 *, ak_uint64, const size_t );
 /*! \brief Модульное возведение в степень в представлении Монтгомери. */
  void ak_mpzn_modpow_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *,
                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Модульное возведение в степень в представлении Монтгомери за время,
+    не зависящее от значения степени. */
+ void ak_mpzn_modpow_montgomery_fixed_window( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                          ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Вычисление обратного вычета по нечетному модулю за время, не зависящее от значения вычета. */
+ int ak_mpzn_inverse_safegcd( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
+/*! \brief Вычисление обратного вычета с помощью бинарного расширенного алгоритма Евклида. */
+ int ak_mpzn_inverse_binary( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef LIBAKRYPT_HAVE_GMP_H
 /*! \brief Преобразование ak_mpznxxx в mpz_t. */
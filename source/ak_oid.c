@@ -10,6 +10,10 @@
 #else
  #error Library cannot be compiled without string.h header
 #endif
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+ #include <stddef.h>
 #ifdef LIBAKRYPT_CRYPTO_FUNCTIONS
  #include <ak_mac.h>
  #include <ak_mgm.h>
@@ -40,6 +44,11 @@
                                     { ( ak_function_void *) ak_random_context_create_urandom,
                                       ( ak_function_void *) ak_random_context_destroy,
                                       ( ak_function_void *) ak_random_context_delete, NULL, NULL }},
+
+   { random_generator, algorithm, "getrandom", "1.2.643.2.52.1.1.7", NULL, NULL,
+                                    { ( ak_function_void *) ak_random_context_create_getrandom,
+                                      ( ak_function_void *) ak_random_context_destroy,
+                                      ( ak_function_void *) ak_random_context_delete, NULL, NULL }},
   #endif
   #ifdef _WIN32
    { random_generator, algorithm, "winrtl", "1.2.643.2.52.1.1.4", NULL, NULL,
@@ -64,6 +73,16 @@
                                       ( ak_function_void *) ak_random_context_destroy,
                                       ( ak_function_void *) ak_random_context_delete, NULL, NULL }},
 
+   { random_generator, algorithm, "ctr-kuznechik", "1.2.643.2.52.1.1.8.1", NULL, NULL,
+                       { ( ak_function_void *) ak_random_context_create_ctr_kuznechik,
+                                      ( ak_function_void *) ak_random_context_destroy,
+                                      ( ak_function_void *) ak_random_context_delete, NULL, NULL }},
+
+   { random_generator, algorithm, "ctr-magma", "1.2.643.2.52.1.1.8.2", NULL, NULL,
+                       { ( ak_function_void *) ak_random_context_create_ctr_magma,
+                                      ( ak_function_void *) ak_random_context_destroy,
+                                      ( ak_function_void *) ak_random_context_delete, NULL, NULL }},
+
   /* 2. идентификаторы алгоритмов бесключевого хеширования,
         значения OID взяты из перечней КриптоПро и ТК26 (http://tk26.ru/methods/OID_TK_26/index.php)
         в дереве библиотеки: 1.2.643.2.52.1.2 - функции бесключевого хеширования */
@@ -470,6 +489,116 @@
 
 /* ----------------------------------------------------------------------------------------------- */
 /*                          поиск OID - функции внутреннего интерфейса                             */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество элементов массива libakrypt_oids (с учетом завершающего элемента). */
+ #define ak_oid_index_size ( sizeof( libakrypt_oids )/( sizeof( struct oid )))
+
+/*! \brief Индекс, ускоряющий поиск OID.
+
+    \details Индекс содержит номера элементов массива libakrypt_oids, упорядоченные
+    по именам и идентификаторам (поиск выполняется методом деления пополам), а также
+    списки элементов с одинаковым типом криптографического механизма.
+    Поскольку состав массива зависит от параметров сборки библиотеки, индекс
+    строится один раз при первом поиске.                                                           */
+ static struct oid_index {
+  /*! \brief номера элементов, упорядоченные по именам */
+   size_t names[ak_oid_index_size];
+  /*! \brief номера элементов, упорядоченные по идентификаторам */
+   size_t ids[ak_oid_index_size];
+  /*! \brief номер следующего элемента с тем же типом механизма
+      (количество OID, если такого элемента нет) */
+   size_t next[ak_oid_index_size];
+  /*! \brief номер первого элемента для каждого типа механизма */
+   size_t first[undefined_engine+1];
+ } ak_oid_index;
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+/*! \brief Флаг однократного построения индекса. */
+ static pthread_once_t ak_oid_index_once = PTHREAD_ONCE_INIT;
+#else
+/*! \brief Флаг построения индекса. */
+ static bool_t ak_oid_index_ready = ak_false;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция упорядочивает номера элементов по значению строки, смещение которой
+    в структуре oid задается параметром offset. Используется устойчивая сортировка вставками,
+    поэтому при совпадении строк сохраняется порядок элементов в массиве libakrypt_oids.           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_oid_index_sort( size_t *index, const size_t offset )
+{
+  size_t i, j, value, count = ak_libakrypt_oids_count();
+  #define ak_oid_index_key( idx ) ( *( char ** )(( char * )&libakrypt_oids[idx] + offset ))
+
+  for( i = 0; i < count; i++ ) {
+     value = i;
+     for( j = i; ( j > 0 ) &&
+                 ( strcmp( ak_oid_index_key( index[j-1] ), ak_oid_index_key( value )) > 0 ); j-- )
+        index[j] = index[j-1];
+     index[j] = value;
+  }
+  #undef ak_oid_index_key
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция строит индекс массива libakrypt_oids.                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_oid_index_create( void )
+{
+  size_t idx, count = ak_libakrypt_oids_count(), last[undefined_engine+1];
+
+  ak_oid_index_sort( ak_oid_index.names, offsetof( struct oid, name ));
+  ak_oid_index_sort( ak_oid_index.ids, offsetof( struct oid, id ));
+
+  for( idx = 0; idx <= undefined_engine; idx++ ) ak_oid_index.first[idx] = last[idx] = count;
+  for( idx = 0; idx < count; idx++ ) {
+     oid_engines_t engine = libakrypt_oids[idx].engine;
+     ak_oid_index.next[idx] = count;
+     if( ak_oid_index.first[engine] == count ) ak_oid_index.first[engine] = idx;
+      else ak_oid_index.next[last[engine]] = idx;
+     last[engine] = idx;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает построенный индекс массива libakrypt_oids.                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline struct oid_index *ak_oid_index_get( void )
+{
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_once( &ak_oid_index_once, ak_oid_index_create );
+#else
+  if( !ak_oid_index_ready ) {
+    ak_oid_index_create();
+    ak_oid_index_ready = ak_true;
+  }
+#endif
+ return &ak_oid_index;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выполняет поиск строки value в упорядоченном индексе методом деления пополам.
+    \return Номер первого (в массиве libakrypt_oids) элемента с заданным значением строки
+    или количество OID, если такой элемент не найден.                                              */
+/* ----------------------------------------------------------------------------------------------- */
+ static size_t ak_oid_index_search( const size_t *index, const size_t offset, const char *value )
+{
+  int cmp = 0;
+  size_t left = 0, right = ak_libakrypt_oids_count(), middle;
+
+ /* ищем первый элемент, не меньший value */
+  while( left < right ) {
+     middle = left + ( right - left )/2;
+     cmp = strcmp( *( char ** )(( char * )&libakrypt_oids[index[middle]] + offset ), value );
+     if( cmp < 0 ) left = middle + 1;
+      else right = middle;
+  }
+  if(( left < ak_libakrypt_oids_count( )) &&
+     ( strcmp( *( char ** )(( char * )&libakrypt_oids[index[left]] + offset ), value ) == 0 ))
+    return index[left];
+ return ak_libakrypt_oids_count();
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param name строка, содержащая символьное (человекочитаемое) имя криптографического механизма
     или параметра.
@@ -478,20 +607,17 @@
 /* ----------------------------------------------------------------------------------------------- */
  ak_oid ak_oid_context_find_by_name( const char *name )
 {
-  size_t len = 0, idx = 0;
+  size_t idx = 0;
 
  /* надо ли стартовать */
   if( name == NULL ) {
     ak_error_message( ak_error_null_pointer, __func__, "using null pointer to oid name" );
     return NULL;
   }
- /* перебор по всем возможным значениям */
-  do{
-     if(( strlen( name ) == ( len = strlen( libakrypt_oids[idx].name ))) &&
-                 ak_ptr_is_equal( name, libakrypt_oids[idx].name, len ))
-       return  &libakrypt_oids[idx];
-
-  } while( ++idx < ak_libakrypt_oids_count( ));
+ /* поиск в упорядоченном индексе */
+  if(( idx = ak_oid_index_search( ak_oid_index_get()->names,
+                          offsetof( struct oid, name ), name )) < ak_libakrypt_oids_count( ))
+    return &libakrypt_oids[idx];
 
   //ak_error_message_fmt( ak_error_oid_id, __func__, "searching oid with wrong name \"%s\"", name );
   ak_error_set_value( ak_error_oid_id );
@@ -506,19 +632,15 @@
 /* ----------------------------------------------------------------------------------------------- */
  ak_oid ak_oid_context_find_by_id( const char *id )
 {
-  size_t len = 0, idx = 0;
+  size_t idx = 0;
   if( id == NULL ) {
     ak_error_message( ak_error_null_pointer, __func__, "using null pointer to oid identifier" );
     return NULL;
   }
 
-  do{
-     if(( strlen( id ) == ( len = strlen( libakrypt_oids[idx].id ))) &&
-                 ak_ptr_is_equal( id, libakrypt_oids[idx].id, len ))
-       return  &libakrypt_oids[idx];
-
-  } while( ++idx < ak_libakrypt_oids_count( ));
-
+  if(( idx = ak_oid_index_search( ak_oid_index_get()->ids,
+                              offsetof( struct oid, id ), id )) < ak_libakrypt_oids_count( ))
+    return &libakrypt_oids[idx];
 
   // ak_error_message_fmt( ak_error_oid_id, __func__,
   //                                          "searching oid with wrong identifier \"%s\"", id );
@@ -534,24 +656,22 @@
 /* ----------------------------------------------------------------------------------------------- */
  ak_oid ak_oid_context_find_by_ni( const char *ni )
 {
-  size_t len = 0, idx = 0;
+  size_t idx = 0, count = ak_libakrypt_oids_count();
+  struct oid_index *index = NULL;
+
   if( ni == NULL ) {
     ak_error_message( ak_error_null_pointer, __func__,
                                                   "using null pointer to oid name or identifier" );
     return NULL;
   }
 
-  do{
-    /* проверка имени */
-     if(( strlen( ni ) == ( len = strlen( libakrypt_oids[idx].name ))) &&
-            ak_ptr_is_equal( ni, libakrypt_oids[idx].name, len ))
-       return &libakrypt_oids[idx];
-    /* проверка идентификатора */
-     if(( strlen( ni ) == ( len = strlen( libakrypt_oids[idx].id ))) &&
-            ak_ptr_is_equal( ni, libakrypt_oids[idx].id, len ))
-       return &libakrypt_oids[idx];
-
-  } while( ++idx < ak_libakrypt_oids_count( ));
+  index = ak_oid_index_get();
+ /* проверка имени */
+  if(( idx = ak_oid_index_search( index->names, offsetof( struct oid, name ), ni )) < count )
+    return &libakrypt_oids[idx];
+ /* проверка идентификатора */
+  if(( idx = ak_oid_index_search( index->ids, offsetof( struct oid, id ), ni )) < count )
+    return &libakrypt_oids[idx];
 
   // ak_error_message_fmt( ak_error_oid_id, __func__,
   //                                      "searching oid with wrong name or identifier\"%s\"", ni );
@@ -567,10 +687,10 @@
 /* ----------------------------------------------------------------------------------------------- */
  ak_oid ak_oid_context_find_by_engine( const oid_engines_t engine )
 {
-  size_t idx = 0;
-  do{
-     if( libakrypt_oids[idx].engine == engine ) return (const ak_oid) &libakrypt_oids[idx];
-  } while( ++idx < ak_libakrypt_oids_count( ));
+  size_t idx = ak_libakrypt_oids_count();
+
+  if( engine < undefined_engine ) idx = ak_oid_index_get()->first[engine];
+  if( idx < ak_libakrypt_oids_count( )) return (const ak_oid) &libakrypt_oids[idx];
   ak_error_message( ak_error_oid_name, __func__, "searching oid with wrong engine" );
 
  return NULL;
@@ -585,6 +705,7 @@
 /* ----------------------------------------------------------------------------------------------- */
  ak_oid ak_oid_context_findnext_by_engine( const ak_oid startoid, const oid_engines_t engine )
 {
+ size_t idx = 0;
  ak_oid oid = ( ak_oid )startoid;
 
  if( oid == NULL) {
@@ -592,6 +713,12 @@
    return NULL;
  }
 
+ /* если тип механизма совпадает, то следующий элемент берется из индекса */
+  if( ak_oid_context_check( oid ) && ( oid->engine == engine )) {
+    idx = ak_oid_index_get()->next[ oid - libakrypt_oids ];
+    return idx < ak_libakrypt_oids_count() ? (const ak_oid) &libakrypt_oids[idx] : NULL;
+  }
+
  /* сдвигаемся по массиву OID вперед */
   while( (++oid)->engine != undefined_engine ) {
     if( oid->engine == engine ) return (const ak_oid) oid;
@@ -607,13 +734,14 @@
 /* ----------------------------------------------------------------------------------------------- */
  bool_t ak_oid_context_check( const ak_oid oid )
 {
-  size_t i;
-  bool_t result = ak_false;
+  size_t i = 0;
 
-  for( i = 0; i < ak_libakrypt_oids_count(); i++ )
-     if( (const ak_oid) &libakrypt_oids[i] == oid ) result = ak_true;
+ /* адрес должен находиться внутри массива и указывать на начало элемента */
+  if(( oid < libakrypt_oids ) || ( oid >= libakrypt_oids + ak_libakrypt_oids_count( )))
+    return ak_false;
+  i = ( size_t )( oid - libakrypt_oids );
 
- return result;
+ return ( (const ak_oid) &libakrypt_oids[i] == oid ) ? ak_true : ak_false;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1244,7 +1244,12 @@
   },
   0xdbf951d5883b2b2fLL, /* n */
   0x66ff43a234713e85LL, /* nq */
-  "8000000000000000000000000000000000000000000000000000000000000431"
+  "8000000000000000000000000000000000000000000000000000000000000431",
+  ak_mpzn_mul_montgomery256, /* умножение по модулю p */
+  ak_mpzn_mul_montgomery256, /* умножение по модулю q */
+  montgomery_reduction,
+  { 0xffffffffffffef3cLL, 0xffffffffffffffffLL, 0xffffffffffffffffLL, 0xffffffffffffffffLL, 0x0000000000000001LL }, /* mu */
+  { 0xe98c0f9b14cc2941LL, 0xbc05d79db5a27aacLL, 0xfffffffffffffffaLL, 0xffffffffffffffffLL, 0x0000000000000001LL }  /* muq */
  };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1261,10 +1266,10 @@
  const static struct wcurve id_tc26_gost_3410_2012_256_paramSetA = {
   ak_mpzn256_size,
   4, /* cofactor */
-  { 0x6d0078e62fc81048LL, 0x94db4f98bfb73698LL, 0x75e9b60631449efdLL, 0xca0709cc398e1cd1LL }, /* a */
-  { 0xacd1216d5cc63966LL, 0x534b728e6773c810LL, 0xfb4e95d31a5032feLL, 0xb76e3775f6a4aee7LL }, /* b */
+  { 0xb22c656f277e7335LL, 0xe25e2013bf95aa33LL, 0xaf4892c23035a27cLL, 0xc2173f1513981673LL }, /* a (в обычной форме) */
+  { 0xba9337a6f8ae9513LL, 0x22fccd9108e17bf7LL, 0xcc20e7c359a9d41aLL, 0x295f9bae7428ed9cLL }, /* b (в обычной форме) */
   { 0xfffffffffffffd97LL, 0xffffffffffffffffLL, 0xffffffffffffffffLL, 0xffffffffffffffffLL }, /* p */
-  { 0x000000000005cf11LL, 0x0000000000000000LL, 0x0000000000000000LL, 0x0000000000000000LL }, /* r2 */
+  { 0x0000000000000001LL, 0x0000000000000000LL, 0x0000000000000000LL, 0x0000000000000000LL }, /* r2 (для обычной формы равно единице) */
   { 0xc115af556c360c67LL, 0x0fd8cddfc87b6635LL, 0x0000000000000000LL, 0x4000000000000000LL }, /* q */
   { 0x57cb446240dd1710LL, 0x7556091c4805caa4LL, 0xd0593365f9384bcdLL, 0x0fb1fbc48b0f0eb4LL }, /* r2q */
   {
@@ -1274,7 +1279,12 @@
   },
   0x46f3234475d5add9LL, /* n */
   0x035bdd1aeafdb0a9LL, /* nq */
-  "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFD97"
+  "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFD97",
+  ak_mpzn_mul_pseudo_mersenne256, /* умножение по модулю p */
+  ak_mpzn_mul_montgomery256, /* умножение по модулю q */
+  pseudo_mersenne_reduction,
+  { 0x0000000000000269LL, 0x0000000000000000LL, 0x0000000000000000LL, 0x0000000000000000LL, 0x0000000000000001LL }, /* mu */
+  { 0xeea50aa93c9f3990LL, 0x0273220378499ca3LL, 0xffffffffffffffffLL, 0xffffffffffffffffLL, 0x0000000000000003LL }  /* muq */
 };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1291,10 +1301,10 @@
  const static struct wcurve id_rfc4357_gost_3410_2001_paramSetA = {
   ak_mpzn256_size,
   1,
-  { 0xfffffffffffff65cLL, 0xffffffffffffffffLL, 0xffffffffffffffffLL, 0xffffffffffffffffLL }, /* a */
-  { 0x0000000000019016LL, 0x0000000000000000LL, 0x0000000000000000LL, 0x0000000000000000LL }, /* b */
+  { 0xfffffffffffffd94LL, 0xffffffffffffffffLL, 0xffffffffffffffffLL, 0xffffffffffffffffLL }, /* a (в обычной форме) */
+  { 0x00000000000000a6LL, 0x0000000000000000LL, 0x0000000000000000LL, 0x0000000000000000LL }, /* b (в обычной форме) */
   { 0xfffffffffffffd97LL, 0xffffffffffffffffLL, 0xffffffffffffffffLL, 0xffffffffffffffffLL }, /* p */
-  { 0x000000000005cf11LL, 0x0000000000000000LL, 0x0000000000000000LL, 0x0000000000000000LL }, /* r2 */
+  { 0x0000000000000001LL, 0x0000000000000000LL, 0x0000000000000000LL, 0x0000000000000000LL }, /* r2 (для обычной формы равно единице) */
   { 0x45841b09b761b893LL, 0x6c611070995ad100LL, 0xffffffffffffffffLL, 0xffffffffffffffffLL }, /* q */
   { 0x9ac2d7858e79a469LL, 0xfb07f8222e76dd52LL, 0xf74885d08a3714c6LL, 0x551fe9cb451179dbLL }, /* r2q */
   {
@@ -1304,7 +1314,12 @@
   },
   0x46f3234475d5add9LL, /* n */
   0x9ee6ea0b57c7da65LL, /* nq */
-  "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFD97"
+  "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFD97",
+  ak_mpzn_mul_pseudo_mersenne256, /* умножение по модулю p */
+  ak_mpzn_mul_montgomery256, /* умножение по модулю q */
+  pseudo_mersenne_reduction,
+  { 0x0000000000000269LL, 0x0000000000000000LL, 0x0000000000000000LL, 0x0000000000000000LL, 0x0000000000000001LL }, /* mu */
+  { 0xba7be4f6489e476dLL, 0x939eef8f66a52effLL, 0x0000000000000000LL, 0x0000000000000000LL, 0x0000000000000001LL }  /* muq */
  };
  #define id_tc26_gost_3410_2012_256_paramSetB ( id_rfc4357_gost_3410_2001_paramSetA )
 
@@ -1335,7 +1350,12 @@
   },
   0xbd667ab8a3347857LL, /* n */
   0xca89614990611a91LL, /* nq */
-  "8000000000000000000000000000000000000000000000000000000000000C99"
+  "8000000000000000000000000000000000000000000000000000000000000C99",
+  ak_mpzn_mul_montgomery256, /* умножение по модулю p */
+  ak_mpzn_mul_montgomery256, /* умножение по модулю q */
+  montgomery_reduction,
+  { 0xffffffffffffcd9cLL, 0xffffffffffffffffLL, 0xffffffffffffffffLL, 0xffffffffffffffffLL, 0x0000000000000001LL }, /* mu */
+  { 0x6da3a790cdd799d3LL, 0x823fcc0039676c68LL, 0xfffffffffffffffaLL, 0xffffffffffffffffLL, 0x0000000000000001LL }  /* muq */
  };
  #define id_tc26_gost_3410_2012_256_paramSetC ( id_rfc4357_gost_3410_2001_paramSetB )
 
@@ -1366,7 +1386,12 @@
   },
   0xdf6e6c2c727c176dLL, /* n */
   0xa1c6af0a552f7577LL, /* nq */
-  "9B9F605F5A858107AB1EC85E6B41C8AACF846E86789051D37998F7B9022D759B"
+  "9B9F605F5A858107AB1EC85E6B41C8AACF846E86789051D37998F7B9022D759B",
+  ak_mpzn_mul_montgomery256, /* умножение по модулю p */
+  ak_mpzn_mul_montgomery256, /* умножение по модулю q */
+  montgomery_reduction,
+  { 0xedc283cdd217b5a2LL, 0xbac48fc06398ae59LL, 0x405384d55f9f3b73LL, 0xa51f176161f1d734LL, 0x0000000000000001LL }, /* mu */
+  { 0x90859e45ba119482LL, 0xfdb70c7fdaf6e4c0LL, 0x405384d55f9f3b74LL, 0xa51f176161f1d734LL, 0x0000000000000001LL }  /* muq */
  };
  #define id_tc26_gost_3410_2012_256_paramSetD ( id_rfc4357_gost_3410_2001_paramSetC )
 
@@ -1397,7 +1422,12 @@
   },
   0xd6412ff7c29b8645LL, /* n */
   0x50bc7d084a21aae1LL, /* nq */
-  "4531ACD1FE0023C7550D267B6B2FEE80922B14B2FFB90F04D4EB7C09B5D2D15DF1D852741AF4704A0458047E80E4546D35B8336FAC224DD81664BBF528BE6373"
+  "4531ACD1FE0023C7550D267B6B2FEE80922B14B2FFB90F04D4EB7C09B5D2D15DF1D852741AF4704A0458047E80E4546D35B8336FAC224DD81664BBF528BE6373",
+  ak_mpzn_mul_montgomery512, /* умножение по модулю p */
+  ak_mpzn_mul_montgomery512, /* умножение по модулю q */
+  montgomery_reduction,
+  { 0x9321403331168039, 0x3e0dbb26c5066545, 0x57c5263e503c0f91, 0x0a34c0232e5384ef, 0x3eb417dd79e484d5, 0x9c2db0b11022a258, 0xd8d804ff6796fd8e, 0xb3223079d17e4ac3, 0x0000000000000003 }, /* mu */
+  { 0xbef0337c720d9890, 0x2c83ae595830d0ec, 0xde72763f8aea7871, 0xfa7ad69503fe08a9, 0x3eb417dd79e484d8, 0x9c2db0b11022a258, 0xd8d804ff6796fd8e, 0xb3223079d17e4ac3, 0x0000000000000003 }  /* muq */
  };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1414,10 +1444,10 @@
  const static struct wcurve id_tc26_gost_3410_2012_512_paramSetA = {
   ak_mpzn512_size,
   1,
-  { 0xfffffffffffff71c, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff }, /* a */
-  { 0x3e2a1b8106e8a17d, 0x3e694a40649ca74b, 0x7cd5ed6575cbfc5f, 0x84e4722c383c8743, 0x9527086e6e4db48e, 0x2d4b3fda85c534b6, 0x9d2dd3769d088dff, 0x57e4a0c5f647c2e3 }, /* b */
+  { 0xfffffffffffffdc4, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff }, /* a (в обычной форме) */
+  { 0x503190785a71c760, 0x862ef9d4ebee4761, 0x4cb4574010da90dd, 0xee3cb090f30d2761, 0x79bd081cfd0b6265, 0x34b82574761cb0e8, 0xc1bd0b2b6667f1da, 0xe8c2505dedfc86dd }, /* b (в обычной форме) */
   { 0xfffffffffffffdc7, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff }, /* p */
-  { 0x000000000004f0b1, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, /* r2 */
+  { 0x0000000000000001, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, /* r2 (для обычной формы равно единице) */
   { 0xcacdb1411f10b275, 0x9b4b38abfad2b85d, 0x6ff22b8d4e056060, 0x27e69532f48d8911, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff }, /* q */
   { 0x546775b92106e979, 0xb55cd33800ab10e6, 0x80b08b27e9cebbc7, 0xa06b76a2bae6fc86, 0xc7433579e382956f, 0xbab8be5dd7b1651d, 0xee028bf9d8ed3314, 0xb66ae6c00bebd6c3 }, /* r2q */
   {
@@ -1427,7 +1457,12 @@
   },
   0x58a1f7e6ce0f4c09LL, /* n */
   0x02ccc1665d51f223LL, /* nq */
-  "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFDC7"
+  "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFDC7",
+  ak_mpzn_mul_pseudo_mersenne512, /* умножение по модулю p */
+  ak_mpzn_mul_montgomery512, /* умножение по модулю q */
+  pseudo_mersenne_reduction,
+  { 0x0000000000000239, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000001 }, /* mu */
+  { 0x35324ebee0ef4d8b, 0x64b4c754052d47a2, 0x900dd472b1fa9f9f, 0xd8196acd0b7276ee, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000001 }  /* muq */
  };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1458,6 +1493,11 @@
   0x4e6a171024e6a171LL, /* n */
   0xc07d62492cbac26bLL, /* nq */
   "8000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000006F",
+  ak_mpzn_mul_montgomery512, /* умножение по модулю p */
+  ak_mpzn_mul_montgomery512, /* умножение по модулю q */
+  montgomery_reduction,
+  { 0xfffffffffffffe44, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0x0000000000000001 }, /* mu */
+  { 0xe72e4eaf22c36919, 0xd19a63b7bf9057c4, 0x4c09221098afcc15, 0xd9784faf6a696ae9, 0xfffffffffffffffa, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0x0000000000000001 }  /* muq */
  };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1474,10 +1514,10 @@
  const static struct wcurve id_tc26_gost_3410_2012_512_paramSetC = {
   ak_mpzn512_size,
   4,
-  { 0xd341ab3699869915, 0x3d6c9273ccebc4c1, 0x486b484c83cb0726, 0x9a8145b812d1a7b0, 0x2003251cadf8effa, 0x6b20d9f8b7db94f1, 0xdd0c19f57c9cc019, 0x408aa82ae77985ca }, /* a */
-  { 0xb304002a3c03ce62, 0xcbe7bfdf359dc095, 0x57398fea29abadad, 0x3ce46aec38657034, 0xabf0edb5e37f775e, 0x63ccffc5280e7697, 0x6754d90e93579656, 0xc9b558b380cc6f00 }, /* b */
+  { 0x2eb6546f39689bd3, 0x2ad97f951fda9f2a, 0x2ade71f46fcf50ff, 0x46e861c0e2c9edd9, 0x4de41c68e1430645, 0x187bc8980eb86664, 0x5485a529d2c722fb, 0xdc9203e514a72187 }, /* a (в обычной форме) */
+  { 0x8d2319a5312557e1, 0x2b8cc7a5f5bf0a3c, 0x8de0284b8bfef3b5, 0x38cbc2fff719d2c1, 0xffda2e4f0de5ade0, 0xc7efb6a9f69f4b57, 0x8ac12952cf37f16a, 0xb4c4ee28cebc6c2c }, /* b (в обычной форме) */
   { 0xfffffffffffffdc7, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff }, /* p */
-  { 0x000000000004f0b1, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, /* r2 */
+  { 0x0000000000000001, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, /* r2 (для обычной формы равно единице) */
   { 0x94623cef47f023ed, 0xc8eda9e7a769a126, 0x4c33a9ff5147502c, 0xc98cdba46506ab00, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0x3fffffffffffffff }, /* q */
   { 0xe58fa18ee6ca4eb6, 0xe79280282d956fca, 0xd016086ec2d4f903, 0x542f8f3fa490666a, 0x04f77045db49adc9, 0x314e0a57f445b20e, 0x8910352f3bea2192, 0x394c72054d8503be }, /* r2q */
   {
@@ -1487,7 +1527,12 @@
   },
   0x58a1f7e6ce0f4c09LL, /* n */
   0x0ed9d8e0b6624e1bLL, /* nq */
-  "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFDC7"
+  "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFDC7",
+  ak_mpzn_mul_pseudo_mersenne512, /* умножение по модулю p */
+  ak_mpzn_mul_montgomery512, /* умножение по модулю q */
+  pseudo_mersenne_reduction,
+  { 0x0000000000000239, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000001 }, /* mu */
+  { 0xb9dc310b80fdc132, 0x712561858965ed96, 0x3cc5600aeb8afd33, 0x673245b9af954ffb, 0x0000000000000003, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000004 }  /* muq */
  };
 
 #endif
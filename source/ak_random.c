@@ -25,6 +25,15 @@
 #ifdef LIBAKRYPT_HAVE_FCNTL_H
  #include <fcntl.h>
 #endif
+#ifdef LIBAKRYPT_HAVE_SYSRANDOM_H
+ #include <sys/random.h>
+#endif
+#ifdef LIBAKRYPT_HAVE_ERRNO_H
+ #include <errno.h>
+#endif
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
  #include <ak_mpzn.h>
@@ -498,6 +507,252 @@
 }
 #endif
 
+#if defined(__unix__) || defined(__APPLE__)
+/* ----------------------------------------------------------------------------------------------- */
+/*                               реализация класса rng_getrandom                                   */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Размер (в байтах) буффера, заполняемого генератором getrandom за одно обращение к ОС. */
+ #define ak_random_getrandom_buffer_size   (16384)
+
+/*! \brief Класс для хранения внутренних состояний буфферизованного генератора getrandom */
+ typedef struct random_getrandom {
+  /*! \brief буффер со случайными данными, полученными от операционной системы */
+  ak_uint8 buffer[ak_random_getrandom_buffer_size];
+  /*! \brief смещение первого неиспользованного байта буффера */
+  size_t offset;
+  /*! \brief файловый дескриптор /dev/urandom (-1, если используется вызов getrandom()) */
+  int fd;
+  /*! \brief номер ветвления процесса, в котором был заполнен буффер */
+  ak_uint64 fork;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  /*! \brief блокировка буффера; генератор используется как общий генератор ключевой информации,
+      поэтому к нему одновременно обращаются несколько потоков */
+  pthread_mutex_t lock;
+#endif
+ } *ak_random_getrandom;
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+/*! \brief Счетчик ветвлений процесса, увеличиваемый в дочернем процессе. */
+ static volatile ak_uint64 ak_random_getrandom_forks = 0;
+/*! \brief Флаг однократной регистрации обработчика ветвления процесса. */
+ static pthread_once_t ak_random_getrandom_once = PTHREAD_ONCE_INIT;
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_random_getrandom_atfork_child( void )
+{
+  ak_random_getrandom_forks++;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_random_getrandom_atfork_register( void )
+{
+  pthread_atfork( NULL, NULL, ak_random_getrandom_atfork_child );
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает значение, изменяющееся при каждом ветвлении процесса.
+
+    При наличии библиотеки pthread используется счетчик, увеличиваемый обработчиком,
+    зарегистрированным с помощью pthread_atfork(), что не требует системных вызовов;
+    в противном случае используется идентификатор процесса.                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_uint64 ak_random_getrandom_fork_value( void )
+{
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  return ak_random_getrandom_forks;
+#else
+  return ( ak_uint64 ) getpid();
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет, что системный вызов getrandom() поддерживается ядром операционной
+    системы (заголовочный файл может присутствовать и при отсутствии такой поддержки).
+
+    \return Функция возвращает \ref ak_true, если системный вызов доступен, и \ref ak_false,
+    если должен использоваться /dev/urandom.                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_random_getrandom_is_supported( void )
+{
+#ifdef LIBAKRYPT_HAVE_SYSRANDOM_H
+  ak_uint8 probe = 0;
+
+  if(( getrandom( &probe, 1, GRND_NONBLOCK ) == -1 )
+ #ifdef LIBAKRYPT_HAVE_ERRNO_H
+                                                    && ( errno == ENOSYS )
+ #endif
+    ) return ak_false;
+ return ak_true;
+#else
+ return ak_false;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция получает от операционной системы заданное количество случайных байт. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_getrandom_read( ak_random_getrandom rg, ak_uint8 *ptr, size_t size )
+{
+  ssize_t result = 0;
+
+  while( size > 0 ) {
+#ifdef LIBAKRYPT_HAVE_SYSRANDOM_H
+    if( rg->fd == -1 ) result = getrandom( ptr, size, 0 );
+     else
+#endif
+    result = read( rg->fd, ptr, size );
+    if( result <= 0 ) {
+#ifdef LIBAKRYPT_HAVE_ERRNO_H
+      if(( result == -1 ) && ( errno == EINTR )) continue;
+#endif
+      return ak_error_message( ak_error_read_data, __func__ ,
+                                                  "wrong reading random data from operating system" );
+    }
+    ptr += result;
+    size -= ( size_t )result;
+  }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_random_getrandom_free( ak_pointer ptr )
+{
+  ak_random_getrandom rg = ( ak_random_getrandom ) ptr;
+
+  if( ptr == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__ , "freeing a null pointer to data" );
+    return;
+  }
+  memset( rg->buffer, 0, sizeof( rg->buffer ));
+  if( rg->fd != -1 ) {
+    if( close( rg->fd ) == -1 )
+      ak_error_message( ak_error_close_file, __func__ , "wrong closing a file with random data" );
+  }
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_destroy( &rg->lock );
+#endif
+  free( ptr );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_getrandom_random( ak_random rnd, const ak_pointer ptr, const ssize_t size )
+{
+  size_t count = 0, len = 0;
+  int error = ak_error_ok;
+  ak_uint8 *value = ptr;
+  ak_random_getrandom rg = NULL;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "use a null pointer to a random generator" );
+  if( ptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                   "use a null pointer to data" );
+  if( size <= 0 ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                                 "use a data with wrong length" );
+  rg = ( ak_random_getrandom ) rnd->data;
+
+ /* после ветвления процесса данные буффера совпадают с данными родительского процесса,
+    поэтому мы их уничтожаем; блокировка могла быть захвачена другим потоком родительского
+    процесса, поэтому она создается заново (сразу после ветвления процесс содержит один поток) */
+  if( rg->fork != ak_random_getrandom_fork_value( )) {
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+    pthread_mutex_init( &rg->lock, NULL );
+#endif
+    memset( rg->buffer, 0, sizeof( rg->buffer ));
+    rg->offset = sizeof( rg->buffer );
+    rg->fork = ak_random_getrandom_fork_value( );
+  }
+
+ /* большие объемы данных считываются напрямую, минуя буффер */
+  count = ( size_t )size;
+  if( count >= sizeof( rg->buffer )) return ak_random_getrandom_read( rg, value, count );
+
+ /* остальные запросы обслуживаются из буффера; использованные байты сразу уничтожаются,
+    а смещение изменяется под блокировкой, поэтому разные потоки получают разные данные */
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &rg->lock );
+#endif
+  while( count > 0 ) {
+    if( rg->offset == sizeof( rg->buffer )) {
+      if(( error = ak_random_getrandom_read( rg, rg->buffer, sizeof( rg->buffer ))) != ak_error_ok ) {
+        ak_error_message( error, __func__ , "wrong refilling of internal buffer" );
+        break;
+      }
+      rg->offset = 0;
+    }
+    len = ak_min( count, sizeof( rg->buffer ) - rg->offset );
+    memcpy( value, rg->buffer + rg->offset, len );
+    memset( rg->buffer + rg->offset, 0, len );
+    rg->offset += len;
+    value += len;
+    count -= len;
+  }
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_unlock( &rg->lock );
+#endif
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Генератор получает случайные данные от операционной системы с помощью системного вызова
+    getrandom(), а в случае его отсутствия, путем чтения из /dev/urandom. В отличие от
+    генератора, создаваемого функцией ak_random_context_create_urandom(), обращение к
+    операционной системе производится не при каждом запросе, а блоками по
+    \ref ak_random_getrandom_buffer_size байт; выданные из буффера данные сразу же уничтожаются.
+
+    После ветвления процесса (вызова fork()) содержимое буффера не используется,
+    поэтому родительский и дочерний процессы получают различные последовательности.
+    Обращения к буфферу выполняются под блокировкой, поэтому генератор может одновременно
+    использоваться несколькими потоками. Если системный вызов getrandom() не поддерживается
+    ядром операционной системы, используется /dev/urandom.
+
+    @param generator Контекст создаваемого генератора.
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_random_context_create_getrandom( ak_random generator )
+{
+  int error = ak_error_ok;
+  ak_random_getrandom rg = NULL;
+
+  if(( error = ak_random_context_create( generator )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong initialization of random generator" );
+
+  if(( generator->data = rg = malloc( sizeof( struct random_getrandom ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+           "incorrect memory allocation for an internal variables of random generator" );
+  memset( rg->buffer, 0, sizeof( rg->buffer ));
+  rg->offset = sizeof( rg->buffer ); /* буффер пуст и будет заполнен при первом обращении */
+  rg->fd = -1;
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_once( &ak_random_getrandom_once, ak_random_getrandom_atfork_register );
+  pthread_mutex_init( &rg->lock, NULL );
+#endif
+  rg->fork = ak_random_getrandom_fork_value();
+
+  if( !ak_random_getrandom_is_supported( ) &&
+                                    (( rg->fd = open( "/dev/urandom", O_RDONLY | O_BINARY )) == -1 )) {
+    ak_error_message( ak_error_open_file, __func__ , "wrong opening a file \"/dev/urandom\"" );
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+    pthread_mutex_destroy( &rg->lock );
+#endif
+    free( generator->data );
+    generator->data = NULL;
+    return ak_error_open_file;
+  }
+
+  generator->oid = ak_oid_context_find_by_name("getrandom");
+  generator->next = NULL;
+  generator->randomize_ptr = NULL;
+  generator->random = ak_random_getrandom_random;
+  generator->free = ak_random_getrandom_free;
+
+ return error;
+}
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param rnd указатель на контекст генератора псевдо-случайных чисел
     @param oid OID генератора.
@@ -531,10 +786,230 @@
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                   реестр генераторов, связанных с потоками выполнения программы                 */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Генератор, принадлежащий одному потоку выполнения программы. */
+ typedef struct random_thread_local {
+  /*! \brief контекст генератора */
+   struct random generator;
+  /*! \brief значение опции mask_random_generator, использованное при создании генератора */
+   ak_int64 index;
+  /*! \brief флаг готовности генератора к использованию
+      (ложен, пока генератор находится в процессе создания) */
+   bool_t ready;
+ } *ak_random_thread_local;
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+/*! \brief Ключ, связывающий с потоком выполнения его генератор. */
+ static pthread_key_t ak_random_thread_local_key;
+/*! \brief Флаг однократного создания ключа ak_random_thread_local_key. */
+ static pthread_once_t ak_random_thread_local_once = PTHREAD_ONCE_INIT;
+ #ifdef LIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL
+/*! \brief Копия указателя на генератор текущего потока, позволяющая избежать вызова
+    функции pthread_getspecific(). */
+  static __thread ak_random_thread_local ak_random_thread_local_slot = NULL;
+ #endif
+#else
+/*! \brief Генератор единственного потока выполнения программы. */
+ static ak_random_thread_local ak_random_thread_local_slot = NULL;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция уничтожает генератор потока выполнения программы.                              */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_random_thread_local_free( ak_pointer ptr )
+{
+  ak_random_thread_local slot = ( ak_random_thread_local ) ptr;
+  if( slot == NULL ) return;
+  if( slot->ready ) ak_random_context_destroy( &slot->generator );
+  free( slot );
+}
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_random_thread_local_key_create( void )
+{
+  pthread_key_create( &ak_random_thread_local_key, ak_random_thread_local_free );
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_random_thread_local ak_random_thread_local_get_slot( void )
+{
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #ifdef LIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL
+  return ak_random_thread_local_slot;
+ #else
+  pthread_once( &ak_random_thread_local_once, ak_random_thread_local_key_create );
+  return ( ak_random_thread_local ) pthread_getspecific( ak_random_thread_local_key );
+ #endif
+#else
+  return ak_random_thread_local_slot;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_random_thread_local_set_slot( ak_random_thread_local slot )
+{
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_once( &ak_random_thread_local_once, ak_random_thread_local_key_create );
+  pthread_setspecific( ak_random_thread_local_key, slot );
+ #ifdef LIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL
+  ak_random_thread_local_slot = slot;
+ #endif
+#else
+  ak_random_thread_local_slot = slot;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция создает генератор, определяемый опцией `mask_random_generator`
+    (индексом OID в таблице идентификаторов библиотеки). Если значение опции отрицательно
+    или не определяет генератор, то создается генератор xorshift32.                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_context_create_option( ak_random generator, const ak_int64 index )
+{
+  ak_oid oid = NULL;
+  oid_engines_t engine;
+  oid_modes_t mode;
+  char name[128], id[128];
+
+  if( index < 0 ) return ak_random_context_create_xorshift32( generator );
+  if( ak_libakrypt_get_oid_by_index( (size_t) index,
+                             &engine, &mode, name, sizeof( name ), id, sizeof( id )) == ak_error_ok )
+    oid = ak_oid_context_find_by_name( name );
+  if(( oid == NULL ) || ( oid->engine != random_generator ) || ( oid->mode != algorithm )) {
+    ak_error_message( ak_error_oid_engine, __func__ ,
+                                         "using wrong value of mask_random_generator option" );
+    return ak_random_context_create_xorshift32( generator );
+  }
+ return ak_random_context_create_oid( generator, oid );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает генератор текущего потока, создавая его при необходимости.
+
+    @param refresh Флаг того, что генератор должен быть пересоздан, если значение опции
+    `mask_random_generator` изменилось после его создания.
+    @return Указатель на генератор или NULL, если генератор находится в процессе создания
+    (вложенный вызов) либо не может быть создан.                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_random ak_random_thread_local_get( bool_t refresh )
+{
+  int error = ak_error_ok;
+  ak_int64 index = -1;
+  ak_random_thread_local slot = ak_random_thread_local_get_slot();
+
+  if( slot != NULL ) {
+    if( !slot->ready ) return NULL;
+    if( !refresh ) return &slot->generator;
+    if(( index = ak_libakrypt_get_option_by_index( option_mask_random_generator )) == slot->index )
+      return &slot->generator;
+   /* значение опции изменилось: пересоздаем генератор */
+    slot->ready = ak_false;
+    ak_random_context_destroy( &slot->generator );
+  } else {
+      if(( slot = malloc( sizeof( struct random_thread_local ))) == NULL ) {
+        ak_error_message( ak_error_out_of_memory, __func__ ,
+                                          "incorrect memory allocation for thread generator" );
+        return NULL;
+      }
+      slot->ready = ak_false;
+      ak_random_thread_local_set_slot( slot );
+      index = ak_libakrypt_get_option_by_index( option_mask_random_generator );
+    }
+
+ /* пока флаг ready ложен, вложенные вызовы (например, при создании ключа
+    генератора, основанного на блочном шифре) не используют этот генератор */
+  slot->index = index;
+  if(( error = ak_random_context_create_option( &slot->generator, index )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect creation of thread generator" );
+    ak_random_thread_local_set_slot( NULL );
+    free( slot );
+    return NULL;
+  }
+  slot->ready = ak_true;
+ return &slot->generator;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выработки данных заимствованным генератором: данные вырабатываются
+    генератором того потока, в котором выполняется вызов.                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_thread_local_random( ak_random rnd, const ak_pointer ptr, const ssize_t size )
+{
+  ak_random generator = ak_random_thread_local_get( ak_false );
+  struct random local;
+  int error = ak_error_ok;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "use a null pointer to a random generator" );
+  if( generator != NULL ) return generator->random( generator, ptr, size );
+
+ /* генератор потока находится в процессе создания,
+    поэтому используем временный генератор */
+  if(( error = ak_random_context_create_xorshift32( &local )) != ak_error_ok ) return error;
+  error = local.random( &local, ptr, size );
+  ak_random_context_destroy( &local );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция создает контекст, не имеющий собственного внутреннего состояния: данные
+    вырабатываются генератором, связанным с потоком, в котором выполняется вызов функции
+    ak_random_context_random(). Генератор потока создается при первом обращении и
+    уничтожается при завершении потока (для потока, вызвавшего ak_libakrypt_destroy(),
+    при вызове этой функции). Тип генератора определяется опцией `mask_random_generator`.
+
+    Такие контексты предназначены для выработки масок секретных ключей: создание и удаление
+    ключа не требуют создания генератора (и, например, открытия файловых дескрипторов).
+    Инициализация заимствованного генератора (функция ak_random_context_randomize())
+    не поддерживается.
+
+    Если вызов происходит в процессе создания генератора потока (например, при создании
+    ключа генератора, основанного на блочном шифре), то создается собственный генератор
+    xorshift32.
+
+    @param rnd указатель на контекст генератора псевдо-случайных чисел
+    @return В случае успеха возвращается ak_error_ok (ноль). В случае возникновения ошибки
+    возвращается ее код.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_random_context_create_thread_local( ak_random rnd )
+{
+  int error = ak_error_ok;
+  ak_random generator = NULL;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                    "use a null pointer to a random generator" );
+  if(( generator = ak_random_thread_local_get( ak_true )) == NULL )
+    return ak_random_context_create_xorshift32( rnd );
+
+  if(( error = ak_random_context_create( rnd )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong initialization of random generator" );
+  rnd->oid = generator->oid;
+  rnd->random = ak_random_thread_local_random;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция уничтожает генератор потока, в котором она вызвана.
+    Вызывается при завершении работы с библиотекой.                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_random_context_thread_local_destroy( void )
+{
+  ak_random_thread_local slot = ak_random_thread_local_get_slot();
+  if( slot == NULL ) return;
+  ak_random_thread_local_set_slot( NULL );
+  ak_random_thread_local_free( slot );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*!  \example test-internal-random01.c                                                             */
 /*!  \example test-internal-random02.c                                                             */
 /*!  \example test-internal-random03.c                                                             */
+/*!  \example test-internal-random04.c                                                             */
 /* ----------------------------------------------------------------------------------------------- */
 /*                                                                                    ak_random.c  */
 /* ----------------------------------------------------------------------------------------------- */
@@ -61,6 +61,8 @@
  int ak_random_context_create_random( ak_random );
 /*! \brief Инициализация контекста генератора, считывающего случайные значения из /dev/urandom. */
  int ak_random_context_create_urandom( ak_random );
+/*! \brief Инициализация контекста буфферизованного генератора, получающего случайные значения с помощью вызова getrandom(). */
+ int ak_random_context_create_getrandom( ak_random );
 #endif
 #ifdef _WIN32
 /*! \brief Инициализация контекста, реализующего интерфейс доступа к генератору псевдо-случайных чисел, предоставляемому ОС Windows. */
@@ -73,6 +75,14 @@
  int ak_random_context_create_hashrnd_streebog512( ak_random );
 /*! \brief Инициализация контекста генератора, основанного на применении функции хеширования, определяемой по ее идентификатору. */
  int ak_random_context_create_hashrnd_oid( ak_random , ak_oid );
+/*! \brief Инициализация контекста подпотока генератора hashrnd, предназначенного для использования в отдельном потоке. */
+ int ak_random_context_create_hashrnd_substream( ak_random , ak_random );
+/*! \brief Инициализация контекста генератора, основанного на применении блочного шифра Кузнечик в режиме гаммирования. */
+ int ak_random_context_create_ctr_kuznechik( ak_random );
+/*! \brief Инициализация контекста генератора, основанного на применении блочного шифра Магма в режиме гаммирования. */
+ int ak_random_context_create_ctr_magma( ak_random );
+/*! \brief Инициализация контекста генератора, основанного на применении блочного шифра, определяемого по его идентификатору. */
+ int ak_random_context_create_ctr_oid( ak_random , ak_oid );
 #endif
 #ifdef LIBAKRYPT_HAVE_SYSUN_H
 /*! \brief Инициализация контекста генератора, считывающего случайные значения из сокета домена unix. */
@@ -80,6 +90,10 @@
 #endif
 /*! \brief Инициализация контекста генератора по заданному OID алгоритма генерации псевдо-случайных чисел. */
  int ak_random_context_create_oid( ak_random, ak_oid );
+/*! \brief Инициализация контекста, использующего генератор текущего потока выполнения программы. */
+ int ak_random_context_create_thread_local( ak_random );
+/*! \brief Уничтожение генератора текущего потока выполнения программы. */
+ void ak_random_context_thread_local_destroy( void );
 /*! \brief Установка внутреннего состояния генератора псевдо-случайных чисел. */
  int ak_random_context_randomize( ak_random , const ak_pointer , const ssize_t );
 /*! \brief Выработка псевдо-случайных данных. */
@@ -19,9 +19,14 @@
  #include <ak_sign.h>
  #include <ak_parameters.h>
  #include <ak_context_manager.h>
+ #include <ak_tools.h>
 
  #include <stdio.h>
 
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Установление или изменение маски секретного ключа ассиметричного криптографического
     алгоритма.
@@ -49,7 +54,7 @@
 #ifndef LIBAKRYPT_LITTLE_ENDIAN
   int i = 0;
 #endif
-  ak_mpznmax u, zeta;
+  ak_mpznmax zeta;
   ak_wcurve wc = NULL;
   int error = ak_error_ok;
 
@@ -83,16 +88,21 @@
     /* приводим значение ключа по модулю q, а потом переводим в представление Монтгомери
        при этом мы предполагаем, что значение ключа установлено в естественном представлении */
      ak_mpzn_rem( (ak_uint64 *)skey->key.data, (ak_uint64 *)skey->key.data, wc->q, wc->size );
-     ak_mpzn_mul_montgomery( (ak_uint64 *)skey->key.data, (ak_uint64 *)skey->key.data, wc->r2q,
-                                                                           wc->q, wc->nq, wc->size);
-     ak_mpzn_mul_montgomery( (ak_uint64 *)skey->key.data,
-                (ak_uint64 *)skey->key.data, (ak_uint64 *)skey->mask.data, wc->q, wc->nq, wc->size);
-
-    /* вычисляем обратное значение для маски */
-     ak_mpzn_set_ui( u, wc->size, 2 );
-     ak_mpzn_sub( u, wc->q, u, wc->size );
-     ak_mpzn_modpow_montgomery( (ak_uint64 *)skey->mask.data, // m <- m^{q-2} (mod q)
-                                         (ak_uint64 *)skey->mask.data, u, wc->q, wc->nq, wc->size );
+     wc->mulq( (ak_uint64 *)skey->key.data, (ak_uint64 *)skey->key.data, wc->r2q,
+                                                                           wc->q, wc->nq, wc->size );
+     wc->mulq( (ak_uint64 *)skey->key.data,
+                (ak_uint64 *)skey->key.data, (ak_uint64 *)skey->mask.data, wc->q, wc->nq, wc->size );
+
+    /* вычисляем обратное значение для маски (за время, не зависящее от значения маски):
+       обращение дает m^{-1}r^{-1} (mod q), двукратное умножение на r^2 возвращает
+       результат в представление Монтгомери */
+     if(( error = ak_mpzn_inverse_safegcd( (ak_uint64 *)skey->mask.data,
+                           (ak_uint64 *)skey->mask.data, wc->q, wc->size )) != ak_error_ok )
+       return ak_error_message( error, __func__ , "wrong inversion of mask value" );
+     wc->mulq( (ak_uint64 *)skey->mask.data, (ak_uint64 *)skey->mask.data, wc->r2q,
+                                                                           wc->q, wc->nq, wc->size );
+     wc->mulq( (ak_uint64 *)skey->mask.data, (ak_uint64 *)skey->mask.data, wc->r2q,
+                                                                           wc->q, wc->nq, wc->size );
     /* меняем значение флага */
      skey->flags |= skey_flag_set_mask;
 
@@ -107,15 +117,16 @@
      ak_mpzn_rem( zeta, zeta, wc->q, wc->size );
 
     /* домножаем ключ на случайное число */
-     ak_mpzn_mul_montgomery( (ak_uint64 *)skey->key.data, (ak_uint64 *)skey->key.data,
+     wc->mulq( (ak_uint64 *)skey->key.data, (ak_uint64 *)skey->key.data,
                                                                     zeta, wc->q, wc->nq, wc->size );
-    /* вычисляем обратное значение zeta */
-     ak_mpzn_set_ui( u, wc->size, 2 );
-     ak_mpzn_sub( u, wc->q, u, wc->size );
-     ak_mpzn_modpow_montgomery( zeta, zeta, u, wc->q, wc->nq, wc->size ); // z <- z^{q-2} (mod q)
+    /* вычисляем обратное значение zeta (в представлении Монтгомери) */
+     if(( error = ak_mpzn_inverse_safegcd( zeta, zeta, wc->q, wc->size )) != ak_error_ok )
+       return ak_error_message( error, __func__ , "wrong inversion of mask value" );
+     wc->mulq( zeta, zeta, wc->r2q, wc->q, wc->nq, wc->size );
+     wc->mulq( zeta, zeta, wc->r2q, wc->q, wc->nq, wc->size );
 
     /* домножаем маску на обратное значение zeta */
-     ak_mpzn_mul_montgomery( (ak_uint64 *)skey->mask.data, (ak_uint64 *)skey->mask.data,
+     wc->mulq( (ak_uint64 *)skey->mask.data, (ak_uint64 *)skey->mask.data,
                                                                    zeta, wc->q, wc->nq, wc->size );
   }
  return error;
@@ -150,10 +161,10 @@
   if( (( skey->flags)&skey_flag_set_mask ) == 0 ) return ak_error_ok;
 
  /* снимаем маску с ключа */
-  ak_mpzn_mul_montgomery( (ak_uint64 *)skey->key.data, (ak_uint64 *)skey->key.data,
+  wc->mulq( (ak_uint64 *)skey->key.data, (ak_uint64 *)skey->key.data,
                                         (ak_uint64 *)skey->mask.data, wc->q, wc->nq, wc->size );
  /* приводим ключ из представления Монтгомери в естественное состояние */
-  ak_mpzn_mul_montgomery( (ak_uint64 *)skey->key.data, (ak_uint64 *)skey->key.data,
+  wc->mulq( (ak_uint64 *)skey->key.data, (ak_uint64 *)skey->key.data,
                                                                    u, wc->q, wc->nq, wc->size );
 #ifndef LIBAKRYPT_LITTLE_ENDIAN
   for( i = 0; i < wc->size; i++ ) ((ak_uint64* )skey->key.data)[i] = bswap_64( ((ak_uint64* )skey->key.data)[i] );
@@ -335,6 +346,13 @@
   int error = ak_error_ok;
   if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                            "destroying a null pointer to digital signature secret key context" );
+  if( sctx->nonces != NULL ) {
+    ak_ptr_wipe( sctx->nonces, sctx->nonces_size*sizeof( struct sign_nonce ),
+                                                                   &sctx->key.generator, ak_true );
+    free( sctx->nonces );
+    sctx->nonces = NULL;
+    sctx->nonces_count = sctx->nonces_size = 0;
+  }
   if(( error = ak_skey_context_destroy( &sctx->key )) != ak_error_ok )
     ak_error_message( error, __func__ , "incorrect destroying of digital signature secret key" );
   if(( error = ak_hash_context_destroy( &sctx->ctx )) != ak_error_ok )
@@ -358,6 +376,62 @@
  return NULL;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция создает контекст секретного ключа, определенного на той же эллиптической кривой,
+    что и ключ `rkey`, и присваивает ему значение ключа `rkey`. Значение ключа копируется
+    в маскированном виде, после чего оба ключа независимо друг от друга перемаскируются.
+    Заранее вычисленные пары \f$ (k, r) \f$ не копируются.
+
+    @param sctx Контекст создаваемого ключа.
+    @param rkey Контекст ключа, значение которого дублируется.
+
+    @return В случае успеха возвращается значение \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_context_create_and_set_signkey( ak_signkey sctx, ak_signkey rkey )
+{
+  ak_wcurve wc = NULL;
+  int error = ak_error_ok;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                              "using null pointer to first secret key context" );
+  if( rkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                             "using null pointer to second secret key context" );
+  if( rkey->key.key.size == 0 ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                     "using non initialized secret key context" );
+  if(( wc = ( ak_wcurve ) rkey->key.data ) == NULL ) return ak_error_message(
+                     ak_error_null_pointer, __func__ , "using null pointer to elliptic curve" );
+
+  if( wc->size == ak_mpzn256_size ) error = ak_signkey_context_create_streebog256( sctx, wc );
+    else error = ak_signkey_context_create_streebog512( sctx, wc );
+  if( error != ak_error_ok )
+    return ak_error_message( error, __func__ , "incorrect creation of secret key context" );
+
+ /* копируем маскированное значение ключа, маску и ресурс */
+  ak_skey_context_modify_begin( &sctx->key );
+  memcpy( sctx->key.key.data, rkey->key.key.data, rkey->key.key.size );
+  memcpy( sctx->key.mask.data, rkey->key.mask.data, rkey->key.mask.size );
+  memcpy( sctx->key.icode.data, rkey->key.icode.data, rkey->key.icode.size );
+  memcpy( &sctx->key.resource, &rkey->key.resource, sizeof( struct resource ));
+  sctx->key.flags = rkey->key.flags;
+  ak_skey_context_modify_end( &sctx->key );
+
+ /* перемаскируем оба ключа */
+  ak_skey_context_modify_begin( &rkey->key );
+  error = rkey->key.set_mask( &rkey->key );
+  ak_skey_context_modify_end( &rkey->key );
+  if( error == ak_error_ok ) {
+    ak_skey_context_modify_begin( &sctx->key );
+    error = sctx->key.set_mask( &sctx->key );
+    ak_skey_context_modify_end( &sctx->key );
+  }
+  if( error != ak_error_ok ) {
+    ak_signkey_context_destroy( sctx );
+    return ak_error_message( error, __func__ , "incorrect secret key remasking" );
+  }
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param sctx контекст секретного ключа алгоритма электронной подписи.
     @return Функция возвращает константное значение.                                               */
@@ -433,6 +507,171 @@
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает `count` случайных вычетов \f$ k \f$ по модулю \f$ q \f$, для каждого из них
+    вычисляет точку \f$ C = [k]P \f$ и значение \f$ r \equiv x_C \pmod{q}\f$, после чего
+    помещает пары \f$ (k, r) \f$ в массив, хранящийся в контексте секретного ключа.
+
+    Вычисленные пары используются функцией ak_signkey_context_sign_hash(): пока массив не пуст,
+    выработка подписи сводится к нескольким умножениям по модулю \f$ q \f$, без вычисления
+    кратной точки. Каждая пара используется ровно один раз и уничтожается сразу после использования.
+
+    Значение \f$ k \f$ хранится в виде двух вычетов \f$ k_1 \equiv kt \pmod{q} \f$ и
+    \f$ k_2 \equiv t^{-1} \pmod{q} \f$, где \f$ t \f$ вырабатывается генератором,
+    связанным с секретным ключом.
+
+    @param sctx контекст секретного ключа алгоритма электронной подписи.
+    @param count количество вычисляемых пар.
+    @return В случае успеха возвращается ноль (\ref ak_error_ok). В противном случае возвращается
+    код ошибки.                                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_context_precompute( ak_signkey sctx, const size_t count )
+{
+  size_t i = 0, total = 0;
+  struct wpoint wr;
+  ak_mpzn512 k, t;
+  ak_wcurve wc = NULL;
+  ak_sign_nonce np = NULL;
+  int error = ak_error_ok;
+  ak_context_manager manager = NULL;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "using null pointer to secret key context" );
+  if( sctx->key.key.size == 0 ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                     "using non initialized secret key context" );
+  if( count == 0 ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                       "using zero number of precomputed values" );
+  if(( total = sctx->nonces_count + count ) < count ) return ak_error_message(
+                         ak_error_wrong_length, __func__ , "too large number of precomputed values" );
+  if(( manager = ak_libakrypt_get_context_manager()) == NULL ) return ak_error_message(
+                   ak_error_null_pointer, __func__, "using internal pointer to context manager" );
+
+ /* увеличиваем объем памяти; старый массив уничтожается, а не передается realloc(),
+    чтобы не оставлять в памяти копий секретных значений */
+  if( total > sctx->nonces_size ) {
+    if(( np = calloc( total, sizeof( struct sign_nonce ))) == NULL )
+      return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                   "incorrect memory allocation for nonce array" );
+    if( sctx->nonces != NULL ) {
+      memcpy( np, sctx->nonces, sctx->nonces_count*sizeof( struct sign_nonce ));
+      ak_ptr_wipe( sctx->nonces, sctx->nonces_size*sizeof( struct sign_nonce ),
+                                                                   &sctx->key.generator, ak_true );
+      free( sctx->nonces );
+    }
+    sctx->nonces = np;
+    sctx->nonces_size = total;
+  }
+
+  wc = ( ak_wcurve ) sctx->key.data;
+  memset( k, 0, sizeof( ak_mpzn512 ));
+  memset( t, 0, sizeof( ak_mpzn512 ));
+  for( i = 0; i < count; i++ ) {
+     np = sctx->nonces + sctx->nonces_count;
+
+    /* вырабатываем случайное число k и маску t */
+     if(( error = ak_mpzn_set_random_modulo( k, wc->q, wc->size,
+                                                    &manager->key_generator )) != ak_error_ok ) {
+       ak_error_message( error, __func__ , "invalid generation of random value" );
+       goto lab_exit;
+     }
+     if(( error = ak_mpzn_set_random_modulo( t, wc->q, wc->size,
+                                                       &sctx->key.generator )) != ak_error_ok ) {
+       ak_error_message( error, __func__ , "invalid generation of mask value" );
+       goto lab_exit;
+     }
+
+    /* вычисляем r */
+     ak_wpoint_pow( &wr, &wc->point, k, wc->size, wc );
+     ak_wpoint_reduce( &wr, wc );
+     ak_mpzn_rem( np->r, wr.x, wc->q, wc->size );
+
+    /* вычисляем k1 <- k*t, считая, что t уже находится в представлении Монтгомери */
+     wc->mulq( np->k1, k, wc->r2q, wc->q, wc->nq, wc->size );
+     wc->mulq( np->k1, np->k1, t, wc->q, wc->nq, wc->size );
+
+    /* вычисляем k2 <- t^{-1} (в представлении Монтгомери) */
+     if(( error = ak_mpzn_inverse_safegcd( np->k2, t, wc->q, wc->size )) != ak_error_ok ) {
+       ak_error_message( error, __func__ , "wrong inversion of mask value" );
+       goto lab_exit;
+     }
+     wc->mulq( np->k2, np->k2, wc->r2q, wc->q, wc->nq, wc->size );
+     wc->mulq( np->k2, np->k2, wc->r2q, wc->q, wc->nq, wc->size );
+
+     sctx->nonces_count++;
+  }
+
+ lab_exit:
+  ak_ptr_wipe( k, sizeof( ak_mpzn512 ), &sctx->key.generator, ak_true );
+  ak_ptr_wipe( t, sizeof( ak_mpzn512 ), &sctx->key.generator, ak_true );
+  memset( &wr, 0, sizeof( struct wpoint ));
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param sctx контекст секретного ключа алгоритма электронной подписи.
+    @return Функция возвращает количество пар \f$ (k, r) \f$, вычисленных с помощью функции
+    ak_signkey_context_precompute() и еще не использованных для выработки подписи.
+    В случае ошибки возвращается ноль.                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ size_t ak_signkey_context_get_precomputed_count( ak_signkey sctx )
+{
+  if( sctx == NULL ) { ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "using null pointer to secret key context" );
+    return 0;
+  }
+ return sctx->nonces_count;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет вторую половинку подписи \f$ s \equiv rd + ke \pmod{q}\f$ для уже
+    вычисленного значения \f$ r \f$, которое должно быть размещено в первой половине массива `out`,
+    и обновляет маску секретного ключа.
+
+    @param sctx контекст секретного ключа алгоритма электронной подписи.
+    @param kr вычет \f$ k \f$ в представлении Монтгомери.
+    @param e целое число, соотвествующее хеш-коду подписываемого сообщения.
+    @param out массив, в первой половине которого содержится значение \f$ r \f$.                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_signkey_context_sign_values_s( ak_signkey sctx,
+                                                      ak_uint64 *kr, ak_uint64 *e, ak_pointer out )
+{
+#ifndef LIBAKRYPT_LITTLE_ENDIAN
+  int i = 0;
+#endif
+  ak_mpznmax x;
+  ak_mpzn512 y, z;
+  ak_wcurve wc = ( ak_wcurve ) sctx->key.data;
+  ak_uint64 *r = (ak_uint64 *)out, *s = ( ak_uint64 *)out + wc->size;
+
+ /* вычисляем значение s <- r*d (mod q) (сначала домножаем на ключ, потом на его маску);
+    поскольку r находится в обычном представлении, результат также получается в обычном виде */
+  wc->mulq( s, r, sctx->key.key.data, wc->q, wc->nq, wc->size );
+  wc->mulq( s, s, sctx->key.mask.data, wc->q, wc->nq, wc->size );
+
+ /* приводим e по модулю q с помощью алгоритма Барретта и помещаем в переменную z <- e */
+  memset( x, 0, sizeof( ak_mpznmax ));
+  memcpy( x, e, sizeof( ak_uint64 )*wc->size );
+  ak_mpzn_rem_barrett( z, x, wc->q, wc->muq, wc->size );
+  if( ak_mpzn_cmp_ui( z, wc->size, 0 )) ak_mpzn_set_ui( z, wc->size, 1 );
+
+ /* вычисляем k*e (mod q) (k в форме Монтгомери, поэтому произведение в обычной форме)
+    и вычисляем s = r*d + k*e (mod q) */
+  wc->mulq( y, kr, z, wc->q, wc->nq, wc->size ); /* y <- k*e */
+  ak_mpzn_add_montgomery( s, s, y, wc->q, wc->size );
+
+#ifndef LIBAKRYPT_LITTLE_ENDIAN
+  for( i = 0; i < 2*wc->size; i++ ) ((ak_uint64* )out)[i] = bswap_64( ((ak_uint64* )out)[i] );
+#endif
+
+ /* завершаемся */
+  memset( x, 0, sizeof( ak_mpznmax ));
+  memset( y, 0, sizeof( ak_mpzn512 ));
+  memset( z, 0, sizeof( ak_mpzn512 ));
+  ak_skey_context_modify_begin( &sctx->key );
+  sctx->key.set_mask( &sctx->key );
+  ak_skey_context_modify_end( &sctx->key );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция вырабатывает электронную подпись для \f$ e \f$ - вычисленного хеш-кода подписываемого
     сообщения и заданного случайного числа \f$ k \f$. Для этого
@@ -467,12 +706,9 @@
  void ak_signkey_context_sign_const_values( ak_signkey sctx,
                                                        ak_uint64 *k, ak_uint64 *e, ak_pointer out )
 {
-#ifndef LIBAKRYPT_LITTLE_ENDIAN
-  int i = 0;
-#endif
   struct wpoint wr;
   ak_wcurve wc = ( ak_wcurve ) sctx->key.data;
-  ak_uint64 *r = (ak_uint64 *)out, *s = ( ak_uint64 *)out + wc->size;
+  ak_uint64 *r = (ak_uint64 *)out;
 
  /* поскольку функция не экспортируется, мы оставляем все проверки функциям верхнего уровня */
  /* вычисляем r */
@@ -480,35 +716,12 @@
   ak_wpoint_reduce( &wr, wc );
   ak_mpzn_rem( r, wr.x, wc->q, wc->size );
 
- /* приводим r к виду Монтгомери и помещаем во временную переменную wr.x <- r */
-  ak_mpzn_mul_montgomery( wr.x, r, wc->r2q, wc->q, wc->nq, wc->size );
-
- /* вычисляем значение s <- r*d (mod q) (сначала домножаем на ключ, потом на его маску) */
-  ak_mpzn_mul_montgomery( s, wr.x, sctx->key.key.data, wc->q, wc->nq, wc->size );
-  ak_mpzn_mul_montgomery( s, s, sctx->key.mask.data, wc->q, wc->nq, wc->size );
-
  /* приводим k к виду Монтгомери и помещаем во временную переменную wr.y <- k */
-  ak_mpzn_mul_montgomery( wr.y, k, wc->r2q, wc->q, wc->nq, wc->size );
-
- /* приводим e к виду Монтгомери и помещаем во временную переменную wr.z <- e */
-  ak_mpzn_rem( wr.z, e, wc->q, wc->size );
-  if( ak_mpzn_cmp_ui( wr.z, wc->size, 0 )) ak_mpzn_set_ui( wr.z, wc->size, 1 );
-  ak_mpzn_mul_montgomery( wr.z, wr.z, wc->r2q, wc->q, wc->nq, wc->size );
-
- /* вычисляем k*e (mod q) и вычисляем s = r*d + k*e (mod q) (в форме Монтгомери) */
-  ak_mpzn_mul_montgomery( wr.y, wr.y, wr.z, wc->q, wc->nq, wc->size ); /* wr.y <- k*e */
-  ak_mpzn_add_montgomery( s, s, wr.y, wc->q, wc->size );
-
- /* приводим s к обычной форме */
-  ak_mpzn_mul_montgomery( s, s,  wc->point.z, /* для экономии памяти пользуемся равенством z = 1 */
-                                 wc->q, wc->nq, wc->size );
-#ifndef LIBAKRYPT_LITTLE_ENDIAN
-  for( i = 0; i < 2*wc->size; i++ ) ((ak_uint64* )out)[i] = bswap_64( ((ak_uint64* )out)[i] );
-#endif
+  wc->mulq( wr.y, k, wc->r2q, wc->q, wc->nq, wc->size );
 
- /* завершаемся */
+ /* вычисляем s */
+  ak_signkey_context_sign_values_s( sctx, wr.y, e, out );
   memset( &wr, 0, sizeof( struct wpoint ));
-  sctx->key.set_mask( &sctx->key );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -534,6 +747,7 @@
   ak_mpzn512 k, h;
   ak_pointer pout = out;
   ak_buffer result = NULL;
+  ak_sign_nonce np = NULL;
   int error = ak_error_ok;
  /* нужен нам для доступа к системному генератору случайных чисел */
   ak_context_manager manager = NULL;
@@ -558,10 +772,11 @@
     return NULL;
   }
 
- /* вырабатываем случайное число */
+ /* вырабатываем случайное число, если нет заранее вычисленных значений */
   memset( k, 0, sizeof( ak_uint64 )*ak_mpzn512_size );
-  if(( error = ak_mpzn_set_random_modulo( k, (( ak_wcurve )sctx->key.data)->q,
-  (( ak_wcurve )sctx->key.data)->size, &manager->key_generator )) != ak_error_ok ) {
+  if(( sctx->nonces_count == 0 ) &&
+     (( error = ak_mpzn_set_random_modulo( k, (( ak_wcurve )sctx->key.data)->q,
+       (( ak_wcurve )sctx->key.data)->size, &manager->key_generator )) != ak_error_ok )) {
     ak_error_message( error, __func__ , "invalid generation of random value");
     return NULL;
   }
@@ -583,7 +798,17 @@
 #endif
 
  /* и только теперь вычисляем электронную подпись */
-  ak_signkey_context_sign_const_values( sctx, k, h, pout );
+  if( sctx->nonces_count > 0 ) {
+    ak_wcurve wc = ( ak_wcurve ) sctx->key.data;
+
+   /* используем последнюю из вычисленных пар (k, r) и сразу ее уничтожаем */
+    np = sctx->nonces + ( --sctx->nonces_count );
+    memcpy( pout, np->r, size );
+    wc->mulq( k, np->k1, np->k2, wc->q, wc->nq, wc->size );
+    ak_ptr_wipe( np, sizeof( struct sign_nonce ), &sctx->key.generator, ak_true );
+    ak_signkey_context_sign_values_s( sctx, k, h, pout );
+  }
+   else ak_signkey_context_sign_const_values( sctx, k, h, pout );
 
  lab_exit:
    ak_ptr_wipe( k, sizeof( ak_uint64 )*ak_mpzn512_size, &sctx->key.generator, ak_true );
@@ -678,6 +903,473 @@
  return ak_signkey_context_sign_hash( sctx, hash, sctx->ctx.hsize, out );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                 выработка общих ключей (алгоритм VKO, Р 50.1.113-2016, RFC 7836)                */
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет точку \f$ R = [ck]Q \f$, где \f$ c \f$ кофактор эллиптической кривой,
+    и приводит ее к аффинной форме. Перед вычислениями проверяется, что точка \f$ Q \f$
+    принадлежит кривой; после вычислений проверяется, что точка \f$ R \f$ не является
+    бесконечно удаленной.
+
+    Кратная точка \f$ [k]Q \f$ вычисляется с помощью лесенки Монтгомери, а умножение на кофактор
+    (величина которого не является секретной) выполняется удвоениями и сложениями,
+    то есть за \f$ \log_2 c \f$ удвоений, а не за полный проход лесенки по 64-битному слову.
+
+    @param wr Точка \f$ R \f$, в которую помещается результат.
+    @param wq Точка \f$ Q \f$ (открытый ключ другой стороны); может совпадать с `wr`.
+    @param k Секретное значение, размер которого равен размеру параметров кривой.
+    @param wc Эллиптическая кривая.
+    @return В случае успеха возвращается ноль (\ref ak_error_ok). В противном случае возвращается
+    код ошибки.                                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_wpoint_vko( ak_wpoint wr, ak_wpoint wq, ak_uint64 *k, ak_wcurve wc )
+{
+  int i = 0;
+  struct wpoint wt;
+
+  if(( wr == NULL ) || ( wq == NULL )) return ak_error_message( ak_error_null_pointer,
+                                         __func__ , "using null pointer to elliptic curve point" );
+  if( k == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                             "using null pointer to secret value" );
+  if( wc == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                          "using null pointer to elliptic curve" );
+  if( !ak_wpoint_is_ok( wq, wc )) return ak_error_message( ak_error_curve_point, __func__ ,
+                                                "using point which does not belong to the curve" );
+ /* вычисляем [k]Q */
+  ak_wpoint_pow( &wt, wq, k, wc->size, wc );
+
+ /* домножаем на кофактор */
+  if( wc->cofactor > 1 ) {
+    struct wpoint ws;
+    ak_wpoint_set_wpoint( &ws, &wt, wc );
+    for( i = 30; i >= 0; i-- ) if(( wc->cofactor >> i )&1 ) break;
+    while( i-- > 0 ) {
+       ak_wpoint_double( &wt, wc );
+       if(( wc->cofactor >> i )&1 ) ak_wpoint_add( &wt, &ws, wc );
+    }
+    memset( &ws, 0, sizeof( struct wpoint ));
+  }
+
+  ak_wpoint_reduce( &wt, wc );
+  if( ak_mpzn_cmp_ui( wt.z, wc->size, 0 )) {
+    memset( &wt, 0, sizeof( struct wpoint ));
+    return ak_error_message( ak_error_curve_point, __func__ , "the result is the point at infinity" );
+  }
+  ak_wpoint_set_wpoint( wr, &wt, wc );
+  memset( &wt, 0, sizeof( struct wpoint ));
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция реализует алгоритм VKO, описанный в рекомендациях Р 50.1.113-2016 (RFC 7836):
+    вычисляется точка \f$ K = [c \cdot UKM \cdot d \pmod{q}]Q \f$, где \f$ d \f$ секретный ключ,
+    \f$ c \f$ кофактор кривой и \f$ Q \f$ открытый ключ другой стороны; результатом является
+    хеш-код от конкатенации координат точки \f$ K \f$, записанных в little endian. Для хеширования
+    используется функция хеширования, связанная с секретным ключом.
+
+    Секретный ключ используется в маскированном виде: вычет \f$ UKM \cdot d \pmod{q} \f$
+    вычисляется умножением на маскированное значение ключа и его маску, после чего ключ
+    перемаскируется.
+
+    @param sctx контекст секретного ключа алгоритма электронной подписи.
+    @param wq открытый ключ другой стороны (точка, принадлежащая той же кривой).
+    @param ukm значение \f$ UKM \f$ в little endian; если указатель равен NULL,
+    используется значение \f$ UKM = 1 \f$.
+    @param ukm_size размер \f$ UKM \f$ в байтах (не более размера параметров кривой).
+    @param out область памяти, куда помещается результат; размер области должен быть
+    не меньше длины хеш-кода функции хеширования, связанной с ключом.
+    @return В случае успеха возвращается ноль (\ref ak_error_ok). В противном случае возвращается
+    код ошибки.                                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_context_vko( ak_signkey sctx, ak_wpoint wq,
+                                       const ak_pointer ukm, const size_t ukm_size, ak_pointer out )
+{
+  ak_wcurve wc = NULL;
+  struct wpoint wr;
+  ak_mpznmax u;
+  ak_mpzn512 s;
+  ak_uint8 buffer[128];
+  int error = ak_error_ok;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "using null pointer to secret key context" );
+  if( sctx->key.key.size == 0 ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                     "using non initialized secret key context" );
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using null pointer to output buffer" );
+  wc = ( ak_wcurve ) sctx->key.data;
+  if(( ukm != NULL ) && ( ukm_size > sizeof( ak_uint64 )*wc->size ))
+    return ak_error_message( ak_error_wrong_length, __func__ , "using ukm with wrong length" );
+
+ /* вычисляем u = UKM (mod q), u != 0 */
+  memset( buffer, 0, sizeof( buffer ));
+  if(( ukm != NULL ) && ( ukm_size > 0 )) memcpy( buffer, ukm, ukm_size );
+   else buffer[0] = 1;
+  memset( u, 0, sizeof( ak_mpznmax ));
+  ak_mpzn_set_little_endian( u, wc->size, buffer, sizeof( ak_uint64 )*wc->size, ak_false );
+  ak_mpzn_rem_barrett( u, u, wc->q, wc->muq, wc->size );
+  if( ak_mpzn_cmp_ui( u, wc->size, 0 )) ak_mpzn_set_ui( u, wc->size, 1 );
+
+ /* вычисляем s = UKM*d (mod q) (сначала домножаем на ключ, потом на его маску);
+    поскольку u находится в обычном представлении, результат также получается в обычном виде */
+  wc->mulq( s, u, sctx->key.key.data, wc->q, wc->nq, wc->size );
+  wc->mulq( s, s, sctx->key.mask.data, wc->q, wc->nq, wc->size );
+  ak_skey_context_modify_begin( &sctx->key );
+  sctx->key.set_mask( &sctx->key );
+  ak_skey_context_modify_end( &sctx->key );
+
+ /* вычисляем точку и хешируем ее координаты */
+  if(( error = ak_wpoint_vko( &wr, wq, s, wc )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect calculation of common point" );
+    goto labexit;
+  }
+  ak_mpzn_to_little_endian( wr.x, wc->size, buffer, sizeof( ak_uint64 )*wc->size, ak_false );
+  ak_mpzn_to_little_endian( wr.y, wc->size,
+                  buffer + sizeof( ak_uint64 )*wc->size, sizeof( ak_uint64 )*wc->size, ak_false );
+  ak_error_set_value( ak_error_ok );
+  ak_hash_context_ptr( &sctx->ctx, buffer, 2*sizeof( ak_uint64 )*wc->size, out );
+  if(( error = ak_error_get_value()) != ak_error_ok )
+    ak_error_message( error, __func__ , "incorrect hashing of common point" );
+
+ labexit:
+  ak_ptr_wipe( s, sizeof( ak_mpzn512 ), &sctx->key.generator, ak_true );
+  memset( buffer, 0, sizeof( buffer ));
+  memset( &wr, 0, sizeof( struct wpoint ));
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                         пул потоков для выработки электронной подписи                           */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Максимальное количество потоков в пуле. */
+ #define ak_signkey_pool_max_workers (256)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Задание на выработку электронной подписи, помещаемое в очередь пула потоков. */
+ typedef struct signkey_pool_job {
+ /*! \brief подписываемый хеш-код */
+  ak_uint8 hash[64];
+ /*! \brief размер хеш-кода (в байтах) */
+  size_t size;
+ /*! \brief функция, получающая результат */
+  ak_function_signkey_pool_callback *callback;
+ /*! \brief пользовательские данные, передаваемые функции callback */
+  ak_pointer data;
+ /*! \brief следующее задание в очереди */
+  struct signkey_pool_job *next;
+} *ak_signkey_pool_job;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Поток пула: собственная копия секретного ключа и генератор случайных чисел. */
+ typedef struct signkey_pool_worker {
+ /*! \brief копия секретного ключа, маскируемая независимо от других копий */
+  struct signkey key;
+ /*! \brief генератор, используемый для выработки случайных чисел \f$ k \f$ */
+  struct random generator;
+ /*! \brief пул, которому принадлежит поток */
+  struct signkey_pool *pool;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ /*! \brief идентификатор потока */
+  pthread_t thread;
+ /*! \brief флаг успешного создания потока */
+  bool_t created;
+#endif
+} *ak_signkey_pool_worker;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Пул потоков, вырабатывающих электронные подписи с помощью одного секретного ключа. */
+ struct signkey_pool {
+ /*! \brief массив потоков */
+  ak_signkey_pool_worker workers;
+ /*! \brief количество инициализированных элементов массива workers */
+  size_t count;
+ /*! \brief первое задание в очереди */
+  ak_signkey_pool_job head;
+ /*! \brief последнее задание в очереди */
+  ak_signkey_pool_job tail;
+ /*! \brief количество поставленных в очередь, но не завершенных заданий */
+  size_t pending;
+ /*! \brief флаг завершения работы потоков */
+  bool_t stop;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ /*! \brief блокировка очереди заданий */
+  pthread_mutex_t lock;
+ /*! \brief сигнал о появлении в очереди нового задания */
+  pthread_cond_t ready;
+ /*! \brief сигнал о завершении всех заданий */
+  pthread_cond_t done;
+#endif
+};
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выработка подписи для одного задания и вызов функции, получающей результат. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_signkey_pool_worker_sign( ak_signkey_pool_worker worker, ak_signkey_pool_job job )
+{
+#ifndef LIBAKRYPT_LITTLE_ENDIAN
+  size_t i = 0;
+#endif
+  ak_mpzn512 k, h;
+  ak_uint8 sign[128];
+  int error = ak_error_ok;
+  ak_wcurve wc = ( ak_wcurve ) worker->key.key.data;
+
+  memset( k, 0, sizeof( ak_mpzn512 ));
+  memset( h, 0, sizeof( ak_mpzn512 ));
+  if(( error = ak_mpzn_set_random_modulo( k, wc->q, wc->size,
+                                                        &worker->generator )) == ak_error_ok ) {
+    memcpy( h, job->hash, job->size );
+#ifndef LIBAKRYPT_LITTLE_ENDIAN
+    for( i = 0; i < wc->size; i++ ) h[i] = bswap_64( h[i] );
+#endif
+    ak_signkey_context_sign_const_values( &worker->key, k, h, sign );
+  } else ak_error_message( error, __func__ , "invalid generation of random value" );
+
+  if( job->callback != NULL ) {
+    if( error == ak_error_ok ) job->callback( job->data, error, sign, 2*job->size );
+      else job->callback( job->data, error, NULL, 0 );
+  }
+  ak_ptr_wipe( k, sizeof( ak_mpzn512 ), &worker->key.key.generator, ak_true );
+  memset( sign, 0, sizeof( sign ));
+}
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция потока: извлекает задания из очереди, пока пул не будет уничтожен. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_signkey_pool_worker_thread( void *ptr )
+{
+  ak_signkey_pool_job job = NULL;
+  ak_signkey_pool_worker worker = ( ak_signkey_pool_worker ) ptr;
+  struct signkey_pool *pool = worker->pool;
+
+  for( ;; ) {
+     pthread_mutex_lock( &pool->lock );
+     while(( pool->head == NULL ) && !pool->stop ) pthread_cond_wait( &pool->ready, &pool->lock );
+    /* при завершении работы поток выходит только после того, как очередь опустеет */
+     if(( job = pool->head ) == NULL ) {
+       pthread_mutex_unlock( &pool->lock );
+       break;
+     }
+     if(( pool->head = job->next ) == NULL ) pool->tail = NULL;
+     pthread_mutex_unlock( &pool->lock );
+
+     ak_signkey_pool_worker_sign( worker, job );
+     memset( job, 0, sizeof( struct signkey_pool_job ));
+     free( job );
+
+     pthread_mutex_lock( &pool->lock );
+     if( --pool->pending == 0 ) pthread_cond_broadcast( &pool->done );
+     pthread_mutex_unlock( &pool->lock );
+  }
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция создает пул из `count` потоков, каждый из которых вырабатывает электронные подписи
+    с помощью собственной копии секретного ключа `sctx`. Копии создаются функцией
+    ak_signkey_context_create_and_set_signkey() и маскируются независимо друг от друга;
+    для выработки случайных чисел \f$ k \f$ каждый поток использует собственный генератор,
+    начальное состояние которого вырабатывается системным генератором ключевой информации.
+
+    Задания на выработку подписи передаются пулу функцией ak_signkey_pool_submit().
+    Если библиотека собрана без поддержки потоков, задания выполняются
+    непосредственно при их постановке в очередь.
+
+    После создания пула контекст `sctx` может использоваться независимо от пула.
+
+    @param sctx контекст секретного ключа алгоритма электронной подписи.
+    @param count количество потоков.
+    @return Функция возвращает указатель на созданный пул. В случае ошибки возвращается NULL,
+    а код ошибки может быть получен с помощью вызова функции ak_error_get_value().                 */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_signkey_pool ak_signkey_pool_new( ak_signkey sctx, const size_t count )
+{
+  size_t i = 0;
+  ak_uint8 seed[32];
+  ak_signkey_pool pool = NULL;
+  int error = ak_error_ok;
+  ak_context_manager manager = NULL;
+
+  if( sctx == NULL ) { ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "using null pointer to secret key context" );
+    return NULL;
+  }
+  if(( count == 0 ) || ( count > ak_signkey_pool_max_workers )) {
+    ak_error_message( ak_error_wrong_length, __func__ , "using wrong number of threads" );
+    return NULL;
+  }
+  if(( manager = ak_libakrypt_get_context_manager()) == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__, "using internal pointer to context manager" );
+    return NULL;
+  }
+
+  if(( pool = calloc( 1, sizeof( struct signkey_pool ))) == NULL ) {
+    ak_error_message( ak_error_out_of_memory, __func__ , "incorrect memory allocation for pool" );
+    return NULL;
+  }
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  if( pthread_mutex_init( &pool->lock, NULL ) != 0 ) {
+    free( pool );
+    ak_error_message( ak_error_undefined_function, __func__ , "wrong initialization of mutex" );
+    return NULL;
+  }
+  pthread_cond_init( &pool->ready, NULL );
+  pthread_cond_init( &pool->done, NULL );
+#endif
+  if(( pool->workers = calloc( count, sizeof( struct signkey_pool_worker ))) == NULL ) {
+    ak_error_message( ak_error_out_of_memory, __func__ , "incorrect memory allocation for threads" );
+    return ak_signkey_pool_delete( pool );
+  }
+
+ /* создаем копии ключа и генераторы */
+  for( i = 0; i < count; i++ ) {
+     ak_signkey_pool_worker worker = pool->workers + i;
+     if(( error = ak_signkey_context_create_and_set_signkey( &worker->key, sctx )) != ak_error_ok ) {
+       ak_error_message( error, __func__ , "incorrect copying of secret key" );
+       return ak_signkey_pool_delete( pool );
+     }
+     if(( error = ak_random_context_create_hashrnd_streebog256( &worker->generator )) != ak_error_ok ) {
+       ak_signkey_context_destroy( &worker->key );
+       ak_error_message( error, __func__ , "incorrect creation of random generator" );
+       return ak_signkey_pool_delete( pool );
+     }
+     worker->pool = pool;
+     pool->count++;
+
+     if((( error = ak_random_context_random( &manager->key_generator,
+                                                      seed, sizeof( seed ))) != ak_error_ok ) ||
+        (( error = ak_random_context_randomize( &worker->generator,
+                                                      seed, sizeof( seed ))) != ak_error_ok )) {
+       ak_ptr_wipe( seed, sizeof( seed ), &worker->key.key.generator, ak_true );
+       ak_error_message( error, __func__ , "incorrect initialization of random generator" );
+       return ak_signkey_pool_delete( pool );
+     }
+     ak_ptr_wipe( seed, sizeof( seed ), &worker->key.key.generator, ak_true );
+  }
+
+ /* запускаем потоки */
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  for( i = 0; i < count; i++ ) {
+     ak_signkey_pool_worker worker = pool->workers + i;
+     if( pthread_create( &worker->thread, NULL, ak_signkey_pool_worker_thread, worker ) != 0 ) {
+       ak_error_message( ak_error_undefined_function, __func__ , "wrong creation of thread" );
+       return ak_signkey_pool_delete( pool );
+     }
+     worker->created = ak_true;
+  }
+#endif
+ return pool;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция копирует хеш-код в задание и помещает задание в очередь пула. После выработки подписи
+    один из потоков пула вызывает функцию `callback`, передавая ей указатель `data`,
+    код ошибки и выработанную подпись. Функции `callback` могут вызываться одновременно
+    из разных потоков и в порядке, отличном от порядка постановки заданий в очередь.
+
+    @param pool пул потоков.
+    @param hash хеш-код подписываемого сообщения.
+    @param size размер хеш-кода (в байтах).
+    @param callback функция, получающая результат; может принимать значение NULL.
+    @param data указатель на пользовательские данные, передаваемые функции `callback`.
+    @return В случае успеха возвращается ноль (\ref ak_error_ok). В противном случае возвращается
+    код ошибки.                                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_pool_submit( ak_signkey_pool pool, const ak_pointer hash, const size_t size,
+                                      ak_function_signkey_pool_callback *callback, ak_pointer data )
+{
+  ak_signkey_pool_job job = NULL;
+
+  if( pool == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                  "using null pointer to pool" );
+  if( hash == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using null pointer to hash value" );
+  if( size != sizeof( ak_uint64 )*(( ak_wcurve )pool->workers[0].key.key.data)->size )
+    return ak_error_message( ak_error_wrong_length, __func__ , "using hash value with wrong length" );
+
+  if(( job = malloc( sizeof( struct signkey_pool_job ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                         "incorrect memory allocation for job" );
+  memcpy( job->hash, hash, size );
+  job->size = size;
+  job->callback = callback;
+  job->data = data;
+  job->next = NULL;
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &pool->lock );
+  if( pool->tail == NULL ) pool->head = job;
+    else pool->tail->next = job;
+  pool->tail = job;
+  pool->pending++;
+  pthread_cond_signal( &pool->ready );
+  pthread_mutex_unlock( &pool->lock );
+#else
+  ak_signkey_pool_worker_sign( pool->workers, job );
+  memset( job, 0, sizeof( struct signkey_pool_job ));
+  free( job );
+#endif
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param pool пул потоков.
+    @return В случае успеха возвращается ноль (\ref ak_error_ok). В противном случае возвращается
+    код ошибки.                                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_pool_wait( ak_signkey_pool pool )
+{
+  if( pool == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                  "using null pointer to pool" );
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &pool->lock );
+  while( pool->pending > 0 ) pthread_cond_wait( &pool->done, &pool->lock );
+  pthread_mutex_unlock( &pool->lock );
+#endif
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция дожидается выполнения всех заданий, находящихся в очереди, завершает работу потоков,
+    уничтожает копии секретного ключа и освобождает память.
+
+    @param ptr указатель на пул потоков.
+    @return Функция возвращает NULL.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_pointer ak_signkey_pool_delete( ak_pointer ptr )
+{
+  size_t i = 0;
+  ak_signkey_pool pool = ( ak_signkey_pool ) ptr;
+
+  if( pool == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__ , "using null pointer to pool" );
+    return NULL;
+  }
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_mutex_lock( &pool->lock );
+  pool->stop = ak_true;
+  pthread_cond_broadcast( &pool->ready );
+  pthread_mutex_unlock( &pool->lock );
+  if( pool->workers != NULL )
+    for( i = 0; i < pool->count; i++ )
+       if( pool->workers[i].created ) pthread_join( pool->workers[i].thread, NULL );
+  pthread_cond_destroy( &pool->done );
+  pthread_cond_destroy( &pool->ready );
+  pthread_mutex_destroy( &pool->lock );
+#endif
+  if( pool->workers != NULL ) {
+    for( i = 0; i < pool->count; i++ ) {
+       ak_random_context_destroy( &pool->workers[i].generator );
+       ak_signkey_context_destroy( &pool->workers[i].key );
+    }
+    free( pool->workers );
+  }
+  free( pool );
+ return NULL;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                     функции для работы с открытыми ключами электронной подписи                  */
 /* ----------------------------------------------------------------------------------------------- */
@@ -721,16 +1413,18 @@
   pctx->wc = ( ak_wcurve )sctx->key.data;
 
  /* теперь определяем открытый ключ */
-  ak_mpzn_mul_montgomery( k, (ak_uint64 *)sctx->key.key.data, one,
-                                                      pctx->wc->q, pctx->wc->nq, pctx->wc->size);
+  pctx->wc->mulq( k, (ak_uint64 *)sctx->key.key.data, one,
+                                                      pctx->wc->q, pctx->wc->nq, pctx->wc->size );
   ak_wpoint_pow( &pctx->qpoint, &pctx->wc->point, k, pctx->wc->size, pctx->wc );
-  ak_mpzn_mul_montgomery( k, (ak_uint64 *)sctx->key.mask.data, one,
-                                                      pctx->wc->q, pctx->wc->nq, pctx->wc->size);
+  pctx->wc->mulq( k, (ak_uint64 *)sctx->key.mask.data, one,
+                                                      pctx->wc->q, pctx->wc->nq, pctx->wc->size );
   ak_wpoint_pow( &pctx->qpoint, &pctx->qpoint, k, pctx->wc->size, pctx->wc );
   ak_wpoint_reduce( &pctx->qpoint, pctx->wc );
 
  /* перемаскируем секретный ключ */
+  ak_skey_context_modify_begin( &sctx->key );
   sctx->key.set_mask( &sctx->key );
+  ak_skey_context_modify_end( &sctx->key );
  return ak_error_ok;
 }
 
@@ -851,7 +1545,8 @@
 #ifndef LIBAKRYPT_LITTLE_ENDIAN
   int i = 0;
 #endif
-  ak_mpzn512 v, z1, z2, u, r, s, h;
+  ak_mpznmax v;
+  ak_mpzn512 z1, z2, r, s, h;
   struct wpoint cpoint, tpoint;
 
   if( pctx == NULL ) {
@@ -884,26 +1579,33 @@
   }
 #endif
 
+  /* значения r и s должны лежать в интервале (0, q) */
+  if( ak_mpzn_cmp_ui( r, pctx->wc->size, 0 ) || ak_mpzn_cmp_ui( s, pctx->wc->size, 0 ))
+    return ak_false;
+  if(( ak_mpzn_cmp( r, pctx->wc->q, pctx->wc->size ) >= 0 ) ||
+                           ( ak_mpzn_cmp( s, pctx->wc->q, pctx->wc->size ) >= 0 )) return ak_false;
+
+  /* e = h (mod q), если e = 0, то e = 1 */
+  memset( v, 0, sizeof( ak_mpznmax ));
   ak_mpzn_set( v, h, pctx->wc->size );
-  ak_mpzn_rem( v, v, pctx->wc->q, pctx->wc->size );
+  ak_mpzn_rem_barrett( v, v, pctx->wc->q, pctx->wc->muq, pctx->wc->size );
   if( ak_mpzn_cmp_ui( v, pctx->wc->size, 0 )) ak_mpzn_set_ui( v, pctx->wc->size, 1 );
-  ak_mpzn_mul_montgomery( v, v, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
 
-  /* вычисляем v (в представлении Монтгомери) */
-  ak_mpzn_set_ui( u, pctx->wc->size, 2 );
-  ak_mpzn_sub( u, pctx->wc->q, u, pctx->wc->size );
-  ak_mpzn_modpow_montgomery( v, v, u, pctx->wc->q, pctx->wc->nq, pctx->wc->size ); // v <- v^{q-2} (mod q)
+  /* вычисляем v = e^{-1} (в представлении Монтгомери);
+     поскольку значение хэш-кода открыто, используем более быстрый бинарный алгоритм */
+  if( ak_mpzn_inverse_binary( v, v, pctx->wc->q, pctx->wc->size ) != ak_error_ok ) {
+    ak_error_message( ak_error_get_value(), __func__ , "wrong inversion of hash value" );
+    return ak_false;
+  }
+  pctx->wc->mulq( v, v, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
 
-  /* вычисляем z1 */
-  ak_mpzn_mul_montgomery( z1, s, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
-  ak_mpzn_mul_montgomery( z1, z1, v, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
-  ak_mpzn_mul_montgomery( z1, z1, pctx->wc->point.z, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+  /* вычисляем z1 = s*v (mod q); поскольку s находится в обычном представлении,
+     а v в представлении Монтгомери, результат получается в обычной форме */
+  pctx->wc->mulq( z1, s, v, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
 
-  /* вычисляем z2 */
-  ak_mpzn_mul_montgomery( z2, r, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
-  ak_mpzn_sub( z2, pctx->wc->q, z2, pctx->wc->size );
-  ak_mpzn_mul_montgomery( z2, z2, v, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
-  ak_mpzn_mul_montgomery( z2, z2, pctx->wc->point.z, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+  /* вычисляем z2 = -r*v (mod q) */
+  ak_mpzn_sub( z2, pctx->wc->q, r, pctx->wc->size );
+  pctx->wc->mulq( z2, z2, v, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
 
  /* сложение точек и проверка */
   ak_wpoint_pow( &cpoint, &pctx->wc->point, z1, pctx->wc->size, pctx->wc );
@@ -916,6 +1618,276 @@
  return ak_true;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Данные одной проверяемой подписи, используемые функцией ak_verifykey_context_verify_batch(). */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct verify_batch_item {
+ /*! \brief Первая часть подписи */
+  ak_mpzn512 r;
+ /*! \brief Вторая часть подписи */
+  ak_mpzn512 s;
+ /*! \brief Вычет \f$ e \f$ (в представлении Монтгомери), затем обратный к нему вычет */
+  ak_mpzn512 v;
+ /*! \brief Произведение \f$ e_0e_1\cdots e_i \f$ (в представлении Монтгомери) */
+  ak_mpzn512 acc;
+ /*! \brief Коэффициенты, на которые умножаются образующая точка и открытый ключ */
+  ak_mpzn512 z1, z2;
+ /*! \brief Вычисляемая точка \f$ [z_1]P + [z_2]Q \f$ */
+  struct wpoint cpoint;
+ /*! \brief Открытый ключ, которым проверяется подпись */
+  ak_verifykey key;
+} *ak_verify_batch_item;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Задание на вычисление точек для нескольких проверяемых подписей. */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct verify_batch_task {
+ /*! \brief Массив проверяемых подписей */
+  ak_verify_batch_item items;
+ /*! \brief Номера подписей, для которых выполняются вычисления */
+  size_t *idx;
+ /*! \brief Общее количество номеров */
+  size_t count;
+ /*! \brief Номер первой обрабатываемой подписи */
+  size_t start;
+ /*! \brief Шаг, с которым перебираются подписи */
+  size_t step;
+} *ak_verify_batch_task;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление точек \f$ C = [z_1]P + [z_2]Q \f$ для подписей с номерами
+    idx[start], idx[start + step], ... (функция может выполняться в отдельном потоке). */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_verifykey_context_verify_batch_points( void *ptr )
+{
+  size_t i = 0;
+  struct wpoint tpoint;
+  ak_verify_batch_task task = ( ak_verify_batch_task ) ptr;
+
+  for( i = task->start; i < task->count; i += task->step ) {
+     ak_verify_batch_item item = task->items + task->idx[i];
+     ak_wcurve wc = item->key->wc;
+
+     ak_wpoint_pow( &item->cpoint, &wc->point, item->z1, wc->size, wc );
+     ak_wpoint_pow( &tpoint, &item->key->qpoint, item->z2, wc->size, wc );
+     ak_wpoint_add( &item->cpoint, &tpoint, wc );
+  }
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Проверка группы подписей, открытые ключи которых определены на одной кривой.
+
+    @param items Массив проверяемых подписей
+    @param idx Номера подписей группы
+    @param count Количество подписей в группе
+    @param results Массив результатов проверки
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_verifykey_context_verify_batch_group( ak_verify_batch_item items,
+                                                 size_t *idx, const size_t count, bool_t *results )
+{
+  size_t i = 0;
+  int error = ak_error_ok;
+  ak_mpzn512 u, t;
+  ak_wpoint *points = NULL;
+  struct verify_batch_task task;
+  ak_wcurve wc = items[idx[0]].key->wc;
+
+ /* прямой проход метода Монтгомери: acc_i = e_0e_1...e_i */
+  for( i = 0; i < count; i++ ) {
+     ak_verify_batch_item item = items + idx[i];
+     if( i == 0 ) ak_mpzn_set( item->acc, item->v, wc->size );
+       else wc->mulq( item->acc, items[idx[i-1]].acc, item->v, wc->q, wc->nq, wc->size );
+  }
+
+ /* единственное обращение: значения e открыты, поэтому используется бинарный алгоритм */
+  if(( error = ak_mpzn_inverse_binary( u, items[idx[count-1]].acc,
+                                                          wc->q, wc->size )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong inversion of hash values product" );
+  wc->mulq( u, u, wc->r2q, wc->q, wc->nq, wc->size );
+  wc->mulq( u, u, wc->r2q, wc->q, wc->nq, wc->size );
+
+ /* обратный проход: v_i = e_i^{-1}, после чего вычисляем z1 и z2 (как в функции
+    ak_verifykey_context_verify_hash() ) */
+  i = count;
+  while( i-- > 0 ) {
+     ak_verify_batch_item item = items + idx[i];
+     if( i > 0 ) wc->mulq( t, u, items[idx[i-1]].acc, wc->q, wc->nq, wc->size );
+       else ak_mpzn_set( t, u, wc->size );
+     wc->mulq( u, u, item->v, wc->q, wc->nq, wc->size );
+     ak_mpzn_set( item->v, t, wc->size );
+
+     wc->mulq( item->z1, item->s, wc->r2q, wc->q, wc->nq, wc->size );
+     wc->mulq( item->z1, item->z1, item->v, wc->q, wc->nq, wc->size );
+     wc->mulq( item->z1, item->z1, wc->point.z, wc->q, wc->nq, wc->size );
+
+     wc->mulq( item->z2, item->r, wc->r2q, wc->q, wc->nq, wc->size );
+     ak_mpzn_sub( item->z2, wc->q, item->z2, wc->size );
+     wc->mulq( item->z2, item->z2, item->v, wc->q, wc->nq, wc->size );
+     wc->mulq( item->z2, item->z2, wc->point.z, wc->q, wc->nq, wc->size );
+  }
+
+ /* вычисляем точки, при необходимости распределяя вычисления между потоками */
+  task.items = items;
+  task.idx = idx;
+  task.count = count;
+  task.start = 0;
+  task.step = 1;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  size_t threads = ( size_t ) ak_libakrypt_get_option_by_index( option_verify_batch_threads );
+  if( threads > count ) threads = count;
+  if( threads > 64 ) threads = 64;
+  if( threads > 1 ) {
+    size_t j = 0;
+    pthread_t tid[64];
+    bool_t created[64];
+    struct verify_batch_task tasks[64];
+
+    task.step = threads;
+    for( j = 1; j < threads; j++ ) {
+       tasks[j] = task;
+       tasks[j].start = j;
+       created[j] = ( pthread_create( &tid[j], NULL,
+                          ak_verifykey_context_verify_batch_points, &tasks[j] ) == 0 );
+    }
+    ak_verifykey_context_verify_batch_points( &task );
+   /* задания, для которых не удалось создать поток, выполняются в текущем потоке */
+    for( j = 1; j < threads; j++ )
+       if( created[j] ) pthread_join( tid[j], NULL );
+         else ak_verifykey_context_verify_batch_points( &tasks[j] );
+  } else
+#endif
+  ak_verifykey_context_verify_batch_points( &task );
+
+ /* одновременно приводим все точки к аффинной форме */
+  if(( points = malloc( count*sizeof( ak_wpoint ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                        "incorrect memory allocation for points" );
+  for( i = 0; i < count; i++ ) points[i] = &items[idx[i]].cpoint;
+  if(( error = ak_wpoint_reduce_batch( points, count, wc )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "wrong reduction of points" );
+    free( points );
+    return error;
+  }
+  free( points );
+
+  for( i = 0; i < count; i++ ) {
+     ak_verify_batch_item item = items + idx[i];
+     ak_mpzn_rem( item->cpoint.x, item->cpoint.x, wc->q, wc->size );
+     if( ak_mpzn_cmp( item->cpoint.x, item->r, wc->size ) == 0 ) results[idx[i]] = ak_true;
+  }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет сразу несколько электронных подписей, вычисленных для заранее
+    вычисленных значений хеш-функции. Для каждой подписи используется свой открытый ключ;
+    длина хеш-кода \f$ i \f$-й подписи должна совпадать с длиной параметров кривой,
+    на которой определен ключ keys[i].
+
+    По сравнению с последовательным вызовом функции ak_verifykey_context_verify_hash()
+    экономия достигается за счет следующих приемов:
+     - подписи группируются по эллиптическим кривым, для каждой группы вычеты \f$ e^{-1} \pmod{q}\f$
+       вычисляются методом Монтгомери одновременного обращения (одно обращение на группу),
+     - итоговые точки приводятся к аффинной форме функцией ak_wpoint_reduce_batch(),
+       также выполняющей одно обращение на группу,
+     - вычисление кратных точек может выполняться в нескольких потоках; количество потоков
+       определяется опцией библиотеки `verify_batch_threads` (по-умолчанию, один поток).
+
+    @param keys Массив указателей на контексты открытых ключей
+    @param hashes Массив указателей на значения хеш-кодов
+    @param signs Массив указателей на проверяемые электронные подписи
+    @param count Количество проверяемых подписей
+    @param results Массив, в который помещаются результаты проверки:
+    ak_true, если подпись верна, и ak_false, если подпись неверна или не может быть проверена
+    (например, задан NULL указатель на ключ, хеш-код или подпись).
+
+    @return Функция возвращает \ref ak_error_ok, если проверка была проведена (при этом
+    часть подписей может оказаться неверной). В противном случае возвращается код ошибки,
+    а все элементы массива results принимают значение ak_false.                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_verifykey_context_verify_batch( ak_verifykey *keys, ak_pointer *hashes,
+                                      ak_pointer *signs, const size_t count, bool_t *results )
+{
+  size_t i = 0, j = 0, gcount = 0, *idx = NULL;
+  ak_mpznmax wide;
+  ak_verify_batch_item items = NULL;
+  int error = ak_error_ok;
+  bool_t *done = NULL;
+
+  if(( keys == NULL ) || ( hashes == NULL ) || ( signs == NULL ) || ( results == NULL ))
+    return ak_error_message( ak_error_null_pointer, __func__ , "using null pointer to input arrays" );
+  if( count == 0 ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                            "using zero number of signatures" );
+  for( i = 0; i < count; i++ ) results[i] = ak_false;
+
+  if((( items = malloc( count*sizeof( struct verify_batch_item ))) == NULL ) ||
+     (( idx = malloc( count*sizeof( size_t ))) == NULL ) ||
+     (( done = malloc( count*sizeof( bool_t ))) == NULL )) {
+    error = ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                  "incorrect memory allocation for signatures" );
+    goto labexit;
+  }
+
+ /* загружаем подписи и хеш-коды, некорректные подписи сразу исключаем из проверки */
+  for( i = 0; i < count; i++ ) {
+     ak_verify_batch_item item = items + i;
+     ak_wcurve wc = NULL;
+
+     done[i] = ak_true;
+     if(( keys[i] == NULL ) || ( hashes[i] == NULL ) || ( signs[i] == NULL )) continue;
+     if(( wc = keys[i]->wc ) == NULL ) continue;
+     item->key = keys[i];
+
+     memcpy( item->r, ( ak_uint64 *)signs[i], sizeof( ak_uint64 )*wc->size );
+     memcpy( item->s, ( ak_uint64 *)signs[i] + wc->size, sizeof( ak_uint64 )*wc->size );
+     memcpy( item->v, hashes[i], sizeof( ak_uint64 )*wc->size );
+#ifndef LIBAKRYPT_LITTLE_ENDIAN
+     for( j = 0; j < wc->size; j++ ) {
+        item->r[j] = bswap_64( item->r[j] );
+        item->s[j] = bswap_64( item->s[j] );
+        item->v[j] = bswap_64( item->v[j] );
+     }
+#endif
+    /* значения r и s должны лежать в интервале (0, q) */
+     if( ak_mpzn_cmp_ui( item->r, wc->size, 0 ) || ak_mpzn_cmp_ui( item->s, wc->size, 0 )) continue;
+     if(( ak_mpzn_cmp( item->r, wc->q, wc->size ) >= 0 ) ||
+                                         ( ak_mpzn_cmp( item->s, wc->q, wc->size ) >= 0 )) continue;
+
+    /* e = h (mod q), если e = 0, то e = 1; переводим e в представление Монтгомери */
+     memset( wide, 0, sizeof( ak_mpznmax ));
+     memcpy( wide, item->v, sizeof( ak_uint64 )*wc->size );
+     ak_mpzn_rem_barrett( item->v, wide, wc->q, wc->muq, wc->size );
+     if( ak_mpzn_cmp_ui( item->v, wc->size, 0 )) ak_mpzn_set_ui( item->v, wc->size, 1 );
+     wc->mulq( item->v, item->v, wc->r2q, wc->q, wc->nq, wc->size );
+     done[i] = ak_false;
+  }
+
+ /* проверяем подписи группами, ключи которых определены на одной кривой */
+  for( i = 0; i < count; i++ ) {
+     if( done[i] ) continue;
+     for( j = i, gcount = 0; j < count; j++ ) {
+        if( done[j] || ( keys[j]->wc != keys[i]->wc )) continue;
+        idx[gcount++] = j;
+        done[j] = ak_true;
+     }
+     if(( error = ak_verifykey_context_verify_batch_group( items,
+                                                          idx, gcount, results )) != ak_error_ok ) {
+       ak_error_message( error, __func__ , "wrong verification of signatures group" );
+       for( j = 0; j < count; j++ ) results[j] = ak_false;
+       goto labexit;
+     }
+  }
+
+  labexit:
+   if( items != NULL ) free( items );
+   if( idx != NULL ) free( idx );
+   if( done != NULL ) free( done );
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param pctx контекст открытого ключа.
     @param in область памяти для которой проверяется электронная подпись.
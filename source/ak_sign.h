@@ -11,6 +11,23 @@
  #include <ak_hmac.h>
  #include <ak_curves.h>
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Заранее вычисленная пара значений \f$ (k, r) \f$, используемая при выработке
+    электронной подписи.
+
+    Значение \f$ k \f$ хранится в маскированном виде, как произведение двух вычетов
+    \f$ k_1 \equiv kt \pmod{q} \f$ и \f$ k_2 \equiv t^{-1} \pmod{q} \f$, где \f$ t \f$
+    случайный вычет. Оба вычета хранятся в представлении Монтгомери.                               */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct sign_nonce {
+ /*! \brief маскированное значение случайного числа \f$ k \f$ */
+  ak_mpzn512 k1;
+ /*! \brief маска случайного числа \f$ k \f$ */
+  ak_mpzn512 k2;
+ /*! \brief значение \f$ r \equiv x_C \pmod{q} \f$, где \f$ C = [k]P \f$ */
+  ak_mpzn512 r;
+} *ak_sign_nonce;
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Секретный ключ алгоритма выработки электронной подписи ГОСТ Р 34.10-2012.
 
@@ -24,6 +41,12 @@
   struct skey key;
  /*! \brief контекст функции хеширования */
   struct hash ctx;
+ /*! \brief массив заранее вычисленных пар \f$ (k, r) \f$ */
+  ak_sign_nonce nonces;
+ /*! \brief количество пар, доступных для выработки подписи */
+  size_t nonces_count;
+ /*! \brief количество пар, под которые выделена память */
+  size_t nonces_size;
 } *ak_signkey;
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -42,6 +65,8 @@
  int ak_signkey_context_destroy( ak_signkey );
 /*! \brief Освобождение памяти из под контекста секретного ключа. */
  ak_pointer ak_signkey_context_delete( ak_pointer );
+/*! \brief Инициализация контекста секретного ключа значением другого ключа. */
+ int ak_signkey_context_create_and_set_signkey( ak_signkey , ak_signkey );
 /*! \brief Размер области памяти, которую занимает электронная подпись. */
  size_t ak_signkey_context_get_code_size( ak_signkey );
 
@@ -50,6 +75,10 @@
  int ak_signkey_context_set_key( ak_signkey , const ak_pointer , const size_t , const bool_t );
 /*! \brief Присвоение секретному ключу электронной подписи случайного значения. */
  int ak_signkey_context_set_key_random( ak_signkey , ak_random );
+/*! \brief Предварительное вычисление пар \f$ (k, r) \f$ для последующей выработки подписей. */
+ int ak_signkey_context_precompute( ak_signkey , const size_t );
+/*! \brief Количество заранее вычисленных пар \f$ (k, r) \f$, доступных для выработки подписей. */
+ size_t ak_signkey_context_get_precomputed_count( ak_signkey );
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Выработка электронной подписи для фиксированного значения случайного числа и вычисленного
@@ -62,6 +91,33 @@
 /*! \brief Выработка электронной подписи для заданного файла. */
  ak_buffer ak_signkey_context_sign_file( ak_signkey , const char * , ak_pointer );
 
+/*! \brief Вычисление общей точки эллиптической кривой \f$ R = [ck]Q \f$ для алгоритма VKO. */
+ int ak_wpoint_vko( ak_wpoint , ak_wpoint , ak_uint64 * , ak_wcurve );
+/*! \brief Выработка общего ключа по алгоритму VKO (Р 50.1.113-2016). */
+ int ak_signkey_context_vko( ak_signkey , ak_wpoint , const ak_pointer , const size_t , ak_pointer );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция, вызываемая по завершении выработки электронной подписи в пуле потоков.
+
+    Функция получает указатель на пользовательские данные, переданные при постановке задания
+    в очередь, код ошибки, указатель на выработанную подпись и ее размер (в байтах).
+    Указатель на подпись действителен только во время вызова функции.                              */
+ typedef void ( ak_function_signkey_pool_callback )( ak_pointer , int , ak_pointer , size_t );
+
+ struct signkey_pool;
+/*! \brief Пул потоков, вырабатывающих электронные подписи с помощью одного секретного ключа. */
+ typedef struct signkey_pool *ak_signkey_pool;
+
+/*! \brief Создание пула потоков для выработки электронной подписи. */
+ ak_signkey_pool ak_signkey_pool_new( ak_signkey , const size_t );
+/*! \brief Постановка в очередь задания на выработку электронной подписи. */
+ int ak_signkey_pool_submit( ak_signkey_pool , const ak_pointer , const size_t ,
+                                                 ak_function_signkey_pool_callback * , ak_pointer );
+/*! \brief Ожидание завершения всех заданий, поставленных в очередь. */
+ int ak_signkey_pool_wait( ak_signkey_pool );
+/*! \brief Уничтожение пула потоков для выработки электронной подписи. */
+ ak_pointer ak_signkey_pool_delete( ak_pointer );
+
 /*! \brief Выполнение тестовых примеров для алгоритмов выработки и проверки электронной подписи */
  bool_t ak_signkey_test( void );
 
@@ -98,6 +154,10 @@
 /*! \brief Проверка электронной подписи для вычисленного заранее значения хеш-функции. */
  bool_t ak_verifykey_context_verify_hash( ak_verifykey , const ak_pointer ,
                                                                        const size_t , ak_pointer );
+/*! \brief Одновременная проверка нескольких электронных подписей для вычисленных заранее
+    значений хеш-функции. */
+ int ak_verifykey_context_verify_batch( ak_verifykey * , ak_pointer * , ak_pointer * ,
+                                                                         const size_t , bool_t * );
 /*! \brief Проверка электронной подписи для заданной области памяти. */
  bool_t ak_verifykey_context_verify_ptr( ak_verifykey , const ak_pointer ,
                                                                        const size_t , ak_pointer );
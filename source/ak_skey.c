@@ -4,6 +4,12 @@
 /*  Файл ak_skey.h                                                                                 */
 /*  - содержит реализации функций, предназначенных для хранения и обработки ключевой информации.   */
 /* ----------------------------------------------------------------------------------------------- */
+/* это объявление нужно для использования функции clock_gettime() */
+#ifdef __linux__
+ #ifndef _DEFAULT_SOURCE
+   #define _DEFAULT_SOURCE
+ #endif
+#endif
 #ifdef LIBAKRYPT_HAVE_TIME_H
  #include <time.h>
 #else
@@ -20,6 +26,10 @@
  #error Library cannot be compiled without string.h header
 #endif
 
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
  #include <ak_mac.h>
  #include <ak_tools.h>
@@ -52,29 +62,38 @@
                                                               "using a zero length for key size" );
   if( isize == 0 ) return ak_error_message( ak_error_zero_length, __func__,
                                                         "using a zero length for integrity code" );
- /* Инициализируем данные базовыми значениями */
+ /* до полной инициализации ключ не проверяется фоновым потоком */
+  memset( &skey->verify, 0, sizeof( struct icode_check ));
+
+ /* Инициализируем данные базовыми значениями;
+    ключ, маска и контрольная сумма размещаются в защищенной области памяти */
   if(( error = ak_buffer_create_function_size( &skey->key,
-                       /* в настоящий момент для выделения памяти используются стандартные функции */
-                                    ak_libakrypt_aligned_malloc, free, size )) != ak_error_ok ) {
+                ak_libakrypt_secure_malloc, ak_libakrypt_secure_free, size )) != ak_error_ok ) {
     ak_error_message( error, __func__ ,"wrong creation a secret key buffer" );
     ak_skey_context_destroy( skey );
     return error;
   }
-  if(( error = ak_buffer_create_size( &skey->mask, size )) != ak_error_ok ) {
+  if(( error = ak_buffer_create_function_size( &skey->mask,
+                ak_libakrypt_secure_malloc, ak_libakrypt_secure_free, size )) != ak_error_ok ) {
     ak_error_message( error, __func__ ,"wrong creation a key mask buffer" );
     ak_skey_context_destroy( skey );
     return error;
   }
-  if(( error = ak_buffer_create_size( &skey->icode, isize )) != ak_error_ok ) {
+  if(( error = ak_buffer_create_function_size( &skey->icode,
+               ak_libakrypt_secure_malloc, ak_libakrypt_secure_free, isize )) != ak_error_ok ) {
     ak_error_message( error, __func__ ,"wrong creation a integrity code buffer" );
     ak_skey_context_destroy( skey );
     return error;
   }
   skey->data = NULL;
   memset( &(skey->resource), 0, sizeof( struct resource )); /* ресурс ключа не определен */
+ /* политика смены маски определяется опциями библиотеки */
+  ak_skey_context_set_mask_refresh( skey,
+     ( mask_refresh_policy_t ) ak_libakrypt_get_option_by_index( option_mask_refresh_policy ),
+                               ak_libakrypt_get_option_by_index( option_mask_refresh_interval ));
 
- /* инициализируем генератор масок */
-  if(( error = ak_random_context_create_xorshift32( &skey->generator )) != ak_error_ok ) {
+ /* инициализируем генератор масок: используется генератор текущего потока */
+  if(( error = ak_random_context_create_thread_local( &skey->generator )) != ak_error_ok ) {
     ak_error_message( error, __func__ , "wrong creation of random generator" );
     ak_skey_context_destroy( skey );
     return error;
@@ -83,7 +102,7 @@
  /* номер ключа генерится случайным образом; изменяется позднее, например,
                                                            при считывания с файлового носителя */
   if(( error = ak_buffer_create_size( &skey->number,
-                (const size_t) ak_libakrypt_get_option( "key_number_length" ))) != ak_error_ok ) {
+                (const size_t) ak_libakrypt_get_option_by_index( option_key_number_length ))) != ak_error_ok ) {
     ak_error_message( error, __func__ ,"wrong creation key number buffer" );
     ak_skey_context_destroy( skey );
     return error;
@@ -108,6 +127,11 @@
   skey->set_icode = ak_skey_context_set_icode_xor;
   skey->check_icode = ak_skey_context_check_icode_xor;
 
+ /* политика проверки контрольной суммы определяется опциями библиотеки;
+    она устанавливается последней, поскольку ключ может быть зарегистрирован для фоновой проверки */
+  ak_skey_context_set_icode_check( skey,
+     ( icode_check_policy_t ) ak_libakrypt_get_option_by_index( option_icode_check_policy ),
+                               ak_libakrypt_get_option_by_index( option_icode_check_interval ));
  return ak_error_ok;
 }
 
@@ -125,6 +149,9 @@
 
   if( skey == NULL ) return ak_error_message( ak_error_null_pointer,
                                              __func__ , "destroying a null pointer to secret key" );
+ /* исключаем ключ из числа ключей, проверяемых фоновым потоком */
+  ak_skey_context_set_icode_check( skey, icode_check_every_call, 1 );
+
  /* готвим маску */
   if(( error = ak_random_context_random( &skey->generator,
                                                   data, sizeof( struct skey ))) != ak_error_ok ) {
@@ -144,7 +171,7 @@
   ak_random_context_destroy( &skey->generator );
   if( skey->data != NULL ) {
    /* при установленном флаге память не очищаем */
-    if( !((skey->flags)&skey_flag_data_not_free )) free( skey->data );
+    if( !((skey->flags)&skey_flag_data_not_free )) ak_libakrypt_secure_free( skey->data );
   }
   ak_buffer_destroy( &skey->number );
   skey->oid = NULL;
@@ -157,6 +184,33 @@
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция замещает значения ключа, его маски и контрольной суммы случайными данными,
+    не освобождая выделенную под них память. После вызова функции ключ считается
+    неустановленным и может повторно использоваться после присвоения нового значения.
+
+    @param skey контекст секретного ключа
+    @return Функция возвращает \ref ak_error_ok (ноль) в случае успеха.
+    В противном случае возвращается код ошибки.                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_skey_context_wipe( ak_skey skey )
+{
+  int error = ak_error_ok;
+
+  if(( error = ak_skey_context_check( skey )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "using invalid secret key" );
+
+  ak_skey_context_modify_begin( skey );
+  ak_buffer_wipe( &skey->key, &skey->generator );
+  ak_buffer_wipe( &skey->mask, &skey->generator );
+  ak_buffer_wipe( &skey->icode, &skey->generator );
+  skey->flags &= ( 0xFFFFFFFFFFFFFFFFLL ^
+                               ( skey_flag_set_key | skey_flag_set_mask | skey_flag_set_icode ));
+  ak_skey_context_modify_end( skey );
+  skey->resource.value.counter = 0;
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Выработанный функцией номер является уникальным (в рамках библиотеки) и однозначно идентифицирует
     секретный ключ. Данный идентификатор может сохраняться вместе с ключом.
@@ -483,31 +537,493 @@
 
     \param skey Контекст секретного ключа.
     \param type Тип присваиваемого ресурса.
-    \param option Строка с именем опции, значение которой присваивается.
+    \param option Индекс опции, значение которой присваивается.
     \param not_before Время, начиная с которого ключ действителен. Значение, равное нулю,
     означает, что будет установлено текущее время.
     \param not_after Время, начиная с которого ключ недействителен.
     \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
     возвращается код ошибки.                                                                       */
 /* ----------------------------------------------------------------------------------------------- */
- int ak_skey_context_set_resource( ak_skey skey, counter_resource_t type, const char *option,
-                                                               time_t not_before, time_t not_after )
+ int ak_skey_context_set_resource( ak_skey skey, counter_resource_t type,
+                                     const option_index_t option, time_t not_before, time_t not_after )
 {
   if( skey == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                                             "using a null pointer to secret key" );
-  if( option == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
-                                                           "using a null pointer to option name" );
   ak_skey_context_set_resource_time( skey, not_before, not_after );
   switch( skey->resource.value.type = type ) {
     case block_counter_resource:
     case key_using_resource:
       if(( skey->resource.value.counter =
-                  ak_libakrypt_get_option( option )) != ak_error_wrong_option ) return ak_error_ok;
+          ak_libakrypt_get_option_by_index( option )) != ak_error_wrong_option ) return ak_error_ok;
         else return ak_error_wrong_option;
   }
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция атомарно уменьшает ресурс ключа на `count` единиц, если после уменьшения
+    в ресурсе остается не менее `remain` единиц. Поскольку ресурс резервируется до начала
+    обработки данных, ключ с развернутыми раундовыми ключами может одновременно использоваться
+    несколькими потоками без дополнительной блокировки. Если после резервирования обработка
+    данных не была выполнена, то неиспользованный ресурс возвращается функцией
+    ak_skey_context_commit_resource().
+
+    Функция не выводит сообщений об ошибках; это должна делать вызывающая функция.
+
+    \param skey Контекст секретного ключа.
+    \param count Резервируемое количество единиц ресурса (блоков или использований ключа).
+    \param remain Количество единиц ресурса, которое должно остаться после резервирования.
+    \return В случае успеха функция возвращает \ref ak_error_ok. Если ресурса недостаточно,
+    то возвращается \ref ak_error_low_key_resource, при этом ресурс не изменяется.                */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_skey_context_reserve_resource( ak_skey skey, const ssize_t count, const ssize_t remain )
+{
+  ssize_t value = ak_atomic_load( &skey->resource.value.counter );
+
+  do {
+     if( value - count < remain ) return ak_error_low_key_resource;
+  } while( !ak_atomic_cas( &skey->resource.value.counter, &value, value - count ));
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция завершает использование ресурса, ранее зарезервированного функцией
+    ak_skey_context_reserve_resource(): неиспользованная часть резерва атомарно
+    возвращается в ресурс ключа.
+
+    \param skey Контекст секретного ключа.
+    \param reserved Количество ранее зарезервированных единиц ресурса.
+    \param used Количество фактически использованных единиц ресурса; значение, равное нулю,
+    означает отмену резервирования.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_skey_context_commit_resource( ak_skey skey, const ssize_t reserved, const ssize_t used )
+{
+  if( reserved > used ) ak_atomic_add( &skey->resource.value.counter, reserved - used );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Политика определяет, как часто меняется маска ключа после его использования:
+    после каждого использования, после обработки `interval` блоков, после `interval`
+    использований ключа или по истечении `interval` секунд. Более редкая смена маски
+    увеличивает скорость обработки коротких сообщений ценой снижения стойкости
+    к атакам по побочным каналам.
+
+    \param skey Контекст секретного ключа.
+    \param policy Политика смены маски.
+    \param interval Интервал смены маски; значения, меньшие единицы, заменяются единицей.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_skey_context_set_mask_refresh( ak_skey skey, mask_refresh_policy_t policy,
+                                                                              ak_int64 interval )
+{
+  if( skey == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using a null pointer to secret key" );
+  switch( policy ) {
+    case mask_refresh_every_call:
+    case mask_refresh_blocks:
+    case mask_refresh_calls:
+    case mask_refresh_timer:
+      skey->refresh.policy = policy;
+      break;
+    default: skey->refresh.policy = mask_refresh_every_call;
+      ak_error_message( ak_error_undefined_value, __func__ , "using unexpected mask refresh policy" );
+  }
+  skey->refresh.interval = ( interval < 1 ) ? 1 : interval;
+  skey->refresh.counter = 0;
+  skey->refresh.time = ( skey->refresh.policy == mask_refresh_timer ) ? time( NULL ) : 0;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Маска разделяемого ключа не меняется при его использовании, поскольку смена маски
+    изменяет ключ, который одновременно может читаться другими потоками. Перед снятием флага
+    владелец ключа должен убедиться, что ключ больше не используется другими потоками.
+
+    \param skey Контекст секретного ключа.
+    \param shared Истина (\ref ak_true), если ключ будет использоваться несколькими потоками
+    одновременно, и ложь (\ref ak_false) в противном случае.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_skey_context_set_shared( ak_skey skey, const bool_t shared )
+{
+  if( skey == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using a null pointer to secret key" );
+  if( shared ) skey->flags |= skey_flag_shared;
+    else skey->flags &= ( 0xFFFFFFFFFFFFFFFFLL ^ skey_flag_shared );
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывается после каждого использования ключа и меняет маску ключа только в том
+    случае, если этого требует установленная для ключа политика. Маска ключа, разделяемого
+    несколькими потоками (см. ak_skey_context_set_shared()), не меняется.
+
+    \param skey Контекст секретного ключа.
+    \param blocks Количество блоков, обработанных при последнем использовании ключа.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_skey_context_remask( ak_skey skey, const size_t blocks )
+{
+  time_t now = 0;
+  int error = ak_error_ok;
+
+  if( skey->flags&skey_flag_shared ) return ak_error_ok;
+  switch( skey->refresh.policy ) {
+    case mask_refresh_blocks:
+      if(( skey->refresh.counter += ( ak_int64 )blocks ) < skey->refresh.interval )
+        return ak_error_ok;
+      break;
+    case mask_refresh_calls:
+      if( ++skey->refresh.counter < skey->refresh.interval ) return ak_error_ok;
+      break;
+    case mask_refresh_timer:
+      if(( now = time( NULL )) - skey->refresh.time < skey->refresh.interval ) return ak_error_ok;
+      skey->refresh.time = now;
+      break;
+    default: break;
+  }
+  skey->refresh.counter = 0;
+  ak_skey_context_modify_begin( skey );
+  error = skey->set_mask( skey );
+  ak_skey_context_modify_end( skey );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                        функции проверки контрольной суммы секретных ключей                      */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция, вызываемая при обнаружении нарушения целостности секретного ключа. */
+ static ak_function_skey_violation *ak_icode_violation_function = NULL;
+
+#if defined( LIBAKRYPT_HAVE_PTHREAD ) && defined( LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Реестр ключей, контрольная сумма которых проверяется отдельным потоком. */
+ static struct icode_verifier {
+  /*! \brief массив указателей на зарегистрированные ключи */
+   ak_skey *keys;
+  /*! \brief количество зарегистрированных ключей */
+   size_t count;
+  /*! \brief размер массива указателей */
+   size_t size;
+  /*! \brief флаг того, что поток проверки запущен */
+   bool_t active;
+  /*! \brief флаг завершения потока проверки */
+   bool_t stop;
+  /*! \brief ключ, проверяемый потоком в данный момент */
+   ak_skey current;
+ } verifier = { NULL, 0, 0, ak_false, ak_false, NULL };
+
+ static pthread_t ak_icode_verifier_thread;
+ static pthread_mutex_t ak_icode_verifier_mutex = PTHREAD_MUTEX_INITIALIZER;
+ static pthread_cond_t ak_icode_verifier_cond = PTHREAD_COND_INITIALIZER;
+/*! \brief Условная переменная, сигнализирующая о завершении проверки очередного ключа. */
+ static pthread_cond_t ak_icode_verifier_done = PTHREAD_COND_INITIALIZER;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет контрольную сумму одного ключа.
+
+    Ключ может одновременно изменяться владеющим им потоком (смена маски, присвоение нового
+    значения), поэтому проверка выполняется по схеме seqlock: ключ, изменяемый в данный момент
+    (нечетное значение счетчика изменений), пропускается, а функция ak_skey_context_modify_begin()
+    дожидается завершения проверки, начатой до изменения счетчика. Тем самым изменения ключа,
+    отмеченные функциями ak_skey_context_modify_begin() и ak_skey_context_modify_end(),
+    не пересекаются с его чтением в данной функции. Изменения, не отмеченные этими функциями,
+    могут привести лишь к ложной пометке ключа, которая устраняется проверкой,
+    выполняемой ak_skey_context_verify() в потоке-владельце.                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_icode_verifier_check( ak_skey skey )
+{
+  bool_t result = ak_true;
+  ak_uint32 sequence = 0;
+
+ /* запись verifier.current должна быть видна потоку-владельцу до чтения счетчика */
+  ak_atomic_fence();
+  sequence = ak_atomic_load( &skey->verify.sequence );
+
+  if( sequence&1 ) return;
+  if(( skey->flags&skey_flag_set_key ) == 0 ) return;
+  result = skey->check_icode( skey );
+  ak_atomic_fence();
+  if( ak_atomic_load( &skey->verify.sequence ) != sequence ) return;
+  if( result != ak_true ) ak_atomic_store( &skey->verify.suspect, 1 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция потока, проверяющего контрольные суммы зарегистрированных ключей.
+
+    Поток просыпается через интервал, равный наименьшему из интервалов проверки
+    зарегистрированных ключей. Несовпадение контрольной суммы лишь помечает ключ;
+    окончательная проверка выполняется функцией ak_skey_context_verify()
+    при следующем использовании ключа.
+
+    Реестр блокируется только на время выбора очередного ключа, а сама проверка выполняется
+    без блокировки, поэтому уничтожение ключей не ожидает завершения полного прохода по реестру.
+    Ключ, проверяемый в данный момент, хранится в поле `current`; функция
+    ak_icode_verifier_unregister() ожидает завершения его проверки.                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_icode_verifier_run( void *arg )
+{
+  size_t i = 0;
+  struct timespec ts;
+  ak_int64 period = 0;
+
+  (void) arg;
+  pthread_mutex_lock( &ak_icode_verifier_mutex );
+  while( !verifier.stop ) {
+    /* определяем время следующей проверки */
+     for( i = 0, period = 1000; i < verifier.count; i++ )
+        if( verifier.keys[i]->verify.interval < period ) period = verifier.keys[i]->verify.interval;
+     clock_gettime( CLOCK_REALTIME, &ts );
+     ts.tv_sec += ( time_t )( period/1000 );
+     if(( ts.tv_nsec += ( long )( period%1000 )*1000000L ) >= 1000000000L ) {
+       ts.tv_sec++; ts.tv_nsec -= 1000000000L;
+     }
+     pthread_cond_timedwait( &ak_icode_verifier_cond, &ak_icode_verifier_mutex, &ts );
+     if( verifier.stop ) break;
+
+    /* ключи, удаленные из реестра во время прохода, пропускаются, а ключ, перемещенный
+       на место удаленного, может быть проверен в следующем проходе */
+     for( i = 0; ( i < verifier.count ) && !verifier.stop; i++ ) {
+        ak_skey skey = verifier.keys[i];
+        if(( skey->verify.counter += period ) < skey->verify.interval ) continue;
+        skey->verify.counter = 0;
+        ak_atomic_store( &verifier.current, skey );
+        pthread_mutex_unlock( &ak_icode_verifier_mutex );
+        ak_icode_verifier_check( skey );
+        pthread_mutex_lock( &ak_icode_verifier_mutex );
+        ak_atomic_store( &verifier.current, NULL );
+        pthread_cond_broadcast( &ak_icode_verifier_done );
+     }
+  }
+  pthread_mutex_unlock( &ak_icode_verifier_mutex );
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция помещает ключ в реестр и, при необходимости, запускает поток проверки. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_icode_verifier_register( ak_skey skey )
+{
+  int error = ak_error_ok;
+
+  pthread_mutex_lock( &ak_icode_verifier_mutex );
+  if( verifier.count == verifier.size ) {
+    size_t size = verifier.size ? 2*verifier.size : 16;
+    ak_skey *keys = realloc( verifier.keys, size*sizeof( ak_skey ));
+    if( keys == NULL ) error = ak_error_out_of_memory;
+     else { verifier.keys = keys; verifier.size = size; }
+  }
+  if( error == ak_error_ok ) {
+    verifier.keys[verifier.count++] = skey;
+    if( !verifier.active ) {
+      verifier.stop = ak_false;
+      if( pthread_create( &ak_icode_verifier_thread, NULL, ak_icode_verifier_run, NULL ) != 0 ) {
+        verifier.count--;
+        error = ak_error_undefined_function;
+      } else verifier.active = ak_true;
+    }
+  }
+  pthread_mutex_unlock( &ak_icode_verifier_mutex );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция удаляет ключ из реестра; если ключ проверяется в данный момент,
+    то функция ожидает завершения проверки.                                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_icode_verifier_unregister( ak_skey skey )
+{
+  size_t i = 0;
+
+  pthread_mutex_lock( &ak_icode_verifier_mutex );
+  for( i = 0; i < verifier.count; i++ ) {
+     if( verifier.keys[i] == skey ) {
+       verifier.keys[i] = verifier.keys[--verifier.count];
+       break;
+     }
+  }
+  while( verifier.current == skey )
+    pthread_cond_wait( &ak_icode_verifier_done, &ak_icode_verifier_mutex );
+  pthread_mutex_unlock( &ak_icode_verifier_mutex );
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Политика определяет, как часто проверяется контрольная сумма ключа перед его использованием:
+    при каждом использовании, после каждых `interval` использований ключа, либо отдельным потоком
+    через каждые `interval` миллисекунд. Более редкая проверка ускоряет обработку коротких
+    сообщений ценой увеличения времени, в течение которого искажение ключа может остаться
+    незамеченным. При фоновой проверке ключ должен быть уничтожен функцией
+    ak_skey_context_destroy() до освобождения памяти, в которой размещен его контекст.
+
+    Если фоновая проверка не поддерживается, то контрольная сумма проверяется
+    при каждом использовании ключа.
+
+    \param skey Контекст секретного ключа.
+    \param policy Политика проверки контрольной суммы.
+    \param interval Интервал проверки; значения, меньшие единицы, заменяются единицей.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_skey_context_set_icode_check( ak_skey skey, icode_check_policy_t policy,
+                                                                              ak_int64 interval )
+{
+  int error = ak_error_ok;
+
+  if( skey == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using a null pointer to secret key" );
+  switch( policy ) {
+    case icode_check_every_call:
+    case icode_check_calls:
+    case icode_check_background:
+      break;
+    default: policy = icode_check_every_call;
+      ak_error_message( ak_error_undefined_value, __func__ , "using unexpected icode check policy" );
+  }
+
+#if defined( LIBAKRYPT_HAVE_PTHREAD ) && defined( LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+  if( skey->verify.policy == icode_check_background ) ak_icode_verifier_unregister( skey );
+#else
+  if( policy == icode_check_background ) {
+    policy = icode_check_every_call;
+    error = ak_error_message( ak_error_undefined_function, __func__ ,
+                                                    "background icode check is not supported" );
+  }
+#endif
+  skey->verify.policy = policy;
+  skey->verify.interval = ( interval < 1 ) ? 1 : interval;
+  skey->verify.counter = 0;
+  skey->verify.suspect = 0;
+
+#if defined( LIBAKRYPT_HAVE_PTHREAD ) && defined( LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+  if( policy == icode_check_background ) {
+    if(( error = ak_icode_verifier_register( skey )) != ak_error_ok ) {
+      skey->verify.policy = icode_check_every_call;
+      ak_error_message( error, __func__ , "wrong registration of key for background icode check" );
+    }
+  }
+#endif
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывается перед каждым использованием ключа и проверяет его контрольную сумму
+    только в том случае, если этого требует установленная для ключа политика. При несовпадении
+    контрольной суммы вызывается функция, установленная с помощью
+    ak_libakrypt_set_icode_violation_function().
+
+    \param skey Контекст секретного ключа.
+    \return Функция возвращает ложь (\ref ak_false), если проверка выполнялась
+    и контрольная сумма не совпала. В остальных случаях возвращается истина (\ref ak_true).        */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_skey_context_verify( ak_skey skey )
+{
+  switch( skey->verify.policy ) {
+    case icode_check_calls:
+     /* счетчик не сбрасывается, чтобы параллельные вызовы для разделяемого ключа
+        не теряли приращений */
+      if( ak_atomic_add( &skey->verify.counter, 1 )%skey->verify.interval ) return ak_true;
+      break;
+#if defined( LIBAKRYPT_HAVE_PTHREAD ) && defined( LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+    case icode_check_background:
+      if( !ak_atomic_load( &skey->verify.suspect )) return ak_true;
+      ak_atomic_store( &skey->verify.suspect, 0 );
+      break;
+#endif
+    default: break;
+  }
+  if( skey->check_icode( skey ) == ak_true ) return ak_true;
+  if( ak_icode_violation_function != NULL ) ak_icode_violation_function( skey );
+ return ak_false;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывается владельцем ключа перед изменением значения или маски ключа, проверяемого
+    отдельным потоком; пока изменение не завершено вызовом ak_skey_context_modify_end(),
+    фоновая проверка ключа не выполняется. Если проверка ключа была начата до вызова функции,
+    то функция дожидается ее завершения. Для остальных политик проверки функция
+    ничего не делает.
+
+    \param skey Контекст секретного ключа.                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_skey_context_modify_begin( ak_skey skey )
+{
+#if defined( LIBAKRYPT_HAVE_PTHREAD ) && defined( LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+  if( skey->verify.policy != icode_check_background ) return;
+  ak_atomic_add( &skey->verify.sequence, 1 );
+
+ /* парная к ak_icode_verifier_check() барьерная инструкция: либо поток проверки увидит
+    нечетное значение счетчика, либо мы увидим ключ в поле verifier.current */
+  ak_atomic_fence();
+  if( ak_atomic_load( &verifier.current ) != skey ) return;
+  pthread_mutex_lock( &ak_icode_verifier_mutex );
+  while( verifier.current == skey )
+    pthread_cond_wait( &ak_icode_verifier_done, &ak_icode_verifier_mutex );
+  pthread_mutex_unlock( &ak_icode_verifier_mutex );
+#else
+  (void) skey;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \param skey Контекст секретного ключа.                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_skey_context_modify_end( ak_skey skey )
+{
+#if defined( LIBAKRYPT_HAVE_PTHREAD ) && defined( LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+  if( skey->verify.policy == icode_check_background ) ak_atomic_add( &skey->verify.sequence, 1 );
+#else
+  (void) skey;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \param function Функция, вызываемая при обнаружении нарушения целостности ключа
+    (несовпадения контрольной суммы); значение NULL отключает вызов.
+    \return Функция возвращает \ref ak_error_ok.                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_libakrypt_set_icode_violation_function( ak_function_skey_violation *function )
+{
+  ak_icode_violation_function = function;
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция завершает поток фоновой проверки контрольных сумм и освобождает память реестра ключей.
+    Функция вызывается из ak_libakrypt_destroy().
+
+    \return Функция возвращает \ref ak_error_ok.                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_libakrypt_icode_verifier_destroy( void )
+{
+#if defined( LIBAKRYPT_HAVE_PTHREAD ) && defined( LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+  bool_t active = ak_false;
+
+  pthread_mutex_lock( &ak_icode_verifier_mutex );
+  if(( active = verifier.active ) == ak_true ) {
+    verifier.stop = ak_true;
+    pthread_cond_signal( &ak_icode_verifier_cond );
+  }
+  pthread_mutex_unlock( &ak_icode_verifier_mutex );
+  if( active ) pthread_join( ak_icode_verifier_thread, NULL );
+
+  pthread_mutex_lock( &ak_icode_verifier_mutex );
+  if( verifier.count > 0 ) ak_error_message_fmt( ak_error_ok, __func__ ,
+                   "%u keys are not destroyed before library exit", (unsigned int) verifier.count );
+  if( verifier.keys != NULL ) free( verifier.keys );
+  verifier.keys = NULL;
+  verifier.count = verifier.size = 0;
+  verifier.active = verifier.stop = ak_false;
+  pthread_mutex_unlock( &ak_icode_verifier_mutex );
+#endif
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \details В большинстве криптографических механизмов копирование ключевой информации
     представляется излишним. Однако в режимах шифрования с динамическим изменением ключа шифрования
@@ -533,11 +1049,13 @@
     return ak_error_message( error, __func__, "incorrect creation of secret key" );
 
  /*копируем данные и указатели на функции */
+  ak_skey_context_modify_begin( skey );
   memcpy( skey->key.data, rkey->key.data, rkey->key.size );
   memcpy( skey->mask.data, rkey->mask.data, rkey->mask.size );
   memcpy( skey->icode.data, rkey->icode.data, rkey->icode.size );
  /* копируем ресурс ключа */
   memcpy( &skey->resource, &rkey->resource, sizeof( struct resource ));
+  ak_skey_context_set_mask_refresh( skey, rkey->refresh.policy, rkey->refresh.interval );
 
  /* поскольку на уровне класса skey определить размер skey->data не представляется возможным,
         копирование внутренних данных должно реализовываться функциями классов - наследников */
@@ -549,9 +1067,14 @@
   skey->unmask = rkey->unmask;
   skey->set_icode = rkey->set_icode;
   skey->check_icode = rkey->check_icode;
+  ak_skey_context_modify_end( skey );
+  ak_skey_context_set_icode_check( skey, rkey->verify.policy, rkey->verify.interval );
 
  /* перемаскируем ключ, значения которого были скопированы */
-  if(( error = rkey->set_mask( rkey )) != ak_error_ok ) {
+  ak_skey_context_modify_begin( rkey );
+  error = rkey->set_mask( rkey );
+  ak_skey_context_modify_end( rkey );
+  if( error != ak_error_ok ) {
     ak_skey_context_destroy( skey );
     return ak_error_message( error, __func__, "incorrect remasking of second key" );
   }
@@ -607,29 +1130,39 @@
   if( ptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                                         "using a null pointer to secret key data" );
  /* присваиваем ключ */
-  if(( error = ak_buffer_set_ptr( &skey->key, ptr, size, cflag )) != ak_error_ok )
-    return ak_error_message( error, __func__ , "wrong assigning a secret key data" );
+  ak_skey_context_modify_begin( skey );
+  if(( error = ak_buffer_set_ptr( &skey->key, ptr, size, cflag )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "wrong assigning a secret key data" );
+    goto labexit;
+  }
 
  /* очищаем флаг начальной инициализации */
   skey->flags &= (0xFFFFFFFFFFFFFFFFLL ^ skey_flag_set_mask );
 
  /* проверяем маску */
   if( skey->mask.size != skey->key.size )
-    if(( error = ak_buffer_alloc( &skey->mask, size )) != ak_error_ok )
-      return ak_error_message( error, __func__ , "incorrect memory allocation for secret key mask" );
+    if(( error = ak_buffer_alloc( &skey->mask, size )) != ak_error_ok ) {
+      ak_error_message( error, __func__ , "incorrect memory allocation for secret key mask" );
+      goto labexit;
+    }
 
  /* маскируем ключ и вычисляем контрольную сумму */
-  if(( error = skey->set_mask( skey )) != ak_error_ok ) return  ak_error_message( error,
-                                                           __func__ , "wrong secret key masking" );
-
-  if(( error = skey->set_icode( skey )) != ak_error_ok ) return ak_error_message( error,
-                                                __func__ , "wrong calculation of integrity code" );
+  if(( error = skey->set_mask( skey )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "wrong secret key masking" );
+    goto labexit;
+  }
+  if(( error = skey->set_icode( skey )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "wrong calculation of integrity code" );
+    goto labexit;
+  }
 
  /* устанавливаем флаг того, что ключевое значение определено.
     теперь ключ можно использовать в криптографических алгоритмах */
   skey->flags |= skey_flag_set_key;
 
- return ak_error_ok;
+  labexit: ak_skey_context_modify_end( skey );
+
+ return error;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -655,23 +1188,32 @@
                                                 "using a null pointer to random number generator" );
  /* присваиваем случайный ключ и случайную маску
     тем самым точное значение ключа ни как не фигурирует */
+  ak_skey_context_modify_begin( skey );
   if(( error = ak_random_context_random( generator, skey->key.data,
-                                                     ( ssize_t ) skey->key.size )) != ak_error_ok )
-    return ak_error_message( error, __func__ , "wrong generation a secret key" );
+                                                     ( ssize_t ) skey->key.size )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "wrong generation a secret key" );
+    goto labexit;
+  }
   if(( error = ak_random_context_random( generator, skey->mask.data,
-                                                    ( ssize_t ) skey->mask.size )) != ak_error_ok )
-    return ak_error_message( error, __func__ , "wrong generation a mask" );
+                                                    ( ssize_t ) skey->mask.size )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "wrong generation a mask" );
+    goto labexit;
+  }
 
  /* меняем значение флага на установленное */
   skey->flags |= skey_flag_set_mask;
 
-  if(( error = skey->set_icode( skey )) != ak_error_ok ) return ak_error_message( error,
-                                                 __func__ , "wrong calculation of integrity code" );
+  if(( error = skey->set_icode( skey )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "wrong calculation of integrity code" );
+    goto labexit;
+  }
 
  /* устанавливаем флаг того, что ключевое значение определено.
     теперь ключ можно использовать в криптографических алгоритмах */
   skey->flags |= skey_flag_set_key;
 
+  labexit: ak_skey_context_modify_end( skey );
+
  return error;
 }
 
@@ -709,23 +1251,32 @@
   if( !pass_size ) return ak_error_message( ak_error_wrong_length, __func__ ,
                                                               "using a password with zero length" );
  /* присваиваем буффер и маскируем его */
+  ak_skey_context_modify_begin( skey );
   if(( error = ak_hmac_context_pbkdf2_streebog512( pass, pass_size, salt, salt_size,
-                   (const size_t) ak_libakrypt_get_option("pbkdf2_iteration_count"),
-                                                 skey->key.size, skey->key.data )) != ak_error_ok )
-                  return ak_error_message( error, __func__ , "wrong generation a secret key data" );
+                   (const size_t) ak_libakrypt_get_option_by_index( option_pbkdf2_iteration_count ),
+                                               skey->key.size, skey->key.data )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "wrong generation a secret key data" );
+    goto labexit;
+  }
 
  /* очищаем флаг начальной инициализации */
   skey->flags &= (0xFFFFFFFFFFFFFFFFLL ^ skey_flag_set_mask );
 
-  if(( error = skey->set_mask( skey )) != ak_error_ok ) return  ak_error_message( error,
-                                                            __func__ , "wrong secret key masking" );
-  if(( error = skey->set_icode( skey )) != ak_error_ok ) return ak_error_message( error,
-                                      __func__ , "wrong calculation of secret key integrity code" );
+  if(( error = skey->set_mask( skey )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "wrong secret key masking" );
+    goto labexit;
+  }
+  if(( error = skey->set_icode( skey )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "wrong calculation of secret key integrity code" );
+    goto labexit;
+  }
 
  /* устанавливаем флаг того, что ключевое значение определено.
     теперь ключ можно использовать в криптографических алгоритмах */
   skey->flags |= skey_flag_set_key;
 
+  labexit: ak_skey_context_modify_end( skey );
+
  return error;
 }
 
@@ -747,10 +1298,15 @@
                                                              "using a null pointer to secret key" );
   if( !(skey->flags&skey_flag_set_key )) return ak_error_message( ak_error_key_value, __func__ ,
                                              "using a secret key context with not assigned value" );
+ /* ключ временно освобождается от маски, что недопустимо при его использовании другими потоками */
+  if( skey->flags&skey_flag_shared ) return ak_error_message( ak_error_key_usage, __func__ ,
+                                                   "unmasking a key shared by several threads" );
  /* теперь собственно вызов функции обновления контекста */
-  skey->unmask( skey );  
+  ak_skey_context_modify_begin( skey );
+  skey->unmask( skey );
   error = ak_mac_context_update( ictx, skey->key.data, skey->key.size );
   skey->set_mask( skey );
+  ak_skey_context_modify_end( skey );
 
  return error;
 }
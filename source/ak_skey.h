@@ -9,6 +9,7 @@
 
 /* ----------------------------------------------------------------------------------------------- */
  #include <ak_hash.h>
+ #include <ak_tools.h>
 
 /* ----------------------------------------------------------------------------------------------- */
 /* Предварительные описания ключевых структур */
@@ -24,6 +25,8 @@
  typedef int ( ak_function_skey )( ak_skey );
 /*! \brief Однопараметрическая функция для проведения действий с секретным ключом, возвращает истину или ложь. */
  typedef bool_t ( ak_function_skey_check )( ak_skey );
+/*! \brief Функция, вызываемая при обнаружении нарушения целостности секретного ключа. */
+ typedef void ( ak_function_skey_violation )( ak_skey );
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Перечисление определяет возможные типы счетчиков ресурса секретного ключа. */
@@ -63,6 +66,59 @@
    struct time_interval time;
  } *ak_resource;
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Перечисление определяет политику смены маски секретного ключа после его использования. */
+ typedef enum {
+  /*! \brief Маска меняется после каждого использования ключа. */
+    mask_refresh_every_call = 0,
+  /*! \brief Маска меняется после обработки заданного количества блоков. */
+    mask_refresh_blocks = 1,
+  /*! \brief Маска меняется после заданного количества использований ключа. */
+    mask_refresh_calls = 2,
+  /*! \brief Маска меняется по истечении заданного количества секунд. */
+    mask_refresh_timer = 3
+} mask_refresh_policy_t;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Структура определяет политику смены маски ключа и ее текущее состояние. */
+ typedef struct mask_refresh {
+  /*! \brief Политика смены маски */
+   mask_refresh_policy_t policy;
+  /*! \brief Интервал смены маски (в блоках, использованиях или секундах) */
+   ak_int64 interval;
+  /*! \brief Количество блоков или использований ключа после последней смены маски */
+   ak_int64 counter;
+  /*! \brief Время последней смены маски */
+   time_t time;
+} *ak_mask_refresh;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Перечисление определяет политику проверки контрольной суммы секретного ключа. */
+ typedef enum {
+  /*! \brief Контрольная сумма проверяется при каждом использовании ключа. */
+    icode_check_every_call = 0,
+  /*! \brief Контрольная сумма проверяется после заданного количества использований ключа. */
+    icode_check_calls = 1,
+  /*! \brief Контрольная сумма проверяется отдельным потоком через заданное количество миллисекунд. */
+    icode_check_background = 2
+} icode_check_policy_t;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Структура определяет политику проверки контрольной суммы ключа и ее текущее состояние. */
+ typedef struct icode_check {
+  /*! \brief Политика проверки контрольной суммы */
+   icode_check_policy_t policy;
+  /*! \brief Признак несовпадения контрольной суммы, обнаруженного при фоновой проверке */
+   ak_uint32 suspect;
+  /*! \brief Интервал проверки (в использованиях ключа или миллисекундах) */
+   ak_int64 interval;
+  /*! \brief Количество использований ключа после последней проверки */
+   ak_int64 counter;
+  /*! \brief Счетчик изменений ключа; нечетное значение означает, что значение или маска ключа
+      в данный момент изменяются владельцем, и фоновая проверка не выполняется */
+   ak_uint32 sequence;
+} *ak_icode_check;
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Перечисление, определяющее флаги хранения и обработки секретных ключей. */
  typedef enum {
@@ -82,6 +138,10 @@
              возлагает это на методы классов-наследников:
              0 - очистка производится, 1 - очистка памяти не производится */
    skey_flag_data_not_free = 0x08LL,
+  /*! \brief Четвертый бит определяет, используется ли ключ одновременно несколькими потоками:
+             0 - ключ используется одним потоком, 1 - ключ разделяется несколькими потоками,
+             и его маска не меняется при использовании ключа. */
+   skey_flag_shared = 0x10LL,
 
  /*! \brief Флаг, который запрещает использование функции ctr без указания синхропосылки. */
    bckey_flag_not_ctr = 0x0100LL,
@@ -105,6 +165,10 @@
    struct random generator;
   /*! \brief ресурс использования ключа */
    struct resource resource;
+  /*! \brief политика смены маски ключа */
+   struct mask_refresh refresh;
+  /*! \brief политика проверки контрольной суммы ключа */
+   struct icode_check verify;
   /*! \brief указатель на внутренние данные ключа */
    ak_pointer data;
   /*! \brief OID алгоритма для которого предназначен секретный ключ */
@@ -127,6 +191,8 @@
  int ak_skey_context_create( ak_skey , size_t , size_t );
 /*! \brief Очистка структуры секретного ключа. */
  int ak_skey_context_destroy( ak_skey );
+/*! \brief Уничтожение ключевой информации без освобождения памяти. */
+ int ak_skey_context_wipe( ak_skey );
 /*! \brief Присвоение секретному ключу уникального номера. */
  int ak_skey_context_set_unique_number( ak_skey );
 /*! \brief Присвоение секретному ключу константного значения. */
@@ -155,9 +221,32 @@
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция устанавливает ресурс ключа. */
- int ak_skey_context_set_resource( ak_skey , counter_resource_t , const char * , time_t , time_t );
+ int ak_skey_context_set_resource( ak_skey , counter_resource_t , const option_index_t ,
+                                                                               time_t , time_t );
+/*! \brief Атомарное резервирование ресурса ключа. */
+ int ak_skey_context_reserve_resource( ak_skey , const ssize_t , const ssize_t );
+/*! \brief Завершение использования зарезервированного ресурса ключа. */
+ void ak_skey_context_commit_resource( ak_skey , const ssize_t , const ssize_t );
 /*! \brief Функция устанавливает временной интервал действия ключа. */
  int ak_skey_context_set_resource_time( ak_skey skey, time_t not_before, time_t not_after );
+/*! \brief Функция устанавливает политику смены маски ключа. */
+ int ak_skey_context_set_mask_refresh( ak_skey , mask_refresh_policy_t , ak_int64 );
+/*! \brief Разрешение или запрет одновременного использования ключа несколькими потоками. */
+ int ak_skey_context_set_shared( ak_skey , const bool_t );
+/*! \brief Смена маски ключа в соответствии с установленной политикой. */
+ int ak_skey_context_remask( ak_skey , const size_t );
+/*! \brief Функция устанавливает политику проверки контрольной суммы ключа. */
+ int ak_skey_context_set_icode_check( ak_skey , icode_check_policy_t , ak_int64 );
+/*! \brief Проверка контрольной суммы ключа в соответствии с установленной политикой. */
+ bool_t ak_skey_context_verify( ak_skey );
+/*! \brief Функция отмечает начало изменения значения или маски ключа. */
+ void ak_skey_context_modify_begin( ak_skey );
+/*! \brief Функция отмечает завершение изменения значения или маски ключа. */
+ void ak_skey_context_modify_end( ak_skey );
+/*! \brief Установка функции, вызываемой при нарушении целостности секретного ключа. */
+ int ak_libakrypt_set_icode_violation_function( ak_function_skey_violation * );
+/*! \brief Остановка потока фоновой проверки контрольных сумм секретных ключей. */
+ int ak_libakrypt_icode_verifier_destroy( void );
 
 #endif
 /* ----------------------------------------------------------------------------------------------- */
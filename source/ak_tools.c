@@ -78,8 +78,63 @@
  #include <ak_tools.h>
 
 /* ----------------------------------------------------------------------------------------------- */
-/*!  Переменная, содержащая в себе код последней ошибки                                            */
- static int ak_errno = ak_error_ok;
+/*! \brief Количество последних сообщений об ошибках, хранимых для каждого потока. */
+ #define ak_error_ring_size                     (8)
+/*! \brief Максимальная длина одного сообщения об ошибке, хранимого в кольцевом буфере. */
+ #define ak_error_ring_message_size           (256)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Состояние ошибок одного потока выполнения программы. */
+ typedef struct error_thread_local {
+  /*! \brief код последней ошибки */
+   int code;
+  /*! \brief общее количество сообщений об ошибках, помещенных в кольцевой буфер */
+   size_t count;
+  /*! \brief кольцевой буфер последних сообщений об ошибках */
+   char messages[ak_error_ring_size][ak_error_ring_message_size];
+ } *ak_error_thread_local;
+
+#ifdef LIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL
+/*! \brief Состояние ошибок текущего потока выполнения программы. */
+ static __thread struct error_thread_local ak_error_state;
+#else
+/*! \brief Общее состояние ошибок (используется при отсутствии поддержки потоков или
+    в случае, когда память для состояния потока не может быть выделена). */
+ static struct error_thread_local ak_error_state;
+ #ifdef LIBAKRYPT_HAVE_PTHREAD
+/*! \brief Ключ, связывающий с потоком выполнения программы состояние его ошибок. */
+  static pthread_key_t ak_error_thread_local_key;
+/*! \brief Флаг однократного создания ключа ak_error_thread_local_key. */
+  static pthread_once_t ak_error_thread_local_once = PTHREAD_ONCE_INIT;
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_error_thread_local_key_create( void )
+{
+  pthread_key_create( &ak_error_thread_local_key, free );
+}
+ #endif
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает указатель на состояние ошибок текущего потока.                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_error_thread_local ak_error_thread_local_get( void )
+{
+#if !defined( LIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL ) && defined( LIBAKRYPT_HAVE_PTHREAD )
+  ak_error_thread_local state = NULL;
+
+  pthread_once( &ak_error_thread_local_once, ak_error_thread_local_key_create );
+  if(( state = pthread_getspecific( ak_error_thread_local_key )) != NULL ) return state;
+  if(( state = calloc( 1, sizeof( struct error_thread_local ))) == NULL ) return &ak_error_state;
+  if( pthread_setspecific( ak_error_thread_local_key, state ) != 0 ) {
+    free( state );
+    return &ak_error_state;
+  }
+  return state;
+#else
+  return &ak_error_state;
+#endif
+}
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Внутренний указатель на функцию аудита                                                         */
@@ -95,32 +150,63 @@
    char *name;
   /*! \brief Численное значение опции (31 значащий бит + знак) */
    ak_int64 value;
+  /*! \brief Минимальное допустимое значение, считываемое из файла настроек */
+   ak_int64 min;
+  /*! \brief Максимальное допустимое значение, считываемое из файла настроек */
+   ak_int64 max;
+  /*! \brief Флаг опции, принимающей одно из перечисленных значений; считываемое из файла
+      настроек значение такой опции, лежащее вне интервала [min, max], отбрасывается,
+      а не приводится к границе интервала */
+   bool_t enumerated;
  } *ak_option;
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! Константные значения опций (значения по-умолчанию) */
+/*! Константные значения опций (значения по-умолчанию); порядок опций должен совпадать
+    с порядком констант перечисления \ref option_index_t                                          */
  static struct option options[] = {
-     { "log_level", ak_log_standard },
-     { "context_manager_size", 32 },
-     { "context_manager_max_size", 4096 },
-     { "key_number_length", 16 },
-     { "pbkdf2_iteration_count", 2000 },
-     { "hmac_key_count_resource", 65536 },
+     { "log_level", ak_log_standard, ak_log_none, 16, ak_false },
+     { "log_async", 0, 0, 1, ak_true },
+     { "context_manager_size", 32, 32, 65536, ak_false },
+     { "context_manager_max_size", 4096, 4096, 2147483647, ak_false },
+     { "key_number_length", 16, 16, 32, ak_false },
+     { "pbkdf2_iteration_count", 2000, 1000, 32768, ak_false },
+     { "hmac_key_count_resource", 65536, 1024, 2147483647, ak_false },
 
   /* значение константы задает максимальный объем зашифрованной информации на одном ключе в 4 Mб:
                                  524288 блока x 8 байт на блок = 4.194.304 байт = 4096 Кб = 4 Mб   */
-     { "magma_cipher_resource", 524288 },
+     { "magma_cipher_resource", 524288, 1024, 2147483647, ak_false },
 
   /* значение константы задает максимальный объем зашифрованной информации на одном ключе в 32 Mб:
                              2097152 блока x 16 байт на блок = 33.554.432 байт = 32768 Кб = 32 Mб  */
-     { "kuznechik_cipher_resource", 2097152 },
-     { "acpkm_message_count", 4096 },
-     { "acpkm_section_magma_block_count", 128 },
-     { "acpkm_section_kuznechik_block_count", 512 },
-
-     { NULL, 0 } /* завершающая константа, должна всегда принимать нулевые значения */
+     { "kuznechik_cipher_resource", 2097152, 1024, 2147483647, ak_false },
+     { "acpkm_message_count", 4096, 1, 2147483647, ak_false },
+     { "acpkm_section_magma_block_count", 128, 1, 2147483647, ak_false },
+     { "acpkm_section_kuznechik_block_count", 512, 1, 2147483647, ak_false },
+     { "verify_batch_threads", 1, 1, 64, ak_false },
+
+  /* индекс генератора масок секретных ключей в таблице OID библиотеки;
+     отрицательное значение означает использование генератора xorshift32 */
+     { "mask_random_generator", -1, -1, 2147483647, ak_false },
+
+  /* политика смены маски секретных ключей после их использования: 0 - после каждого использования,
+     1 - после обработки mask_refresh_interval блоков, 2 - после mask_refresh_interval использований,
+     3 - по истечении mask_refresh_interval секунд */
+     { "mask_refresh_policy", 0, 0, 3, ak_true },
+     { "mask_refresh_interval", 1, 1, 2147483647, ak_false },
+
+  /* политика проверки контрольной суммы секретных ключей: 0 - при каждом использовании,
+     1 - после icode_check_interval использований, 2 - отдельным потоком через каждые
+     icode_check_interval миллисекунд */
+     { "icode_check_policy", 0, 0, 2, ak_true },
+     { "icode_check_interval", 1, 1, 2147483647, ak_false },
+
+     { NULL, 0, 0, 0, ak_false } /* завершающая константа, должна всегда принимать нулевые значения */
  };
 
+/*! \brief Проверка соответствия массива опций перечислению option_index_t на этапе компиляции. */
+ typedef char ak_options_size_check[
+          ( sizeof( options )/sizeof( struct option ) == option_undefined + 1 ) ? 1 : -1 ];
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \b Внимание. Функция экспортируется.
 
@@ -132,18 +218,58 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! \param name Имя опции
+/*! \brief Функция возвращает индекс опции с заданным именем или \ref option_undefined.          */
+/* ----------------------------------------------------------------------------------------------- */
+ static option_index_t ak_libakrypt_find_option( const char *name )
+{
+  size_t i = 0;
+
+  if( name == NULL ) return option_undefined;
+  for( i = 0; i < ak_libakrypt_options_count(); i++ )
+     if( strcmp( name, options[i].name ) == 0 ) return ( option_index_t ) i;
+ return option_undefined;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Значение опции считывается атомарно и может изменяться другими потоками, например,
+    при вызове функции ak_libakrypt_reload_options().
+
+    \param index Индекс опции
+    \return Значение опции с заданным индексом. Если индекс указан неверно, то возвращается
+    ошибка \ref ak_error_wrong_option.                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_int64 ak_libakrypt_get_option_by_index( const option_index_t index )
+{
+  if(( size_t ) index >= ak_libakrypt_options_count( )) return ak_error_wrong_option;
+ return ak_atomic_load( &options[index].value );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \b Внимание! Функция не проверяет и не интерпретирует значение устанавливаемой опции.
+
+    \param index Индекс опции
+    \param value Значение опции
+    \return В случае удачного установления значения опции возвращается \ref ak_error_ok.
+     Если индекс опции указан неверно, то возвращается ошибка \ref ak_error_wrong_option.          */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_libakrypt_set_option_by_index( const option_index_t index, const ak_int64 value )
+{
+  if(( size_t ) index >= ak_libakrypt_options_count( )) return ak_error_wrong_option;
+  ak_atomic_store( &options[index].value, value );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция выполняет поиск опции по имени; в часто вызываемых функциях следует использовать
+    функцию ak_libakrypt_get_option_by_index().
+
+    \param name Имя опции
     \return Значение опции с заданным именем. Если имя указано неверно, то возвращается
     ошибка \ref ak_error_wrong_option.                                                             */
 /* ----------------------------------------------------------------------------------------------- */
  ak_int64 ak_libakrypt_get_option( const char *name )
 {
-  size_t i = 0;
-  ak_int64 result = ak_error_wrong_option;
-  for( i = 0; i < ak_libakrypt_options_count(); i++ ) {
-     if( strncmp( name, options[i].name, strlen( options[i].name )) == 0 ) result = options[i].value;
-  }
- return result;
+ return ak_libakrypt_get_option_by_index( ak_libakrypt_find_option( name ));
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -157,15 +283,7 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_libakrypt_set_option( const char *name, const ak_int64 value )
 {
-  size_t i = 0;
-  int result = ak_error_wrong_option;
-  for( i = 0; i < ak_libakrypt_options_count(); i++ ) {
-     if( strncmp( name, options[i].name, strlen( options[i].name )) == 0 ) {
-       options[i].value = value;
-       result = ak_error_ok;
-     }
-  }
- return result;
+ return ak_libakrypt_set_option_by_index( ak_libakrypt_find_option( name ), value );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -206,8 +324,7 @@
 /* ----------------------------------------------------------------------------------------------- */
  ak_int64 ak_libakrypt_get_option_value( const size_t index )
 {
- if( index >= ak_libakrypt_options_count() ) return ak_error_wrong_option;
-  else return options[index].value;
+ return ak_libakrypt_get_option_by_index(( option_index_t ) index );
 }
 
 #ifndef LIBAKRYPT_CONST_CRYPTO_PARAMS
@@ -321,16 +438,96 @@
  return ak_false;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция считывает имя (или идентификатор) генератора псевдо-случайных чисел и
+    определяет индекс соответствующего ему OID в таблице идентификаторов библиотеки.
+
+    @param string Строка, считанная из файла
+    @param field Имя считываемой опции
+    @param value Указатель на переменную, в которую помещается индекс OID
+    @return Функция возвращает \ref ak_true, если генератор найден. В противном случае
+    возвращается \ref ak_false.                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_libakrypt_load_random_option( const char *string, const char *field,
+                                                                                ak_int64 *value )
+{
+  size_t idx = 0, len = 0;
+  oid_engines_t engine;
+  oid_modes_t mode;
+  char *ptr = NULL, name[128], id[128];
+
+  if(( ptr = strstr( string, field )) == NULL ) return ak_false;
+  ptr += strlen( field );
+  while(( ptr[len] != 0 ) && ( ptr[len] != ' ' ) && ( ptr[len] != '\t' ) && ( ptr[len] != '\r' ))
+    len++;
+
+  for( idx = 0; idx < ak_libakrypt_oids_count(); idx++ ) {
+     if( ak_libakrypt_get_oid_by_index( idx, &engine, &mode,
+                                     name, sizeof( name ), id, sizeof( id )) != ak_error_ok ) continue;
+     if(( engine != random_generator ) || ( mode != algorithm )) continue;
+     if((( strlen( name ) == len ) && ( strncmp( ptr, name, len ) == 0 )) ||
+        (( strlen( id ) == len ) && ( strncmp( ptr, id, len ) == 0 ))) {
+       *value = ( ak_int64 )idx;
+       return ak_true;
+     }
+  }
+  ak_error_message_fmt( ak_error_undefined_value, __func__,
+                                    "using an undefinded random generator for variable %s", field );
+ return ak_false;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция разбирает одну строку файла настроек вида `имя = значение` и помещает
+    значение опции, приведенное к допустимому интервалу, в массив values. Недопустимые значения
+    перечислимых опций отбрасываются.
+
+    @param string Строка, считанная из файла
+    @param values Массив значений опций                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_libakrypt_load_option_line( const char *string, ak_int64 *values )
+{
+  size_t i = 0;
+  ak_int64 value = 0;
+  char field[128];
+
+  while(( *string == ' ' ) || ( *string == '\t' )) string++;
+  for( i = 0; i < ak_libakrypt_options_count(); i++ ) {
+     ak_snprintf( field, sizeof( field ), "%s = ", options[i].name );
+     if( strncmp( string, field, strlen( field )) != 0 ) continue;
+
+    /* генератор масок задается своим именем или идентификатором */
+     if( i == option_mask_random_generator ) {
+       if( ak_libakrypt_load_random_option( string, field, &value )) values[i] = value;
+       return;
+     }
+     if( ak_libakrypt_load_one_option( string, field, &value )) {
+      /* недопустимое значение перечислимой опции не заменяется другим допустимым значением,
+         поскольку оно может иметь совершенно другой смысл; опция сохраняет свое значение */
+       if( options[i].enumerated && (( value < options[i].min ) || ( value > options[i].max ))) {
+         ak_error_message_fmt( ak_error_undefined_value, __func__,
+                        "unexpected value %lld for option %s", (long long) value, options[i].name );
+         return;
+       }
+       if( value < options[i].min ) value = options[i].min;
+       if( value > options[i].max ) value = options[i].max;
+       values[i] = value;
+     }
+     return;
+  }
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция считывает опции из открытого файла, дескриптор которого передается в
     качестве аргумента функции.
 
     @param fd Дескриптор файла. Должен быть предварительно открыт на чтение с помощью функции
     ak_file_is_exist().
+    @param values Массив, в который помещаются считанные значения опций; значения опций,
+    отсутствующих в файле, не изменяются.
 
     @return Функция возвращает код ошибки или \ref ak_error_ok.                                    */
 /* ----------------------------------------------------------------------------------------------- */
- static int ak_libakrypt_load_options_from_file( ak_file fd )
+ static int ak_libakrypt_load_options_from_file( ak_file fd, ak_int64 *values )
 {
  int off = 0;
  size_t idx = 0;
@@ -350,62 +547,9 @@
                                          "libakrypt.conf has a line with more than 1022 symbols" );
      }
     if( ch == '\n' ) {
-      if((strlen(localbuffer) != 0 ) && ( strchr( localbuffer, '#' ) == 0 )) {
-        ak_int64 value = 0;
-
-        /* устанавливаем уровень аудита */
-        if( ak_libakrypt_load_one_option( localbuffer, "log_level = ", &value ))
-          ak_libakrypt_set_option( "log_level", value );
-
-        /* устанавливаем минимальный размер структуры управления контекстами */
-        if( ak_libakrypt_load_one_option( localbuffer, "context_manager_size = ", &value )) {
-          if( value < 32 ) value = 32;
-          if( value > 65536 ) value = 65536;
-          ak_libakrypt_set_option( "context_manager_size", value );
-        }
-
-       /* устанавливаем максимально возможный размер структуры управления контекстами */
-        if( ak_libakrypt_load_one_option( localbuffer, "context_manager_max_size = ", &value )) {
-          if( value < 4096 ) value = 4096;
-          if( value > 2147483647 ) value = 2147483647;
-          ak_libakrypt_set_option( "context_manager_max_size", value );
-        }
-
-       /* устанавливаем длину номера ключа */
-        if( ak_libakrypt_load_one_option( localbuffer, "key_number_length = ", &value )) {
-          if( value < 16 ) value = 16;
-          if( value > 32 ) value = 32;
-          ak_libakrypt_set_option( "key_number_length", value );
-        }
-
-       /* устанавливаем количество циклов в алгоритме pbkdf2 */
-        if( ak_libakrypt_load_one_option( localbuffer, "pbkdf2_iteration_count = ", &value )) {
-          if( value < 1000 ) value = 1000;
-          if( value > 32768 ) value = 32768;
-          ak_libakrypt_set_option( "pbkdf2_iteration_count", value );
-        }
-
-       /* устанавливаем ресурс ключа выработки имитовставки для алгоритма HMAC */
-        if( ak_libakrypt_load_one_option( localbuffer, "hmac_key_counter_resource = ", &value )) {
-          if( value < 1024 ) value = 1024;
-          if( value > 2147483647 ) value = 2147483647;
-          ak_libakrypt_set_option( "hmac_key_count_resource", value );
-        }
-
-       /* устанавливаем ресурс ключа алгоритма блочного шифрования Магма */
-        if( ak_libakrypt_load_one_option( localbuffer, "magma_cipher_resource = ", &value )) {
-          if( value < 1024 ) value = 1024;
-          if( value > 2147483647 ) value = 2147483647;
-          ak_libakrypt_set_option( "magma_cipher_resource", value );
-        }
-       /* устанавливаем ресурс ключа алгоритма блочного шифрования Магма */
-        if( ak_libakrypt_load_one_option( localbuffer, "kuznechik_cipher_resource = ", &value )) {
-          if( value < 1024 ) value = 1024;
-          if( value > 2147483647 ) value = 2147483647;
-          ak_libakrypt_set_option( "kuznechik_cipher_resource", value );
-        }
-
-      } /* далее мы очищаем строку независимо от ее содержимого */
+      if((strlen(localbuffer) != 0 ) && ( strchr( localbuffer, '#' ) == 0 ))
+        ak_libakrypt_load_option_line( localbuffer, values );
+     /* далее мы очищаем строку независимо от ее содержимого */
       off = 0;
       memset( localbuffer, 0, 1024 );
     } else localbuffer[off++] = ch;
@@ -416,6 +560,54 @@
   return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция ищет файл `libakrypt.conf` сначала в домашнем каталоге пользователя, потом
+    в системном каталоге, и считывает из него значения опций.
+
+    @param values Массив, в который помещаются считанные значения опций
+    @param name Буффер, в который помещается имя считанного файла
+    @return Функция возвращает \ref ak_error_ok в случае успеха. Если файл не найден,
+    возвращается \ref ak_error_access_file. В остальных случаях возвращается код ошибки.           */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_libakrypt_read_options( ak_int64 *values, char *name )
+{
+ int where, error = ak_error_ok;
+ struct file fd;
+
+ for( where = 0; where < 2; where++ ) {
+   /* создаем имя файла, расположенного в домашнем (системном) каталоге */
+    if(( error = ak_libakrypt_create_filename( name, FILENAME_MAX,
+                                                      "libakrypt.conf", where )) != ak_error_ok )
+      return ak_error_message( error, __func__, "incorrect name generation for options file");
+
+   /* пытаемся считать данные из указанного файла */
+    if( ak_file_open_to_read( &fd, name ) == ak_error_ok ) {
+      if(( error = ak_libakrypt_load_options_from_file( &fd, values )) != ak_error_ok )
+        return ak_error_message_fmt( error, __func__,
+                                         "file %s exists, but contains invalid data", name );
+      return ak_error_ok;
+    }
+ }
+ return ak_error_access_file;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция публикует новые значения опций. Каждое значение изменяется атомарно,
+    поэтому потоки, использующие опции, получают либо старое, либо новое значение.
+    \return Функция возвращает количество измененных опций.                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static size_t ak_libakrypt_publish_options( const ak_int64 *values )
+{
+  size_t i = 0, count = 0;
+
+  for( i = 0; i < ak_libakrypt_options_count(); i++ ) {
+     if( ak_libakrypt_get_option_by_index(( option_index_t ) i ) == values[i] ) continue;
+     ak_libakrypt_set_option_by_index(( option_index_t ) i, values[i] );
+     count++;
+  }
+ return count;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  static int ak_libakrypt_write_options( void )
 {
@@ -491,7 +683,21 @@
 
   for( i = 0; i < ak_libakrypt_options_count(); i++ ) {
     memset( hpath, 0, ak_min( 1024, FILENAME_MAX ));
-    ak_snprintf( hpath, FILENAME_MAX - 1, "%s = %d\n", options[i].name, options[i].value );
+   /* генератор масок сохраняется в файле своим именем, а не индексом */
+    if( i == option_mask_random_generator ) {
+      oid_engines_t engine;
+      oid_modes_t mode;
+      char name[128], id[128];
+
+      ak_int64 value = ak_libakrypt_get_option_by_index( option_mask_random_generator );
+
+      if(( value < 0 ) || ( ak_libakrypt_get_oid_by_index( (size_t) value,
+                         &engine, &mode, name, sizeof( name ), id, sizeof( id )) != ak_error_ok ))
+        ak_snprintf( name, sizeof( name ), "xorshift32" );
+      ak_snprintf( hpath, FILENAME_MAX - 1, "%s = %s\n", options[i].name, name );
+    } else
+      ak_snprintf( hpath, FILENAME_MAX - 1, "%s = %lld\n", options[i].name,
+                 ( long long ) ak_libakrypt_get_option_by_index(( option_index_t ) i ));
     if( ak_file_write( &fd, hpath, strlen( hpath )) < 1 ) {
      #ifdef _MSC_VER
       strerror_s( hpath, FILENAME_MAX, errno ); /* помещаем сообщение об ошибке в ненужный буффер */
@@ -517,49 +723,27 @@
 /* ----------------------------------------------------------------------------------------------- */
  bool_t ak_libakrypt_load_options( void )
 {
- struct file fd;
+ size_t i = 0;
  int error = ak_error_ok;
  char name[FILENAME_MAX];
+ ak_int64 values[option_undefined];
 
-/* создаем имя файла, расположенного в домашнем каталоге */
- if(( error = ak_libakrypt_create_filename( name, FILENAME_MAX,
-                                                          "libakrypt.conf", 0 )) != ak_error_ok ) {
-   ak_error_message( error, __func__, "incorrect name generation for options file");
-   return ak_false;
- }
-/* пытаемся считать данные из указанного файла */
- if( ak_file_open_to_read( &fd, name ) == ak_error_ok ) {
-   if(( error = ak_libakrypt_load_options_from_file( &fd )) == ak_error_ok ) {
-     if( ak_libakrypt_get_option( "log_level" ) > ak_log_standard ) {
-       ak_error_message_fmt( ak_error_ok, __func__,
-                                                 "all options was read from %s file", name );
-     }
-     return ak_true;
-   } else {
-         ak_error_message_fmt( error, __func__, "file %s exists, but contains invalid data", name );
-       return ak_false;
-     }
- }
+ for( i = 0; i < ak_libakrypt_options_count(); i++ )
+    values[i] = ak_libakrypt_get_option_by_index(( option_index_t ) i );
 
-/* создаем имя файла, расположенного в системном каталоге */
- if(( error = ak_libakrypt_create_filename( name, FILENAME_MAX,
-                                                          "libakrypt.conf", 1 )) != ak_error_ok ) {
-   ak_error_message( error, __func__, "incorrect name generation for options file");
+/* пытаемся считать данные из домашнего или системного каталога */
+ if(( error = ak_libakrypt_read_options( values, name )) == ak_error_ok ) {
+   ak_libakrypt_publish_options( values );
+   if( ak_libakrypt_get_option_by_index( option_log_level ) > ak_log_standard ) {
+     ak_error_message_fmt( ak_error_ok, __func__, "all options was read from %s file", name );
+   }
+   return ak_true;
+ }
+ if( error != ak_error_access_file ) {
+   ak_error_message( error, __func__, "wrong options reading from libakrypt.conf file" );
    return ak_false;
  }
-/* пытаемся считать данные из указанного файла */
- if( ak_file_open_to_read( &fd, name ) == ak_error_ok ) {
-   if(( error = ak_libakrypt_load_options_from_file( &fd )) == ak_error_ok ) {
-     if( ak_libakrypt_get_option( "log_level" ) > ak_log_standard ) {
-       ak_error_message_fmt( ak_error_ok, __func__,
-                                                 "all options was read from %s file", name );
-     }
-     return ak_true;
-   } else {
-       ak_error_message_fmt( error, __func__, "wrong options reading from %s file", name );
-       return ak_false;
-     }
- } else ak_error_message( ak_error_access_file, __func__,
+ ak_error_message( ak_error_access_file, __func__,
                          "file libakrypt.conf not found either in home or system directory");
 
  /* формируем дерево подкаталогов и записываем файл с настройками */
@@ -572,11 +756,55 @@
 }
 #endif
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция повторно считывает файл `libakrypt.conf` и атомарно изменяет значения опций,
+    что позволяет изменять настройки библиотеки без перезапуска программы.
+    Опции, отсутствующие в файле, сохраняют свои текущие значения.
+
+    Новые значения используются всеми последующими операциями, например, ресурсы ключей
+    устанавливаются при присвоении ключам новых значений, а политика смены маски -
+    при создании ключей. Значения опций `context_manager_size` и `context_manager_max_size`
+    используются только при создании или увеличении структуры управления контекстами.
+    Изменение опции `log_async` включает или выключает асинхронный вывод сообщений.
+
+    \b Внимание. Функция экспортируется.
+
+    \return В случае успеха функция возвращает \ref ak_error_ok (ноль). Если файл не найден
+    или содержит некорректные данные, то значения опций не изменяются и возвращается
+    код ошибки.                                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_libakrypt_reload_options( void )
+{
+#ifndef LIBAKRYPT_CONST_CRYPTO_PARAMS
+ size_t i = 0, count = 0;
+ int error = ak_error_ok;
+ char name[FILENAME_MAX];
+ ak_int64 async, values[option_undefined];
+
+ for( i = 0; i < ak_libakrypt_options_count(); i++ )
+    values[i] = ak_libakrypt_get_option_by_index(( option_index_t ) i );
+ async = values[option_log_async];
+
+ if(( error = ak_libakrypt_read_options( values, name )) != ak_error_ok )
+   return ak_error_message( error, __func__, "wrong reloading of libakrypt.conf file" );
+ count = ak_libakrypt_publish_options( values );
+
+ if( values[option_log_async] != async ) ak_log_set_async( values[option_log_async] == 1 );
+ if( ak_libakrypt_get_option_by_index( option_log_level ) > ak_log_standard )
+   ak_error_message_fmt( ak_error_ok, __func__,
+                               "%u options changed after reading %s file", (unsigned int)count, name );
+ return ak_error_ok;
+#else
+ return ak_error_message( ak_error_undefined_function, __func__,
+                        "reloading of options is not supported with constant crypto parameters" );
+#endif
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  void ak_libakrypt_log_options( void )
 {
  /* выводим сообщение об установленных параметрах библиотеки */
-  if( ak_libakrypt_get_option( "log_level" ) >= ak_log_maximum ) {
+  if( ak_libakrypt_get_option_by_index( option_log_level ) >= ak_log_maximum ) {
     size_t i = 0;
     ak_error_message_fmt( ak_error_ok, __func__, "libakrypt version: %s",
                                                                      ak_libakrypt_version( ));
@@ -584,7 +812,8 @@
     поскольку она будет далее тестироваться отдельно     */
     for( i = 1; i < ak_libakrypt_options_count(); i++ )
        ak_error_message_fmt( ak_error_ok, __func__,
-                              "value of option %s is %d", options[i].name, options[i].value );
+                              "value of option %s is %lld", options[i].name,
+                             ( long long ) ak_libakrypt_get_option_by_index(( option_index_t ) i ));
    }
 }
 
@@ -720,7 +949,7 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
- int ak_log_get_level( void ) { return (int)ak_libakrypt_get_option("log_level"); }
+ int ak_log_get_level( void ) { return (int)ak_libakrypt_get_option_by_index( option_log_level ); }
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Все сообщения библиотеки могут быть разделены на три уровня.
@@ -754,30 +983,78 @@
 {
  int value = ak_max( level, ak_log_get_level( ));
 
-   if( value < 0 ) return ak_libakrypt_set_option("log_level", ak_log_none );
+   if( value < 0 ) return ak_libakrypt_set_option_by_index( option_log_level, ak_log_none );
    if( value > 16 ) value = 16;
- return ak_libakrypt_set_option("log_level", value );
+ return ak_libakrypt_set_option_by_index( option_log_level, value );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \b Внимание. Функция экспортируется.
     \param value Код ошибки, который будет установлен. В случае, если значение value положительно,
     то код ошибки полагается равным величине \ref ak_error_ok (ноль).
+    Код ошибки хранится отдельно для каждого потока выполнения программы.
+
     \return Функция возвращает устанавливаемое значение.                                           */
 /* ----------------------------------------------------------------------------------------------- */
  int ak_error_set_value( const int value )
 {
-  return ( ak_errno = value );
+  return ( ak_error_thread_local_get()->code = value );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \b Внимание. Функция экспортируется.
-    \return Функция возвращает текущее значение кода ошибки. Данное значение не является
-    защищенным от возможности изменения различными потоками выполнения программы.                  */
+    \return Функция возвращает значение кода последней ошибки, возникшей в текущем потоке
+    выполнения программы. Ошибки, возникающие в других потоках, на это значение не влияют.         */
 /* ----------------------------------------------------------------------------------------------- */
  int ak_error_get_value( void )
 {
-  return ak_errno;
+  return ak_error_thread_local_get()->code;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для каждого потока выполнения программы библиотека хранит несколько последних сообщений
+    об ошибках (сообщений с отрицательным кодом), сформированных функцией ak_error_message().
+    Сообщения сохраняются независимо от уровня аудита и установленной функции вывода сообщений.
+
+    \b Внимание. Функция экспортируется.
+    \return Функция возвращает количество сообщений, доступных с помощью функции
+    ak_error_get_message().                                                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ size_t ak_error_get_messages_count( void )
+{
+  size_t count = ak_error_thread_local_get()->count;
+ return count < ak_error_ring_size ? count : ak_error_ring_size;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \b Внимание. Функция экспортируется.
+    \param index Номер сообщения; нулевое значение соответствует последнему сообщению,
+    единица - предпоследнему и т.д.
+    \return Функция возвращает указатель на сообщение об ошибке текущего потока. Если сообщение
+    с заданным номером отсутствует, то возвращается NULL. Сообщение остается доступным до
+    тех пор, пока в текущем потоке не будет сформировано \ref ak_error_ring_size новых сообщений.  */
+/* ----------------------------------------------------------------------------------------------- */
+ const char *ak_error_get_message( const size_t index )
+{
+  ak_error_thread_local state = ak_error_thread_local_get();
+
+  if( index >= ak_error_get_messages_count()) return NULL;
+ return state->messages[( state->count - 1 - index )%ak_error_ring_size];
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция удаляет все сообщения об ошибках текущего потока и устанавливает код ошибки
+    равным \ref ak_error_ok.
+
+    \b Внимание. Функция экспортируется.                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_error_clear_messages( void )
+{
+  ak_error_thread_local state = ak_error_thread_local_get();
+
+  state->code = ak_error_ok;
+  state->count = 0;
+  memset( state->messages, 0, sizeof( state->messages ));
 }
 
 #ifdef LIBAKRYPT_HAVE_SYSLOG_H
@@ -843,6 +1120,384 @@
   return ak_error_ok;
 }
 
+#if defined( LIBAKRYPT_HAVE_PTHREAD ) && defined( LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+/* ----------------------------------------------------------------------------------------------- */
+/*                               асинхронный вывод сообщений аудита                                */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество сообщений, хранимых в кольцевом буфере одного потока. */
+ #define ak_log_ring_size                     (256)
+/*! \brief Максимальная длина одного сообщения, хранимого в кольцевом буфере. */
+ #define ak_log_message_size                  (512)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Кольцевой буфер сообщений одного потока выполнения программы.
+
+    \details Сообщения помещаются в буфер только потоком-владельцем, а извлекаются только
+    потоком вывода сообщений, поэтому для доступа к буферу блокировки не используются.
+    После завершения потока-владельца буфер может быть использован другим потоком.                 */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct log_ring {
+  /*! \brief количество помещенных в буфер сообщений (изменяется только владельцем) */
+   ak_uint32 head;
+  /*! \brief количество выведенных сообщений (изменяется только потоком вывода) */
+   ak_uint32 tail;
+  /*! \brief количество сообщений, отброшенных из-за переполнения буфера */
+   ak_uint64 dropped;
+  /*! \brief количество отброшенных сообщений, о которых уже было выведено уведомление */
+   ak_uint64 reported;
+  /*! \brief флаг наличия у буфера потока-владельца */
+   int owned;
+  /*! \brief следующий буфер в списке */
+   struct log_ring *next;
+  /*! \brief сообщения */
+   char messages[ak_log_ring_size][ak_log_message_size];
+ } *ak_log_ring;
+
+/*! \brief Список кольцевых буферов всех потоков. */
+ static ak_log_ring ak_log_rings = NULL;
+/*! \brief Флаг использования асинхронного вывода сообщений. */
+ static int ak_log_async = 0;
+/*! \brief Флаг наличия сообщений, ожидающих вывода. */
+ static int ak_log_wakeup = 0;
+/*! \brief Флаг завершения потока вывода сообщений. */
+ static int ak_log_stop = 0;
+/*! \brief Поток вывода сообщений. */
+ static pthread_t ak_log_thread;
+/*! \brief Мьютекс, исключающий одновременный вывод сообщений из буферов несколькими потоками. */
+ static pthread_mutex_t ak_log_drain_mutex = PTHREAD_MUTEX_INITIALIZER;
+/*! \brief Мьютекс, защищающий запуск и остановку потока вывода сообщений. */
+ static pthread_mutex_t ak_log_control_mutex = PTHREAD_MUTEX_INITIALIZER;
+/*! \brief Мьютекс и условная переменная, используемые для пробуждения потока вывода. */
+ static pthread_mutex_t ak_log_wakeup_mutex = PTHREAD_MUTEX_INITIALIZER;
+ static pthread_cond_t ak_log_wakeup_cond = PTHREAD_COND_INITIALIZER;
+/*! \brief Ключ, связывающий с потоком выполнения программы его кольцевой буфер. */
+ static pthread_key_t ak_log_ring_key;
+/*! \brief Флаг однократного создания ключа ak_log_ring_key. */
+ static pthread_once_t ak_log_ring_once = PTHREAD_ONCE_INIT;
+/*! \brief Флаг однократной регистрации обработчика ветвления процесса. */
+ static pthread_once_t ak_log_atfork_once = PTHREAD_ONCE_INIT;
+ #ifdef LIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL
+/*! \brief Копия указателя на кольцевой буфер текущего потока. */
+  static __thread ak_log_ring ak_log_ring_slot = NULL;
+ #endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция освобождает кольцевой буфер при завершении потока-владельца; сам буфер
+    остается в списке и может быть использован другим потоком.                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_log_ring_release( ak_pointer ptr )
+{
+#ifdef LIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL
+ /* буфер может быть занят другим потоком, поэтому указатель на него не должен сохраняться */
+  ak_log_ring_slot = NULL;
+#endif
+  if( ptr != NULL ) ak_atomic_store( &(( ak_log_ring ) ptr )->owned, 0 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_log_ring_key_create( void )
+{
+  pthread_key_create( &ak_log_ring_key, ak_log_ring_release );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Обработчик ветвления процесса, выполняемый в дочернем процессе.
+
+    Поток вывода сообщений в дочерний процесс не копируется, поэтому асинхронный вывод
+    выключается, а мьютексы, которые могли быть захвачены потоком вывода в момент ветвления,
+    инициализируются заново. Сообщения, не выведенные к моменту ветвления, выводятся
+    родительским процессом и в дочернем процессе отбрасываются.                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_log_atfork_child( void )
+{
+  ak_log_ring ring = NULL;
+
+  ak_log_async = 0;
+  ak_log_stop = 0;
+  ak_log_wakeup = 0;
+  pthread_mutex_init( &ak_log_drain_mutex, NULL );
+  pthread_mutex_init( &ak_log_control_mutex, NULL );
+  pthread_mutex_init( &ak_log_wakeup_mutex, NULL );
+  pthread_cond_init( &ak_log_wakeup_cond, NULL );
+  pthread_mutex_init( &ak_function_log_default_mutex, NULL );
+  for( ring = ak_log_rings; ring != NULL; ring = ring->next ) {
+     ring->tail = ring->head;
+     ring->reported = ring->dropped;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_log_atfork_register( void )
+{
+  pthread_atfork( NULL, NULL, ak_log_atfork_child );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает кольцевой буфер текущего потока, при необходимости занимая
+    свободный буфер из списка или создавая новый.                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_log_ring ak_log_ring_get( void )
+{
+  int expected = 0;
+  ak_log_ring ring = NULL, head = NULL;
+
+#ifdef LIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL
+  if(( ring = ak_log_ring_slot ) != NULL ) return ring;
+#endif
+  pthread_once( &ak_log_ring_once, ak_log_ring_key_create );
+  if(( ring = pthread_getspecific( ak_log_ring_key )) != NULL ) return ring;
+
+ /* ищем буфер, освобожденный завершившимся потоком */
+  for( ring = ak_atomic_load( &ak_log_rings ); ring != NULL; ring = ring->next ) {
+     expected = 0;
+     if( ak_atomic_cas( &ring->owned, &expected, 1 )) break;
+  }
+ /* создаем новый буфер и добавляем его в начало списка */
+  if( ring == NULL ) {
+    if(( ring = calloc( 1, sizeof( struct log_ring ))) == NULL ) return NULL;
+    ring->owned = 1;
+    head = ak_atomic_load( &ak_log_rings );
+    do {
+        ring->next = head;
+    } while( !ak_atomic_cas( &ak_log_rings, &head, ring ));
+  }
+
+  pthread_setspecific( ak_log_ring_key, ring );
+#ifdef LIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL
+  ak_log_ring_slot = ring;
+#endif
+ return ring;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция помещает сообщение в кольцевой буфер текущего потока. При переполнении
+    буфера сообщение отбрасывается, а счетчик отброшенных сообщений увеличивается.                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_log_ring_push( const char *message )
+{
+  ak_uint32 head = 0;
+  ak_log_ring ring = NULL;
+
+  if(( ring = ak_log_ring_get( )) == NULL ) return ak_error_out_of_memory;
+  head = ring->head;
+  if( head - ak_atomic_load( &ring->tail ) >= ak_log_ring_size ) {
+    ak_atomic_add( &ring->dropped, 1 );
+    return ak_error_ok;
+  }
+  strncpy( ring->messages[ head%ak_log_ring_size ], message, ak_log_message_size-1 );
+  ring->messages[ head%ak_log_ring_size ][ ak_log_message_size-1 ] = 0;
+  ak_atomic_store( &ring->head, head+1 );
+
+ /* поток вывода пробуждается только один раз для каждой серии сообщений */
+  if( ak_atomic_exchange( &ak_log_wakeup, 1 ) == 0 ) {
+    pthread_mutex_lock( &ak_log_wakeup_mutex );
+    pthread_cond_signal( &ak_log_wakeup_cond );
+    pthread_mutex_unlock( &ak_log_wakeup_mutex );
+  }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выводит все накопленные сообщения; вызывается под защитой мьютекса
+    ak_log_drain_mutex.                                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_log_drain_rings( void )
+{
+  ak_uint32 head, tail;
+  ak_uint64 dropped;
+  ak_log_ring ring = NULL;
+  char string[128];
+
+  for( ring = ak_atomic_load( &ak_log_rings ); ring != NULL; ring = ring->next ) {
+     head = ak_atomic_load( &ring->head );
+     tail = ring->tail;
+     dropped = ak_atomic_load( &ring->dropped );
+     if(( head == tail ) && ( dropped == ring->reported )) continue;
+
+    /* сообщения одного буфера выводятся одной серией */
+     pthread_mutex_lock( &ak_function_log_default_mutex );
+     for( ; tail != head; tail++ ) {
+        if( ak_function_log_default != NULL )
+          ak_function_log_default( ring->messages[ tail%ak_log_ring_size ] );
+        ak_atomic_store( &ring->tail, tail+1 );
+     }
+     if( dropped != ring->reported ) {
+       ak_snprintf( string, sizeof( string ), "%s(): %llu log messages dropped due to overflow",
+                                 __func__, ( unsigned long long )( dropped - ring->reported ));
+       if( ak_function_log_default != NULL ) ak_function_log_default( string );
+       ring->reported = dropped;
+     }
+     pthread_mutex_unlock( &ak_function_log_default_mutex );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция потока вывода сообщений.                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_log_drain_thread( void *arg )
+{
+  (void) arg;
+  for( ;; ) {
+     pthread_mutex_lock( &ak_log_wakeup_mutex );
+     while( !ak_atomic_load( &ak_log_wakeup ) && !ak_atomic_load( &ak_log_stop ))
+       pthread_cond_wait( &ak_log_wakeup_cond, &ak_log_wakeup_mutex );
+     pthread_mutex_unlock( &ak_log_wakeup_mutex );
+
+    /* флаг сбрасывается до вывода, поэтому сообщения, помещенные в буферы во время вывода,
+       приведут к повторному пробуждению потока */
+     ak_atomic_store( &ak_log_wakeup, 0 );
+     pthread_mutex_lock( &ak_log_drain_mutex );
+     ak_log_drain_rings();
+     pthread_mutex_unlock( &ak_log_drain_mutex );
+     if( ak_atomic_load( &ak_log_stop )) break;
+  }
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция включает или выключает асинхронный вывод сообщений аудита.
+
+    При асинхронном выводе функция ak_log_set_message() не вызывает функцию-обработчик сообщений,
+    а помещает сообщение в кольцевой буфер текущего потока, не используя блокировок.
+    Накопленные сообщения выводятся сериями отдельным потоком, который создается
+    данной функцией. При переполнении буфера новые сообщения отбрасываются, а количество
+    отброшенных сообщений выводится при следующем выводе сообщений из буфера.
+    Асинхронный вывод также может быть включен с помощью опции `log_async`
+    (см. раздел \ref construction_options).
+
+    При выключении асинхронного вывода все накопленные сообщения выводятся, а поток вывода
+    завершается. Выключение выполняется функцией ak_libakrypt_destroy().
+
+    \b Внимание. Функция экспортируется.
+
+    \param enable Флаг включения (\ref ak_true) или выключения (\ref ak_false) асинхронного вывода.
+    \return В случае успеха, возвращается ak_error_ok (ноль). Если асинхронный вывод
+    не поддерживается, то возвращается \ref ak_error_undefined_function.                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_log_set_async( const bool_t enable )
+{
+#if defined( LIBAKRYPT_HAVE_PTHREAD ) && defined( LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+  int error = ak_error_ok;
+
+  pthread_once( &ak_log_atfork_once, ak_log_atfork_register );
+  pthread_mutex_lock( &ak_log_control_mutex );
+  if( enable ) {
+    if( !ak_atomic_load( &ak_log_async )) {
+      ak_atomic_store( &ak_log_stop, 0 );
+      if( pthread_create( &ak_log_thread, NULL, ak_log_drain_thread, NULL ) != 0 )
+        error = ak_error_undefined_function;
+       else ak_atomic_store( &ak_log_async, 1 );
+    }
+  } else {
+     if( ak_atomic_load( &ak_log_async )) {
+       ak_atomic_store( &ak_log_async, 0 );
+       pthread_mutex_lock( &ak_log_wakeup_mutex );
+       ak_atomic_store( &ak_log_stop, 1 );
+       pthread_cond_signal( &ak_log_wakeup_cond );
+       pthread_mutex_unlock( &ak_log_wakeup_mutex );
+       pthread_join( ak_log_thread, NULL );
+
+      /* выводим сообщения, помещенные в буферы во время остановки потока */
+       pthread_mutex_lock( &ak_log_drain_mutex );
+       ak_log_drain_rings();
+       pthread_mutex_unlock( &ak_log_drain_mutex );
+     }
+    }
+  pthread_mutex_unlock( &ak_log_control_mutex );
+
+  if( error != ak_error_ok )
+    return ak_error_message( error, __func__, "wrong creation of log output thread" );
+ return error;
+#else
+  if( enable ) return ak_error_message( ak_error_undefined_function, __func__,
+                                         "asynchronous log output is not supported on this platform" );
+ return ak_error_ok;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывается из ak_libakrypt_destroy() после завершения потока вывода сообщений и
+    освобождает кольцевые буферы, не занятые потоками, а также буфер текущего потока.
+    Буферы, принадлежащие другим работающим потокам, остаются в списке, поскольку эти потоки
+    хранят указатели на них; такие буферы освобождаются при следующем вызове функции после
+    завершения потоков-владельцев.                                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_log_destroy_rings( void )
+{
+#if defined( LIBAKRYPT_HAVE_PTHREAD ) && defined( LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+  int expected = 0;
+  ak_log_ring ring = NULL, next = NULL, own = NULL, head = NULL;
+
+  pthread_mutex_lock( &ak_log_control_mutex );
+  if( ak_atomic_load( &ak_log_async )) { /* поток вывода еще работает */
+    pthread_mutex_unlock( &ak_log_control_mutex );
+    return;
+  }
+
+ /* буфер текущего потока отсоединяется от потока */
+  pthread_once( &ak_log_ring_once, ak_log_ring_key_create );
+  if(( own = pthread_getspecific( ak_log_ring_key )) != NULL ) {
+    pthread_setspecific( ak_log_ring_key, NULL );
+   #ifdef LIBAKRYPT_HAVE_BUILTIN_THREAD_LOCAL
+    ak_log_ring_slot = NULL;
+   #endif
+  }
+
+  pthread_mutex_lock( &ak_log_drain_mutex );
+  ak_log_drain_rings();
+  ring = ak_atomic_exchange( &ak_log_rings, NULL );
+  for( ; ring != NULL; ring = next ) {
+     next = ring->next;
+     expected = 0;
+     if(( ring == own ) || ak_atomic_cas( &ring->owned, &expected, 1 )) {
+       free( ring );
+     } else { /* буфер занят другим потоком и возвращается в список */
+         head = ak_atomic_load( &ak_log_rings );
+         do {
+             ring->next = head;
+         } while( !ak_atomic_cas( &ak_log_rings, &head, ring ));
+       }
+  }
+  pthread_mutex_unlock( &ak_log_drain_mutex );
+  pthread_mutex_unlock( &ak_log_control_mutex );
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция выводит все сообщения, накопленные в кольцевых буферах потоков к моменту ее вызова.
+    Если асинхронный вывод сообщений не используется, функция ничего не делает.
+
+    \b Внимание. Функция экспортируется.
+    \return Функция всегда возвращает ak_error_ok (ноль).                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_log_flush( void )
+{
+#if defined( LIBAKRYPT_HAVE_PTHREAD ) && defined( LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+  pthread_mutex_lock( &ak_log_drain_mutex );
+  ak_log_drain_rings();
+  pthread_mutex_unlock( &ak_log_drain_mutex );
+#endif
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \b Внимание. Функция экспортируется.
+    \return Функция возвращает общее количество сообщений, отброшенных всеми потоками
+    из-за переполнения кольцевых буферов асинхронного вывода.                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_uint64 ak_log_get_dropped( void )
+{
+  ak_uint64 dropped = 0;
+#if defined( LIBAKRYPT_HAVE_PTHREAD ) && defined( LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+  ak_log_ring ring = NULL;
+
+  for( ring = ak_atomic_load( &ak_log_rings ); ring != NULL; ring = ring->next )
+     dropped += ak_atomic_load( &ring->dropped );
+#endif
+ return dropped;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция использует установленную ранее функцию-обработчик сообщений. Если сообщение,
     или обработчик не определены (равны NULL) возвращается код ошибки.
@@ -860,6 +1515,10 @@
   if( message == NULL ) {
     return ak_error_message( ak_error_null_pointer, __func__ , "using a NULL string for message" );
   } else {
+          #if defined( LIBAKRYPT_HAVE_PTHREAD ) && defined( LIBAKRYPT_HAVE_BUILTIN_ATOMIC )
+           if( ak_atomic_load( &ak_log_async ))
+             if( ak_log_ring_push( message ) == ak_error_ok ) return ak_error_ok;
+          #endif
           #ifdef LIBAKRYPT_HAVE_PTHREAD
            pthread_mutex_lock( &ak_function_log_default_mutex );
           #endif
@@ -936,6 +1595,17 @@
  #endif
 #endif
   ak_log_set_message( error_event_string );
+
+ /* сохраняем сообщение об ошибке в кольцевом буфере текущего потока */
+  if( code < 0 ) {
+    ak_error_thread_local state = ak_error_thread_local_get();
+    char *ptr = state->messages[ state->count%ak_error_ring_size ];
+
+    ak_snprintf( ptr, ak_error_ring_message_size, "%s%s %s (code: %d)",
+                                         function == NULL ? "" : function, br, message, code );
+    ptr[ ak_error_ring_message_size-1 ] = 0;
+    state->count++;
+  }
  return ak_error_set_value( code );
 }
 
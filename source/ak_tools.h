@@ -15,6 +15,28 @@
  #include <windows.h>
 #endif
 
+/* ----------------------------------------------------------------------------------------------- */
+/* атомарные операции; если компилятор их не поддерживает, то операции становятся обычными,
+   а использующий их код должен самостоятельно обеспечить блокировку                               */
+#ifdef LIBAKRYPT_HAVE_BUILTIN_ATOMIC
+ #define ak_atomic_load( ptr )          __atomic_load_n( (ptr), __ATOMIC_ACQUIRE )
+ #define ak_atomic_store( ptr, val )    __atomic_store_n( (ptr), (val), __ATOMIC_RELEASE )
+ #define ak_atomic_exchange( ptr, val ) __atomic_exchange_n( (ptr), (val), __ATOMIC_ACQ_REL )
+ #define ak_atomic_add( ptr, val )      __atomic_add_fetch( (ptr), (val), __ATOMIC_ACQ_REL )
+ #define ak_atomic_sub( ptr, val )      __atomic_sub_fetch( (ptr), (val), __ATOMIC_ACQ_REL )
+ #define ak_atomic_cas( ptr, exp, val ) \
+   __atomic_compare_exchange_n( (ptr), (exp), (val), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE )
+ #define ak_atomic_fence()              __atomic_thread_fence( __ATOMIC_SEQ_CST )
+#else
+ #define ak_atomic_load( ptr )          ( *(ptr) )
+ #define ak_atomic_store( ptr, val )    ( *(ptr) = (val) )
+ #define ak_atomic_add( ptr, val )      ( *(ptr) += (val) )
+ #define ak_atomic_sub( ptr, val )      ( *(ptr) -= (val) )
+ #define ak_atomic_cas( ptr, exp, val ) \
+   (( *(ptr) == *(exp) ) ? ( *(ptr) = (val), 1 ) : ( *(exp) = *(ptr), 0 ))
+ #define ak_atomic_fence()
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Структура данных для хранения дескриптора и параметров файла. */
  typedef struct file {
@@ -38,16 +60,69 @@
  int ak_file_create_to_write( ak_file , const char * );
 /*! \brief Функция закрывает файл с заданным дескриптором. */
  int ak_file_close( ak_file );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция освобождает память кольцевых буферов асинхронного вывода сообщений. */
+ void ak_log_destroy_rings( void );
 /*! \brief Функция считывает заданное количество байт из файла. */
  ssize_t ak_file_read( ak_file , ak_pointer , size_t );
 /*! \brief Функция записывает заданное количество байт в файл. */
  ssize_t ak_file_write( ak_file , ak_const_pointer , size_t );
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Индексы опций библиотеки.
+    \details Порядок констант совпадает с порядком опций в массиве опций библиотеки;
+    индекс позволяет получить значение опции без поиска по ее имени.                              */
+ typedef enum {
+  /*! \brief уровень аудита */
+   option_log_level,
+  /*! \brief флаг асинхронного вывода сообщений аудита */
+   option_log_async,
+  /*! \brief начальный размер структуры управления контекстами */
+   option_context_manager_size,
+  /*! \brief максимальный размер структуры управления контекстами */
+   option_context_manager_max_size,
+  /*! \brief длина номера ключа */
+   option_key_number_length,
+  /*! \brief количество итераций алгоритма pbkdf2 */
+   option_pbkdf2_iteration_count,
+  /*! \brief ресурс ключа алгоритма HMAC */
+   option_hmac_key_count_resource,
+  /*! \brief ресурс ключа алгоритма блочного шифрования Магма */
+   option_magma_cipher_resource,
+  /*! \brief ресурс ключа алгоритма блочного шифрования Кузнечик */
+   option_kuznechik_cipher_resource,
+  /*! \brief количество сообщений, обрабатываемых в режиме ACPKM */
+   option_acpkm_message_count,
+  /*! \brief длина секции режима ACPKM для алгоритма Магма (в блоках) */
+   option_acpkm_section_magma_block_count,
+  /*! \brief длина секции режима ACPKM для алгоритма Кузнечик (в блоках) */
+   option_acpkm_section_kuznechik_block_count,
+  /*! \brief количество потоков, используемых при проверке пакета подписей */
+   option_verify_batch_threads,
+  /*! \brief индекс OID генератора масок секретных ключей */
+   option_mask_random_generator,
+  /*! \brief политика смены маски секретных ключей */
+   option_mask_refresh_policy,
+  /*! \brief интервал смены маски секретных ключей */
+   option_mask_refresh_interval,
+  /*! \brief политика проверки контрольной суммы секретных ключей */
+   option_icode_check_policy,
+  /*! \brief интервал проверки контрольной суммы секретных ключей */
+   option_icode_check_interval,
+  /*! \brief неопределенная опция (количество опций) */
+   option_undefined
+ } option_index_t;
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция устанавливает значение опции с заданным именем. */
  int ak_libakrypt_set_option( const char *name, const ak_int64 value );
 /*! \brief Функция возвращает значение опции с заданным именем. */
  ak_int64 ak_libakrypt_get_option( const char *name );
+/*! \brief Функция устанавливает значение опции с заданным индексом. */
+ int ak_libakrypt_set_option_by_index( const option_index_t , const ak_int64 );
+/*! \brief Функция возвращает значение опции с заданным индексом. */
+ ak_int64 ak_libakrypt_get_option_by_index( const option_index_t );
 /*! \brief Вывод в логгер текущих значений опций библиотеки. */
  void ak_libakrypt_log_options( void );
 
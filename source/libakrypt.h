@@ -212,6 +212,8 @@ extern "C" {
  #define ak_error_terminal                    (-37)
 /*! \brief Использование неопределенного буффера. */
  #define ak_error_wrong_buffer                (-38)
+/*! \brief Попытка уничтожения защищенной области памяти, содержащей неуничтоженные секретные данные. */
+ #define ak_error_secure_memory_used          (-39)
 
 /*! \brief Неверное значение дескриптора объекта. */
  #define ak_error_wrong_handle                (-40)
@@ -444,6 +446,12 @@ extern "C" {
 #endif
 /*! \brief Функция вывода сообщения об ошибке в стандартный канал вывода ошибок. */
  dll_export int ak_function_log_stderr( const char * );
+/*! \brief Включение или выключение асинхронного вывода сообщений аудита. */
+ dll_export int ak_log_set_async( const bool_t );
+/*! \brief Вывод всех сообщений, накопленных при асинхронном выводе. */
+ dll_export int ak_log_flush( void );
+/*! \brief Количество сообщений, отброшенных при асинхронном выводе. */
+ dll_export ak_uint64 ak_log_get_dropped( void );
 /*! \brief Вывод сообщений о возникшей в процессе выполнения ошибке. */
  dll_export int ak_error_message( const int, const char *, const char * );
 /*! \brief Вывод сообщений о возникшей в процессе выполнения ошибке. */
@@ -452,6 +460,12 @@ extern "C" {
  dll_export int ak_error_set_value( const int );
 /*! \brief Функция возвращает код последней ошибки выполнения программы. */
  dll_export int ak_error_get_value( void );
+/*! \brief Функция возвращает количество последних сообщений об ошибках текущего потока. */
+ dll_export size_t ak_error_get_messages_count( void );
+/*! \brief Функция возвращает одно из последних сообщений об ошибках текущего потока. */
+ dll_export const char *ak_error_get_message( const size_t );
+/*! \brief Функция удаляет сообщения об ошибках текущего потока. */
+ dll_export void ak_error_clear_messages( void );
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция возвращает общее количества опций библиотеки. */
@@ -460,6 +474,8 @@ extern "C" {
  dll_export char *ak_libakrypt_get_option_name( const size_t index );
 /*! \brief Получение значения опции по ее номеру. */
  dll_export ak_int64 ak_libakrypt_get_option_value( const size_t index );
+/*! \brief Повторное считывание опций библиотеки из файла libakrypt.conf. */
+ dll_export int ak_libakrypt_reload_options( void );
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Получение человекочитаемого имени для заданного типа криптографического механизма. */
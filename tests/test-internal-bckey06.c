@@ -0,0 +1,68 @@
+/* Пример, иллюстрирующий политики смены маски ключа алгоритма блочного шифрования
+   (на примере блочного шифра кузнечик).
+   Используются неэкспортируемые функции библиотеки.
+
+   test-internal-bckey06.c
+*/
+ #include <stdio.h>
+ #include <string.h>
+ #include <stdlib.h>
+ #include <ak_bckey.h>
+
+/* проверяем, сколько раз изменилась маска ключа за count вызовов функции зашифрования */
+ int count_remasks( mask_refresh_policy_t policy, ak_int64 interval, size_t count, size_t blocks )
+{
+  size_t i = 0;
+  int changes = 0;
+  struct bckey key, ref;
+  ak_uint8 value[32], in[64], out[64], out2[64], mask[32];
+
+  memset( value, 0x5a, sizeof( value ));
+  memset( in, 0x17, sizeof( in ));
+  ak_bckey_context_create_kuznechik( &key );
+  ak_bckey_context_set_key( &key, value, sizeof( value ), ak_true );
+  ak_skey_context_set_mask_refresh( &key.key, policy, interval );
+  ak_bckey_context_create_kuznechik( &ref );
+  ak_bckey_context_set_key( &ref, value, sizeof( value ), ak_true );
+
+  for( i = 0; i < count; i++ ) {
+     memcpy( mask, key.key.mask.data, sizeof( mask ));
+     ak_bckey_context_encrypt_ecb( &key, in, out, blocks*16 );
+     ak_bckey_context_encrypt_ecb( &ref, in, out2, blocks*16 );
+     if( !ak_ptr_is_equal( out, out2, blocks*16 )) changes = -1000;
+     if( !ak_ptr_is_equal( mask, key.key.mask.data, sizeof( mask ))) changes++;
+  }
+  ak_bckey_context_destroy( &key );
+  ak_bckey_context_destroy( &ref );
+ return changes;
+}
+
+ int main( void )
+{
+  int changes = 0, error = EXIT_SUCCESS;
+
+  if( ak_libakrypt_create( ak_function_log_stderr ) != ak_true ) return ak_libakrypt_destroy();
+
+ /* маска меняется после каждого вызова */
+  printf("every call:        %d remasks (expected 12)\n",
+                          changes = count_remasks( mask_refresh_every_call, 1, 12, 1 ));
+  if( changes != 12 ) error = EXIT_FAILURE;
+
+ /* маска меняется после обработки 8 блоков (по 2 блока за вызов) */
+  printf("every 8 blocks:    %d remasks (expected 3)\n",
+                               changes = count_remasks( mask_refresh_blocks, 8, 12, 2 ));
+  if( changes != 3 ) error = EXIT_FAILURE;
+
+ /* маска меняется после каждых трех вызовов */
+  printf("every 3 calls:     %d remasks (expected 4)\n",
+                                changes = count_remasks( mask_refresh_calls, 3, 12, 4 ));
+  if( changes != 4 ) error = EXIT_FAILURE;
+
+ /* маска меняется раз в час */
+  printf("every hour:        %d remasks (expected 0)\n",
+                              changes = count_remasks( mask_refresh_timer, 3600, 12, 1 ));
+  if( changes != 0 ) error = EXIT_FAILURE;
+
+  ak_libakrypt_destroy();
+ return error;
+}
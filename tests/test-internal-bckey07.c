@@ -0,0 +1,90 @@
+/* Тестовый пример, иллюстрирующий быструю смену значения ключа алгоритма блочного шифрования:
+   результат шифрования после смены ключа сравнивается с результатом, получаемым для ключа,
+   значение которого присвоено обычным образом; также проверяется повторное использование
+   памяти и сравнивается скорость смены ключа.
+   Пример использует неэкспортируемые функции.
+
+   test-internal-bckey07.c
+*/
+
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_bckey.h>
+
+ #define iterations   (10000)
+
+ int test_rekey( const char *name )
+{
+  size_t i = 0;
+  clock_t tmr;
+  struct bckey one, two;
+  ak_pointer keydata = NULL, data = NULL;
+  int exitcode = EXIT_SUCCESS;
+  ak_uint8 value[32], in[64], out[64], reference[64];
+  ak_oid oid = ak_oid_context_find_by_name( name );
+
+  memset( value, 0x11, sizeof( value ));
+  for( i = 0; i < sizeof( in ); i++ ) in[i] = ( ak_uint8 )i;
+  ak_bckey_context_create_oid( &one, oid );
+  ak_bckey_context_create_oid( &two, oid );
+  ak_bckey_context_set_key( &one, value, sizeof( value ), ak_true );
+  keydata = one.key.key.data;
+  data = one.key.data;
+
+ /* многократно меняем ключ и сравниваем с ключом, значение которого присвоено заново */
+  for( i = 0; i < 16; i++ ) {
+     value[i] = ( ak_uint8 )( 0xa5 + i );
+     if( ak_bckey_context_rekey( &one, value, sizeof( value )) != ak_error_ok )
+       exitcode = EXIT_FAILURE;
+     ak_bckey_context_set_key( &two, value, sizeof( value ), ak_true );
+     ak_bckey_context_encrypt_ecb( &one, in, out, sizeof( in ));
+     ak_bckey_context_encrypt_ecb( &two, in, reference, sizeof( in ));
+     if( !ak_ptr_is_equal( out, reference, sizeof( out ))) exitcode = EXIT_FAILURE;
+     if( one.key.resource.value.counter != two.key.resource.value.counter )
+       exitcode = EXIT_FAILURE;
+     ak_bckey_context_decrypt_ecb( &one, out, reference, sizeof( out ));
+     if( !ak_ptr_is_equal( in, reference, sizeof( in ))) exitcode = EXIT_FAILURE;
+  }
+ /* память под ключ и развернутые ключи не выделяется повторно */
+  if(( keydata != one.key.key.data ) || ( data != one.key.data )) {
+    printf("memory of secret key is reallocated\n");
+    exitcode = EXIT_FAILURE;
+  }
+ /* ключ неверной длины не принимается */
+  if( ak_bckey_context_rekey( &one, value, 16 ) != ak_error_wrong_length ) exitcode = EXIT_FAILURE;
+  printf("%s rekey: %s\n", name, exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+
+ /* сравнение скорости */
+  tmr = clock();
+  for( i = 0; i < iterations; i++ ) {
+     value[0] = ( ak_uint8 )i;
+     ak_bckey_context_set_key( &two, value, sizeof( value ), ak_true );
+  }
+  tmr = clock() - tmr;
+  printf(" set key: %.3fs\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+  tmr = clock();
+  for( i = 0; i < iterations; i++ ) {
+     value[0] = ( ak_uint8 )i;
+     ak_bckey_context_rekey( &one, value, sizeof( value ));
+  }
+  tmr = clock() - tmr;
+  printf(" rekey:   %.3fs\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  ak_bckey_context_destroy( &one );
+  ak_bckey_context_destroy( &two );
+ return exitcode;
+}
+
+ int main( void )
+{
+  int error = EXIT_SUCCESS;
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+
+  if(( error = test_rekey( "kuznechik" )) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_rekey( "magma" )) != EXIT_SUCCESS ) goto exitlab;
+
+  exitlab: ak_libakrypt_destroy();
+ return error;
+}
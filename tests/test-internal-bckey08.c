@@ -0,0 +1,133 @@
+/* Пример, иллюстрирующий политики проверки контрольной суммы ключа алгоритма блочного шифрования:
+   проверка при каждом использовании ключа, после заданного количества использований
+   и проверка отдельным потоком; также сравнивается скорость зашифрования коротких сообщений.
+   Используются неэкспортируемые функции библиотеки.
+
+   test-internal-bckey08.c
+*/
+ #define _POSIX_C_SOURCE 200112L
+
+ #include <time.h>
+ #include <stdio.h>
+ #include <string.h>
+ #include <stdlib.h>
+ #include <ak_bckey.h>
+
+ #define iterations    (500000)
+
+/* количество обнаруженных нарушений целостности ключа */
+ static int violations = 0;
+
+ void count_violations( ak_skey skey )
+{
+  (void) skey;
+  violations++;
+}
+
+/* искажаем ключ и возвращаем номер вызова функции зашифрования, при котором искажение обнаружено */
+ int detect_violation( icode_check_policy_t policy, ak_int64 interval, int count )
+{
+  int i = 0, result = -1;
+  struct bckey key;
+  ak_uint8 value[32], in[16], out[16];
+
+  memset( value, 0x5a, sizeof( value ));
+  memset( in, 0x17, sizeof( in ));
+  ak_bckey_context_create_magma( &key );
+  ak_bckey_context_set_key( &key, value, sizeof( value ), ak_true );
+  ak_skey_context_set_icode_check( &key.key, policy, interval );
+  if( ak_bckey_context_encrypt_ecb( &key, in, out, sizeof( in )) != ak_error_ok ) result = -2;
+
+  violations = 0;
+  ((ak_uint8 *)key.key.key.data)[0] ^= 0x01;
+  for( i = 1; ( i <= count ) && ( result == -1 ); i++ ) {
+    if( policy == icode_check_background ) {
+      struct timespec ts = { 0, 2000000L };
+      nanosleep( &ts, NULL );
+    }
+    if( ak_bckey_context_encrypt_ecb( &key, in, out, sizeof( in )) == ak_error_wrong_key_icode )
+      result = i;
+  }
+  if( violations != ( result > 0 )) result = -3;
+  ((ak_uint8 *)key.key.key.data)[0] ^= 0x01;
+  ak_bckey_context_destroy( &key );
+ return result;
+}
+
+/* ключ, маска которого меняется при каждом использовании, одновременно проверяется фоновым
+   потоком; возвращается количество ошибок зашифрования и вызовов функции нарушения целостности */
+ int remask_violations( void )
+{
+  size_t i = 0;
+  int errors = 0;
+  struct bckey key;
+  ak_uint8 value[32], in[16], out[16];
+
+  memset( value, 0x6e, sizeof( value ));
+  memset( in, 0x29, sizeof( in ));
+  ak_bckey_context_create_magma( &key );
+  ak_bckey_context_set_key( &key, value, sizeof( value ), ak_true );
+  ak_skey_context_set_mask_refresh( &key.key, mask_refresh_every_call, 0 );
+  ak_skey_context_set_icode_check( &key.key, icode_check_background, 1 );
+
+  violations = 0;
+  for( i = 0; i < iterations/5; i++ ) /* ресурс ключа Магма ограничен 2^18 блоками */
+     if( ak_bckey_context_encrypt_ecb( &key, in, out, sizeof( in )) != ak_error_ok ) errors++;
+  ak_bckey_context_destroy( &key );
+ return errors + violations;
+}
+
+/* скорость зашифрования коротких сообщений при заданной политике */
+ double encrypt_speed( icode_check_policy_t policy, ak_int64 interval )
+{
+  size_t i = 0;
+  clock_t tmr;
+  struct bckey key;
+  ak_uint8 value[32], in[16], out[16];
+
+  memset( value, 0x33, sizeof( value ));
+  memset( in, 0x44, sizeof( in ));
+  ak_bckey_context_create_magma( &key );
+  ak_bckey_context_set_key( &key, value, sizeof( value ), ak_true );
+  ak_skey_context_set_mask_refresh( &key.key, mask_refresh_calls, 1000000 );
+  ak_skey_context_set_icode_check( &key.key, policy, interval );
+
+  tmr = clock();
+  for( i = 0; i < iterations; i++ ) ak_bckey_context_encrypt_ecb( &key, in, out, 8 );
+  tmr = clock() - tmr;
+  ak_bckey_context_destroy( &key );
+ return ((double) tmr) / ((double) CLOCKS_PER_SEC);
+}
+
+ int main( void )
+{
+  int result = 0, error = EXIT_SUCCESS;
+
+  if( ak_libakrypt_create( NULL ) != ak_true ) return ak_libakrypt_destroy();
+  ak_libakrypt_set_icode_violation_function( count_violations );
+
+ /* при каждом использовании искажение обнаруживается сразу */
+  printf("every call: %d", result = detect_violation( icode_check_every_call, 1, 10 ));
+  if( result == 1 ) printf(" Ok\n"); else { printf(" Wrong\n"); error = EXIT_FAILURE; }
+
+ /* первая проверка выполнена до искажения ключа, поэтому следующая выполняется
+    при четвертом использовании ключа после искажения */
+  printf("every 5 calls: %d", result = detect_violation( icode_check_calls, 5, 10 ));
+  if( result == 4 ) printf(" Ok\n"); else { printf(" Wrong\n"); error = EXIT_FAILURE; }
+
+ /* фоновый поток проверяет ключ каждую миллисекунду */
+  printf("background: %d", result = detect_violation( icode_check_background, 1, 1000 ));
+  if( result > 0 ) printf(" Ok\n"); else { printf(" Wrong\n"); error = EXIT_FAILURE; }
+
+ /* смена маски во время фоновой проверки не приводит к ложным срабатываниям */
+  printf("background with remasking: %d", result = remask_violations( ));
+  if( result == 0 ) printf(" Ok\n"); else { printf(" Wrong\n"); error = EXIT_FAILURE; }
+
+  printf("encryption of %d blocks:\n", iterations );
+  printf(" every call:     %.3fs\n", encrypt_speed( icode_check_every_call, 1 ));
+  printf(" every 64 calls: %.3fs\n", encrypt_speed( icode_check_calls, 64 ));
+  printf(" background:     %.3fs\n", encrypt_speed( icode_check_background, 100 ));
+
+  ak_libakrypt_destroy();
+ return error;
+}
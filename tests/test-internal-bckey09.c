@@ -0,0 +1,124 @@
+/* Пример, иллюстрирующий одновременное использование одного ключа алгоритма блочного шифрования
+   несколькими потоками (в режимах MGM и простой замены): ресурс ключа резервируется атомарно, поэтому его значение
+   после работы потоков должно уменьшиться в точности на количество обработанных блоков;
+   маска разделяемого ключа при этом не меняется, а счетчик проверок контрольной суммы
+   не теряет приращений.
+   Используются неэкспортируемые функции библиотеки.
+
+   test-internal-bckey09.c
+*/
+ #include <stdio.h>
+ #include <string.h>
+ #include <stdlib.h>
+ #include <ak_bckey.h>
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+
+ #define threads_count   (4)
+ #define calls_count  (20000)
+
+/* общий для всех потоков ключ и эталонный результат зашифрования */
+ static struct bckey key;
+ static ak_uint8 in[52], reference[52], icode[16], iv[16], eref[32];
+
+/* функция потока: многократно зашифровывает данные, вычисляет имитовставку
+   и зашифровывает начало данных в режиме простой замены */
+ void *thread_mgm( void *arg )
+{
+  size_t i = 0;
+  long result = EXIT_SUCCESS;
+  ak_uint8 out[52], tag[16], eout[32];
+
+  for( i = 0; i < calls_count; i++ ) {
+     ak_bckey_context_encrypt_mgm( &key, &key, NULL, 0, in, out, sizeof( in ),
+                                                             iv, sizeof( iv ), tag, sizeof( tag ));
+     if( !ak_ptr_is_equal( out, reference, sizeof( out ))) result = EXIT_FAILURE;
+     if( !ak_ptr_is_equal( tag, icode, sizeof( tag ))) result = EXIT_FAILURE;
+     if( ak_bckey_context_encrypt_ecb( &key, in, eout, sizeof( eout )) != ak_error_ok )
+       result = EXIT_FAILURE;
+     if( !ak_ptr_is_equal( eout, eref, sizeof( eout ))) result = EXIT_FAILURE;
+  }
+  *(long *)arg = result;
+ return NULL;
+}
+
+ int main( void )
+{
+  size_t i = 0;
+  ssize_t counter = 0, expected = 0, used = 0;
+  ak_int64 checks = 0, verified = 0;
+  ak_uint8 value[32], mask[32];
+  int error = EXIT_SUCCESS;
+  long results[threads_count];
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_t threads[threads_count];
+#endif
+
+  if( ak_libakrypt_create( NULL ) != ak_true ) return ak_libakrypt_destroy();
+
+  memset( value, 0x21, sizeof( value ));
+  for( i = 0; i < sizeof( in ); i++ ) in[i] = ( ak_uint8 )i;
+  memset( iv, 0x12, sizeof( iv ));
+
+  ak_bckey_context_create_kuznechik( &key );
+  ak_bckey_context_set_key( &key, value, sizeof( value ), ak_true );
+ /* маска ключа не должна меняться, пока ключ используется несколькими потоками,
+    даже если политика требует ее смены при каждом использовании */
+  ak_skey_context_set_shared( &key.key, ak_true );
+  ak_skey_context_set_mask_refresh( &key.key, mask_refresh_every_call, 1 );
+  ak_skey_context_set_icode_check( &key.key, icode_check_calls, 1000 );
+  memcpy( mask, key.key.mask.data, sizeof( mask ));
+  counter = key.key.resource.value.counter;
+  checks = key.key.verify.counter;
+  ak_bckey_context_encrypt_mgm( &key, &key, NULL, 0, in, reference, sizeof( in ),
+                                                         iv, sizeof( iv ), icode, sizeof( icode ));
+  ak_bckey_context_encrypt_ecb( &key, in, eref, sizeof( eref ));
+  used = counter - key.key.resource.value.counter;
+  verified = key.key.verify.counter - checks;
+  if( !ak_ptr_is_equal( mask, key.key.mask.data, sizeof( mask ))) error = EXIT_FAILURE;
+  printf("shared key mask: %s\n", error == EXIT_SUCCESS ? "Ok" : "Wrong" );
+
+ /* проверка резервирования */
+  counter = key.key.resource.value.counter;
+  if( ak_skey_context_reserve_resource( &key.key, counter, 1 ) != ak_error_low_key_resource )
+    error = EXIT_FAILURE;
+  if( ak_skey_context_reserve_resource( &key.key, 10, 0 ) != ak_error_ok ) error = EXIT_FAILURE;
+  ak_skey_context_commit_resource( &key.key, 10, 4 );
+  if( key.key.resource.value.counter != counter - 4 ) error = EXIT_FAILURE;
+  ak_skey_context_commit_resource( &key.key, 4, 0 );
+  printf("reserve and commit: %s\n", error == EXIT_SUCCESS ? "Ok" : "Wrong" );
+
+ /* одновременное зашифрование */
+  counter = key.key.resource.value.counter;
+  checks = key.key.verify.counter;
+  for( i = 0; i < threads_count; i++ ) results[i] = EXIT_FAILURE;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  for( i = 0; i < threads_count; i++ )
+     pthread_create( threads+i, NULL, thread_mgm, results+i );
+  for( i = 0; i < threads_count; i++ ) pthread_join( threads[i], NULL );
+#else
+  for( i = 0; i < threads_count; i++ ) thread_mgm( results+i );
+#endif
+  for( i = 0; i < threads_count; i++ ) if( results[i] != EXIT_SUCCESS ) error = EXIT_FAILURE;
+
+  expected = counter - ( ssize_t )( threads_count*calls_count )*used;
+  printf("resource: %lld (expected %lld)\n",
+                       (long long) key.key.resource.value.counter, (long long) expected );
+  if( key.key.resource.value.counter != expected ) error = EXIT_FAILURE;
+  printf("icode checks: %lld (expected %lld)\n", (long long)( key.key.verify.counter - checks ),
+                                           (long long)( threads_count*calls_count )*verified );
+  if( key.key.verify.counter - checks != ( threads_count*calls_count )*verified )
+    error = EXIT_FAILURE;
+  if( !ak_ptr_is_equal( mask, key.key.mask.data, sizeof( mask ))) error = EXIT_FAILURE;
+
+ /* при ошибке в синхропосылке резерв возвращается */
+  counter = key.key.resource.value.counter;
+  ak_bckey_context_ctr( &key, in, reference, sizeof( in ), iv, 2 );
+  if( key.key.resource.value.counter != counter ) error = EXIT_FAILURE;
+
+  printf("shared key: %s\n", error == EXIT_SUCCESS ? "Ok" : "Wrong" );
+  ak_bckey_context_destroy( &key );
+  ak_libakrypt_destroy();
+ return error;
+}
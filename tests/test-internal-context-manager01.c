@@ -0,0 +1,187 @@
+/* Тестовый пример, иллюстрирующий работу структуры управления контекстами:
+   добавление и удаление контекстов, обнаружение устаревших дескрипторов,
+   увеличение объема памяти и одновременную работу нескольких потоков.
+   Пример использует неэкспортируемые функции.
+
+   test-internal-context-manager01.c
+*/
+
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <ak_tools.h>
+ #include <ak_context_manager.h>
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+
+ #define handles_count  (1000)
+ #define threads_count     (4)
+
+/* проверка добавления, удаления и повторного использования ячеек */
+ int test_stale( void )
+{
+  oid_engines_t engine;
+  int exitcode = EXIT_SUCCESS;
+  ak_handle one = ak_error_wrong_handle, two = ak_error_wrong_handle;
+
+  if(( one = ak_mac_new_streebog256( "first" )) == ak_error_wrong_handle ) return EXIT_FAILURE;
+  if( ak_handle_get_context( one, &engine ) == NULL ) exitcode = EXIT_FAILURE;
+  if( engine != mac_function ) exitcode = EXIT_FAILURE;
+  if( ak_handle_delete( one ) != ak_error_ok ) exitcode = EXIT_FAILURE;
+
+ /* ячейка используется повторно, но дескриптор отличается */
+  if(( two = ak_mac_new_streebog256( "second" )) == ak_error_wrong_handle ) return EXIT_FAILURE;
+  printf("first handle: %016llx, second handle: %016llx\n",
+                                             (unsigned long long) one, (unsigned long long) two );
+  if( one == two ) exitcode = EXIT_FAILURE;
+  if(( one&0xffffffff ) != ( two&0xffffffff )) exitcode = EXIT_FAILURE;
+
+ /* устаревший дескриптор не должен предоставлять доступ к новому контексту */
+  if( ak_handle_get_context( one, &engine ) != NULL ) exitcode = EXIT_FAILURE;
+  if( ak_handle_delete( one ) == ak_error_ok ) exitcode = EXIT_FAILURE;
+  if( ak_handle_get_context( two, &engine ) == NULL ) exitcode = EXIT_FAILURE;
+  if( ak_handle_delete( two ) != ak_error_ok ) exitcode = EXIT_FAILURE;
+
+  printf("stale handles: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+ return exitcode;
+}
+
+/* проверка увеличения объема памяти */
+ int test_grow( void )
+{
+  size_t i = 0;
+  oid_engines_t engine;
+  int exitcode = EXIT_SUCCESS;
+  ak_handle handles[handles_count];
+  ak_context_manager manager = ak_libakrypt_get_context_manager();
+
+  for( i = 0; i < handles_count; i++ )
+     if(( handles[i] = ak_mac_new_streebog256( NULL )) == ak_error_wrong_handle )
+       exitcode = EXIT_FAILURE;
+  printf("segments: %u, nodes: %u\n", (unsigned int) manager->count,
+                                                                  (unsigned int) manager->size );
+  if( manager->size < handles_count ) exitcode = EXIT_FAILURE;
+
+ /* все контексты остаются доступными после добавления новых сегментов */
+  for( i = 0; i < handles_count; i++ )
+     if( ak_handle_get_context( handles[i], &engine ) == NULL ) exitcode = EXIT_FAILURE;
+  for( i = 0; i < handles_count; i++ )
+     if( ak_handle_delete( handles[i] ) != ak_error_ok ) exitcode = EXIT_FAILURE;
+
+  printf("growing: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+ return exitcode;
+}
+
+/* функция потока: многократно создает и удаляет контексты */
+ void *thread_handles( void *arg )
+{
+  size_t i = 0, j = 0;
+  oid_engines_t engine;
+  long result = EXIT_SUCCESS;
+  ak_handle handles[64];
+
+  for( i = 0; i < 200; i++ ) {
+     for( j = 0; j < 64; j++ )
+        if(( handles[j] = ak_mac_new_streebog256( NULL )) == ak_error_wrong_handle )
+          result = EXIT_FAILURE;
+     for( j = 0; j < 64; j++ ) {
+        if( ak_handle_get_context( handles[j], &engine ) == NULL ) result = EXIT_FAILURE;
+        if( ak_handle_delete( handles[j] ) != ak_error_ok ) result = EXIT_FAILURE;
+     }
+  }
+  *(long *)arg = result;
+ return NULL;
+}
+
+/* проверка одновременной работы нескольких потоков */
+ int test_threads( void )
+{
+  size_t i = 0;
+  clock_t tmr;
+  int exitcode = EXIT_SUCCESS;
+  long results[threads_count];
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_t threads[threads_count];
+#endif
+
+  for( i = 0; i < threads_count; i++ ) results[i] = EXIT_FAILURE;
+  tmr = clock();
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  for( i = 0; i < threads_count; i++ )
+     pthread_create( threads+i, NULL, thread_handles, results+i );
+  for( i = 0; i < threads_count; i++ ) pthread_join( threads[i], NULL );
+#else
+  for( i = 0; i < threads_count; i++ ) thread_handles( results+i );
+#endif
+  tmr = clock() - tmr;
+  for( i = 0; i < threads_count; i++ ) if( results[i] != EXIT_SUCCESS ) exitcode = EXIT_FAILURE;
+
+  printf("concurrent handles: %s (%.3fs)\n",
+          exitcode == EXIT_SUCCESS ? "Ok" : "Wrong", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+ return exitcode;
+}
+
+/* функция потока: обращается к контекстам до тех пор, пока они не будут удалены */
+ void *thread_readers( void *arg )
+{
+  size_t j = 0;
+  oid_engines_t engine;
+  ak_handle *handles = ( ak_handle * )arg;
+
+  for( j = 0; j < 64; j++ )
+     while( ak_handle_get_context( handles[j], &engine ) != NULL );
+ return NULL;
+}
+
+/* проверка освобождения памяти при одновременном поиске и удалении контекстов */
+ int test_reclaim( void )
+{
+  size_t i = 0;
+  int exitcode = EXIT_SUCCESS;
+  ak_handle handles[64], handle = ak_error_wrong_handle;
+  ak_context_manager manager = ak_libakrypt_get_context_manager();
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_t threads[threads_count];
+#endif
+
+  for( i = 0; i < 64; i++ )
+     if(( handles[i] = ak_mac_new_streebog256( NULL )) == ak_error_wrong_handle )
+       return EXIT_FAILURE;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  for( i = 0; i < threads_count; i++ )
+     pthread_create( threads+i, NULL, thread_readers, handles );
+#endif
+  for( i = 0; i < 64; i++ )
+     if( ak_handle_delete( handles[i] ) != ak_error_ok ) exitcode = EXIT_FAILURE;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  for( i = 0; i < threads_count; i++ ) pthread_join( threads[i], NULL );
+#endif
+
+  for( i = 0; i < ak_context_manager_reader_stripes; i++ )
+     if( manager->readers[i].count != 0 ) exitcode = EXIT_FAILURE;
+
+ /* поиск контекстов не освобождает удаленные элементы, это выполняется
+    при следующем добавлении контекста, когда читающих потоков уже нет */
+  if(( handle = ak_mac_new_streebog256( NULL )) == ak_error_wrong_handle ) return EXIT_FAILURE;
+  if( manager->retired != NULL ) exitcode = EXIT_FAILURE;
+  if( ak_handle_delete( handle ) != ak_error_ok ) exitcode = EXIT_FAILURE;
+  if( manager->retired != NULL ) exitcode = EXIT_FAILURE;
+
+  printf("reclaiming of deleted nodes: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+ return exitcode;
+}
+
+ int main( void )
+{
+  int error = EXIT_SUCCESS;
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+
+  if(( error = test_stale( )) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_grow( )) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_threads( )) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_reclaim( )) != EXIT_SUCCESS ) goto exitlab;
+
+  exitlab: ak_libakrypt_destroy();
+ return error;
+}
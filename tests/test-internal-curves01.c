@@ -0,0 +1,128 @@
+/* Пример, иллюстрирующий согласованность вычисления кратных точек с помощью лесенки Монтгомери
+   (для кривых длины 256 бит используются точки вдвое меньшего размера), с помощью
+   последовательных удвоений и сложений точек, а также, для образующей точки,
+   с помощью метода гребенки.
+
+   Внимание! Используются не экспортируемые функции.
+
+   test-internal-curves01.c
+*/
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <time.h>
+ #include <ak_curves.h>
+ #include <ak_oid.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+/* вычисляем кратную точку методом "удвоения и сложения" */
+ void double_and_add( ak_wpoint wq, ak_wpoint wp, ak_uint64 *k, ak_wcurve wc )
+{
+  long long int i;
+
+  ak_wpoint_set_as_unit( wq, wc );
+  for( i = 64*wc->size-1; i >= 0; i-- ) {
+     ak_wpoint_double( wq, wc );
+     if(( k[i>>6] >> ( i&0x3F ))&1 ) ak_wpoint_add( wq, wp, wc );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ size_t wpoint_pow_compare( ak_wcurve wc, ak_random generator, size_t count )
+{
+  size_t i = 0, val = 0;
+  ak_mpzn512 k;
+  struct wpoint wp, wq1, wq2, wq3;
+  clock_t tmr;
+
+ /* порядок образующей точки; метод гребенки должен давать бесконечно удаленную точку
+    для k = q и точку -P для k = q-1 */
+  ak_wpoint_pow( &wq1, &wc->point, wc->q, wc->size, wc );
+  ak_wpoint_pow_base( &wq3, wc->q, wc->size, wc );
+  ak_mpzn_set_ui( k, wc->size, 1 );
+  ak_mpzn_sub( k, wc->q, k, wc->size );
+  ak_wpoint_pow_base( &wq2, k, wc->size, wc );
+  ak_wpoint_reduce( &wq2, wc );
+  ak_wpoint_set( &wp, wc );
+  ak_wpoint_reduce( &wp, wc );
+  ak_mpzn_add( wq2.y, wq2.y, wp.y, wc->size );
+  if( ak_mpzn_cmp_ui( wq1.z, wc->size, 0 ) && ak_mpzn_cmp_ui( wq3.z, wc->size, 0 ) &&
+     ( ak_mpzn_cmp( wq2.x, wp.x, wc->size ) == 0 ) && ( ak_mpzn_cmp( wq2.y, wc->p, wc->size ) == 0 ))
+    val++;
+
+ /* случайные кратные точки */
+  ak_wpoint_set( &wp, wc );
+  tmr = clock();
+  for( i = 1; i < count; i++ ) {
+     bool_t base = ak_true;
+
+     ak_mpzn_set_random_modulo( k, wc->q, wc->size, generator );
+
+    /* для образующей точки сравниваем лесенку Монтгомери с методом гребенки */
+     if( i%4 == 1 ) {
+       ak_wpoint_pow( &wq1, &wc->point, k, wc->size, wc );
+       ak_wpoint_pow_base( &wq3, k, wc->size, wc );
+       ak_wpoint_reduce( &wq1, wc );
+       ak_wpoint_reduce( &wq3, wc );
+       if(( ak_mpzn_cmp( wq1.x, wq3.x, wc->size ) != 0 ) ||
+          ( ak_mpzn_cmp( wq1.y, wq3.y, wc->size ) != 0 )) base = ak_false;
+     }
+
+     ak_wpoint_pow( &wq1, &wp, k, wc->size, wc );
+     double_and_add( &wq2, &wp, k, wc );
+     ak_wpoint_reduce( &wq1, wc );
+     ak_wpoint_reduce( &wq2, wc );
+     if( base && ( ak_mpzn_cmp( wq1.x, wq2.x, wc->size ) == 0 ) &&
+        ( ak_mpzn_cmp( wq1.y, wq2.y, wc->size ) == 0 ) && ak_wpoint_is_ok( &wq1, wc )) val++;
+    /* следующая точка зависит от предыдущей */
+     ak_wpoint_set_wpoint( &wp, &wq1, wc );
+  }
+  tmr = clock() - tmr;
+  printf(" correct points %u from %u (time: %.3fs)\n",
+                      (unsigned int)val, (unsigned int)count, ((double) tmr) / ((double) CLOCKS_PER_SEC));
+ return val;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  ak_oid oid = NULL;
+  size_t count = 32;
+  struct random generator;
+  int totalmany = 0, howmany = 0;
+
+  if( ak_libakrypt_create( NULL ) != ak_true ) return ak_libakrypt_destroy();
+  ak_random_context_create_lcg( &generator );
+
+  oid = ak_oid_context_find_by_engine( identifier );
+  while( oid != NULL ) {
+    if( oid->mode == wcurve_params ) {
+      ak_wcurve wc = ( ak_wcurve ) oid->data;
+      printf("%s (%u bits)\n", oid->name, (unsigned int)( 64*wc->size ));
+
+     /* для кривых длины 256 бит проверяем преобразование параметров */
+      if( wc->size == ak_mpzn256_size ) {
+        struct wpoint256 wp256;
+        struct wpoint wp;
+
+        totalmany++;
+        ak_wpoint256_set_wpoint( &wp256, &wc->point, wc );
+        ak_wpoint256_pow( &wp256, &wp256, wc->q, ak_mpzn256_size, wc );
+        ak_wpoint_set_wpoint256( &wp, &wp256, wc );
+        if( ak_mpzn_cmp_ui( wp.z, wc->size, 0 )) howmany++;
+          else printf(" wrong order of base point for 256 bit structures\n");
+      }
+
+      totalmany++;
+      if( wpoint_pow_compare( wc, &generator, count ) == count ) howmany++;
+    }
+    oid = ak_oid_context_findnext_by_engine( oid, identifier );
+  }
+  ak_random_context_destroy( &generator );
+
+  printf("\n total tests: %d (passed: %d)\n", totalmany, howmany );
+  ak_libakrypt_destroy();
+
+ if( totalmany != howmany ) return EXIT_FAILURE;
+ return EXIT_SUCCESS;
+}
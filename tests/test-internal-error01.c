@@ -0,0 +1,127 @@
+/* Тестовый пример, иллюстрирующий независимость кодов ошибок и сообщений об ошибках
+   различных потоков выполнения программы.
+   Пример использует неэкспортируемые функции.
+
+   test-internal-error01.c
+*/
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_tools.h>
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+
+ #define threads_count  (4)
+
+/* функция аудита, не выводящая сообщений */
+ int silent( const char *message )
+{
+  (void) message;
+ return ak_error_ok;
+}
+
+/* проверка кольцевого буфера сообщений текущего потока */
+ int test_ring( void )
+{
+  int i = 0;
+  char string[64];
+  const char *message = NULL;
+  int exitcode = EXIT_SUCCESS;
+
+  ak_error_clear_messages();
+  if( ak_error_get_messages_count() != 0 ) exitcode = EXIT_FAILURE;
+  if( ak_error_get_message( 0 ) != NULL ) exitcode = EXIT_FAILURE;
+
+ /* сообщения с неотрицательным кодом в буфер не помещаются */
+  ak_error_message( ak_error_ok, __func__, "informational message" );
+  if( ak_error_get_messages_count() != 0 ) exitcode = EXIT_FAILURE;
+
+ /* помещаем в буфер больше сообщений, чем он может хранить */
+  for( i = 1; i <= 20; i++ ) {
+     ak_snprintf( string, sizeof( string ), "message number %d", i );
+     ak_error_message( -i, __func__, string );
+  }
+  printf("stored messages: %u\n", (unsigned int) ak_error_get_messages_count( ));
+  for( i = 0; i < (int) ak_error_get_messages_count(); i++ )
+     printf(" %d: %s\n", i, ak_error_get_message( i ));
+
+  if( ak_error_get_value() != -20 ) exitcode = EXIT_FAILURE;
+  if(( message = ak_error_get_message( 0 )) == NULL ) exitcode = EXIT_FAILURE;
+   else if( strstr( message, "message number 20 (code: -20)" ) == NULL ) exitcode = EXIT_FAILURE;
+  if(( message = ak_error_get_message( 1 )) == NULL ) exitcode = EXIT_FAILURE;
+   else if( strstr( message, "message number 19 " ) == NULL ) exitcode = EXIT_FAILURE;
+  if( ak_error_get_message( ak_error_get_messages_count( )) != NULL ) exitcode = EXIT_FAILURE;
+
+  ak_error_clear_messages();
+  if( ak_error_get_messages_count() != 0 ) exitcode = EXIT_FAILURE;
+  if( ak_error_get_value() != ak_error_ok ) exitcode = EXIT_FAILURE;
+
+  printf("error ring: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+ return exitcode;
+}
+
+/* функция потока: многократно устанавливает собственный код ошибки и проверяет его */
+ void *thread_errors( void *arg )
+{
+  size_t i = 0;
+  long result = EXIT_SUCCESS;
+  int code = -100 - (int)(*(long *)arg);
+
+  for( i = 0; i < 100000; i++ ) {
+     ak_error_set_value( code );
+     if( ak_error_get_value() != code ) result = EXIT_FAILURE;
+     ak_error_set_value( ak_error_ok );
+     if( ak_error_get_value() != ak_error_ok ) result = EXIT_FAILURE;
+  }
+  ak_error_message( code, __func__, "thread message" );
+  if( ak_error_get_value() != code ) result = EXIT_FAILURE;
+  if( ak_error_get_messages_count() != 1 ) result = EXIT_FAILURE;
+
+  *(long *)arg = result;
+ return NULL;
+}
+
+/* проверка независимости кодов ошибок различных потоков */
+ int test_threads( void )
+{
+  size_t i = 0;
+  int exitcode = EXIT_SUCCESS;
+  long results[threads_count];
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_t threads[threads_count];
+#endif
+
+  ak_error_clear_messages();
+  ak_error_set_value( ak_error_wrong_length );
+  for( i = 0; i < threads_count; i++ ) results[i] = ( long )i;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  for( i = 0; i < threads_count; i++ )
+     pthread_create( threads+i, NULL, thread_errors, results+i );
+  for( i = 0; i < threads_count; i++ ) pthread_join( threads[i], NULL );
+  for( i = 0; i < threads_count; i++ ) if( results[i] != EXIT_SUCCESS ) exitcode = EXIT_FAILURE;
+
+ /* ошибки других потоков не изменяют состояние текущего потока */
+  if( ak_error_get_value() != ak_error_wrong_length ) exitcode = EXIT_FAILURE;
+  if( ak_error_get_messages_count() != 0 ) exitcode = EXIT_FAILURE;
+#endif
+
+  printf("thread local errors: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+ return exitcode;
+}
+
+ int main( void )
+{
+  int error = EXIT_SUCCESS;
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+
+ /* сообщения об ошибках, формируемые примером, в журнал не выводятся */
+  ak_log_set_function( silent );
+
+  if(( error = test_ring( )) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_threads( )) != EXIT_SUCCESS ) goto exitlab;
+
+  exitlab: ak_libakrypt_destroy();
+ return error;
+}
@@ -0,0 +1,132 @@
+/* Тестовый пример, иллюстрирующий асинхронный вывод сообщений аудита:
+   сообщения нескольких потоков помещаются в кольцевые буферы и выводятся отдельным потоком.
+   Проверяется также, что в дочернем процессе асинхронный вывод выключается, а
+   кольцевые буферы освобождаются при завершении работы с библиотекой.
+   Пример использует неэкспортируемые функции.
+
+   test-internal-log01.c
+*/
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_tools.h>
+#ifdef LIBAKRYPT_HAVE_UNISTD_H
+ #include <unistd.h>
+ #include <sys/wait.h>
+#endif
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+
+ #define threads_count     (4)
+ #define messages_count (1000)
+
+/* количество полученных сообщений и номер последнего сообщения каждого потока
+   (функция аудита вызывается библиотекой последовательно) */
+ static size_t received = 0;
+ static int last[threads_count];
+ static int ordered = 1;
+
+/* функция аудита, подсчитывающая полученные сообщения */
+ int log_counter( const char *message )
+{
+  int thread = 0, number = 0;
+  const char *ptr = NULL;
+
+  if(( ptr = strstr( message, "thread " )) == NULL ) return ak_error_ok;
+  if( sscanf( ptr, "thread %d message %d", &thread, &number ) != 2 ) return ak_error_ok;
+  if(( thread < 0 ) || ( thread >= threads_count )) return ak_error_ok;
+  if( number <= last[thread] ) ordered = 0;
+  last[thread] = number;
+  received++;
+ return ak_error_ok;
+}
+
+/* функция потока: формирует серию сообщений */
+ void *thread_messages( void *arg )
+{
+  int i = 0;
+  char string[64];
+
+  for( i = 0; i < messages_count; i++ ) {
+     ak_snprintf( string, sizeof( string ), "thread %d message %d", (int)(*(long *)arg), i );
+     ak_error_message( ak_error_ok, __func__, string );
+  }
+ return NULL;
+}
+
+ int main( void )
+{
+  size_t i = 0;
+  ak_uint64 dropped = 0;
+  int error = EXIT_SUCCESS;
+#ifdef LIBAKRYPT_HAVE_UNISTD_H
+  pid_t pid = 0;
+  int status = 0;
+#endif
+  long numbers[threads_count];
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_t threads[threads_count];
+#endif
+
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+  ak_log_set_function( log_counter );
+  for( i = 0; i < threads_count; i++ ) { last[i] = -1; numbers[i] = ( long )i; }
+
+  if( ak_log_set_async( ak_true ) != ak_error_ok ) {
+    printf("asynchronous log output is not supported\n");
+    return ak_libakrypt_destroy();
+  }
+
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  for( i = 0; i < threads_count; i++ )
+     pthread_create( threads+i, NULL, thread_messages, numbers+i );
+  for( i = 0; i < threads_count; i++ ) pthread_join( threads[i], NULL );
+#endif
+
+ /* все сообщения должны быть либо выведены, либо учтены как отброшенные */
+  ak_log_flush();
+  dropped = ak_log_get_dropped();
+  printf("received: %u, dropped: %u\n", (unsigned int) received, (unsigned int) dropped );
+  if( received + dropped != threads_count*messages_count ) error = EXIT_FAILURE;
+  if( !ordered ) {
+    printf("wrong order of messages\n");
+    error = EXIT_FAILURE;
+  }
+
+ /* после выключения асинхронного вывода сообщения выводятся сразу */
+  ak_log_set_async( ak_false );
+  numbers[0] = 0;
+  last[0] = -1;
+  received = 0;
+  thread_messages( numbers );
+  if( received != messages_count ) error = EXIT_FAILURE;
+
+#ifdef LIBAKRYPT_HAVE_UNISTD_H
+ /* в дочернем процессе поток вывода отсутствует, поэтому сообщения выводятся сразу,
+    а завершение работы с библиотекой не ожидает потока родительского процесса */
+  ak_log_set_async( ak_true );
+  if(( pid = fork()) == -1 ) error = EXIT_FAILURE;
+  if( pid == 0 ) {
+    last[0] = -1;
+    received = 0;
+    thread_messages( numbers );
+    ak_libakrypt_destroy();
+    _exit( received == messages_count ? EXIT_SUCCESS : EXIT_FAILURE );
+  }
+  if( pid > 0 ) {
+    waitpid( pid, &status, 0 );
+    if( !WIFEXITED( status ) || ( WEXITSTATUS( status ) != EXIT_SUCCESS )) error = EXIT_FAILURE;
+    printf("log output in child process: %s\n",
+                   WIFEXITED( status ) && WEXITSTATUS( status ) == EXIT_SUCCESS ? "Ok" : "Wrong" );
+  }
+#endif
+
+  printf("asynchronous log output: %s\n", error == EXIT_SUCCESS ? "Ok" : "Wrong" );
+  ak_libakrypt_destroy();
+
+ /* после завершения работы с библиотекой кольцевые буферы освобождены */
+  if( ak_log_get_dropped() != 0 ) error = EXIT_FAILURE;
+ return error;
+}
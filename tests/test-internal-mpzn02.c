@@ -0,0 +1,106 @@
+/* Пример, иллюстрирующий согласованность развернутых вариантов умножения Монтгомери
+   и умножения по псевдомерсенновым модулям с универсальной функцией ak_mpzn_mul_montgomery()
+   для всех параметров эллиптических кривых.
+
+   Внимание! Используются не экспортируемые функции.
+
+   test-internal-mpzn02.c
+*/
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <time.h>
+ #include <ak_curves.h>
+ #include <ak_oid.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+/* сравниваем результаты умножения по модулю p для функции, определенной в кривой, и универсальной;
+   если задан вычет r2, то результат универсальной функции домножается на него
+   (это позволяет перейти от представления Монтгомери к обычному представлению)                    */
+ size_t mul_montgomery_compare( ak_wcurve wc, ak_function_mpzn_mul_montgomery *mul,
+             ak_uint64 *p, ak_uint64 n0, ak_uint64 *r2, ak_random generator, size_t count )
+{
+  size_t i = 0, val = 0;
+  ak_mpzn512 x, y, z1, z2;
+  clock_t tmr;
+
+ /* граничные значения: p-1 */
+  ak_mpzn_set_ui( y, wc->size, 1 );
+  ak_mpzn_sub( x, p, y, wc->size );
+  ak_mpzn_mul_montgomery( z1, x, x, p, n0, wc->size );
+  if( r2 != NULL ) ak_mpzn_mul_montgomery( z1, z1, r2, p, n0, wc->size );
+  mul( z2, x, x, p, n0, wc->size );
+  if( ak_mpzn_cmp( z1, z2, wc->size ) == 0 ) val++;
+
+ /* случайные значения */
+  for( i = 1; i < count; i++ ) {
+     ak_mpzn_set_random_modulo( x, p, wc->size, generator );
+     ak_mpzn_set_random_modulo( y, p, wc->size, generator );
+     ak_mpzn_mul_montgomery( z1, x, y, p, n0, wc->size );
+     if( r2 != NULL ) ak_mpzn_mul_montgomery( z1, z1, r2, p, n0, wc->size );
+     mul( z2, x, y, p, n0, wc->size );
+     if( ak_mpzn_cmp( z1, z2, wc->size ) == 0 ) val++;
+  }
+  printf(" correct multiplications %u from %u\n", (unsigned int)val, (unsigned int)count );
+
+ /* сравниваем время вычислений */
+  tmr = clock();
+  for( i = 0; i < count; i++ ) ak_mpzn_mul_montgomery( x, x, y, p, n0, wc->size );
+  tmr = clock() - tmr;
+  printf(" generic time:   %.3fs\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  tmr = clock();
+  for( i = 0; i < count; i++ ) mul( z1, z1, y, p, n0, wc->size );
+  tmr = clock() - tmr;
+  printf(" optimized time: %.3fs\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+ return val;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  char *str = NULL;
+  ak_oid oid = NULL;
+  size_t count = 100000;
+  struct random generator;
+  int totalmany = 0, howmany = 0;
+
+  if( ak_libakrypt_create( NULL ) != ak_true ) return ak_libakrypt_destroy();
+  ak_random_context_create_lcg( &generator );
+
+ /* организуем цикл по перебору всех известных эллиптических кривых */
+  oid = ak_oid_context_find_by_engine( identifier );
+  while( oid != NULL ) {
+    if( oid->mode == wcurve_params ) {
+      ak_wcurve wc = ( ak_wcurve ) oid->data;
+      ak_uint64 *r2 = NULL;
+      ak_mpzn512 c2;
+
+     /* для модуля p = 2^n - c выполнено r^2 = c^2 (mod p) */
+      if( wc->reduction == pseudo_mersenne_reduction ) {
+        ak_uint64 c = ( ak_uint64 )0 - wc->p[0];
+        ak_mpzn_set_ui( r2 = c2, wc->size, c*c );
+      }
+      printf("%s\n - p: %s%s\n", oid->name, str = ak_mpzn_to_hexstr( wc->p, wc->size ),
+                             wc->reduction == pseudo_mersenne_reduction ? " (pseudo mersenne)" : "" );
+      free( str );
+      totalmany++;
+      if( mul_montgomery_compare( wc, wc->mul,
+                                       wc->p, wc->n, r2, &generator, count ) == count ) howmany++;
+
+      printf(" - q: %s\n", str = ak_mpzn_to_hexstr( wc->q, wc->size ));
+      free( str );
+      totalmany++;
+      if( mul_montgomery_compare( wc, wc->mulq,
+                                   wc->q, wc->nq, NULL, &generator, count ) == count ) howmany++;
+    }
+    oid = ak_oid_context_findnext_by_engine( oid, identifier );
+  }
+  ak_random_context_destroy( &generator );
+
+  printf("\n total modular multiplication tests: %d (passed: %d)\n", totalmany, howmany );
+  ak_libakrypt_destroy();
+
+ if( totalmany != howmany ) return EXIT_FAILURE;
+ return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+/* Пример, иллюстрирующий согласованность функций вычисления обратных вычетов
+   ak_mpzn_inverse_safegcd() и ak_mpzn_inverse_binary() с возведением в степень p-2
+   для модулей всех параметров эллиптических кривых.
+
+   Внимание! Используются не экспортируемые функции.
+
+   test-internal-mpzn03.c
+*/
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <time.h>
+ #include <ak_curves.h>
+ #include <ak_oid.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+/* сравниваем обратные вычеты по модулю p, вычисленные тремя способами */
+ size_t inverse_compare( ak_uint64 *p, ak_uint64 n0, ak_uint64 *r2,
+                                        const size_t size, ak_random generator, size_t count )
+{
+  size_t i = 0, val = 0;
+  ak_mpzn512 x, k, z1, z2, z3;
+  clock_t tmr;
+
+  ak_mpzn_set_ui( k, size, 2 );
+  ak_mpzn_sub( k, p, k, size );
+  for( i = 0; i < count; i++ ) {
+    /* граничные значения: 1 и p-1, далее случайные значения */
+     if( i == 0 ) ak_mpzn_set_ui( x, size, 1 );
+       else if( i == 1 ) { ak_mpzn_set_ui( x, size, 1 ); ak_mpzn_sub( x, p, x, size ); }
+         else ak_mpzn_set_random_modulo( x, p, size, generator );
+     if( ak_mpzn_cmp_ui( x, size, 0 )) ak_mpzn_set_ui( x, size, 1 );
+
+    /* x^{p-2} в представлении Монтгомери, затем переводим в обычное представление */
+     ak_mpzn_mul_montgomery( z1, x, r2, p, n0, size );
+     ak_mpzn_modpow_montgomery( z1, z1, k, p, n0, size );
+     ak_mpzn_set_ui( z2, size, 1 );
+     ak_mpzn_mul_montgomery( z1, z1, z2, p, n0, size );
+
+     ak_mpzn_inverse_safegcd( z2, x, p, size );
+     ak_mpzn_inverse_binary( z3, x, p, size );
+     if(( ak_mpzn_cmp( z1, z2, size ) == 0 ) && ( ak_mpzn_cmp( z1, z3, size ) == 0 )) val++;
+  }
+  printf(" correct inversions %u from %u\n", (unsigned int)val, (unsigned int)count );
+
+ /* сравниваем время вычислений */
+  tmr = clock();
+  for( i = 0; i < count; i++ ) ak_mpzn_modpow_montgomery( z1, x, k, p, n0, size );
+  tmr = clock() - tmr;
+  printf(" modpow time:  %.3fs\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  tmr = clock();
+  for( i = 0; i < count; i++ ) ak_mpzn_inverse_safegcd( z2, x, p, size );
+  tmr = clock() - tmr;
+  printf(" safegcd time: %.3fs\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  tmr = clock();
+  for( i = 0; i < count; i++ ) ak_mpzn_inverse_binary( z3, x, p, size );
+  tmr = clock() - tmr;
+  printf(" binary time:  %.3fs\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+ return val;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  char *str = NULL;
+  ak_oid oid = NULL;
+  size_t count = 5000;
+  struct random generator;
+  int totalmany = 0, howmany = 0;
+  ak_mpzn512 zero = ak_mpzn512_zero;
+
+  if( ak_libakrypt_create( NULL ) != ak_true ) return ak_libakrypt_destroy();
+  ak_random_context_create_lcg( &generator );
+
+ /* организуем цикл по перебору всех известных эллиптических кривых */
+  oid = ak_oid_context_find_by_engine( identifier );
+  while( oid != NULL ) {
+    if( oid->mode == wcurve_params ) {
+      ak_wcurve wc = ( ak_wcurve ) oid->data;
+      ak_mpzn512 r2;
+
+     /* для псевдомерсенновых модулей в кривой хранится единица, поэтому вычисляем r^2 = c^2 */
+      if( wc->reduction == pseudo_mersenne_reduction ) {
+        ak_uint64 c = ( ak_uint64 )0 - wc->p[0];
+        ak_mpzn_set_ui( r2, wc->size, c*c );
+      } else ak_mpzn_set( r2, wc->r2, wc->size );
+
+      printf("%s\n - p: %s\n", oid->name, str = ak_mpzn_to_hexstr( wc->p, wc->size ));
+      free( str );
+      totalmany++;
+      if( inverse_compare( wc->p, wc->n, r2, wc->size, &generator, count ) == count ) howmany++;
+
+      printf(" - q: %s\n", str = ak_mpzn_to_hexstr( wc->q, wc->size ));
+      free( str );
+      totalmany++;
+      if( inverse_compare( wc->q, wc->nq, wc->r2q, wc->size, &generator, count ) == count ) howmany++;
+
+     /* ноль не имеет обратного элемента */
+      totalmany++;
+      if(( ak_mpzn_inverse_safegcd( r2, zero, wc->p, wc->size ) != ak_error_ok ) &&
+         ( ak_mpzn_inverse_binary( r2, zero, wc->p, wc->size ) != ak_error_ok )) howmany++;
+    }
+    oid = ak_oid_context_findnext_by_engine( oid, identifier );
+  }
+  ak_random_context_destroy( &generator );
+
+  printf("\n total inversion tests: %d (passed: %d)\n", totalmany, howmany );
+  ak_libakrypt_destroy();
+
+ if( totalmany != howmany ) return EXIT_FAILURE;
+ return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+/* Пример, иллюстрирующий согласованность приведения вычетов двойной длины по алгоритму Барретта
+   с умножением Монтгомери для модулей p и q всех параметров эллиптических кривых.
+
+   Внимание! Используются не экспортируемые функции.
+
+   test-internal-mpzn04.c
+*/
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <time.h>
+ #include <ak_curves.h>
+ #include <ak_oid.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+/* сравниваем результат приведения произведения xy функцией ak_mpzn_rem_barrett() с результатом
+   умножения Монтгомери, домноженным на вычет r2 (т.е. переведенным в обычное представление)      */
+ size_t barrett_compare( ak_wcurve wc, ak_uint64 *m, ak_uint64 n0, ak_uint64 *mu,
+                                               ak_uint64 *r2, ak_random generator, size_t count )
+{
+  size_t i = 0, val = 0;
+  ak_mpzn512 x, y, z1, z2;
+  ak_mpznmax u;
+  clock_t tmr;
+
+ /* граничное значение: u = 2^{128*size} - 1, тогда u \equiv r^2 - 1 (mod m) */
+  memset( u, 0xff, sizeof( ak_uint64 )*2*wc->size );
+  ak_mpzn_rem_barrett( z1, u, m, mu, wc->size );
+  ak_mpzn_set_ui( x, wc->size, 1 );
+  ak_mpzn_sub( z2, r2, x, wc->size );
+  if( ak_mpzn_cmp( z1, z2, wc->size ) == 0 ) val++;
+
+ /* случайные значения */
+  for( i = 1; i < count; i++ ) {
+     ak_mpzn_set_random_modulo( x, m, wc->size, generator );
+     ak_mpzn_set_random_modulo( y, m, wc->size, generator );
+     ak_mpzn_mul( u, x, y, wc->size );
+     ak_mpzn_rem_barrett( z1, u, m, mu, wc->size );
+     ak_mpzn_mul_montgomery( z2, x, y, m, n0, wc->size );
+     ak_mpzn_mul_montgomery( z2, z2, r2, m, n0, wc->size );
+     if( ak_mpzn_cmp( z1, z2, wc->size ) == 0 ) val++;
+  }
+  printf(" correct reductions %u from %u\n", (unsigned int)val, (unsigned int)count );
+
+ /* сравниваем время вычислений */
+  tmr = clock();
+  for( i = 0; i < count; i++ ) ak_mpzn_rem_barrett( z1, u, m, mu, wc->size );
+  tmr = clock() - tmr;
+  printf(" barrett time:    %.3fs\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  tmr = clock();
+  for( i = 0; i < count; i++ ) ak_mpzn_mul_montgomery( z2, z2, r2, m, n0, wc->size );
+  tmr = clock() - tmr;
+  printf(" montgomery time: %.3fs\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+ return val;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  char *str = NULL;
+  ak_oid oid = NULL;
+  size_t count = 100000;
+  struct random generator;
+  int totalmany = 0, howmany = 0;
+
+  if( ak_libakrypt_create( NULL ) != ak_true ) return ak_libakrypt_destroy();
+  ak_random_context_create_lcg( &generator );
+
+ /* организуем цикл по перебору всех известных эллиптических кривых */
+  oid = ak_oid_context_find_by_engine( identifier );
+  while( oid != NULL ) {
+    if( oid->mode == wcurve_params ) {
+      ak_wcurve wc = ( ak_wcurve ) oid->data;
+      ak_uint64 *r2 = wc->r2;
+      ak_mpzn512 c2;
+
+     /* для модуля p = 2^n - c выполнено r^2 = c^2 (mod p) */
+      if( wc->reduction == pseudo_mersenne_reduction ) {
+        ak_uint64 c = ( ak_uint64 )0 - wc->p[0];
+        ak_mpzn_set_ui( r2 = c2, wc->size, c*c );
+      }
+      printf("%s\n - p: %s\n", oid->name, str = ak_mpzn_to_hexstr( wc->p, wc->size ));
+      free( str );
+      totalmany++;
+      if( barrett_compare( wc, wc->p, wc->n, wc->mu, r2, &generator, count ) == count ) howmany++;
+
+      printf(" - q: %s\n", str = ak_mpzn_to_hexstr( wc->q, wc->size ));
+      free( str );
+      totalmany++;
+      if( barrett_compare( wc, wc->q, wc->nq, wc->muq,
+                                                  wc->r2q, &generator, count ) == count ) howmany++;
+    }
+    oid = ak_oid_context_findnext_by_engine( oid, identifier );
+  }
+  ak_random_context_destroy( &generator );
+
+  printf("\n total barrett reduction tests: %d (passed: %d)\n", totalmany, howmany );
+  ak_libakrypt_destroy();
+
+ if( totalmany != howmany ) return EXIT_FAILURE;
+ return EXIT_SUCCESS;
+}
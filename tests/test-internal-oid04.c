@@ -0,0 +1,92 @@
+/* Тестовый пример, иллюстрирующий поиск oid по имени, идентификатору и типу
+   криптографического механизма с помощью индекса; результаты поиска сравниваются
+   с результатами последовательного перебора всех oid.
+   Пример использует неэкспортируемые функции.
+
+   test-internal-oid04.c
+*/
+
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_oid.h>
+
+/* последовательный поиск первого oid с заданным именем или идентификатором */
+ ak_oid linear_find( const char *value, const int byname )
+{
+  ak_oid oid = ak_oid_context_find_by_engine( random_generator );
+
+ /* начало массива oid: первый элемент всегда является генератором */
+  while( oid->engine != undefined_engine ) {
+    if( strcmp( byname ? oid->name : oid->id, value ) == 0 ) return oid;
+    oid++;
+  }
+ return NULL;
+}
+
+ int main( void )
+{
+  size_t i = 0;
+  clock_t tmr;
+  ak_oid oid = NULL, next = NULL;
+  oid_engines_t engine;
+  oid_modes_t mode;
+  int exitcode = EXIT_SUCCESS, count = 0, total = 0;
+  char name[128], id[128];
+
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+
+ /* 1. поиск всех oid по имени и идентификатору */
+  for( i = 0; i < ak_libakrypt_oids_count(); i++ ) {
+     ak_libakrypt_get_oid_by_index( i, &engine, &mode, name, sizeof( name ), id, sizeof( id ));
+     if( ak_oid_context_find_by_name( name ) != linear_find( name, 1 )) {
+       printf("wrong search of %s by name\n", name );
+       exitcode = EXIT_FAILURE;
+     }
+     if( ak_oid_context_find_by_id( id ) != linear_find( id, 0 )) {
+       printf("wrong search of %s by id\n", id );
+       exitcode = EXIT_FAILURE;
+     }
+     if(( ak_oid_context_find_by_ni( name ) != linear_find( name, 1 )) ||
+        ( ak_oid_context_find_by_ni( id ) != linear_find( id, 0 ))) {
+       printf("wrong search of %s by name or id\n", name );
+       exitcode = EXIT_FAILURE;
+     }
+  }
+ /* поиск несуществующих значений */
+  if( ak_oid_context_find_by_name( "unknown-name" ) != NULL ) exitcode = EXIT_FAILURE;
+  if( ak_oid_context_find_by_id( "1.2.643.2.52.999" ) != NULL ) exitcode = EXIT_FAILURE;
+  if( ak_oid_context_find_by_ni( "" ) != NULL ) exitcode = EXIT_FAILURE;
+  printf("search by name and id: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+
+ /* 2. перебор oid для каждого типа механизма */
+  for( engine = identifier; engine < undefined_engine; engine++ ) {
+     count = 0;
+     oid = ak_oid_context_find_by_engine( engine );
+     while( oid != NULL ) {
+       if( !ak_oid_context_check( oid ) || ( oid->engine != engine )) exitcode = EXIT_FAILURE;
+      /* проверяем, что между найденными oid нет пропущенных */
+       next = ak_oid_context_findnext_by_engine( oid, engine );
+       while( ++oid != next ) {
+         if( oid->engine == undefined_engine ) break;
+         if( oid->engine == engine ) exitcode = EXIT_FAILURE;
+       }
+       oid = next;
+       count++;
+     }
+     total += count;
+  }
+  printf("enumeration of %d oids: %s\n", total, exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+  if( total != (int) ak_libakrypt_oids_count( )) exitcode = EXIT_FAILURE;
+  if( ak_oid_context_check( NULL )) exitcode = EXIT_FAILURE;
+
+ /* 3. скорость поиска */
+  tmr = clock();
+  for( i = 0; i < 1000000; i++ ) ak_oid_context_find_by_name( "streebog256" );
+  tmr = clock() - tmr;
+  printf("1000000 searches by name: %.3fs\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  ak_libakrypt_destroy();
+ return exitcode;
+}
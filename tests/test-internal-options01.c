@@ -0,0 +1,131 @@
+/* Тестовый пример, иллюстрирующий доступ к опциям библиотеки по индексу и по имени,
+   а также повторное считывание опций из файла libakrypt.conf без перезапуска программы.
+   Пример использует неэкспортируемые функции.
+
+   test-internal-options01.c
+*/
+
+ #define _POSIX_C_SOURCE 200112L
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_bckey.h>
+ #include <ak_tools.h>
+#ifndef _WIN32
+ #include <sys/stat.h>
+#endif
+
+/* проверка совпадения значений опций, получаемых по индексу и по имени */
+ int test_access( void )
+{
+  size_t i = 0;
+  int exitcode = EXIT_SUCCESS;
+
+  if( ak_libakrypt_options_count() != option_undefined ) exitcode = EXIT_FAILURE;
+  for( i = 0; i < ak_libakrypt_options_count(); i++ ) {
+     char *name = ak_libakrypt_get_option_name( i );
+     if( ak_libakrypt_get_option( name ) != ak_libakrypt_get_option_by_index(( option_index_t ) i ))
+       exitcode = EXIT_FAILURE;
+     if( ak_libakrypt_get_option_value( i ) != ak_libakrypt_get_option_by_index(( option_index_t ) i ))
+       exitcode = EXIT_FAILURE;
+  }
+
+ /* изменение опции по имени видно при доступе по индексу, и наоборот */
+  ak_libakrypt_set_option( "pbkdf2_iteration_count", 3000 );
+  if( ak_libakrypt_get_option_by_index( option_pbkdf2_iteration_count ) != 3000 )
+    exitcode = EXIT_FAILURE;
+  ak_libakrypt_set_option_by_index( option_pbkdf2_iteration_count, 2000 );
+  if( ak_libakrypt_get_option( "pbkdf2_iteration_count" ) != 2000 ) exitcode = EXIT_FAILURE;
+
+ /* неверные имена и индексы */
+  if( ak_libakrypt_get_option( "pbkdf2_iteration" ) != ak_error_wrong_option ) exitcode = EXIT_FAILURE;
+  if( ak_libakrypt_get_option_by_index( option_undefined ) != ak_error_wrong_option )
+    exitcode = EXIT_FAILURE;
+  if( ak_libakrypt_set_option_by_index( option_undefined, 1 ) != ak_error_wrong_option )
+    exitcode = EXIT_FAILURE;
+
+  printf("access to options: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+ return exitcode;
+}
+
+/* проверка повторного считывания опций из файла */
+ int test_reload( void )
+{
+  FILE *fp = NULL;
+  struct bckey key;
+  ak_uint8 value[32];
+  int exitcode = EXIT_SUCCESS;
+  ak_int64 generator = ak_libakrypt_get_option_by_index( option_mask_random_generator );
+
+#ifndef _WIN32
+ /* создаем файл настроек в отдельном домашнем каталоге */
+  mkdir( "options01", 0700 );
+  mkdir( "options01/.config", 0700 );
+  mkdir( "options01/.config/libakrypt", 0700 );
+  if(( fp = fopen( "options01/.config/libakrypt/libakrypt.conf", "w" )) == NULL ) {
+    printf("unable to create options file\n");
+    return EXIT_FAILURE;
+  }
+  fprintf( fp, "# options for test-internal-options01\n" );
+  fprintf( fp, "  pbkdf2_iteration_count = 4000\n" );
+  fprintf( fp, "kuznechik_cipher_resource = 5\n" );
+  fprintf( fp, "hmac_key_count_resource = 4096\n" );
+  fprintf( fp, "mask_random_generator = ctr-magma\n" );
+  fprintf( fp, "mask_refresh_policy = 7\n" );
+  fprintf( fp, "icode_check_policy = -1\n" );
+  fprintf( fp, "unknown_option = 12\n" );
+  fclose( fp );
+  setenv( "HOME", "options01", 1 );
+#endif
+
+  if( ak_libakrypt_reload_options() != ak_error_ok ) {
+    printf("options file is not reloaded\n");
+    return EXIT_FAILURE;
+  }
+  printf("pbkdf2_iteration_count: %lld\n",
+                 (long long) ak_libakrypt_get_option_by_index( option_pbkdf2_iteration_count ));
+  printf("kuznechik_cipher_resource: %lld\n",
+              (long long) ak_libakrypt_get_option_by_index( option_kuznechik_cipher_resource ));
+  printf("hmac_key_count_resource: %lld\n",
+                (long long) ak_libakrypt_get_option_by_index( option_hmac_key_count_resource ));
+
+  if( ak_libakrypt_get_option_by_index( option_pbkdf2_iteration_count ) != 4000 )
+    exitcode = EXIT_FAILURE;
+ /* значение, меньшее допустимого, заменяется минимальным */
+  if( ak_libakrypt_get_option_by_index( option_kuznechik_cipher_resource ) != 1024 )
+    exitcode = EXIT_FAILURE;
+  if( ak_libakrypt_get_option_by_index( option_hmac_key_count_resource ) != 4096 )
+    exitcode = EXIT_FAILURE;
+  if( ak_libakrypt_get_option_by_index( option_mask_random_generator ) == generator )
+    exitcode = EXIT_FAILURE;
+ /* недопустимое значение перечислимой опции отбрасывается, а не заменяется границей интервала */
+  if( ak_libakrypt_get_option_by_index( option_mask_refresh_policy ) != 0 ) exitcode = EXIT_FAILURE;
+  if( ak_libakrypt_get_option_by_index( option_icode_check_policy ) != 0 ) exitcode = EXIT_FAILURE;
+
+ /* новые значения используются ключами, создаваемыми после считывания опций */
+  memset( value, 0x11, sizeof( value ));
+  ak_libakrypt_set_option_by_index( option_mask_random_generator, generator );
+  ak_bckey_context_create_kuznechik( &key );
+  ak_bckey_context_set_key( &key, value, sizeof( value ), ak_true );
+  if( key.key.resource.value.counter != 1024 ) exitcode = EXIT_FAILURE;
+  ak_bckey_context_destroy( &key );
+
+#ifndef _WIN32
+  remove( "options01/.config/libakrypt/libakrypt.conf" );
+#endif
+  printf("reloading of options: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+ return exitcode;
+}
+
+ int main( void )
+{
+  int error = EXIT_SUCCESS;
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+
+  if(( error = test_access( )) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_reload( )) != EXIT_SUCCESS ) goto exitlab;
+
+  exitlab: ak_libakrypt_destroy();
+ return error;
+}
@@ -0,0 +1,227 @@
+/* Тестовый пример, иллюстрирующий использование пулов ключей алгоритмов блочного шифрования
+   и контекстов сжимающих отображений: повторное использование контекстов,
+   уничтожение ключевой информации и зависящих от нее внутренних состояний алгоритмов
+   при возврате в пул и сравнение скорости
+   с многократным созданием и уничтожением контекстов.
+   Пример использует неэкспортируемые функции.
+
+   test-internal-pool01.c
+*/
+
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_mac.h>
+ #include <ak_bckey.h>
+
+ #define iterations   (10000)
+
+/* проверка пула ключей блочного шифрования */
+ int test_bckey_pool( const char *name )
+{
+  size_t i = 0;
+  clock_t tmr;
+  struct bckey key;
+  struct bckey_pool pool;
+  ak_bckey bkey = NULL, bkey2 = NULL;
+  int exitcode = EXIT_SUCCESS;
+  ak_uint8 value[32], saved[32], rounds[32], in[16], out[16], reference[16];
+  ak_pointer schedule = NULL;
+  ak_oid oid = ak_oid_context_find_by_name( name );
+
+  memset( value, 0x5a, sizeof( value ));
+  memset( in, 0x3c, sizeof( in ));
+  ak_bckey_context_create_oid( &key, oid );
+  ak_bckey_context_set_key( &key, value, sizeof( value ), ak_true );
+  ak_bckey_context_encrypt_ecb( &key, in, reference, sizeof( in ));
+  ak_bckey_context_destroy( &key );
+
+  if( ak_bckey_pool_create( &pool, oid, 2 ) != ak_error_ok ) return EXIT_FAILURE;
+  if(( bkey = ak_bckey_pool_checkout( &pool, value, sizeof( value ))) == NULL ) {
+    ak_bckey_pool_destroy( &pool );
+    return EXIT_FAILURE;
+  }
+  ak_bckey_context_encrypt_ecb( bkey, in, out, sizeof( in ));
+  if( !ak_ptr_is_equal( out, reference, sizeof( out ))) exitcode = EXIT_FAILURE;
+  memcpy( saved, bkey->key.key.data, sizeof( saved ));
+  schedule = bkey->key.data;
+  memcpy( rounds, schedule, sizeof( rounds ));
+
+ /* после возврата в пул ключ не может использоваться, а развернутые ключи
+    уничтожаются без освобождения занимаемой ими памяти */
+  ak_bckey_pool_checkin( &pool, bkey );
+  if( bkey->key.flags&skey_flag_set_key ) exitcode = EXIT_FAILURE;
+  if( ak_ptr_is_equal( bkey->key.key.data, saved, sizeof( saved ))) exitcode = EXIT_FAILURE;
+  if( bkey->key.data != schedule ) exitcode = EXIT_FAILURE;
+    else if( ak_ptr_is_equal( schedule, rounds, sizeof( rounds ))) exitcode = EXIT_FAILURE;
+
+ /* повторно извлекается тот же контекст */
+  bkey2 = ak_bckey_pool_checkout( &pool, value, sizeof( value ));
+  if( bkey2 != bkey ) exitcode = EXIT_FAILURE;
+  if( bkey2->key.data != schedule ) exitcode = EXIT_FAILURE;
+  memset( out, 0, sizeof( out ));
+  ak_bckey_context_encrypt_ecb( bkey2, in, out, sizeof( in ));
+  if( !ak_ptr_is_equal( out, reference, sizeof( out ))) exitcode = EXIT_FAILURE;
+  ak_bckey_pool_checkin( &pool, bkey2 );
+  printf("%s pool: %s (created %u contexts)\n", name,
+                           exitcode == EXIT_SUCCESS ? "Ok" : "Wrong", (unsigned int) pool.total );
+  if( pool.total != 2 ) exitcode = EXIT_FAILURE;
+
+ /* сравнение скорости */
+  tmr = clock();
+  for( i = 0; i < iterations; i++ ) {
+     value[0] = ( ak_uint8 )i;
+     ak_bckey_context_create_oid( &key, oid );
+     ak_bckey_context_set_key( &key, value, sizeof( value ), ak_true );
+     ak_bckey_context_destroy( &key );
+  }
+  tmr = clock() - tmr;
+  printf(" create/destroy:   %.3fs\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+  tmr = clock();
+  for( i = 0; i < iterations; i++ ) {
+     value[0] = ( ak_uint8 )i;
+     if(( bkey = ak_bckey_pool_checkout( &pool, value, sizeof( value ))) == NULL ) {
+       exitcode = EXIT_FAILURE;
+       break;
+     }
+     ak_bckey_pool_checkin( &pool, bkey );
+  }
+  tmr = clock() - tmr;
+  printf(" checkout/checkin: %.3fs\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  ak_bckey_pool_destroy( &pool );
+ return exitcode;
+}
+
+/* проверка пула контекстов сжимающих отображений */
+ int test_mac_pool( const char *name, const bool_t keyed )
+{
+  struct mac ctx;
+  struct mac_pool pool;
+  ak_mac ictx = NULL, ictx2 = NULL;
+  int exitcode = EXIT_SUCCESS;
+  ak_uint8 value[32], in[100], out[64], reference[64];
+  ak_oid oid = ak_oid_context_find_by_name( name );
+
+  memset( value, 0x17, sizeof( value ));
+  memset( in, 0x71, sizeof( in ));
+  memset( out, 0, sizeof( out ));
+  memset( reference, 0, sizeof( reference ));
+  ak_mac_context_create_oid( &ctx, oid );
+  if( keyed ) ak_mac_context_set_key( &ctx, value, sizeof( value ), ak_true );
+  ak_mac_context_ptr( &ctx, in, sizeof( in ), reference );
+  ak_mac_context_destroy( &ctx );
+
+  if( ak_mac_pool_create( &pool, oid, 1 ) != ak_error_ok ) return EXIT_FAILURE;
+  if(( ictx = ak_mac_pool_checkout( &pool, keyed ? value : NULL, sizeof( value ))) == NULL ) {
+    ak_mac_pool_destroy( &pool );
+    return EXIT_FAILURE;
+  }
+  ak_mac_context_ptr( ictx, in, sizeof( in ), out );
+  if( !ak_ptr_is_equal( out, reference, ictx->hsize )) exitcode = EXIT_FAILURE;
+  ak_mac_pool_checkin( &pool, ictx );
+  if( keyed && ( ak_mac_context_get_skey( ictx )->flags&skey_flag_set_key ))
+    exitcode = EXIT_FAILURE;
+
+ /* повторное извлечение контекста */
+  ictx2 = ak_mac_pool_checkout( &pool, keyed ? value : NULL, sizeof( value ));
+  if( ictx2 != ictx ) exitcode = EXIT_FAILURE;
+  memset( out, 0, sizeof( out ));
+  ak_mac_context_ptr( ictx2, in, sizeof( in ), out );
+  if( !ak_ptr_is_equal( out, reference, ictx2->hsize )) exitcode = EXIT_FAILURE;
+
+ /* контекст, не возвращенный в пул, уничтожается пользователем */
+  ictx = ak_mac_pool_checkout( &pool, keyed ? value : NULL, sizeof( value ));
+  if(( ictx == NULL ) || ( ictx == ictx2 ) || ( pool.total != 2 )) exitcode = EXIT_FAILURE;
+  ak_mac_pool_checkin( &pool, ictx2 );
+  if( ictx != NULL ) ak_mac_context_delete( ictx );
+
+  printf("%s pool: %s\n", name, exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+  ak_mac_pool_destroy( &pool );
+ return exitcode;
+}
+
+/* проверка отсутствия зависящих от ключа состояний после возврата контекстов в пул */
+ int test_mac_pool_wipe( void )
+{
+  struct hash hash;
+  struct mac_pool pool;
+  ak_mac ictx = NULL;
+  ak_mgm mctx = NULL;
+  ak_hmac hctx = NULL;
+  ak_omac octx = NULL;
+  int exitcode = EXIT_SUCCESS;
+  struct mgm_ctx zero;
+  ak_uint8 value[32], in[100], out[64], reference[64], saved[16];
+
+  memset( value, 0x17, sizeof( value ));
+  memset( in, 0x71, sizeof( in ));
+  memset( saved, 0x2e, sizeof( saved ));
+  memset( &zero, 0, sizeof( zero ));
+
+ /* состояние функции хеширования HMAC совпадает с начальным состоянием функции хеширования */
+  ak_hash_context_create_streebog256( &hash );
+  hash.finalize( &hash, NULL, 0, reference );
+  ak_hash_context_destroy( &hash );
+  if( ak_mac_pool_create( &pool, ak_oid_context_find_by_name( "hmac-streebog256" ), 1 )
+                                                              != ak_error_ok ) return EXIT_FAILURE;
+  if(( ictx = ak_mac_pool_checkout( &pool, value, sizeof( value ))) == NULL ) exitcode = EXIT_FAILURE;
+   else {
+     hctx = ( ak_hmac )ictx->ctx;
+     hctx->ctx.finalize( &hctx->ctx, NULL, 0, out );
+     if( ak_ptr_is_equal( out, reference, 32 )) exitcode = EXIT_FAILURE;
+     ak_mac_pool_checkin( &pool, ictx );
+     hctx->ctx.finalize( &hctx->ctx, NULL, 0, out );
+     if( !ak_ptr_is_equal( out, reference, 32 )) exitcode = EXIT_FAILURE;
+   }
+  ak_mac_pool_destroy( &pool );
+
+ /* промежуточное значение имитовставки OMAC уничтожается */
+  if( ak_mac_pool_create( &pool, ak_oid_context_find_by_name( "omac-kuznechik" ), 1 )
+                                                              != ak_error_ok ) return EXIT_FAILURE;
+  if(( ictx = ak_mac_pool_checkout( &pool, value, sizeof( value ))) == NULL ) exitcode = EXIT_FAILURE;
+   else {
+     octx = ( ak_omac )ictx->ctx;
+     ak_mac_context_ptr( ictx, in, sizeof( in ), out );
+     memcpy( saved, octx->yaout.data, sizeof( saved ));
+     if( ak_ptr_is_equal( saved, &zero, sizeof( saved ))) exitcode = EXIT_FAILURE;
+     ak_mac_pool_checkin( &pool, ictx );
+     if( ak_ptr_is_equal( saved, octx->yaout.data, sizeof( saved ))) exitcode = EXIT_FAILURE;
+   }
+  ak_mac_pool_destroy( &pool );
+
+ /* внутреннее состояние алгоритма MGM обнуляется */
+  if( ak_mac_pool_create( &pool, ak_oid_context_find_by_name( "mgm-kuznechik" ), 1 )
+                                                              != ak_error_ok ) return EXIT_FAILURE;
+  if(( ictx = ak_mac_pool_checkout( &pool, value, sizeof( value ))) == NULL ) exitcode = EXIT_FAILURE;
+   else {
+     mctx = ( ak_mgm )ictx->ctx;
+     ak_mac_context_set_iv( ictx, saved, sizeof( saved ));
+     ak_mac_context_ptr( ictx, in, sizeof( in ), out );
+     if( ak_ptr_is_equal( &mctx->mctx, &zero, sizeof( zero ))) exitcode = EXIT_FAILURE;
+     ak_mac_pool_checkin( &pool, ictx );
+     if( !ak_ptr_is_equal( &mctx->mctx, &zero, sizeof( zero ))) exitcode = EXIT_FAILURE;
+     if( mctx->iv.data != NULL ) exitcode = EXIT_FAILURE;
+   }
+  ak_mac_pool_destroy( &pool );
+
+  printf("wiping of mac states: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+ return exitcode;
+}
+
+ int main( void )
+{
+  int error = EXIT_SUCCESS;
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+
+  if(( error = test_bckey_pool( "kuznechik" )) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_bckey_pool( "magma" )) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_mac_pool( "streebog256", ak_false )) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_mac_pool( "hmac-streebog256", ak_true )) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_mac_pool( "omac-kuznechik", ak_true )) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_mac_pool_wipe( )) != EXIT_SUCCESS ) goto exitlab;
+
+  exitlab: ak_libakrypt_destroy();
+ return error;
+}
@@ -1,5 +1,5 @@
 /* Тестовый пример, иллюстрирующий создание серии генераторов,
-   основанных на применении функций хеширования (hashrnd).
+   основанных на применении функций хеширования (hashrnd), и их подпотоков.
    Пример использует неэкспортируемые функции.
 
    test-internal-random02.c
@@ -63,6 +63,30 @@
           }
   }
 
+ /* 3. генерация тех же данных фрагментами большой длины (используется вывод,
+       минующий внутренний буффер генератора) */
+ for( i = 0; i < 10; i++ ) {
+    offset = 0;
+    len = sizeof( buffer );
+    ak_random_context_randomize( &generator, cnt, sizeof( cnt ));
+
+    while( len > 0 ) {
+      size_t val = 1 + rand()%200;
+      if( val > len ) val = len;
+      ak_random_context_random( &generator, buffer+offset, val );
+      offset += val;
+      len -= val;
+    }
+    ak_hash_context_ptr( &streebog, buffer, sizeof( buffer ), out2 );
+    ak_ptr_to_hexstr_static( out2, sizeof( out2 ), string, sizeof( string ), ak_false );
+    printf("hash: %s", string );
+    if( ak_ptr_is_equal( out, out2, sizeof( out ))) printf(" Ok (bulk)\n");
+     else {
+            printf("Wrong (bulk)\n");
+            exitcode = EXIT_FAILURE;
+          }
+  }
+
  /* Освобождаем память */
   ak_random_context_destroy( &generator );
   ak_hash_context_destroy( &streebog );
@@ -70,6 +94,47 @@
  return exitcode;
 }
 
+/* функция, проверяющая, что подпотоки генератора вырабатывают различные последовательности */
+ int test_substreams( ak_oid oid )
+{
+  size_t i = 0, j = 0;
+  struct random generator, sub[4], nested;
+  int exitcode = EXIT_SUCCESS;
+  ak_uint8 buffer[5][256];
+
+  printf("\nTest for substreams of hashrnd-%s generator\n", oid->name );
+  ak_random_context_create_hashrnd_oid( &generator, oid );
+  for( i = 0; i < 4; i++ ) {
+     if( ak_random_context_create_hashrnd_substream( sub+i, &generator ) != ak_error_ok ) {
+       printf("wrong creation of substream\n");
+       exitcode = EXIT_FAILURE;
+       while( i > 0 ) ak_random_context_destroy( sub + --i );
+       ak_random_context_destroy( &generator );
+       return exitcode;
+     }
+  }
+
+  ak_random_context_random( &generator, buffer[4], sizeof( buffer[4] ));
+  for( i = 0; i < 4; i++ ) ak_random_context_random( sub+i, buffer[i], sizeof( buffer[i] ));
+  for( i = 0; i < 5; i++ )
+     for( j = i+1; j < 5; j++ )
+        if( ak_ptr_is_equal( buffer[i], buffer[j], sizeof( buffer[i] ))) exitcode = EXIT_FAILURE;
+  printf("substreams: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+
+ /* подпоток подпотока совпал бы с одним из подпотоков основного генератора,
+    поэтому его создание запрещено */
+  if( ak_random_context_create_hashrnd_substream( &nested, sub+1 ) == ak_error_ok ) {
+    ak_random_context_random( &nested, buffer[4], sizeof( buffer[4] ));
+    ak_random_context_destroy( &nested );
+    exitcode = EXIT_FAILURE;
+  }
+  printf("substream of substream is rejected: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+
+  for( i = 0; i < 4; i++ ) ak_random_context_destroy( sub+i );
+  ak_random_context_destroy( &generator );
+ return exitcode;
+}
+
 
  int main( void )
 {
@@ -78,6 +143,10 @@
 
   if(( error = test( ak_oid_context_find_by_name( "streebog256" ))) != EXIT_SUCCESS ) goto exitlab;
   if(( error = test( ak_oid_context_find_by_name( "streebog512" ))) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_substreams( ak_oid_context_find_by_name( "streebog256" ))) != EXIT_SUCCESS )
+    goto exitlab;
+  if(( error = test_substreams( ak_oid_context_find_by_name( "streebog512" ))) != EXIT_SUCCESS )
+    goto exitlab;
 
   exitlab: ak_libakrypt_destroy();
  return error;
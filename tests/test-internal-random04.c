@@ -0,0 +1,140 @@
+/* Тестовый пример, иллюстрирующий работу буфферизованного генератора, получающего
+   случайные данные от операционной системы с помощью вызова getrandom().
+   Проверяется, что после ветвления процесса родительский и дочерний процессы
+   получают различные последовательности, что несколько потоков, одновременно использующих
+   генератор, получают различные значения, а также сравнивается скорость работы генератора
+   со скоростью чтения из /dev/urandom.
+   Пример использует неэкспортируемые функции.
+
+   test-internal-random04.c
+*/
+
+ #include <time.h>
+ #include <stdio.h>
+ #include <string.h>
+ #include <stdlib.h>
+ #include <unistd.h>
+ #include <sys/wait.h>
+ #include <ak_random.h>
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+
+ #define threads_count   (4)
+ #define values_count (2048)
+
+/* общий для всех потоков генератор и вырабатываемые потоками значения */
+ static struct random generator;
+ static ak_uint8 values[threads_count*values_count][16];
+
+/* ----------------------------------------------------------------------------------------------- */
+/* функция потока: вырабатывает серию коротких последовательностей */
+ void *thread_random( void *arg )
+{
+  size_t i = 0, idx = *(size_t *)arg;
+
+  for( i = 0; i < values_count; i++ )
+     ak_random_context_random( &generator, values[idx*values_count + i], 16 );
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int compare_values( const void *x, const void *y )
+{
+ return memcmp( x, y, 16 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* вырабатываем много коротких последовательностей и измеряем время */
+ double speed( ak_random generator, size_t count )
+{
+  size_t i = 0;
+  ak_uint8 buffer[32];
+  clock_t tmr = clock();
+
+  for( i = 0; i < count; i++ ) ak_random_context_random( generator, buffer, sizeof( buffer ));
+  tmr = clock() - tmr;
+ return ((double) tmr) / ((double) CLOCKS_PER_SEC);
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  int fd[2], status = 0;
+  pid_t pid;
+  size_t i = 0;
+  struct random urandom;
+  size_t idx[threads_count];
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_t threads[threads_count];
+#endif
+  ak_uint8 out[32], child[32], zero[32], large[40000];
+  int result = EXIT_FAILURE;
+
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+  if( ak_random_context_create_getrandom( &generator ) != ak_error_ok ) goto exlab;
+  printf("generator: %s\n", generator.oid->name );
+
+ /* последовательные значения должны различаться, в том числе на границе буффера */
+  memset( zero, 0, sizeof( zero ));
+  ak_random_context_random( &generator, child, 17 );
+  for( i = 0; i < 1100; i++ ) {
+     ak_random_context_random( &generator, out, sizeof( out ));
+     if(( memcmp( out, zero, sizeof( out )) == 0 ) || ( memcmp( out, child, sizeof( out )) == 0 )) {
+       printf("equal values of random sequences (iteration %u)\n", (unsigned int) i );
+       goto exlab;
+     }
+     memcpy( child, out, sizeof( out ));
+  }
+  if( ak_random_context_random( &generator, large, sizeof( large )) != ak_error_ok ) goto exlab;
+
+ /* после ветвления процесса последовательности должны различаться */
+  if( pipe( fd ) != 0 ) goto exlab;
+  if(( pid = fork()) == -1 ) goto exlab;
+  if( pid == 0 ) {
+    close( fd[0] );
+    ak_random_context_random( &generator, out, sizeof( out ));
+    if( write( fd[1], out, sizeof( out )) != sizeof( out )) _exit( EXIT_FAILURE );
+    close( fd[1] );
+    _exit( EXIT_SUCCESS );
+  }
+  close( fd[1] );
+  ak_random_context_random( &generator, out, sizeof( out ));
+  if( read( fd[0], child, sizeof( child )) != sizeof( child )) goto exlab;
+  close( fd[0] );
+  waitpid( pid, &status, 0 );
+  if( memcmp( out, child, sizeof( out )) == 0 ) {
+    printf("parent and child processes have equal random sequences\n");
+    goto exlab;
+  }
+  printf("parent and child processes have different random sequences\n");
+
+ /* потоки, одновременно использующие генератор, не должны получать одинаковые значения */
+  for( i = 0; i < threads_count; i++ ) idx[i] = i;
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  for( i = 0; i < threads_count; i++ ) pthread_create( threads+i, NULL, thread_random, idx+i );
+  for( i = 0; i < threads_count; i++ ) pthread_join( threads[i], NULL );
+#else
+  for( i = 0; i < threads_count; i++ ) thread_random( idx+i );
+#endif
+  qsort( values, threads_count*values_count, sizeof( values[0] ), compare_values );
+  for( i = 1; i < threads_count*values_count; i++ )
+     if( memcmp( values[i-1], values[i], sizeof( values[0] )) == 0 ) {
+       printf("threads have equal random values\n");
+       goto exlab;
+     }
+  printf("threads have different random values\n");
+
+ /* сравниваем скорость */
+  if( ak_random_context_create_urandom( &urandom ) == ak_error_ok ) {
+    printf("getrandom:   %.3fs\n", speed( &generator, 100000 ));
+    printf("dev-urandom: %.3fs\n", speed( &urandom, 100000 ));
+    ak_random_context_destroy( &urandom );
+  }
+  result = EXIT_SUCCESS;
+
+  exlab:
+   ak_random_context_destroy( &generator );
+   ak_libakrypt_destroy();
+ return result;
+}
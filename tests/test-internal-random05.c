@@ -0,0 +1,233 @@
+/* Тестовый пример, иллюстрирующий работу генераторов, основанных на применении
+   алгоритмов блочного шифрования в режиме гаммирования (ctr-kuznechik и ctr-magma),
+   а также их использование в качестве генераторов масок секретных ключей
+   и использование ключами генераторов, связанных с потоками выполнения программы.
+   Пример использует неэкспортируемые функции.
+
+   test-internal-random05.c
+*/
+
+ #include <time.h>
+ #include <stdio.h>
+ #include <string.h>
+ #include <stdlib.h>
+ #include <ak_oid.h>
+ #include <ak_bckey.h>
+ #include <ak_tools.h>
+ #include <ak_random.h>
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+
+/* функция, проверяющая, что два генератора вырабатывают различные последовательности */
+ int test( ak_oid oid )
+{
+  size_t i = 0, len = 0, offset = 0;
+  struct random one, two;
+  int exitcode = EXIT_SUCCESS;
+  ak_uint8 buffer[4096], buffer2[4096], string[80];
+
+  if( oid == NULL ) return EXIT_FAILURE;
+  printf("\nTest for %s random generator\n", oid->name );
+  if( ak_random_context_create_oid( &one, oid ) != ak_error_ok ) return EXIT_FAILURE;
+  if( ak_random_context_create_oid( &two, oid ) != ak_error_ok ) {
+    ak_random_context_destroy( &one );
+    return EXIT_FAILURE;
+  }
+
+ /* 1. проверяем, что созданный генератор связан со своим OID */
+  if( one.oid != oid ) {
+    printf("wrong oid of generator\n");
+    exitcode = EXIT_FAILURE;
+  }
+
+ /* 2. два генератора должны вырабатывать различные данные */
+  ak_random_context_random( &one, buffer, sizeof( buffer ));
+  ak_random_context_random( &two, buffer2, sizeof( buffer2 ));
+  ak_ptr_to_hexstr_static( buffer, 32, string, sizeof( string ), ak_false );
+  printf("one: %s\n", string );
+  ak_ptr_to_hexstr_static( buffer2, 32, string, sizeof( string ), ak_false );
+  printf("two: %s\n", string );
+  if( ak_ptr_is_equal( buffer, buffer2, sizeof( buffer ))) {
+    printf("equal outputs of different generators\n");
+    exitcode = EXIT_FAILURE;
+  }
+
+ /* 3. последовательные фрагменты случайной длины не должны повторяться;
+       объем вырабатываемых данных достаточен для многократной замены ключа */
+  for( i = 0; i < 512; i++ ) {
+    memcpy( buffer2, buffer, sizeof( buffer ));
+    offset = 0;
+    len = sizeof( buffer );
+    while( len > 0 ) {
+      size_t val = 1 + rand()%300;
+      if( val > len ) val = len;
+      if( ak_random_context_random( &one, buffer+offset, val ) != ak_error_ok ) {
+        exitcode = EXIT_FAILURE;
+        break;
+      }
+      offset += val;
+      len -= val;
+    }
+    if( ak_ptr_is_equal( buffer, buffer2, sizeof( buffer ))) exitcode = EXIT_FAILURE;
+  }
+
+ /* 4. инициализация генератора не должна приводить к повторению данных */
+  memset( buffer2, 0x11, 64 );
+  ak_random_context_randomize( &one, buffer2, 64 );
+  ak_random_context_random( &one, buffer, 64 );
+  ak_random_context_randomize( &two, buffer2, 64 );
+  ak_random_context_random( &two, buffer2, 64 );
+  if( ak_ptr_is_equal( buffer, buffer2, 64 )) {
+    printf("equal outputs after randomization\n");
+    exitcode = EXIT_FAILURE;
+  }
+  printf("random generation: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+
+  ak_random_context_destroy( &one );
+  ak_random_context_destroy( &two );
+ return exitcode;
+}
+
+/* сравнение скорости работы генераторов */
+ void speed( const char *name )
+{
+  size_t i = 0;
+  clock_t tmr;
+  struct random generator;
+  ak_uint8 buffer[32];
+
+  if( ak_random_context_create_oid( &generator,
+                                            ak_oid_context_find_by_name( name )) != ak_error_ok )
+    return;
+  tmr = clock();
+  for( i = 0; i < 100000; i++ ) ak_random_context_random( &generator, buffer, sizeof( buffer ));
+  tmr = clock() - tmr;
+  printf(" %-20s %.3fs\n", name, ((double) tmr) / ((double) CLOCKS_PER_SEC));
+  ak_random_context_destroy( &generator );
+}
+
+/* проверка работы секретного ключа, маскируемого генератором ctr-kuznechik */
+ int test_mask( void )
+{
+  size_t idx = 0;
+  int exitcode = EXIT_SUCCESS;
+  struct bckey one, two;
+  ak_uint8 key[32], in[16], out[16], out2[16];
+  oid_engines_t engine;
+  oid_modes_t mode;
+  char name[128], id[128];
+
+  memset( key, 0x23, sizeof( key ));
+  memset( in, 0x45, sizeof( in ));
+
+ /* ключ с генератором масок по-умолчанию */
+  ak_bckey_context_create_kuznechik( &one );
+  ak_bckey_context_set_key( &one, key, sizeof( key ), ak_true );
+  ak_bckey_context_encrypt_ecb( &one, in, out, sizeof( in ));
+
+ /* ключ, маски которого вырабатываются генератором ctr-kuznechik */
+  for( idx = 0; idx < ak_libakrypt_oids_count(); idx++ ) {
+     ak_libakrypt_get_oid_by_index( idx, &engine, &mode, name, sizeof( name ), id, sizeof( id ));
+     if( strcmp( name, "ctr-kuznechik" ) == 0 ) break;
+  }
+  ak_libakrypt_set_option( "mask_random_generator", idx );
+  ak_bckey_context_create_kuznechik( &two );
+  ak_libakrypt_set_option( "mask_random_generator", -1 );
+
+  if(( two.key.generator.oid == NULL ) ||
+                              ( strcmp( two.key.generator.oid->name, "ctr-kuznechik" ) != 0 )) {
+    printf("wrong mask generator of secret key\n");
+    exitcode = EXIT_FAILURE;
+  }
+  ak_bckey_context_set_key( &two, key, sizeof( key ), ak_true );
+  ak_bckey_context_encrypt_ecb( &two, in, out2, sizeof( in ));
+  if( !ak_ptr_is_equal( out, out2, sizeof( out ))) exitcode = EXIT_FAILURE;
+  printf("masking with ctr-kuznechik: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+
+  ak_bckey_context_destroy( &one );
+  ak_bckey_context_destroy( &two );
+ return exitcode;
+}
+
+/* функция потока: создает серию ключей и проверяет результат зашифрования */
+ static ak_uint8 reference[16];
+
+ void *thread_keys( void *arg )
+{
+  size_t i = 0;
+  struct bckey key;
+  ak_uint8 value[32], in[16], out[16];
+  long result = EXIT_SUCCESS;
+
+  memset( value, 0x23, sizeof( value ));
+  memset( in, 0x45, sizeof( in ));
+  for( i = 0; i < 1000; i++ ) {
+     ak_bckey_context_create_kuznechik( &key );
+    /* у ключа нет собственного генератора масок */
+     if( key.key.generator.data != NULL ) result = EXIT_FAILURE;
+     ak_bckey_context_set_key( &key, value, sizeof( value ), ak_true );
+     ak_bckey_context_encrypt_ecb( &key, in, out, sizeof( in ));
+     if( !ak_ptr_is_equal( out, reference, sizeof( out ))) result = EXIT_FAILURE;
+     ak_bckey_context_destroy( &key );
+  }
+  *(long *)arg = result;
+ return NULL;
+}
+
+/* проверка ключей, использующих генераторы потоков */
+ int test_thread_local( void )
+{
+  clock_t tmr;
+  struct bckey key;
+  int exitcode = EXIT_SUCCESS;
+  ak_uint8 value[32], in[16];
+  long results[4] = { EXIT_FAILURE, EXIT_FAILURE, EXIT_FAILURE, EXIT_FAILURE };
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  size_t i = 0;
+  pthread_t threads[4];
+#endif
+
+  memset( value, 0x23, sizeof( value ));
+  memset( in, 0x45, sizeof( in ));
+  ak_bckey_context_create_kuznechik( &key );
+  ak_bckey_context_set_key( &key, value, sizeof( value ), ak_true );
+  ak_bckey_context_encrypt_ecb( &key, in, reference, sizeof( in ));
+  ak_bckey_context_destroy( &key );
+
+  tmr = clock();
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  for( i = 0; i < 4; i++ ) pthread_create( threads+i, NULL, thread_keys, results+i );
+  for( i = 0; i < 4; i++ ) {
+     pthread_join( threads[i], NULL );
+     if( results[i] != EXIT_SUCCESS ) exitcode = EXIT_FAILURE;
+  }
+#else
+  thread_keys( results );
+  if( results[0] != EXIT_SUCCESS ) exitcode = EXIT_FAILURE;
+#endif
+  tmr = clock() - tmr;
+  printf("keys with thread local generators: %s (%.3fs)\n",
+          exitcode == EXIT_SUCCESS ? "Ok" : "Wrong", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+ return exitcode;
+}
+
+ int main( void )
+{
+  int error = EXIT_SUCCESS;
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+
+  if(( error = test( ak_oid_context_find_by_name( "ctr-kuznechik" ))) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test( ak_oid_context_find_by_name( "ctr-magma" ))) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_mask( )) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_thread_local( )) != EXIT_SUCCESS ) goto exitlab;
+
+  printf("\ngeneration time of 100000 x 32 bytes:\n");
+  speed( "xorshift32" );
+  speed( "hashrnd-streebog256" );
+  speed( "ctr-magma" );
+  speed( "ctr-kuznechik" );
+
+  exitlab: ak_libakrypt_destroy();
+ return error;
+}
@@ -0,0 +1,171 @@
+/* Тестовый пример, иллюстрирующий размещение ключевой информации в защищенной области памяти:
+   выделение и освобождение ячеек различных размеров, размещение секретных ключей
+   и одновременную работу нескольких потоков.
+   Пример использует неэкспортируемые функции.
+
+   test-internal-secure01.c
+*/
+
+/* как и в ak_buffer.c, объявление нужно для использования флага MAP_ANONYMOUS */
+#ifdef __linux__
+ #ifndef _DEFAULT_SOURCE
+   #define _DEFAULT_SOURCE
+ #endif
+#endif
+
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_bckey.h>
+ #include <ak_buffer.h>
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+ #include <pthread.h>
+#endif
+#ifdef LIBAKRYPT_HAVE_SYSMMAN_H
+ #include <sys/mman.h>
+#endif
+
+ #define threads_count  (4)
+
+/* защищенная область памяти создается только при наличии анонимного отображения страниц;
+   в противном случае ячейки выделяются обычным образом и не принадлежат защищенной области */
+#if defined( LIBAKRYPT_HAVE_SYSMMAN_H ) && defined( MAP_ANONYMOUS )
+ #define secure_arena  (ak_true)
+#else
+ #define secure_arena  (ak_false)
+#endif
+
+/* проверка выделения и освобождения ячеек */
+ int test_alloc( void )
+{
+  size_t i = 0;
+  ak_uint8 *ptrs[512];
+  int exitcode = EXIT_SUCCESS;
+  size_t used = ak_libakrypt_secure_used();
+
+  for( i = 0; i < 512; i++ ) {
+     size_t size = 1 + i%1024;
+     if(( ptrs[i] = ak_libakrypt_secure_malloc( size )) == NULL ) return EXIT_FAILURE;
+    /* память выравнена по границе 16 байт и доступна для записи */
+     if((( size_t )ptrs[i] )%16 != 0 ) exitcode = EXIT_FAILURE;
+     memset( ptrs[i], (int) i, size );
+  }
+  printf("used slots: %u\n", (unsigned int) ak_libakrypt_secure_used( ));
+  for( i = 0; i < 512; i++ ) {
+     if( ak_libakrypt_secure_contains( ptrs[i] ) != secure_arena ) exitcode = EXIT_FAILURE;
+     if( ptrs[i][i%1024] != ( ak_uint8 ) i ) exitcode = EXIT_FAILURE;
+  }
+  for( i = 0; i < 512; i++ ) ak_libakrypt_secure_free( ptrs[i] );
+  if( ak_libakrypt_secure_used() != used ) exitcode = EXIT_FAILURE;
+
+ /* память большого размера выделяется вне защищенной области */
+  if(( ptrs[0] = ak_libakrypt_secure_malloc( 4096 )) == NULL ) return EXIT_FAILURE;
+  if( ak_libakrypt_secure_contains( ptrs[0] ) != ak_false ) exitcode = EXIT_FAILURE;
+  ak_libakrypt_secure_free( ptrs[0] );
+  ak_libakrypt_secure_free( NULL );
+
+  printf("secure allocation: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+ return exitcode;
+}
+
+/* проверка размещения секретных ключей */
+ int test_keys( void )
+{
+  struct bckey one, two;
+  int exitcode = EXIT_SUCCESS;
+  ak_uint8 key[32], in[16], out[16];
+  size_t used = ak_libakrypt_secure_used();
+
+  memset( key, 0x77, sizeof( key ));
+  memset( in, 0x11, sizeof( in ));
+  ak_bckey_context_create_kuznechik( &one );
+  ak_bckey_context_set_key( &one, key, sizeof( key ), ak_true );
+  ak_bckey_context_create_magma( &two );
+  ak_bckey_context_set_key( &two, key, sizeof( key ), ak_true );
+
+  if(( ak_libakrypt_secure_contains( one.key.key.data ) != secure_arena ) ||
+     ( ak_libakrypt_secure_contains( one.key.mask.data ) != secure_arena ) ||
+     ( ak_libakrypt_secure_contains( one.key.icode.data ) != secure_arena ) ||
+     ( ak_libakrypt_secure_contains( one.key.data ) != secure_arena ) ||
+     ( ak_libakrypt_secure_contains( two.key.key.data ) != secure_arena ) ||
+     ( ak_libakrypt_secure_contains( two.key.data ) != secure_arena )) {
+    printf("secret key is placed out of secure memory\n");
+    exitcode = EXIT_FAILURE;
+  }
+  if( ak_bckey_context_encrypt_ecb( &one, in, out, sizeof( in )) != ak_error_ok )
+    exitcode = EXIT_FAILURE;
+  if( ak_bckey_context_encrypt_ecb( &two, in, out, sizeof( in )) != ak_error_ok )
+    exitcode = EXIT_FAILURE;
+
+  ak_bckey_context_destroy( &one );
+  ak_bckey_context_destroy( &two );
+  if( ak_libakrypt_secure_used() != used ) exitcode = EXIT_FAILURE;
+
+  printf("secret keys in secure memory: %s\n", exitcode == EXIT_SUCCESS ? "Ok" : "Wrong" );
+ return exitcode;
+}
+
+/* функция потока: создает и уничтожает серию ключей */
+ void *thread_keys( void *arg )
+{
+  size_t i = 0;
+  struct bckey key;
+  ak_uint8 value[32], in[16], out[16];
+  long result = EXIT_SUCCESS;
+
+  memset( value, 0x23, sizeof( value ));
+  memset( in, 0x45, sizeof( in ));
+  for( i = 0; i < 2000; i++ ) {
+     ak_bckey_context_create_kuznechik( &key );
+     ak_bckey_context_set_key( &key, value, sizeof( value ), ak_true );
+     if( ak_bckey_context_encrypt_ecb( &key, in, out, sizeof( in )) != ak_error_ok )
+       result = EXIT_FAILURE;
+     ak_bckey_context_destroy( &key );
+  }
+  *(long *)arg = result;
+ return NULL;
+}
+
+/* проверка одновременной работы нескольких потоков */
+ int test_threads( void )
+{
+  size_t i = 0;
+  clock_t tmr;
+  int exitcode = EXIT_SUCCESS;
+  long results[threads_count];
+  size_t used = ak_libakrypt_secure_used();
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  pthread_t threads[threads_count];
+#endif
+
+  for( i = 0; i < threads_count; i++ ) results[i] = EXIT_FAILURE;
+  tmr = clock();
+#ifdef LIBAKRYPT_HAVE_PTHREAD
+  for( i = 0; i < threads_count; i++ )
+     pthread_create( threads+i, NULL, thread_keys, results+i );
+  for( i = 0; i < threads_count; i++ ) pthread_join( threads[i], NULL );
+#else
+  for( i = 0; i < threads_count; i++ ) thread_keys( results+i );
+#endif
+  tmr = clock() - tmr;
+  for( i = 0; i < threads_count; i++ ) if( results[i] != EXIT_SUCCESS ) exitcode = EXIT_FAILURE;
+  if( ak_libakrypt_secure_used() != used ) exitcode = EXIT_FAILURE;
+
+  printf("concurrent keys: %s (%.3fs)\n",
+          exitcode == EXIT_SUCCESS ? "Ok" : "Wrong", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+ return exitcode;
+}
+
+ int main( void )
+{
+  int error = EXIT_SUCCESS;
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+
+  if(( error = test_alloc( )) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_keys( )) != EXIT_SUCCESS ) goto exitlab;
+  if(( error = test_threads( )) != EXIT_SUCCESS ) goto exitlab;
+
+  exitlab: ak_libakrypt_destroy();
+ return error;
+}
@@ -0,0 +1,119 @@
+/* Пример, иллюстрирующий одновременную проверку нескольких электронных подписей,
+   выработанных для ключей, определенных на разных эллиптических кривых.
+   Результаты пакетной проверки сравниваются с результатами проверки каждой подписи в отдельности.
+   Внимание! Используются неэкспортируемые функции.
+
+   test-internal-sign03.c */
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <time.h>
+ #include <ak_sign.h>
+ #include <ak_parameters.h>
+ #include <ak_tools.h>
+
+ #define keys_count   (3)
+ #define signs_count (48)
+
+/* сравниваем результаты пакетной и поэлементной проверки подписей */
+ int batch_compare( ak_verifykey *keys, ak_pointer *hashes, ak_pointer *signs, bool_t *expected )
+{
+  size_t i = 0, val = 0;
+  bool_t results[signs_count];
+  clock_t tmr;
+
+  tmr = clock();
+  if( ak_verifykey_context_verify_batch( keys, hashes, signs, signs_count, results ) != ak_error_ok ) {
+    printf(" batch verification error\n");
+    return ak_false;
+  }
+  tmr = clock() - tmr;
+  printf(" batch verification time: %.3fs (threads: %d)\n",
+     ((double) tmr) / ((double) CLOCKS_PER_SEC), (int)ak_libakrypt_get_option( "verify_batch_threads" ));
+
+  for( i = 0; i < signs_count; i++ ) if( results[i] == expected[i] ) val++;
+  printf(" correct results %u from %u\n", (unsigned int)val, (unsigned int)signs_count );
+ return ( val == signs_count );
+}
+
+ int main( void )
+{
+  size_t i = 0;
+  clock_t tmr;
+  int error = ak_error_ok, result = EXIT_FAILURE;
+  struct random generator;
+  struct signkey skeys[keys_count];
+  struct verifykey vkeys[keys_count];
+  ak_uint8 hashbuf[signs_count][64], signbuf[signs_count][128];
+  ak_verifykey keys[signs_count];
+  ak_pointer hashes[signs_count], signs[signs_count];
+  bool_t expected[signs_count];
+  ak_wcurve curves[keys_count] = {
+    (ak_wcurve) &id_tc26_gost_3410_2012_256_paramSetA,
+    (ak_wcurve) &id_rfc4357_gost_3410_2001_paramSetB,
+    (ak_wcurve) &id_tc26_gost_3410_2012_512_paramSetB };
+
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+  ak_random_context_create_lcg( &generator );
+
+ /* создаем ключи */
+  for( i = 0; i < keys_count; i++ ) {
+     if( curves[i]->size == ak_mpzn256_size )
+       error = ak_signkey_context_create_streebog256( &skeys[i], curves[i] );
+      else error = ak_signkey_context_create_streebog512( &skeys[i], curves[i] );
+     if( error != ak_error_ok ) return ak_libakrypt_destroy();
+     ak_signkey_context_set_key_random( &skeys[i], &generator );
+     ak_verifykey_context_create_from_signkey( &vkeys[i], &skeys[i] );
+  }
+
+ /* вырабатываем подписи */
+  memset( hashbuf, 0, sizeof( hashbuf ));
+  memset( signbuf, 0, sizeof( signbuf ));
+  for( i = 0; i < signs_count; i++ ) {
+     size_t k = i%keys_count, len = sizeof( ak_uint64 )*curves[k]->size;
+     ak_random_context_random( &generator, hashbuf[i], len );
+     ak_signkey_context_sign_hash( &skeys[k], hashbuf[i], len, signbuf[i] );
+     keys[i] = &vkeys[k];
+     hashes[i] = hashbuf[i];
+     signs[i] = signbuf[i];
+     expected[i] = ak_true;
+  }
+
+ /* портим некоторые из подписей */
+  hashbuf[5][3] ^= 0x01; expected[5] = ak_false;
+  signbuf[11][7] ^= 0x80; expected[11] = ak_false;
+  signs[17] = NULL; expected[17] = ak_false;
+  memset( signbuf[20] + 8*curves[20%keys_count]->size, 0, 8*curves[20%keys_count]->size );
+  expected[20] = ak_false;
+  keys[25] = &vkeys[( 25+1 )%keys_count]; expected[25] = ak_false; /* ключ на другой кривой */
+
+ /* проверяем поэлементно */
+  tmr = clock();
+  for( i = 0; i < signs_count; i++ ) {
+     if( i == 17 ) continue;
+     if( ak_verifykey_context_verify_hash( keys[i], hashes[i],
+                          sizeof( ak_uint64 )*keys[i]->wc->size, signs[i] ) != expected[i] ) {
+       printf(" unexpected result of single verification for %u signature\n", (unsigned int)i );
+       goto labexit;
+     }
+  }
+  tmr = clock() - tmr;
+  printf(" single verification time: %.3fs\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+ /* проверяем пакетом в одном и нескольких потоках */
+  if( !batch_compare( keys, hashes, signs, expected )) goto labexit;
+  ak_libakrypt_set_option( "verify_batch_threads", 4 );
+  if( !batch_compare( keys, hashes, signs, expected )) goto labexit;
+  result = EXIT_SUCCESS;
+
+  labexit:
+  for( i = 0; i < keys_count; i++ ) {
+     ak_verifykey_context_destroy( &vkeys[i] );
+     ak_signkey_context_destroy( &skeys[i] );
+  }
+  ak_random_context_destroy( &generator );
+  ak_libakrypt_destroy();
+
+ return result;
+}
@@ -0,0 +1,87 @@
+/* Пример, иллюстрирующий выработку электронной подписи с использованием заранее вычисленных
+   пар (k, r). Подписи, выработанные с использованием пар и без них, проверяются
+   функцией ak_verifykey_context_verify_hash().
+   Внимание! Используются неэкспортируемые функции.
+
+   test-internal-sign04.c */
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <time.h>
+ #include <ak_sign.h>
+ #include <ak_parameters.h>
+
+ #define precomputed_count (32)
+ #define signs_count       (40)
+
+/* вырабатываем и проверяем подписи для заданной кривой */
+ bool_t precompute_test( ak_wcurve wc, ak_random generator )
+{
+  size_t i = 0, val = 0, len = sizeof( ak_uint64 )*wc->size;
+  struct signkey skey;
+  struct verifykey vkey;
+  ak_uint8 hash[64], sign[128];
+  bool_t result = ak_false;
+  clock_t tmr;
+
+  if( wc->size == ak_mpzn256_size ) {
+    if( ak_signkey_context_create_streebog256( &skey, wc ) != ak_error_ok ) return ak_false;
+  } else
+      if( ak_signkey_context_create_streebog512( &skey, wc ) != ak_error_ok ) return ak_false;
+  ak_signkey_context_set_key_random( &skey, generator );
+  ak_verifykey_context_create_from_signkey( &vkey, &skey );
+
+ /* вычисляем пары (k, r) */
+  tmr = clock();
+  if( ak_signkey_context_precompute( &skey, precomputed_count/2 ) != ak_error_ok ) goto labexit;
+  if( ak_signkey_context_precompute( &skey, precomputed_count/2 ) != ak_error_ok ) goto labexit;
+  tmr = clock() - tmr;
+  printf(" precomputation time: %.3fs (%u values)\n",
+                    ((double) tmr) / ((double) CLOCKS_PER_SEC), (unsigned int)precomputed_count );
+  if( ak_signkey_context_get_precomputed_count( &skey ) != precomputed_count ) goto labexit;
+
+ /* вырабатываем подписи: сначала используются пары, потом вычисления выполняются полностью */
+  memset( hash, 0, sizeof( hash ));
+  memset( sign, 0, sizeof( sign ));
+  tmr = clock();
+  for( i = 0; i < signs_count; i++ ) {
+     ak_random_context_random( generator, hash, len );
+     ak_signkey_context_sign_hash( &skey, hash, len, sign );
+     if( ak_verifykey_context_verify_hash( &vkey, hash, len, sign )) val++;
+  }
+  tmr = clock() - tmr;
+  printf(" sign and verify time: %.3fs\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+  printf(" correct signatures %u from %u\n", (unsigned int)val, (unsigned int)signs_count );
+  if( ak_signkey_context_get_precomputed_count( &skey ) != 0 ) goto labexit;
+  if( val == signs_count ) result = ak_true;
+
+ labexit:
+  ak_verifykey_context_destroy( &vkey );
+  ak_signkey_context_destroy( &skey );
+ return result;
+}
+
+ int main( void )
+{
+  struct random generator;
+  int result = EXIT_SUCCESS;
+
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+  ak_random_context_create_lcg( &generator );
+
+  printf("id_tc26_gost_3410_2012_256_paramSetA\n");
+  if( !precompute_test( (ak_wcurve) &id_tc26_gost_3410_2012_256_paramSetA,
+                                                            &generator )) result = EXIT_FAILURE;
+  printf("id_rfc4357_gost_3410_2001_paramSetB\n");
+  if( !precompute_test( (ak_wcurve) &id_rfc4357_gost_3410_2001_paramSetB,
+                                                            &generator )) result = EXIT_FAILURE;
+  printf("id_tc26_gost_3410_2012_512_paramSetB\n");
+  if( !precompute_test( (ak_wcurve) &id_tc26_gost_3410_2012_512_paramSetB,
+                                                            &generator )) result = EXIT_FAILURE;
+
+  ak_random_context_destroy( &generator );
+  ak_libakrypt_destroy();
+
+ return result;
+}
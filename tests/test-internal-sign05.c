@@ -0,0 +1,96 @@
+/* Пример, иллюстрирующий выработку электронных подписей с помощью пула потоков,
+   каждый из которых использует собственную копию секретного ключа.
+   Внимание! Используются неэкспортируемые функции.
+
+   test-internal-sign05.c */
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <time.h>
+ #include <ak_sign.h>
+ #include <ak_parameters.h>
+
+ #define workers_count  (4)
+ #define signs_count  (128)
+
+/* результат выработки одной подписи */
+ typedef struct job_result {
+  int error;
+  size_t size;
+  ak_uint8 sign[128];
+ } *ak_job_result;
+
+/* функция, получающая результат; каждое задание пишет только в свою ячейку массива */
+ void sign_callback( ak_pointer data, int error, ak_pointer sign, size_t size )
+{
+  ak_job_result res = ( ak_job_result ) data;
+  res->error = error;
+  res->size = size;
+  if( sign != NULL ) memcpy( res->sign, sign, size );
+}
+
+ int main( void )
+{
+  size_t i = 0, val = 0, len = 0;
+  struct random generator;
+  struct signkey skey;
+  struct verifykey vkey;
+  ak_signkey_pool pool = NULL;
+  ak_uint8 hashbuf[signs_count][64], sign[128];
+  struct job_result results[signs_count];
+  int result = EXIT_FAILURE;
+  ak_wcurve wc = (ak_wcurve) &id_tc26_gost_3410_2012_512_paramSetA;
+  clock_t tmr;
+
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+  ak_random_context_create_lcg( &generator );
+
+  ak_signkey_context_create_streebog512( &skey, wc );
+  ak_signkey_context_set_key_random( &skey, &generator );
+  ak_verifykey_context_create_from_signkey( &vkey, &skey );
+  len = sizeof( ak_uint64 )*wc->size;
+
+  if(( pool = ak_signkey_pool_new( &skey, workers_count )) == NULL ) goto labexit;
+
+ /* ставим задания в очередь */
+  memset( hashbuf, 0, sizeof( hashbuf ));
+  memset( results, 0, sizeof( results ));
+  tmr = clock();
+  for( i = 0; i < signs_count; i++ ) {
+     results[i].error = ak_error_undefined_value;
+     ak_random_context_random( &generator, hashbuf[i], len );
+     if( ak_signkey_pool_submit( pool, hashbuf[i], len, sign_callback, results+i ) != ak_error_ok )
+       goto labexit;
+  }
+  ak_signkey_pool_wait( pool );
+  tmr = clock() - tmr;
+  printf(" pool signing time: %.3fs (%d threads, cpu time)\n",
+                                       ((double) tmr) / ((double) CLOCKS_PER_SEC), workers_count );
+
+ /* проверяем подписи */
+  for( i = 0; i < signs_count; i++ ) {
+     if(( results[i].error == ak_error_ok ) && ( results[i].size == 2*len ) &&
+        ak_verifykey_context_verify_hash( &vkey, hashbuf[i], len, results[i].sign )) val++;
+  }
+  printf(" correct signatures %u from %u\n", (unsigned int)val, (unsigned int)signs_count );
+  if( val != signs_count ) goto labexit;
+
+ /* исходный ключ остается работоспособным после создания копий */
+  memset( sign, 0, sizeof( sign ));
+  ak_signkey_context_sign_hash( &skey, hashbuf[0], len, sign );
+  if( !ak_verifykey_context_verify_hash( &vkey, hashbuf[0], len, sign )) {
+    printf(" wrong signature for original key\n");
+    goto labexit;
+  }
+  result = EXIT_SUCCESS;
+
+ labexit:
+  if( pool != NULL ) ak_signkey_pool_delete( pool );
+  ak_verifykey_context_destroy( &vkey );
+  ak_signkey_context_destroy( &skey );
+  ak_random_context_destroy( &generator );
+  ak_libakrypt_destroy();
+
+ return result;
+}
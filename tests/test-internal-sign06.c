@@ -0,0 +1,116 @@
+/* Пример, иллюстрирующий выработку общего ключа по алгоритму VKO (Р 50.1.113-2016):
+   обе стороны, используя свой секретный и чужой открытый ключи, должны получить
+   одинаковые значения, совпадающие с хеш-кодом точки [c*UKM*d (mod q)]Q, вычисленной напрямую.
+   Также проверяется, что точки, не принадлежащие кривой, отвергаются.
+   Внимание! Используются неэкспортируемые функции.
+
+   test-internal-sign06.c */
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ak_sign.h>
+ #include <ak_parameters.h>
+
+/* вырабатываем общие ключи для заданной кривой */
+ bool_t vko_test( ak_wcurve wc, ak_random generator )
+{
+  struct signkey ska, skb;
+  struct verifykey vka, vkb;
+  struct wpoint wp;
+  ak_mpzn512 u, d, c;
+  ak_uint8 ukm[8], outa[64], outb[64], buffer[128];
+  bool_t result = ak_false;
+
+  if( wc->size == ak_mpzn256_size ) {
+    ak_signkey_context_create_streebog256( &ska, wc );
+    ak_signkey_context_create_streebog256( &skb, wc );
+  } else {
+      ak_signkey_context_create_streebog512( &ska, wc );
+      ak_signkey_context_create_streebog512( &skb, wc );
+    }
+  /* ключ первой стороны известен и используется для прямого вычисления общей точки */
+  ak_mpzn_set_random_modulo( d, wc->q, wc->size, generator );
+  ak_signkey_context_set_key( &ska, d, sizeof( ak_uint64 )*wc->size, ak_true );
+  ak_signkey_context_set_key_random( &skb, generator );
+  ak_verifykey_context_create_from_signkey( &vka, &ska );
+  ak_verifykey_context_create_from_signkey( &vkb, &skb );
+
+  memset( outa, 0, sizeof( outa ));
+  memset( outb, 0, sizeof( outb ));
+  ak_random_context_random( generator, ukm, sizeof( ukm ));
+  if( ak_signkey_context_vko( &ska, &vkb.qpoint, ukm, sizeof( ukm ), outa ) != ak_error_ok ) goto labexit;
+  if( ak_signkey_context_vko( &skb, &vka.qpoint, ukm, sizeof( ukm ), outb ) != ak_error_ok ) goto labexit;
+  if( memcmp( outa, outb, ska.ctx.hsize ) != 0 ) {
+    printf(" different values of common keys\n");
+    goto labexit;
+  }
+
+ /* вычисляем u = c*UKM*d (mod q) в обычном представлении и хеш-код точки [u]Q */
+  ak_mpzn_set_ui( u, wc->size, 0 );
+  ak_mpzn_set_little_endian( u, 1, ukm, sizeof( ukm ), ak_false );
+  ak_mpzn_set_ui( c, wc->size, wc->cofactor );
+  wc->mulq( u, u, d, wc->q, wc->nq, wc->size );
+  wc->mulq( u, u, wc->r2q, wc->q, wc->nq, wc->size );
+  wc->mulq( u, u, c, wc->q, wc->nq, wc->size );
+  wc->mulq( u, u, wc->r2q, wc->q, wc->nq, wc->size );
+  ak_wpoint_pow( &wp, &vkb.qpoint, u, wc->size, wc );
+  ak_wpoint_reduce( &wp, wc );
+  ak_mpzn_to_little_endian( wp.x, wc->size, buffer, sizeof( ak_uint64 )*wc->size, ak_false );
+  ak_mpzn_to_little_endian( wp.y, wc->size,
+                      buffer + sizeof( ak_uint64 )*wc->size, sizeof( ak_uint64 )*wc->size, ak_false );
+  ak_hash_context_ptr( &ska.ctx, buffer, 2*sizeof( ak_uint64 )*wc->size, outb );
+  if( memcmp( outa, outb, ska.ctx.hsize ) != 0 ) {
+    printf(" common key differs from directly calculated value\n");
+    goto labexit;
+  }
+
+ /* другое значение UKM дает другой ключ */
+  ukm[0] ^= 0x01;
+  if( ak_signkey_context_vko( &skb, &vka.qpoint, ukm, sizeof( ukm ), outb ) != ak_error_ok ) goto labexit;
+  if( memcmp( outa, outb, ska.ctx.hsize ) == 0 ) {
+    printf(" equal values of common keys for different ukm\n");
+    goto labexit;
+  }
+
+ /* точка, не принадлежащая кривой */
+  ak_wpoint_set_wpoint( &wp, &vka.qpoint, wc );
+  wp.x[0] ^= 0x01;
+  if( ak_signkey_context_vko( &skb, &wp, ukm, sizeof( ukm ), outb ) == ak_error_ok ) {
+    printf(" wrong point accepted\n");
+    goto labexit;
+  }
+  result = ak_true;
+  printf(" Ok\n");
+
+ labexit:
+  ak_verifykey_context_destroy( &vka );
+  ak_verifykey_context_destroy( &vkb );
+  ak_signkey_context_destroy( &ska );
+  ak_signkey_context_destroy( &skb );
+ return result;
+}
+
+ int main( void )
+{
+  struct random generator;
+  int result = EXIT_SUCCESS;
+
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+  ak_random_context_create_lcg( &generator );
+
+  printf("id_tc26_gost_3410_2012_256_paramSetA\n");
+  if( !vko_test( (ak_wcurve) &id_tc26_gost_3410_2012_256_paramSetA, &generator ))
+    result = EXIT_FAILURE;
+  printf("id_rfc4357_gost_3410_2001_paramSetB\n");
+  if( !vko_test( (ak_wcurve) &id_rfc4357_gost_3410_2001_paramSetB, &generator ))
+    result = EXIT_FAILURE;
+  printf("id_tc26_gost_3410_2012_512_paramSetC\n");
+  if( !vko_test( (ak_wcurve) &id_tc26_gost_3410_2012_512_paramSetC, &generator ))
+    result = EXIT_FAILURE;
+
+  ak_random_context_destroy( &generator );
+  ak_libakrypt_destroy();
+
+ return result;
+}
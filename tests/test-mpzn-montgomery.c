@@ -1,5 +1,6 @@
  #include <stdio.h>
  #include <stdlib.h>
+ #include <string.h>
  #include <time.h>
  #include <ak_curves.h>
  #include <ak_oid.h>
@@ -227,6 +228,80 @@
  return ( val == count );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/* тест для операции возведения в степень в представлении монтгомери */
+ bool_t modpow_montgomery_test( size_t size, const char *prime, ak_uint64 n0, size_t count )
+{
+  size_t i = 0, val = 0, valfw = 0;
+  mpz_t xm, km, zm, pm, rm, sm;
+  ak_mpznmax x, k, p, z;
+  struct random generator;
+  clock_t tmr;
+
+  mpz_init(xm);
+  mpz_init(km);
+  mpz_init(zm);
+  mpz_init(pm);
+  mpz_init(rm);
+  mpz_init(sm);
+  ak_random_context_create_lcg( &generator );
+
+  mpz_set_str( pm, prime, 16 );
+  ak_mpz_to_mpzn( pm, p, size );
+  mpz_set_ui( rm, 2 ); mpz_pow_ui( rm, rm, size*64 ); mpz_mod( rm, rm, pm );
+  mpz_invert( sm, rm, pm );
+
+  for( i = 0; i < count; i++ ) {
+     ak_mpzn_set_random_modulo( x, p, size, &generator );
+     ak_mpzn_set_random( k, size, &generator );
+    /* проверяем степени с длинными сериями нулей и единиц */
+     if( i == 1 ) { ak_mpzn_set_ui( k, size, 0 ); k[size-1] = 1; }
+     if( i == 2 ) memset( k, 0xff, size*sizeof( ak_uint64 ));
+     if( i == 3 ) ak_mpzn_set_ui( k, size, 0 );
+     ak_mpzn_to_mpz( x, size, xm );
+     ak_mpzn_to_mpz( k, size, km );
+
+     // тестовый пример: результат (x*r^{-1})^k * r
+     mpz_mul( zm, xm, sm ); mpz_mod( zm, zm, pm );
+     mpz_powm( zm, zm, km, pm );
+     mpz_mul( zm, zm, rm ); mpz_mod( zm, zm, pm );
+
+     ak_mpzn_modpow_montgomery( z, x, k, p, n0, size );
+     ak_mpzn_to_mpz( z, size, xm );
+     if( mpz_cmp( xm, zm ) == 0 ) val++;
+     ak_mpzn_modpow_montgomery_fixed_window( z, x, k, p, n0, size );
+     ak_mpzn_to_mpz( z, size, xm );
+     if( mpz_cmp( xm, zm ) == 0 ) valfw++;
+  }
+  printf(" correct montgomery exponentiations %ld (sliding window) and %ld (fixed window) from %ld\n",
+                                                                            val, valfw, count );
+  // speed test
+  tmr = clock();
+  for( i = 0; i < count; i++ ) ak_mpzn_modpow_montgomery( z, x, k, p, n0, size );
+  tmr = clock() - tmr;
+  printf(" mpzn time: %.3fs [sliding window]\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  tmr = clock();
+  for( i = 0; i < count; i++ ) ak_mpzn_modpow_montgomery_fixed_window( z, x, k, p, n0, size );
+  tmr = clock() - tmr;
+  printf(" mpzn time: %.3fs [fixed window]\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  tmr = clock();
+  for( i = 0; i < count; i++ ) mpz_powm( zm, xm, km, pm );
+  tmr = clock() - tmr;
+  printf(" gmp time:  %.3fs\n\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  ak_random_context_destroy( &generator );
+  mpz_clear(sm);
+  mpz_clear(rm);
+  mpz_clear(pm);
+  mpz_clear(zm);
+  mpz_clear(km);
+  mpz_clear(xm);
+
+ return (( val == count ) && ( valfw == count ));
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  int main( void )
 {
@@ -251,10 +326,10 @@
         printf(" - ak_mpzn_mul_montgomery() function test for ak_mpzn256 started\n");
         totalmany++;
         if( mul_montgomery_test( wc->size, str, wc->n, count )) howmany++;
+        printf(" - ak_mpzn_modpow_montgomery() function test for ak_mpzn256 started\n");
+        totalmany++;
+        if( modpow_montgomery_test( wc->size, str, wc->n, count/1000 )) howmany++;
         free( str );
-
-  // добавить modpow!!
-
       }
       if( wc->size == ak_mpzn512_size ) {
         printf(" - p: %s\n", str = ak_mpzn_to_hexstr( wc->p, wc->size ));
@@ -264,6 +339,9 @@
         printf(" - ak_mpzn_mul_montgomery() function test for ak_mpzn512 started\n");
         totalmany++;
         if( mul_montgomery_test( wc->size, str, wc->n, count )) howmany++;
+        printf(" - ak_mpzn_modpow_montgomery() function test for ak_mpzn512 started\n");
+        totalmany++;
+        if( modpow_montgomery_test( wc->size, str, wc->n, count/1000 )) howmany++;
         free( str );
       }
     }